@@ -154,7 +154,7 @@ AudioTimeAxisView::~AudioTimeAxisView ()
 void
 AudioTimeAxisView::first_idle ()
 {
-	_view->attach ();
+	_view->attach (UIConfiguration::instance().get_virtualize_editor_tracks ());
 	post_construct ();
 }
 
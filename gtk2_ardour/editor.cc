@@ -5939,6 +5939,8 @@ Editor::redisplay_track_views ()
 	_summary->set_background_dirty();
 	_group_tabs->set_dirty ();
 
+	queue_track_virtualization ();
+
 	return false;
 }
 
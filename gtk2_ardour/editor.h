@@ -345,6 +345,7 @@ public:
 	void temporal_zoom_step_mouse_focus (bool zoom_out);
 	void temporal_zoom_step_mouse_focus_scale (bool zoom_out, double scale);
 	void ensure_time_axis_view_is_visible (TimeAxisView const & tav, bool at_top);
+	void queue_track_virtualization ();
 	void tav_zoom_step (bool coarser);
 	void tav_zoom_smooth (bool coarser, bool force_all);
 
@@ -1246,6 +1247,9 @@ private:
 	bool             _tvl_redisplay_on_resume;
 	sigc::connection _tvl_redisplay_connection;
 
+	bool update_track_virtualization ();
+	sigc::connection _tvl_virtualization_connection;
+
 	sigc::connection super_rapid_screen_update_connection;
 	void center_screen_internal (samplepos_t, float);
 
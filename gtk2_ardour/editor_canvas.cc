@@ -51,6 +51,7 @@
 #include "audio_time_axis.h"
 #include "editor_drag.h"
 #include "region_view.h"
+#include "streamview.h"
 #include "editor_group_tabs.h"
 #include "editor_summary.h"
 #include "video_timeline.h"
@@ -1006,6 +1007,62 @@ Editor::tie_vertical_scrolling ()
 		_region_peak_cursor->hide ();
 		_summary->set_overlays_dirty ();
 	}
+	queue_track_virtualization ();
+}
+
+void
+Editor::queue_track_virtualization ()
+{
+	if (!_tvl_virtualization_connection.connected ()) {
+		_tvl_virtualization_connection = Glib::signal_idle().connect (sigc::mem_fun (*this, &Editor::update_track_virtualization));
+	}
+}
+
+/** Create region views of tracks that are visible (or within one page
+ * of the visible area), and drop region views of tracks that are more
+ * than four pages away. Track headers, selection and the session's
+ * regions are not affected.
+ */
+bool
+Editor::update_track_virtualization ()
+{
+	if (!_session || _session->deletion_in_progress ()) {
+		return false;
+	}
+
+	const bool   virtualize = UIConfiguration::instance().get_virtualize_editor_tracks ();
+	const double page       = std::max (1.0, _visible_canvas_height);
+	const double top        = vertical_adjustment.get_value ();
+
+	for (TrackViewList::const_iterator i = track_views.begin (); i != track_views.end (); ++i) {
+		RouteTimeAxisView* rtv = dynamic_cast<RouteTimeAxisView*> (*i);
+		if (!rtv || !rtv->view ()) {
+			continue;
+		}
+
+		StreamView* sv = rtv->view ();
+
+		if (!virtualize) {
+			sv->realize ();
+			continue;
+		}
+
+		if (rtv->hidden ()) {
+			sv->unrealize ();
+			continue;
+		}
+
+		const double y0 = rtv->y_position ();
+		const double y1 = y0 + rtv->effective_height ();
+
+		if (y1 >= top - page && y0 <= top + 2 * page) {
+			sv->realize ();
+		} else if (y1 < top - 4 * page || y0 > top + 5 * page) {
+			sv->unrealize ();
+		}
+	}
+
+	return false;
 }
 
 void
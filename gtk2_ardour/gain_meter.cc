@@ -837,9 +837,13 @@ GainMeterBase::meter_channels() const
 		if (_meter) { return _meter->input_streams(); }
 		else { return ChanCount(); }
 }
-void
+bool
 GainMeterBase::update_meters()
 {
+	if (!_clear_meters && !level_meter->update_pending ()) {
+		return false;
+	}
+
 	if (_clear_meters) {
 		max_peak = minus_infinity ();
 		level_meter->clear_meters ();
@@ -868,6 +872,7 @@ GainMeterBase::update_meters()
 			peak_display.set_name ("MixerStripPeakDisplayPeak");
 			_meter_peaked = true;
 	}
+	return true;
 }
 
 void GainMeterBase::color_handler(bool /*dpi*/)
@@ -86,7 +86,7 @@ public:
 	                           boost::shared_ptr<ARDOUR::GainControl> control);
 
 	void update_gain_sensitive ();
-	void update_meters ();
+	bool update_meters ();
 
 	const ARDOUR::ChanCount meter_channels () const;
 
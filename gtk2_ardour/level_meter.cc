@@ -57,6 +57,8 @@ LevelMeterBase::LevelMeterBase (Session* s, PBD::EventLoop::InvalidationRecord*
 	, midi_count (0)
 	, meter_count (0)
 	, max_visible_meters (0)
+	, last_level_serial (0)
+	, idle_updates (0)
 	, color_changed (false)
 {
 	set_session (s);
@@ -85,6 +87,7 @@ LevelMeterBase::set_meter (PeakMeter* meter)
 
 	_meter = meter;
 	color_changed = true; // force update
+	idle_updates = 0;
 
 	if (_meter) {
 		_meter->ConfigurationChanged.connect (_configuration_connection, parent_invalidator, boost::bind (&LevelMeterBase::configuration_changed, this, _1, _2), gui_context());
@@ -127,6 +130,36 @@ static float vu_standard() {
 	}
 }
 
+/** Return true if the meters need to be updated, false if the
+ * PeakMeter did not publish new levels since the last call and
+ * the peak-hold of all meters has expired.
+ */
+bool
+LevelMeterBase::update_pending ()
+{
+	if (!_meter) {
+		return false;
+	}
+
+	const guint serial = _meter->level_serial ();
+
+	if (serial != last_level_serial) {
+		last_level_serial = serial;
+		idle_updates = 0;
+		return true;
+	}
+
+	/* FastMeter counts peak-hold in calls to ::set(), keep
+	 * feeding it the settled value until the hold has expired.
+	 */
+	const uint32_t hold = (uint32_t) std::max (0.f, floorf (UIConfiguration::instance().get_meter_hold()));
+	if (idle_updates <= hold) {
+		++idle_updates;
+		return true;
+	}
+	return false;
+}
+
 float
 LevelMeterBase::update_meters ()
 {
@@ -260,6 +293,7 @@ LevelMeterBase::setup_meters (int len, int initial_width, int thin_width)
 	MeterType meter_type = _meter->meter_type ();
 	uint32_t nmidi = _meter->input_streams().n_midi();
 	uint32_t nmeters = _meter->input_streams().n_total();
+	idle_updates = 0;
 	regular_meter_width = initial_width;
 	thin_meter_width = thin_width;
 	meter_length = len;
@@ -517,6 +551,7 @@ void LevelMeterBase::clear_meters (bool reset_highlight)
 			(*i).meter->set_highlight(false);
 	}
 	max_peak = minus_infinity();
+	idle_updates = 0;
 }
 
 void LevelMeterBase::hide_meters ()
@@ -62,6 +62,7 @@ public:
 	void update_gain_sensitive ();
 
 	float update_meters ();
+	bool  update_pending ();
 	void update_meters_falloff ();
 	void clear_meters (bool reset_highlight = true);
 	void hide_meters ();
@@ -108,6 +109,8 @@ private:
 	uint32_t               midi_count;
 	uint32_t               meter_count;
 	uint32_t               max_visible_meters;
+	guint                  last_level_serial;
+	uint32_t               idle_updates;
 
 	PBD::ScopedConnection _configuration_connection;
 	PBD::ScopedConnection _meter_type_connection;
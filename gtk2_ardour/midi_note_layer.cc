@@ -0,0 +1,389 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <list>
+
+#include <cairomm/context.h>
+#include <glibmm/threads.h>
+
+#include "pbd/pthread_utils.h"
+
+#include "temporal/tempo.h"
+
+#include "ardour/midi_model.h"
+
+#include "gtkmm2ext/colors.h"
+
+#include "midi_note_layer.h"
+#include "rgb_macros.h"
+
+using namespace ArdourCanvas;
+using namespace Temporal;
+
+MidiNoteLayer::MidiNoteLayer (Item* parent)
+	: Item (parent)
+	, _outline_color (0x000000ff)
+	, _samples_per_pixel (0)
+	, _width (0)
+	, _contents_height (0)
+	, _lowest (0)
+	, _highest (127)
+{
+}
+
+void
+MidiNoteLayer::set_geometry (boost::shared_ptr<Geometry const> g)
+{
+	begin_visual_change ();
+	_geometry = g;
+	end_visual_change ();
+}
+
+void
+MidiNoteLayer::set_layout (double samples_per_pixel, double width, uint8_t lowest, uint8_t highest, double contents_height)
+{
+	if (_samples_per_pixel == samples_per_pixel && _width == width && _lowest == lowest && _highest == highest && _contents_height == contents_height) {
+		return;
+	}
+
+	begin_change ();
+	_samples_per_pixel = samples_per_pixel;
+	_width             = width;
+	_lowest            = lowest;
+	_highest           = std::max (lowest, highest);
+	_contents_height   = contents_height;
+	_bounding_box_dirty = true;
+	end_change ();
+}
+
+void
+MidiNoteLayer::set_colors (std::vector<Gtkmm2ext::Color> const & colors, Gtkmm2ext::Color outline)
+{
+	begin_visual_change ();
+	_colors        = colors;
+	_outline_color = outline;
+	end_visual_change ();
+}
+
+void
+MidiNoteLayer::set_hidden (std::set<Evoral::event_id_t> const & hidden)
+{
+	if (_hidden == hidden) {
+		return;
+	}
+
+	begin_visual_change ();
+	_hidden = hidden;
+	end_visual_change ();
+}
+
+void
+MidiNoteLayer::compute_bounding_box () const
+{
+	if (_width > 0 && _contents_height > 0) {
+		_bounding_box = Rect (0, 0, _width, _contents_height);
+	} else {
+		_bounding_box = Rect ();
+	}
+	bb_clean ();
+}
+
+/* see MidiRegionView::note_to_y () */
+double
+MidiNoteLayer::note_to_y (uint8_t note) const
+{
+	const double note_height = _contents_height / (double)(_highest - _lowest + 1);
+	return _contents_height - (note + 1 - _lowest) * note_height + 1;
+}
+
+double
+MidiNoteLayer::note_height () const
+{
+	return std::max (1., floor (_contents_height / (double)(_highest - _lowest + 1)) - 1);
+}
+
+/* see MidiRegionView::update_sustained () */
+Rect
+MidiNoteLayer::note_rect (NoteGeometry const & g, double nh) const
+{
+	const double x0 = floor (g.start / _samples_per_pixel);
+	const double x1 = std::max (x0 + 1., std::max (1., floor (g.end / _samples_per_pixel)) - 1);
+	const double y0 = 1 + floor (note_to_y (g.note));
+
+	return Rect (x0, y0, x1, y0 + nh);
+}
+
+Evoral::event_id_t
+MidiNoteLayer::note_at (Duple const & pos) const
+{
+	Evoral::event_id_t id = -1;
+
+	if (!_geometry || _samples_per_pixel <= 0) {
+		return id;
+	}
+
+	const double nh = note_height ();
+
+	for (Geometry::const_iterator i = _geometry->begin (); i != _geometry->end (); ++i) {
+
+		const Rect r (note_rect (*i, nh));
+
+		if (r.x0 > pos.x) {
+			break;
+		}
+
+		/* later notes are drawn on top */
+		if (in_note_range (*i) && r.contains (pos)) {
+			id = i->id;
+		}
+	}
+
+	return id;
+}
+
+void
+MidiNoteLayer::notes_in (Rect const & area, std::set<Evoral::event_id_t> & ids) const
+{
+	if (!_geometry || _samples_per_pixel <= 0) {
+		return;
+	}
+
+	const double nh = note_height ();
+
+	for (Geometry::const_iterator i = _geometry->begin (); i != _geometry->end (); ++i) {
+
+		const Rect r (note_rect (*i, nh));
+
+		if (r.x0 >= area.x1) {
+			break;
+		}
+
+		/* see MidiRegionView::update_drag_selection () */
+		if (in_note_range (*i) && r.x1 > area.x0 && r.y0 < area.y1 && r.y1 > area.y0) {
+			ids.insert (i->id);
+		}
+	}
+}
+
+void
+MidiNoteLayer::render (Rect const & area, Cairo::RefPtr<Cairo::Context> context) const
+{
+	if (!_geometry || _geometry->empty () || _samples_per_pixel <= 0 || _colors.empty ()) {
+		return;
+	}
+
+	const Rect self (item_to_window (Rect (0, 0, _width, _contents_height)));
+	const Rect draw = self.intersection (area);
+
+	if (!draw) {
+		return;
+	}
+
+	const double nh       = note_height ();
+	const size_t n_colors = _colors.size ();
+
+	/* Collect visible notes per color, then paint each color with a
+	 * single fill. Notes are sorted by start-time, so we can stop at
+	 * the first note that starts after the visible area.
+	 */
+	std::vector<std::vector<Rect> > batches (n_colors);
+
+	for (Geometry::const_iterator i = _geometry->begin (); i != _geometry->end (); ++i) {
+
+		const Rect r (note_rect (*i, nh).translate (Duple (self.x0, self.y0)));
+
+		if (r.x0 > draw.x1) {
+			break;
+		}
+
+		if (!in_note_range (*i) || r.x1 < draw.x0 || r.y0 > draw.y1 || r.y1 < draw.y0) {
+			continue;
+		}
+
+		if (!_hidden.empty () && _hidden.find (i->id) != _hidden.end ()) {
+			continue;
+		}
+
+		const size_t c = std::min (n_colors - 1, (size_t) (i->channel * 16 + i->velocity / 8));
+		batches[c].push_back (r);
+	}
+
+	context->save ();
+	context->rectangle (draw.x0, draw.y0, draw.width (), draw.height ());
+	context->clip ();
+	context->set_line_width (1.0);
+
+	for (size_t c = 0; c < n_colors; ++c) {
+		if (batches[c].empty ()) {
+			continue;
+		}
+
+		for (std::vector<Rect>::const_iterator r = batches[c].begin (); r != batches[c].end (); ++r) {
+			context->rectangle (r->x0 + .5, r->y0 + .5, r->width (), r->height ());
+		}
+
+		Gtkmm2ext::set_source_rgba (context, _colors[c]);
+		context->fill_preserve ();
+		Gtkmm2ext::set_source_rgba (context, UINT_INTERPOLATE (_colors[c], _outline_color, 0.5));
+		context->stroke ();
+	}
+
+	context->restore ();
+}
+
+/* ****************************************************************************/
+
+MidiNoteLayer::Job::Job (boost::shared_ptr<ARDOUR::MidiModel> model,
+                         timepos_t const & source_position,
+                         timepos_t const & region_position,
+                         timepos_t const & region_start,
+                         timecnt_t const & region_length)
+	: _model (model)
+	, _source_position (source_position)
+	, _region_position (region_position)
+	, _region_start (region_start)
+	, _region_length (region_length)
+	, _lowest (127)
+	, _highest (0)
+{
+}
+
+void
+MidiNoteLayer::Job::run ()
+{
+	using ARDOUR::MidiModel;
+
+	TempoMap::fetch ();
+
+	boost::shared_ptr<Geometry> g (new Geometry);
+
+	{
+		MidiModel::ReadLock lock (_model->read_lock ());
+		MidiModel::Notes&   notes (_model->notes ());
+
+		const timepos_t region_end (_region_start + _region_length);
+		const Beats     source_end (region_end.beats ());
+
+		g->reserve (notes.size ());
+
+		for (MidiModel::Notes::const_iterator n = notes.begin (); n != notes.end (); ++n) {
+			boost::shared_ptr<Evoral::Note<Beats> > note (*n);
+
+			/* see MidiRegionView::note_in_region_range () */
+			const timepos_t note_start (note->time ());
+			if (note_start < _region_start || note_start >= region_end) {
+				continue;
+			}
+
+			/* see MidiRegionView::update_sustained () */
+			NoteGeometry ng;
+			ng.start = (note_start + _source_position).earlier (_region_position).samples ();
+
+			if (note->length () == Beats ()) {
+				ng.end = ng.start;
+			} else {
+				timepos_t note_end (note->end_time ());
+				if (note->end_time () > source_end) {
+					note_end = timepos_t (source_end);
+				}
+				ng.end = _region_position.distance (note_end + _source_position).samples ();
+			}
+
+			ng.note     = note->note ();
+			ng.velocity = note->velocity ();
+			ng.channel  = note->channel ();
+			ng.id       = note->id ();
+
+			_lowest  = std::min (_lowest, ng.note);
+			_highest = std::max (_highest, ng.note);
+
+			g->push_back (ng);
+		}
+	}
+
+	_geometry = g;
+	Done (); /* EMIT SIGNAL */
+}
+
+/* ****************************************************************************/
+
+namespace {
+
+/** A single background thread that computes note geometry for all
+ * MidiRegionViews, in the order that jobs were scheduled.
+ */
+class NoteLayerWorker
+{
+public:
+	static NoteLayerWorker& instance ()
+	{
+		static NoteLayerWorker* w = new NoteLayerWorker;
+		return *w;
+	}
+
+	void schedule (boost::shared_ptr<MidiNoteLayer::Job> job)
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+		_queue.push_back (job);
+		_cond.signal ();
+	}
+
+private:
+	NoteLayerWorker ()
+	{
+		Glib::Threads::Thread::create (sigc::mem_fun (*this, &NoteLayerWorker::thread));
+	}
+
+	void thread ()
+	{
+		pthread_set_name ("MIDINoteLayer");
+
+		while (true) {
+			boost::shared_ptr<MidiNoteLayer::Job> job;
+			{
+				Glib::Threads::Mutex::Lock lm (_lock);
+				while (_queue.empty ()) {
+					_cond.wait (_lock);
+				}
+				job = _queue.front ();
+				_queue.pop_front ();
+			}
+
+			/* skip jobs that were superseded, nobody holds a reference
+			 * to them anymore.
+			 */
+			if (job.unique ()) {
+				continue;
+			}
+
+			job->run ();
+		}
+	}
+
+	Glib::Threads::Mutex                              _lock;
+	Glib::Threads::Cond                               _cond;
+	std::list<boost::shared_ptr<MidiNoteLayer::Job> > _queue;
+};
+
+}
+
+void
+MidiNoteLayer::schedule (boost::shared_ptr<Job> job)
+{
+	NoteLayerWorker::instance ().schedule (job);
+}
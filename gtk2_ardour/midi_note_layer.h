@@ -0,0 +1,139 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __gtk_ardour_midi_note_layer_h__
+#define __gtk_ardour_midi_note_layer_h__
+
+#include <set>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "pbd/signals.h"
+
+#include "evoral/types.h"
+
+#include "temporal/timeline.h"
+
+#include "canvas/item.h"
+
+#include "gtkmm2ext/colors.h"
+
+namespace ARDOUR {
+	class MidiModel;
+}
+
+/** A canvas item that draws all notes of a MIDI region in batches,
+ * without creating a canvas item per note. It is used to display
+ * regions with a large number of notes, see MidiRegionView.
+ *
+ * Note geometry is kept in samples relative to the region position
+ * so that zoom changes only require a redraw. Notes that have a canvas
+ * item of their own (selected notes, the note under the pointer) are
+ * not drawn. The layer's geometry is also used to find those notes.
+ */
+class MidiNoteLayer : public ArdourCanvas::Item
+{
+public:
+	struct NoteGeometry {
+		Temporal::samplecnt_t start; ///< relative to region position
+		Temporal::samplecnt_t end;   ///< relative to region position
+		uint8_t               note;
+		uint8_t               velocity;
+		uint8_t               channel;
+		Evoral::event_id_t    id;
+	};
+
+	typedef std::vector<NoteGeometry> Geometry;
+
+	MidiNoteLayer (ArdourCanvas::Item* parent);
+
+	void set_geometry (boost::shared_ptr<Geometry const>);
+	void set_layout (double samples_per_pixel, double width, uint8_t lowest, uint8_t highest, double contents_height);
+
+	/** Fill colors, indexed by (channel * 16 + velocity / 8) */
+	void set_colors (std::vector<Gtkmm2ext::Color> const &, Gtkmm2ext::Color outline);
+
+	/** Notes that are not drawn, because they are displayed by a note item */
+	void set_hidden (std::set<Evoral::event_id_t> const &);
+
+	/** @return ID of the topmost note at the given position (in item coordinates), or -1 */
+	Evoral::event_id_t note_at (ArdourCanvas::Duple const &) const;
+
+	/** Add IDs of all notes intersecting the given area (in item coordinates) */
+	void notes_in (ArdourCanvas::Rect const &, std::set<Evoral::event_id_t> &) const;
+
+	void render (ArdourCanvas::Rect const &, Cairo::RefPtr<Cairo::Context>) const;
+	void compute_bounding_box () const;
+
+	size_t n_notes () const { return _geometry ? _geometry->size () : 0; }
+
+	/** Computes note geometry from a MidiModel on a background thread.
+	 *
+	 * All region properties are copied when the job is created, the
+	 * model is only accessed with its read-lock held while the job runs.
+	 * Done is emitted from the worker thread.
+	 */
+	class Job
+	{
+	public:
+		Job (boost::shared_ptr<ARDOUR::MidiModel>,
+		     Temporal::timepos_t const & source_position,
+		     Temporal::timepos_t const & region_position,
+		     Temporal::timepos_t const & region_start,
+		     Temporal::timecnt_t const & region_length);
+
+		void run ();
+
+		boost::shared_ptr<Geometry const> geometry () const { return _geometry; }
+		uint8_t lowest_note () const  { return _lowest; }
+		uint8_t highest_note () const { return _highest; }
+
+		PBD::Signal0<void> Done;
+
+	private:
+		boost::shared_ptr<ARDOUR::MidiModel> _model;
+		Temporal::timepos_t                  _source_position;
+		Temporal::timepos_t                  _region_position;
+		Temporal::timepos_t                  _region_start;
+		Temporal::timecnt_t                  _region_length;
+		boost::shared_ptr<Geometry const>    _geometry;
+		uint8_t                              _lowest;
+		uint8_t                              _highest;
+	};
+
+	/** queue a job for the background worker */
+	static void schedule (boost::shared_ptr<Job>);
+
+private:
+	double note_to_y (uint8_t note) const;
+	double note_height () const;
+	ArdourCanvas::Rect note_rect (NoteGeometry const &, double note_height) const;
+	bool in_note_range (NoteGeometry const & g) const { return g.note >= _lowest && g.note <= _highest; }
+
+	boost::shared_ptr<Geometry const> _geometry;
+	std::set<Evoral::event_id_t>      _hidden;
+	std::vector<Gtkmm2ext::Color>     _colors;
+	Gtkmm2ext::Color                  _outline_color;
+
+	double  _samples_per_pixel;
+	double  _width;
+	double  _contents_height;
+	uint8_t _lowest;
+	uint8_t _highest;
+};
+
+#endif /* __gtk_ardour_midi_note_layer_h__ */
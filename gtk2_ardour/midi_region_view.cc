@@ -55,6 +55,8 @@
 #include "evoral/Control.h"
 #include "evoral/midi_util.h"
 
+#include "temporal/tempo.h"
+
 #include "canvas/debug.h"
 #include "canvas/text.h"
 
@@ -129,6 +131,9 @@ MidiRegionView::MidiRegionView (ArdourCanvas::Container*      parent,
 	, _entered (false)
 	, _entered_note (0)
 	, _mouse_changed_selection (false)
+	, _note_layer (0)
+	, _note_layer_dirty (true)
+	, _hovered_note (-1)
 {
 	CANVAS_DEBUG_NAME (_note_group, string_compose ("note group for %1", get_item_name()));
 
@@ -171,6 +176,9 @@ MidiRegionView::MidiRegionView (ArdourCanvas::Container*      parent,
 	, _entered (false)
 	, _entered_note (0)
 	, _mouse_changed_selection (false)
+	, _note_layer (0)
+	, _note_layer_dirty (true)
+	, _hovered_note (-1)
 {
 	CANVAS_DEBUG_NAME (_note_group, string_compose ("note group for %1", get_item_name()));
 
@@ -222,6 +230,9 @@ MidiRegionView::MidiRegionView (const MidiRegionView& other)
 	, _entered (false)
 	, _entered_note (0)
 	, _mouse_changed_selection (false)
+	, _note_layer (0)
+	, _note_layer_dirty (true)
+	, _hovered_note (-1)
 {
 	init (false);
 }
@@ -248,6 +259,9 @@ MidiRegionView::MidiRegionView (const MidiRegionView& other, boost::shared_ptr<M
 	, _entered (false)
 	, _entered_note (0)
 	, _mouse_changed_selection (false)
+	, _note_layer (0)
+	, _note_layer_dirty (true)
+	, _hovered_note (-1)
 {
 	init (true);
 }
@@ -303,6 +317,10 @@ MidiRegionView::init (bool wfd)
 	                                            boost::bind (&MidiRegionView::mouse_mode_changed, this),
 	                                            gui_context ());
 
+	Temporal::TempoMap::MapChanged.connect (_tempo_map_connection, invalidator (*this),
+	                                        boost::bind (&MidiRegionView::tempo_map_changed, this),
+	                                        gui_context ());
+
 	Config->ParameterChanged.connect (*this, invalidator (*this), boost::bind (&MidiRegionView::parameter_changed, this, _1), gui_context());
 	connect_to_diskstream ();
 }
@@ -477,6 +495,7 @@ MidiRegionView::leave_internal()
 	hide_verbose_cursor ();
 	remove_ghost_note ();
 	_entered_note = 0;
+	set_hovered_note (-1);
 
 	// Raise frame handles above notes so they catch events
 	if (frame_handle_start) {
@@ -600,6 +619,14 @@ MidiRegionView::motion (GdkEventMotion* ev)
 {
 	PublicEditor& editor = trackview.editor ();
 
+	if (note_layer_visible () && _mouse_state == None && editor.internal_editing ()) {
+		/* only the note under the pointer has a note item */
+		double x = ev->x;
+		double y = ev->y;
+		group->canvas_to_item (x, y);
+		set_hovered_note (_note_layer->note_at (ArdourCanvas::Duple (x, y)));
+	}
+
 	if (!_entered_note) {
 
 		if (_mouse_state == AddDragging) {
@@ -908,7 +935,8 @@ MidiRegionView::display_model(boost::shared_ptr<MidiModel> model)
 	_model = model;
 
 	content_connection.disconnect ();
-	_model->ContentsChanged.connect (content_connection, invalidator (*this), boost::bind (&MidiRegionView::redisplay_model, this), gui_context());
+	_model->ContentsChanged.connect (content_connection, invalidator (*this), boost::bind (&MidiRegionView::model_changed, this), gui_context());
+	_note_layer_dirty = true;
 	/* Don't signal as nobody else needs to know until selection has been altered. */
 	clear_events();
 
@@ -1112,6 +1140,32 @@ MidiRegionView::redisplay_model()
 		return;
 	}
 
+	if (use_note_layer ()) {
+		redisplay_note_layer ();
+		return;
+	}
+
+	if (_note_layer) {
+		_note_layer->hide ();
+		_note_layer_job.reset ();
+		_note_layer_connection.disconnect ();
+		_note_layer_dirty = true;
+	}
+
+	update_note_items (0);
+
+	display_sysexes();
+	display_patch_changes ();
+}
+
+/** Create, update and remove note items to match the model.
+ *
+ * @param ids if non-zero, only notes with these IDs get a note item,
+ * all other note items are removed.
+ */
+void
+MidiRegionView::update_note_items (std::set<Evoral::event_id_t> const * ids)
+{
 	for (_optimization_iterator = _events.begin(); _optimization_iterator != _events.end(); ++_optimization_iterator) {
 		_optimization_iterator->second->invalidate();
 	}
@@ -1131,6 +1185,10 @@ MidiRegionView::redisplay_model()
 		boost::shared_ptr<NoteType> note (*n);
 		bool visible;
 
+		if (ids && ids->find (note->id ()) == ids->end ()) {
+			continue;
+		}
+
 		if (note_in_region_range (note, visible)) {
 			if (!empty_when_starting && (cne = find_canvas_note (note)) != 0) {
 				cne->validate ();
@@ -1214,13 +1272,167 @@ MidiRegionView::redisplay_model()
 		}
 	}
 
-	display_sysexes();
-	display_patch_changes ();
-
 	_marked_for_selection.clear ();
 	_marked_for_velocity.clear ();
 	_pending_note_selection.clear ();
 
+	if (note_layer_visible ()) {
+		std::set<Evoral::event_id_t> hidden;
+		for (Events::iterator i = _events.begin(); i != _events.end(); ++i) {
+			hidden.insert (i->first->id ());
+		}
+		_note_layer->set_hidden (hidden);
+	}
+}
+
+void
+MidiRegionView::model_changed ()
+{
+	_note_layer_dirty = true;
+	redisplay_model ();
+}
+
+void
+MidiRegionView::tempo_map_changed ()
+{
+	/* note geometry is in samples */
+	_note_layer_dirty = true;
+
+	if (note_layer_visible ()) {
+		redisplay_note_layer ();
+	}
+}
+
+/** @return true if notes should be drawn by a MidiNoteLayer rather than
+ * one canvas item per note.
+ */
+bool
+MidiRegionView::use_note_layer ()
+{
+	const uint32_t limit = UIConfiguration::instance().get_max_midi_note_items ();
+
+	if (limit == 0 || _active_notes) {
+		return false;
+	}
+
+	MidiModel::ReadLock lock (_model->read_lock ());
+	return _model->notes ().size () > limit;
+}
+
+void
+MidiRegionView::redisplay_note_layer ()
+{
+	if (!_note_layer) {
+		_note_layer = new MidiNoteLayer (group);
+		CANVAS_DEBUG_NAME (_note_layer, string_compose ("note layer for %1", get_item_name()));
+		_note_layer->set_ignore_events (true);
+		_note_layer->raise_to_top ();
+		_note_group->raise_to_top ();
+	}
+
+	/* fill colors for unselected notes by channel and velocity, see NoteBase::base_color */
+	const uint32_t region_color = midi_stream_view ()->get_region_color ();
+	std::vector<Gtkmm2ext::Color> colors;
+	colors.reserve (256);
+	for (uint8_t chn = 0; chn < 16; ++chn) {
+		for (uint8_t vel = 0; vel < 128; vel += 8) {
+			colors.push_back (NoteBase::base_color (color_mode (), region_color, vel + 4, chn, false));
+		}
+	}
+	_note_layer->set_colors (colors, 0x000000ff);
+
+	_note_layer->set_layout (trackview.editor().get_current_zoom (), _pixel_width, _current_range_min, _current_range_max, contents_height ());
+	_note_layer->show ();
+
+	if (_note_layer_dirty) {
+		/* geometry does not depend on zoom or note-range, only re-compute
+		 * it when the model or the region's bounds changed.
+		 */
+		_note_layer_dirty = false;
+		_note_layer_job.reset (new MidiNoteLayer::Job (_model, _region->source_position (), _region->position (), _region->start (), _region->length ()));
+		_note_layer_job->Done.connect (_note_layer_connection, invalidator (*this), boost::bind (&MidiRegionView::note_layer_geometry_ready, this, boost::weak_ptr<MidiNoteLayer::Job> (_note_layer_job)), gui_context ());
+		MidiNoteLayer::schedule (_note_layer_job);
+	}
+
+	sync_note_items ();
+
+	display_sysexes ();
+	display_patch_changes ();
+}
+
+void
+MidiRegionView::note_layer_geometry_ready (boost::weak_ptr<MidiNoteLayer::Job> wj)
+{
+	boost::shared_ptr<MidiNoteLayer::Job> job (wj.lock ());
+
+	if (!job || job != _note_layer_job || !_note_layer) {
+		/* superseded */
+		return;
+	}
+
+	_note_layer->set_geometry (job->geometry ());
+	_note_layer_job.reset ();
+
+	if (job->lowest_note () <= job->highest_note ()) {
+		midi_stream_view ()->update_note_range (job->lowest_note ());
+		midi_stream_view ()->update_note_range (job->highest_note ());
+	}
+}
+
+/** Used when notes are drawn by the MidiNoteLayer: only selected notes
+ * (including those about to be selected), the note under the pointer and
+ * @a extra get a note item, all other note items are removed.
+ */
+void
+MidiRegionView::sync_note_items (std::set<Evoral::event_id_t> const & extra)
+{
+	std::set<Evoral::event_id_t> ids (extra);
+
+	for (Selection::const_iterator i = _selection.begin(); i != _selection.end(); ++i) {
+		ids.insert ((*i)->note()->id ());
+	}
+	for (std::set<boost::shared_ptr<NoteType> >::const_iterator i = _marked_for_selection.begin(); i != _marked_for_selection.end(); ++i) {
+		ids.insert ((*i)->id ());
+	}
+	for (std::set<boost::shared_ptr<NoteType> >::const_iterator i = _marked_for_velocity.begin(); i != _marked_for_velocity.end(); ++i) {
+		ids.insert ((*i)->id ());
+	}
+	ids.insert (_pending_note_selection.begin(), _pending_note_selection.end());
+
+	if (_entered_note) {
+		ids.insert (_entered_note->note()->id ());
+	}
+	if (_hovered_note >= 0) {
+		ids.insert (_hovered_note);
+	}
+
+	update_note_items (&ids);
+}
+
+void
+MidiRegionView::set_hovered_note (Evoral::event_id_t id)
+{
+	if (id == _hovered_note) {
+		return;
+	}
+
+	_hovered_note = id;
+
+	if (note_layer_visible ()) {
+		sync_note_items ();
+	}
+}
+
+/** Make sure that every note has a note item, before selecting from all
+ * notes. When using the note layer, unselected note items are removed
+ * again by the next sync_note_items ().
+ */
+void
+MidiRegionView::add_all_note_items ()
+{
+	if (note_layer_visible ()) {
+		update_note_items (0);
+	}
 }
 
 void
@@ -1369,6 +1581,7 @@ MidiRegionView::~MidiRegionView ()
 	_entered_note = 0;
 	clear_events ();
 
+	delete _note_layer;
 	delete _note_group;
 	delete _note_diff_command;
 	delete _step_edit_cursor;
@@ -1377,6 +1590,8 @@ MidiRegionView::~MidiRegionView ()
 void
 MidiRegionView::region_resized (const PropertyChange& what_changed)
 {
+	_note_layer_dirty = true;
+
 	RegionView::region_resized(what_changed); // calls RegionView::set_duration()
 
 	/* catch end and start trim so we can update the view*/
@@ -2142,6 +2357,7 @@ void
 MidiRegionView::select_all_notes ()
 {
 	PBD::Unwinder<bool> uw (_no_sound_notes, true);
+	add_all_note_items ();
 	for (Events::iterator i = _events.begin(); i != _events.end(); ++i) {
 		add_to_selection (i->second);
 	}
@@ -2151,6 +2367,7 @@ void
 MidiRegionView::select_range (timepos_t const & start, timepos_t const & end)
 {
 	PBD::Unwinder<bool> uw (_no_sound_notes, true);
+	add_all_note_items ();
 	for (Events::iterator i = _events.begin(); i != _events.end(); ++i) {
 		timepos_t t = _region->source_beats_to_absolute_time (i->first->time());
 		if (t >= start && t <= end) {
@@ -2168,6 +2385,8 @@ MidiRegionView::extend_selection ()
 
 	PBD::Unwinder<bool> uw (_no_sound_notes, true);
 
+	add_all_note_items ();
+
 	/* find end of current selection */
 
 	timepos_t first_note_start = timepos_t::max (BeatTime);
@@ -2196,6 +2415,7 @@ void
 MidiRegionView::invert_selection ()
 {
 	PBD::Unwinder<bool> uw (_no_sound_notes, true);
+	add_all_note_items ();
 	for (Events::iterator i = _events.begin(); i != _events.end(); ++i) {
 		if (i->second->selected()) {
 			remove_from_selection(i->second);
@@ -2223,11 +2443,17 @@ MidiRegionView::select_notes (list<Evoral::event_id_t> notes, bool allow_auditio
 			_pending_note_selection.insert(*n);
 		}
 	}
+
+	if (!_pending_note_selection.empty () && note_layer_visible ()) {
+		sync_note_items ();
+	}
 }
 
 void
 MidiRegionView::select_matching_notes (uint8_t notenum, uint16_t channel_mask, bool add, bool extend)
 {
+	add_all_note_items ();
+
 	bool have_selection = !_selection.empty();
 	uint8_t low_note = 127;
 	uint8_t high_note = 0;
@@ -2298,6 +2524,8 @@ MidiRegionView::select_matching_notes (uint8_t notenum, uint16_t channel_mask, b
 void
 MidiRegionView::toggle_matching_notes (uint8_t notenum, uint16_t channel_mask)
 {
+	add_all_note_items ();
+
 	MidiModel::Notes& notes (_model->notes());
 	_optimization_iterator = _events.begin();
 
@@ -2355,6 +2583,8 @@ MidiRegionView::note_selected (NoteBase* ev, bool add, bool extend)
 			earliest = ev->note()->time();
 		}
 
+		add_all_note_items ();
+
 		for (Events::iterator i = _events.begin(); i != _events.end(); ++i) {
 
 			/* find notes entirely within OR spanning the earliest..latest range */
@@ -2385,6 +2615,13 @@ MidiRegionView::update_drag_selection(timepos_t const & start, timepos_t const &
 	const double     y0 = max(0.0, gy0 - y);
 	const double     y1 = max(0.0, gy1 - y);
 
+	if (note_layer_visible ()) {
+		/* create note items for all notes in the rect */
+		std::set<Evoral::event_id_t> ids;
+		_note_layer->notes_in (ArdourCanvas::Rect (x0, y0, x1, y1), ids);
+		sync_note_items (ids);
+	}
+
 	// TODO: Make this faster by storing the last updated selection rect, and only
 	// adjusting things that are in the area that appears/disappeared.
 	// We probably need a tree to be able to find events in O(log(n)) time.
@@ -2431,6 +2668,13 @@ MidiRegionView::update_vertical_drag_selection (double y1, double y2, bool exten
 		swap (y1, y2);
 	}
 
+	if (note_layer_visible ()) {
+		/* create note items for all notes in the range */
+		std::set<Evoral::event_id_t> ids;
+		_note_layer->notes_in (ArdourCanvas::Rect (0, y1, ArdourCanvas::COORD_MAX, y2), ids);
+		sync_note_items (ids);
+	}
+
 	// TODO: Make this faster by storing the last updated selection rect, and only
 	// adjusting things that are in the area that appears/disappeared.
 	// We probably need a tree to be able to find events in O(log(n)) time.
@@ -3860,6 +4104,13 @@ MidiRegionView::selection_as_notelist (Notes& selected, bool allow_all_if_none_s
 	}
 
 	if (allow_all_if_none_selected && !had_selected) {
+		if (note_layer_visible ()) {
+			/* not every note has a note item */
+			MidiModel::ReadLock lock (_model->read_lock ());
+			MidiModel::Notes& notes (_model->notes ());
+			selected.insert (notes.begin (), notes.end ());
+			return;
+		}
 		for (Events::iterator i = _events.begin(); i != _events.end(); ++i) {
 			selected.insert (i->first);
 		}
@@ -35,6 +35,7 @@
 #include "ardour/types.h"
 
 #include "editing.h"
+#include "midi_note_layer.h"
 #include "region_view.h"
 #include "midi_time_axis.h"
 #include "time_axis_view_item.h"
@@ -565,6 +566,30 @@ public:
 
 	double note_to_y (uint8_t note) const;
 	uint8_t y_to_note (double y) const;
+
+	/* Regions with many notes are drawn by a MidiNoteLayer, whose
+	 * geometry is computed on a background thread. Individual note
+	 * items are only created for selected notes and the note under
+	 * the pointer.
+	 */
+	MidiNoteLayer*                         _note_layer;
+	boost::shared_ptr<MidiNoteLayer::Job>  _note_layer_job;
+	PBD::ScopedConnection                  _note_layer_connection;
+	PBD::ScopedConnection                  _tempo_map_connection;
+	bool                                   _note_layer_dirty;
+	Evoral::event_id_t                     _hovered_note;
+
+	bool note_layer_visible () const { return _note_layer && _note_layer->visible (); }
+
+	void model_changed ();
+	void tempo_map_changed ();
+	bool use_note_layer ();
+	void redisplay_note_layer ();
+	void note_layer_geometry_ready (boost::weak_ptr<MidiNoteLayer::Job>);
+	void update_note_items (std::set<Evoral::event_id_t> const *);
+	void sync_note_items (std::set<Evoral::event_id_t> const & extra = std::set<Evoral::event_id_t> ());
+	void set_hovered_note (Evoral::event_id_t);
+	void add_all_note_items ();
 };
 
 
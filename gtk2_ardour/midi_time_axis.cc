@@ -97,6 +97,7 @@
 #include "rgb_macros.h"
 #include "selection.h"
 #include "step_editor.h"
+#include "ui_config.h"
 #include "utils.h"
 #include "note_base.h"
 
@@ -308,7 +309,7 @@ void
 MidiTimeAxisView::first_idle ()
 {
 	if (is_track ()) {
-		_view->attach ();
+		_view->attach (UIConfiguration::instance().get_virtualize_editor_tracks ());
 	}
 }
 
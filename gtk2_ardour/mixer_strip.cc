@@ -956,10 +956,10 @@ MixerStrip::update_output_display ()
 	}
 }
 
-void
+bool
 MixerStrip::fast_update ()
 {
-	gpm.update_meters ();
+	return gpm.update_meters ();
 }
 
 void
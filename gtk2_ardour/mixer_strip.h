@@ -108,7 +108,7 @@ public:
 	PannerUI&       panner_ui()       { return panners; }
 	PluginSelector* plugin_selector();
 
-	void fast_update ();
+	bool fast_update ();
 	void set_embedded (bool);
 
 	void set_route (boost::shared_ptr<ARDOUR::Route>);
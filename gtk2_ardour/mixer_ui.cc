@@ -78,6 +78,7 @@
 #include "utils.h"
 #include "route_sorter.h"
 #include "actions.h"
+#include "debug.h"
 #include "gui_thread.h"
 #include "mixer_group_tabs.h"
 #include "plugin_utils.h"
@@ -117,6 +118,8 @@ Mixer_UI::instance ()
 Mixer_UI::Mixer_UI ()
 	: Tabbable (_content, _("Mixer"), X_("mixer"))
 	, plugin_search_clear_button (Stock::CLEAR)
+	, _meter_update_cycles (0)
+	, _meter_update_damaged (0)
 	, no_track_list_redisplay (false)
 	, in_group_row_change (false)
 	, track_menu (0)
@@ -1385,14 +1388,45 @@ Mixer_UI::stop_updating ()
 void
 Mixer_UI::fast_update_strips ()
 {
-	if (_content.is_mapped () && _session) {
-		for (list<MixerStrip *>::iterator i = strips.begin(); i != strips.end(); ++i) {
-			(*i)->fast_update ();
-		}
-		if (foldback_strip) {
-			foldback_strip->fast_update ();
+	if (!_content.is_mapped () || !_session) {
+		return;
+	}
+
+	/* Single pass over all strips. Strips whose PeakMeter did not
+	 * publish new levels (and whose peak-hold expired) return early
+	 * without touching any widget, so only strips with changed meters
+	 * are damaged.
+	 */
+	_meter_update_stats.start ();
+
+	for (list<MixerStrip *>::iterator i = strips.begin(); i != strips.end(); ++i) {
+		if ((*i)->fast_update ()) {
+			++_meter_update_damaged;
 		}
 	}
+	if (foldback_strip) {
+		foldback_strip->fast_update ();
+	}
+
+	_meter_update_stats.update ();
+
+	if (++_meter_update_cycles < 250) {
+		return;
+	}
+
+#ifndef NDEBUG
+	microseconds_t min, max;
+	double avg, dev;
+	if (_meter_update_stats.get_stats (min, max, avg, dev)) {
+		DEBUG_TRACE (DEBUG::GUITiming, string_compose ("Mixer meter update: %1 strips, %2 damaged/cycle, min: %3 max: %4 avg: %5 dev: %6 [usec]\n",
+		                                               strips.size (), _meter_update_damaged / (float)_meter_update_cycles,
+		                                               min, max, avg, dev));
+	}
+#endif
+
+	_meter_update_stats.reset ();
+	_meter_update_cycles  = 0;
+	_meter_update_damaged = 0;
 }
 
 void
@@ -41,6 +41,7 @@
 
 #include "pbd/stateful.h"
 #include "pbd/signals.h"
+#include "pbd/timing.h"
 
 #include "ardour/ardour.h"
 #include "ardour/types.h"
@@ -245,6 +246,10 @@ private:
 	sigc::connection fast_screen_update_connection;
 	void fast_update_strips ();
 
+	PBD::TimingStats _meter_update_stats;
+	uint32_t         _meter_update_cycles;
+	uint32_t         _meter_update_damaged;
+
 	void track_name_changed (MixerStrip *);
 
 	void redisplay_track_list ();
@@ -183,30 +183,33 @@ NoteBase::set_selected(bool selected)
 uint32_t
 NoteBase::base_color()
 {
-	using namespace ARDOUR;
+	return base_color (_region.color_mode(), _region.midi_stream_view()->get_region_color(), _note->velocity(), _note->channel(), selected());
+}
 
-	ColorMode mode = _region.color_mode();
+/** Compute the fill color of a note, without needing a NoteBase instance
+ * (used by MidiNoteLayer).
+ */
+uint32_t
+NoteBase::base_color (ARDOUR::ColorMode mode, uint32_t region_color, uint8_t velocity, uint8_t channel, bool selected)
+{
+	using namespace ARDOUR;
 
 	const uint8_t min_opacity = 15;
-	uint8_t       opacity = std::max(min_opacity, uint8_t(_note->velocity() + _note->velocity()));
+	uint8_t       opacity = std::max(min_opacity, uint8_t(velocity + velocity));
 
 	switch (mode) {
 	case TrackColor:
-	{
-		const uint32_t region_color = _region.midi_stream_view()->get_region_color();
 		return UINT_INTERPOLATE (UINT_RGBA_CHANGE_A (region_color, opacity), _selected_col,
 					 0.5);
-	}
 
 	case ChannelColors:
-		return UINT_INTERPOLATE (UINT_RGBA_CHANGE_A (NoteBase::midi_channel_colors[_note->channel()], opacity),
+		return UINT_INTERPOLATE (UINT_RGBA_CHANGE_A (NoteBase::midi_channel_colors[channel], opacity),
 		                          _selected_col, 0.5);
 
 	default:
 		if (UIConfiguration::instance().get_use_note_color_for_velocity()) {
-			return meter_style_fill_color(_note->velocity(), selected());
+			return meter_style_fill_color(velocity, selected);
 		} else {
-			const uint32_t region_color = _region.midi_stream_view()->get_region_color();
 			return UINT_INTERPOLATE (UINT_RGBA_CHANGE_A (region_color, opacity), _selected_col,
 			                         0.5);
 		}
@@ -3120,6 +3120,16 @@ These settings will only take effect after %1 is restarted.\n\
 			    sigc::mem_fun (UIConfiguration::instance(), &UIConfiguration::set_update_editor_during_summary_drag)
 			    ));
 
+	bo = new BoolOption (
+			"virtualize-editor-tracks",
+			_("Only create region displays for visible tracks"),
+			sigc::mem_fun (UIConfiguration::instance(), &UIConfiguration::get_virtualize_editor_tracks),
+			sigc::mem_fun (UIConfiguration::instance(), &UIConfiguration::set_virtualize_editor_tracks)
+			);
+	add_option (_("Editor"), bo);
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, regions of tracks that are scrolled far out of view are not displayed. This reduces memory usage and speeds up loading of sessions with many tracks."));
+
 	add_option (_("Editor"),
 	    new BoolOption (
 		    "autoscroll-editor",
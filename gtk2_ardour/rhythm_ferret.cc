@@ -29,11 +29,11 @@
 #include "ardour/audioregion.h"
 #include "ardour/onset_detector.h"
 #include "ardour/session.h"
-#include "ardour/transient_detector.h"
 
 #include "rhythm_ferret.h"
 #include "audio_region_view.h"
 #include "editor.h"
+#include "gui_thread.h"
 #include "time_axis_view.h"
 
 #include "pbd/i18n.h"
@@ -229,6 +229,7 @@ RhythmFerret::run_analysis ()
 		return;
 	}
 
+	cancel_analysis ();
 	clear_transients ();
 
 	regions_with_transients = editor.get_selection().regions;
@@ -241,14 +242,18 @@ RhythmFerret::run_analysis ()
 
 	for (RegionSelection::iterator i = regions_with_transients.begin(); i != regions_with_transients.end(); ++i) {
 
-		boost::shared_ptr<AudioReadable> rd = boost::static_pointer_cast<AudioRegion> ((*i)->region());
+		boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> ((*i)->region());
+		if (!ar) {
+			continue;
+		}
 
 		switch (get_analysis_mode()) {
 		case PercussionOnset:
-			run_percussion_onset_analysis (rd, (*i)->region()->position_sample(), current_results);
-			break;
+			/* results are set when all jobs have finished */
+			queue_percussion_onset_analysis (ar);
+			continue;
 		case NoteOnset:
-			run_note_onset_analysis (rd, (*i)->region()->position_sample(), current_results);
+			run_note_onset_analysis (ar, ar->position_sample(), current_results);
 			break;
 		default:
 			break;
@@ -257,42 +262,84 @@ RhythmFerret::run_analysis ()
 		(*i)->region()->set_onsets (current_results);
 		current_results.clear();
 	}
+
+	if (!pending_analysis.empty ()) {
+		analyze_button.set_sensitive (false);
+		/* jobs may have finished before we connected */
+		percussion_onset_analysis_finished ();
+	}
 }
 
-int
-RhythmFerret::run_percussion_onset_analysis (boost::shared_ptr<AudioReadable> readable, sampleoffset_t /*offset*/, AnalysisFeatureList& results)
+void
+RhythmFerret::queue_percussion_onset_analysis (boost::shared_ptr<AudioRegion> region)
 {
-	try {
-		TransientDetector t (_session->sample_rate());
+	float dB = detection_threshold_adjustment.get_value();
+	float coeff = dB > -80.0f ? pow (10.0f, dB * 0.05f) : 0.0f;
 
-		for (uint32_t i = 0; i < readable->n_channels(); ++i) {
+	list<AnalysisService::JobPtr>& jobs (pending_analysis[region]);
 
-			AnalysisFeatureList these_results;
+	for (uint32_t i = 0; i < region->n_channels(); ++i) {
+		AnalysisService::JobPtr job = AnalysisService::analyze_transients (region->audio_source (i), region->start_sample (), region->length_samples (),
+		                                                                   coeff, 4, sensitivity_adjustment.get_value());
+		job->Finished.connect (analysis_connections, invalidator (*this), boost::bind (&RhythmFerret::percussion_onset_analysis_finished, this), gui_context());
+		jobs.push_back (job);
+	}
+}
 
-			t.reset ();
-			float dB = detection_threshold_adjustment.get_value();
-			float coeff = dB > -80.0f ? pow (10.0f, dB * 0.05f) : 0.0f;
-			t.set_threshold (coeff);
-			t.set_sensitivity (4, sensitivity_adjustment.get_value());
+void
+RhythmFerret::percussion_onset_analysis_finished ()
+{
+	for (PendingAnalysis::iterator i = pending_analysis.begin (); i != pending_analysis.end ();) {
 
-			if (t.run ("", readable.get(), i, these_results)) {
-				continue;
+		bool done = true;
+		for (list<AnalysisService::JobPtr>::const_iterator j = i->second.begin (); j != i->second.end (); ++j) {
+			if (!(*j)->finished ()) {
+				done = false;
+				break;
 			}
+		}
 
-			/* merge */
-
-			results.insert (results.end(), these_results.begin(), these_results.end());
-			these_results.clear ();
+		if (!done) {
+			++i;
+			continue;
+		}
 
-			t.update_positions (readable.get(), i, results);
+		/* merge the results of all channels */
+		AnalysisFeatureList results;
+		for (list<AnalysisService::JobPtr>::const_iterator j = i->second.begin (); j != i->second.end (); ++j) {
+			if (!(*j)->failed ()) {
+				results.insert (results.end(), (*j)->transients ().begin (), (*j)->transients ().end ());
+			}
 		}
+		results.sort ();
+		results.unique ();
 
-	} catch (failed_constructor& err) {
-		error << "Could not load percussion onset detection plugin" << endmsg;
-		return -1;
+		i->first->set_onsets (results);
+		pending_analysis.erase (i++);
 	}
 
-	return 0;
+	if (pending_analysis.empty ()) {
+		analysis_connections.drop_connections ();
+		analyze_button.set_sensitive (true);
+	}
+}
+
+void
+RhythmFerret::cancel_analysis ()
+{
+	/* Job::cancel emits Finished, disconnect first */
+	analysis_connections.drop_connections ();
+
+	PendingAnalysis pending;
+	pending.swap (pending_analysis);
+
+	for (PendingAnalysis::const_iterator i = pending.begin (); i != pending.end (); ++i) {
+		for (list<AnalysisService::JobPtr>::const_iterator j = i->second.begin (); j != i->second.end (); ++j) {
+			(*j)->cancel ();
+		}
+	}
+
+	analyze_button.set_sensitive (true);
 }
 
 int
@@ -432,6 +479,7 @@ void
 RhythmFerret::set_session (Session* s)
 {
 	ArdourDialog::set_session (s);
+	cancel_analysis ();
 	current_results.clear ();
 }
 
@@ -439,6 +487,7 @@ void
 RhythmFerret::on_hide ()
 {
 	ArdourDialog::on_hide ();
+	cancel_analysis ();
 	clear_transients ();
 }
 
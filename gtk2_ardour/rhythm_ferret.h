@@ -32,11 +32,17 @@
 #include <gtkmm/comboboxtext.h>
 #include <gtkmm/button.h>
 
+#include "pbd/signals.h"
+
+#include "ardour/analysis_service.h"
+
 #include "ardour_dialog.h"
 #include "region_selection.h"
 
 namespace ARDOUR {
 	class AudioReadable;
+	class AudioRegion;
+	class Region;
 }
 
 class Editor;
@@ -107,6 +113,11 @@ private:
 
 	ARDOUR::AnalysisFeatureList current_results;
 
+	/** Percussion onset analysis in progress, one job per region channel */
+	typedef std::map<boost::shared_ptr<ARDOUR::Region>, std::list<ARDOUR::AnalysisService::JobPtr> > PendingAnalysis;
+	PendingAnalysis           pending_analysis;
+	PBD::ScopedConnectionList analysis_connections;
+
 	void clear_transients ();
 	/** Regions that we have added transient marks to */
 	RegionSelection regions_with_transients;
@@ -117,7 +128,9 @@ private:
 	int get_note_onset_function ();
 
 	void run_analysis ();
-	int run_percussion_onset_analysis (boost::shared_ptr<ARDOUR::AudioReadable> region, ARDOUR::sampleoffset_t offset, ARDOUR::AnalysisFeatureList& results);
+	void queue_percussion_onset_analysis (boost::shared_ptr<ARDOUR::AudioRegion>);
+	void percussion_onset_analysis_finished ();
+	void cancel_analysis ();
 	int run_note_onset_analysis (boost::shared_ptr<ARDOUR::AudioReadable> region, ARDOUR::sampleoffset_t offset, ARDOUR::AnalysisFeatureList& results);
 
 	void do_action ();
@@ -71,6 +71,7 @@ StreamView::StreamView (RouteTimeAxisView& tv, ArdourCanvas::Container* canvas_g
 	, _layers (1)
 	, _layer_display (Overlaid)
 	, height (tv.height)
+	, _display_pending (false)
 	, last_rec_data_sample(0)
 {
 	CANVAS_DEBUG_NAME (_canvas_group, string_compose ("SV canvas group %1", _trackview.name()));
@@ -102,12 +103,60 @@ StreamView::~StreamView ()
 	delete canvas_rect;
 }
 
+/** Display the track's playlist.
+ *  @param defer if true, region views are not created until the track
+ *  scrolls into view (see ::realize) or they are first needed.
+ */
 void
-StreamView::attach ()
+StreamView::attach (bool defer)
 {
-	if (_trackview.is_track()) {
-		display_track (_trackview.track ());
+	if (!_trackview.is_track()) {
+		return;
+	}
+
+	if (defer) {
+		_display_pending = true;
+		_trackview.editor().queue_track_virtualization ();
+		return;
 	}
+
+	_display_pending = false;
+	display_track (_trackview.track ());
+}
+
+/** Create region views for a track whose display was deferred */
+void
+StreamView::realize ()
+{
+	if (_display_pending) {
+		attach (false);
+	}
+}
+
+/** Drop all region views of a track that is far outside the visible area.
+ *  The regions themselves remain owned by the playlist, the views are
+ *  re-created by ::realize. Tracks that are recording or have selected
+ *  regions are left alone.
+ *
+ *  @return true if region views were dropped.
+ */
+bool
+StreamView::unrealize ()
+{
+	if (_display_pending || !_trackview.is_track()) {
+		return false;
+	}
+
+	if (rec_active || rec_updating || !rec_regions.empty () || num_selected_regionviews () > 0) {
+		return false;
+	}
+
+	playlist_switched_connection.disconnect ();
+	playlist_connections.drop_connections ();
+	undisplay_track ();
+
+	_display_pending = true;
+	return true;
 }
 
 int
@@ -473,6 +522,8 @@ StreamView::update_rec_box ()
 RegionView*
 StreamView::find_view (boost::shared_ptr<const Region> region)
 {
+	realize ();
+
 	for (list<RegionView*>::iterator i = region_views.begin(); i != region_views.end(); ++i) {
 
 		if ((*i)->region() == region) {
@@ -498,6 +549,8 @@ StreamView::num_selected_regionviews () const
 void
 StreamView::foreach_regionview (sigc::slot<void,RegionView*> slot)
 {
+	realize ();
+
 	for (list<RegionView*>::iterator i = region_views.begin(); i != region_views.end(); ++i) {
 		slot (*i);
 	}
@@ -547,6 +600,8 @@ StreamView::get_selectables (timepos_t const & start, timepos_t const & end, dou
 		return;  // Don't select regions with an internal tool
 	}
 
+	realize ();
+
 	layer_t min_layer = 0;
 	layer_t max_layer = 0;
 
@@ -594,6 +649,8 @@ StreamView::get_selectables (timepos_t const & start, timepos_t const & end, dou
 void
 StreamView::get_inverted_selectables (Selection& sel, list<Selectable*>& results)
 {
+	realize ();
+
 	for (list<RegionView*>::iterator i = region_views.begin(); i != region_views.end(); ++i) {
 		if (!sel.regions.contains (*i)) {
 			results.push_back (*i);
@@ -604,6 +661,8 @@ StreamView::get_inverted_selectables (Selection& sel, list<Selectable*>& results
 void
 StreamView::get_regionviews_at_or_after (timepos_t const & pos, RegionSelection& regions)
 {
+	realize ();
+
 	for (list<RegionView*>::iterator i = region_views.begin(); i != region_views.end(); ++i) {
 		if ((*i)->region()->position() >= pos) {
 			regions.push_back (*i);
@@ -72,7 +72,14 @@ public:
 	RouteTimeAxisView&       trackview()       { return _trackview; }
 	const RouteTimeAxisView& trackview() const { return _trackview; }
 
-	void attach ();
+	void attach (bool defer = false);
+
+	/* track virtualization: region views are only created while the
+	 * track is (close to being) visible in the editor.
+	 */
+	void realize ();
+	bool unrealize ();
+	bool realized () const { return !_display_pending; }
 
 	void set_zoom_all();
 
@@ -183,6 +190,8 @@ protected:
 
 	double height;
 
+	bool _display_pending;
+
 	PBD::ScopedConnectionList rec_data_ready_connections;
 	samplepos_t               last_rec_data_sample;
 
@@ -59,7 +59,9 @@ UI_CONFIG_VARIABLE (bool, show_waveforms_while_recording, "show-waveforms-while-
 UI_CONFIG_VARIABLE (ARDOUR::WaveformScale, waveform_scale, "waveform-scale", Logarithmic)
 UI_CONFIG_VARIABLE (ARDOUR::WaveformShape, waveform_shape, "waveform-shape", Traditional)
 UI_CONFIG_VARIABLE (bool, update_editor_during_summary_drag, "update-editor-during-summary-drag", true)
+UI_CONFIG_VARIABLE (bool, virtualize_editor_tracks, "virtualize-editor-tracks", true)
 UI_CONFIG_VARIABLE (bool, never_display_periodic_midi, "never-display-periodic-midi", true)
+UI_CONFIG_VARIABLE (uint32_t, max_midi_note_items, "max-midi-note-items", 4000) /* per region, 0: unlimited */
 UI_CONFIG_VARIABLE (bool, sound_midi_notes, "sound-midi-notes", false)
 UI_CONFIG_VARIABLE (bool, show_plugin_scan_window, "show-plugin-scan-window", false)
 UI_CONFIG_VARIABLE (bool, show_zoom_tools, "show-zoom-tools", true)
@@ -0,0 +1,711 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <sstream>
+
+#include <boost/scoped_ptr.hpp>
+
+#include "pbd/compose.h"
+#include "pbd/cpus.h"
+#include "pbd/error.h"
+#include "pbd/gstdio_compat.h"
+#include "pbd/pthread_utils.h"
+#include "pbd/xml++.h"
+
+#include "ardour/analysis_graph.h"
+#include "ardour/analysis_service.h"
+#include "ardour/audiofilesource.h"
+#include "ardour/audioregion.h"
+#include "ardour/automation_list.h"
+#include "ardour/ebur128_analysis.h"
+#include "ardour/export_analysis.h"
+#include "ardour/filename_extensions.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/readable.h"
+#include "ardour/session.h"
+#include "ardour/session_event.h"
+#include "ardour/transient_detector.h"
+
+#include "pbd/i18n.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+vector<pthread_t>              AnalysisService::_workers;
+bool                           AnalysisService::_started = false;
+bool                           AnalysisService::_quit = false;
+list<AnalysisService::JobPtr>  AnalysisService::_queue;
+Glib::Threads::Mutex           AnalysisService::_queue_lock;
+Glib::Threads::Cond            AnalysisService::_queue_cond;
+AnalysisService::CacheFiles    AnalysisService::_cache;
+set<string>                    AnalysisService::_dirty;
+Glib::Threads::Mutex           AnalysisService::_cache_lock;
+Glib::Threads::Mutex           AnalysisService::_save_lock;
+
+namespace {
+
+/** Present a range of one or more sources (one per channel) as
+ * AudioReadable, starting at sample 0.
+ */
+class RangeReadable : public AudioReadable
+{
+public:
+	RangeReadable (vector<boost::shared_ptr<AudioSource> > const& sources, samplepos_t start, samplecnt_t length)
+		: _sources (sources)
+		, _start (start)
+		, _length (length)
+	{}
+
+	samplecnt_t read (Sample* buf, samplepos_t pos, samplecnt_t cnt, int channel) const
+	{
+		if (channel < 0 || (size_t) channel >= _sources.size () || pos >= _length) {
+			return 0;
+		}
+		return _sources[channel]->read (buf, _start + pos, min (cnt, _length - pos));
+	}
+
+	samplecnt_t readable_length_samples () const { return _length; }
+	uint32_t n_channels () const { return _sources.size (); }
+
+private:
+	vector<boost::shared_ptr<AudioSource> > _sources;
+	samplepos_t                             _start;
+	samplecnt_t                             _length;
+};
+
+/* plugin instantiation is not thread-safe */
+Glib::Threads::Mutex plugin_lock;
+
+void
+add_list_state (stringstream& ss, boost::shared_ptr<AutomationList> l)
+{
+	if (!l) {
+		return;
+	}
+	Glib::Threads::RWLock::ReaderLock lm (l->lock ());
+	for (AutomationList::const_iterator i = l->begin (); i != l->end (); ++i) {
+		ss << (*i)->when.str () << ' ' << (*i)->value << ' ';
+	}
+	ss << ';';
+}
+
+/** @return a hash of all region properties that affect AudioRegion::read_at() */
+string
+region_state_key (boost::shared_ptr<AudioRegion> r)
+{
+	stringstream ss;
+	ss.precision (9);
+	ss << r->scale_amplitude ()
+	   << r->envelope_active () << r->fade_in_active () << r->fade_out_active () << ';';
+	add_list_state (ss, r->envelope ());
+	add_list_state (ss, r->fade_in ());
+	add_list_state (ss, r->fade_out ());
+	add_list_state (ss, r->inverse_fade_in ());
+	add_list_state (ss, r->inverse_fade_out ());
+
+	/* FNV-1a */
+	uint64_t     hash = 14695981039346656037ULL;
+	string const str  = ss.str ();
+	for (string::const_iterator c = str.begin (); c != str.end (); ++c) {
+		hash = (hash ^ (uint8_t) *c) * 1099511628211ULL;
+	}
+
+	stringstream hs;
+	hs << hex << hash;
+	return hs.str ();
+}
+
+}
+
+/* ****************************************************************************/
+
+AnalysisService::Job::Job (Type t, vector<boost::shared_ptr<AudioSource> > const& sources, samplepos_t start, samplecnt_t length,
+                           float threshold, uint32_t mode, float sensitivity)
+	: _type (t)
+	, _start (start)
+	, _length (length)
+	, _read_region (false)
+	, _threshold (threshold)
+	, _sensitivity_mode (mode)
+	, _sensitivity (sensitivity)
+	, _loudness (0)
+	, _loudness_range (0)
+	, _cached (false)
+	, _state (Queued)
+{
+	stringstream ss;
+	ss << (int) _type << ':' << _start << ':' << _length;
+	if (_type == Transients) {
+		ss << ':' << _threshold << ':' << _sensitivity_mode << ':' << _sensitivity;
+	}
+
+	for (vector<boost::shared_ptr<AudioSource> >::const_iterator i = sources.begin (); i != sources.end (); ++i) {
+		_sources.push_back (*i);
+		/* a source that is still being written changes its length */
+		ss << ':' << (*i)->id ().to_s () << '@' << (*i)->readable_length_samples ();
+	}
+
+	_key = ss.str ();
+}
+
+AnalysisService::Job::Job (boost::shared_ptr<AudioRegion> region)
+	: _type (Loudness)
+	, _region (region)
+	, _start (region->start_sample ())
+	, _length (region->length_samples ())
+	, _read_region (true)
+	, _threshold (0)
+	, _sensitivity_mode (0)
+	, _sensitivity (0)
+	, _loudness (0)
+	, _loudness_range (0)
+	, _cached (false)
+	, _state (Queued)
+{
+	stringstream ss;
+	ss << (int) _type << ":region:" << _start << ':' << _length << ':' << region_state_key (region);
+
+	for (uint32_t n = 0; n < region->n_channels (); ++n) {
+		boost::shared_ptr<AudioSource> src (region->audio_source (n));
+		_sources.push_back (src);
+		ss << ':' << src->id ().to_s () << '@' << src->readable_length_samples ();
+	}
+
+	_key = ss.str ();
+}
+
+bool
+AnalysisService::Job::finished () const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	return _state == Done || _state == Failed;
+}
+
+bool
+AnalysisService::Job::failed () const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	return _state == Failed;
+}
+
+void
+AnalysisService::Job::wait () const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	while (_state == Queued || _state == Running) {
+		_cond.wait (_lock);
+	}
+}
+
+void
+AnalysisService::Job::cancel ()
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+		if (_state != Queued) {
+			return;
+		}
+		_state = Failed;
+		_cond.broadcast ();
+	}
+	Finished (); /* EMIT SIGNAL */
+}
+
+void
+AnalysisService::Job::finish (bool ok)
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+		_state = ok ? Done : Failed;
+		_cond.broadcast ();
+	}
+	Finished (); /* EMIT SIGNAL */
+}
+
+void
+AnalysisService::Job::run ()
+{
+	vector<boost::shared_ptr<AudioSource> > sources;
+
+	for (vector<boost::weak_ptr<AudioSource> >::const_iterator i = _sources.begin (); i != _sources.end (); ++i) {
+		boost::shared_ptr<AudioSource> s (i->lock ());
+		if (!s) {
+			/* source was removed meanwhile */
+			finish (false);
+			return;
+		}
+		sources.push_back (s);
+	}
+
+	if (sources.empty () || _length <= 0) {
+		finish (false);
+		return;
+	}
+
+	if (_read_region) {
+		/* same as the editor's region loudness analysis */
+		boost::shared_ptr<AudioRegion> region (_region.lock ());
+		if (!region) {
+			finish (false);
+			return;
+		}
+		AnalysisGraph ag (&region->session ());
+		ag.set_total_samples (_length);
+		ag.analyze_region (region.get (), false);
+
+		AnalysisResults const& ar (ag.results ());
+		if (ar.size () != 1 || !ar.begin ()->second->have_loudness) {
+			finish (false);
+			return;
+		}
+		_loudness       = ar.begin ()->second->integrated_loudness;
+		_loudness_range = ar.begin ()->second->loudness_range;
+
+		AnalysisService::store (*this);
+		finish (true);
+		return;
+	}
+
+	RangeReadable rr (sources, _start, _length);
+	float const   sr = sources.front ()->sample_rate ();
+
+	try {
+		switch (_type) {
+			case Loudness:
+				{
+					boost::scoped_ptr<EBUr128Analysis> a;
+					{
+						Glib::Threads::Mutex::Lock lm (plugin_lock);
+						a.reset (new EBUr128Analysis (sr));
+					}
+					if (a->run (&rr)) {
+						finish (false);
+						return;
+					}
+					_loudness       = a->loudness ();
+					_loudness_range = a->loudness_range ();
+				}
+				break;
+			case Transients:
+				{
+					boost::scoped_ptr<TransientDetector> td;
+					{
+						Glib::Threads::Mutex::Lock lm (plugin_lock);
+						td.reset (new TransientDetector (sr));
+					}
+					td->set_threshold (_threshold);
+					td->set_sensitivity (_sensitivity_mode, _sensitivity);
+
+					AnalysisFeatureList results;
+					if (td->run ("", &rr, 0, results)) {
+						finish (false);
+						return;
+					}
+					td->update_positions (&rr, 0, results);
+					_transients = results;
+				}
+				break;
+		}
+	} catch (...) {
+		error << string_compose (_("Analysis of %1 failed."), sources.front ()->name ()) << endmsg;
+		finish (false);
+		return;
+	}
+
+	AnalysisService::store (*this);
+	finish (true);
+}
+
+/* ****************************************************************************/
+
+void
+AnalysisService::start ()
+{
+	/* caller must hold _queue_lock */
+	if (_started) {
+		return;
+	}
+	_started = true;
+
+	for (uint32_t i = 0; i < n_workers (); ++i) {
+		pthread_t thread;
+		if (pthread_create_and_store ("Analysis", &thread, _thread_work, 0) == 0) {
+			_workers.push_back (thread);
+		}
+	}
+}
+
+void
+AnalysisService::cleanup ()
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_queue_lock);
+		_quit = true;
+		_queue_cond.broadcast ();
+	}
+
+	/* running jobs complete, queued jobs are left to flush () */
+	for (vector<pthread_t>::const_iterator i = _workers.begin (); i != _workers.end (); ++i) {
+		pthread_join (*i, 0);
+	}
+	_workers.clear ();
+
+	flush ();
+}
+
+uint32_t
+AnalysisService::n_workers ()
+{
+	uint32_t n_threads = Config->get_analysis_threads ();
+	if (n_threads == 0) {
+		n_threads = hardware_concurrency ();
+	}
+	return std::max<uint32_t> (1, n_threads);
+}
+
+void*
+AnalysisService::_thread_work (void*)
+{
+	SessionEvent::create_per_thread_pool ("AnalysisService", 64);
+	thread_work ();
+	return 0;
+}
+
+void
+AnalysisService::thread_work ()
+{
+	while (true) {
+		JobPtr job;
+		{
+			Glib::Threads::Mutex::Lock lm (_queue_lock);
+			while (_queue.empty () && !_quit) {
+				_queue_cond.wait (_queue_lock);
+			}
+			if (_quit) {
+				return;
+			}
+			job = _queue.front ();
+			_queue.pop_front ();
+		}
+
+		{
+			Glib::Threads::Mutex::Lock lm (job->_lock);
+			if (job->_state != Job::Queued) {
+				/* cancelled */
+				continue;
+			}
+			job->_state = Job::Running;
+		}
+
+		/* an identical job may have completed meanwhile */
+		if (job->_cached || lookup (*job, true)) {
+			job->finish (true);
+		} else {
+			job->run ();
+		}
+
+		bool idle;
+		{
+			Glib::Threads::Mutex::Lock lm (_queue_lock);
+			idle = _queue.empty ();
+		}
+		if (idle) {
+			/* write results once a batch of jobs is complete */
+			save_dirty ();
+		}
+	}
+}
+
+void
+AnalysisService::queue (JobPtr job)
+{
+	/* cached results are reported before any pending analysis.
+	 * Only check results in memory here, a worker loads cache-files.
+	 */
+	bool const cached = lookup (*job, false);
+
+	Glib::Threads::Mutex::Lock lm (_queue_lock);
+	start ();
+
+	if (_workers.empty ()) {
+		lm.release ();
+		job->_state = Job::Running;
+		if (cached || lookup (*job, true)) {
+			job->finish (true);
+		} else {
+			job->run ();
+			save_dirty ();
+		}
+		return;
+	}
+
+	if (cached) {
+		_queue.push_front (job);
+	} else {
+		_queue.push_back (job);
+	}
+	_queue_cond.signal ();
+}
+
+AnalysisService::JobPtr
+AnalysisService::analyze_loudness (vector<boost::shared_ptr<AudioSource> > const& sources, samplepos_t start, samplecnt_t length)
+{
+	JobPtr job (new Job (Loudness, sources, start, length));
+	queue (job);
+	return job;
+}
+
+AnalysisService::JobPtr
+AnalysisService::analyze_region_loudness (boost::shared_ptr<AudioRegion> region)
+{
+	JobPtr job (new Job (region));
+	queue (job);
+	return job;
+}
+
+AnalysisService::JobPtr
+AnalysisService::analyze_transients (boost::shared_ptr<AudioSource> source, samplepos_t start, samplecnt_t length,
+                                     float threshold, uint32_t mode, float sensitivity)
+{
+	vector<boost::shared_ptr<AudioSource> > sources;
+	sources.push_back (source);
+
+	JobPtr job (new Job (Transients, sources, start, length, threshold, mode, sensitivity));
+	queue (job);
+	return job;
+}
+
+void
+AnalysisService::wait (list<JobPtr> const& jobs)
+{
+	for (list<JobPtr>::const_iterator i = jobs.begin (); i != jobs.end (); ++i) {
+		(*i)->wait ();
+	}
+}
+
+void
+AnalysisService::flush ()
+{
+	list<JobPtr> queued;
+	{
+		Glib::Threads::Mutex::Lock lm (_queue_lock);
+		queued.swap (_queue);
+	}
+	for (list<JobPtr>::const_iterator i = queued.begin (); i != queued.end (); ++i) {
+		(*i)->cancel ();
+	}
+
+	save_dirty ();
+
+	Glib::Threads::Mutex::Lock lm (_cache_lock);
+	_cache.clear ();
+}
+
+/* ****************************************************************************/
+
+string
+AnalysisService::cache_path (boost::shared_ptr<AudioSource> src)
+{
+	string path = src->peak_path ();
+	if (path.empty ()) {
+		return path;
+	}
+	string const suffix (peakfile_suffix);
+	if (path.size () > suffix.size () && path.compare (path.size () - suffix.size (), suffix.size (), suffix) == 0) {
+		path.erase (path.size () - suffix.size ());
+	}
+	return path + analysisfile_suffix;
+}
+
+/** @param load read the cache-file if it is not yet known, otherwise
+ * only results in memory are considered.
+ */
+bool
+AnalysisService::lookup (Job& job, bool load)
+{
+	boost::shared_ptr<AudioSource> src (job._sources.front ().lock ());
+	if (!src) {
+		return false;
+	}
+
+	string const path = cache_path (src);
+	if (path.empty ()) {
+		return false;
+	}
+
+	if (load) {
+		load_cache (path, src);
+	}
+
+	Glib::Threads::Mutex::Lock lm (_cache_lock);
+	CacheFiles::const_iterator f = _cache.find (path);
+	if (f == _cache.end ()) {
+		return false;
+	}
+
+	CacheMap::const_iterator i = f->second.find (job._key);
+	if (i == f->second.end ()) {
+		return false;
+	}
+
+	job._loudness       = i->second.loudness;
+	job._loudness_range = i->second.loudness_range;
+	job._transients     = i->second.transients;
+	job._cached         = true;
+	return true;
+}
+
+void
+AnalysisService::store (Job const& job)
+{
+	boost::shared_ptr<AudioSource> src (job._sources.front ().lock ());
+	if (!src) {
+		return;
+	}
+
+	string const path = cache_path (src);
+	if (path.empty ()) {
+		return;
+	}
+
+	load_cache (path, src);
+
+	Glib::Threads::Mutex::Lock lm (_cache_lock);
+	CacheFiles::iterator f = _cache.find (path);
+	if (f == _cache.end ()) {
+		/* flushed meanwhile, saving now would drop other results of the file */
+		return;
+	}
+
+	CacheEntry& e (f->second[job._key]);
+
+	e.loudness       = job._loudness;
+	e.loudness_range = job._loudness_range;
+	e.transients     = job._transients;
+
+	_dirty.insert (path);
+}
+
+void
+AnalysisService::save_dirty ()
+{
+	/* serialize writers, but do not hold _cache_lock during file I/O */
+	Glib::Threads::Mutex::Lock sl (_save_lock);
+
+	CacheFiles dirty;
+	{
+		Glib::Threads::Mutex::Lock lm (_cache_lock);
+		for (set<string>::const_iterator i = _dirty.begin (); i != _dirty.end (); ++i) {
+			CacheFiles::const_iterator c = _cache.find (*i);
+			if (c != _cache.end ()) {
+				dirty.insert (*c);
+			}
+		}
+		_dirty.clear ();
+	}
+
+	for (CacheFiles::const_iterator i = dirty.begin (); i != dirty.end (); ++i) {
+		save_cache (i->first, i->second);
+	}
+}
+
+void
+AnalysisService::load_cache (string const& path, boost::shared_ptr<AudioSource> src)
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_cache_lock);
+		if (_cache.find (path) != _cache.end ()) {
+			return;
+		}
+	}
+
+	/* file I/O without holding _cache_lock */
+	CacheMap cache;
+	read_cache (path, src, cache);
+
+	Glib::Threads::Mutex::Lock lm (_cache_lock);
+	/* no-op if another worker was faster */
+	_cache.insert (make_pair (path, cache));
+}
+
+void
+AnalysisService::read_cache (string const& path, boost::shared_ptr<AudioSource> src, CacheMap& cache)
+{
+	GStatBuf cache_stat;
+	if (g_stat (path.c_str (), &cache_stat) != 0) {
+		return;
+	}
+
+	/* ignore results if the audio file was modified after the analysis */
+	boost::shared_ptr<AudioFileSource> afs = boost::dynamic_pointer_cast<AudioFileSource> (src);
+	GStatBuf audio_stat;
+	if (afs && g_stat (afs->path ().c_str (), &audio_stat) == 0 && audio_stat.st_mtime > cache_stat.st_mtime) {
+		return;
+	}
+
+	XMLTree tree;
+	if (!tree.read (path) || !tree.root () || tree.root ()->name () != X_("Analysis")) {
+		return;
+	}
+
+	XMLNodeList const& children (tree.root ()->children ());
+	for (XMLNodeConstIterator n = children.begin (); n != children.end (); ++n) {
+		string key;
+		if ((*n)->name () != X_("Result") || !(*n)->get_property (X_("key"), key)) {
+			continue;
+		}
+		CacheEntry& e (cache[key]);
+		(*n)->get_property (X_("loudness"), e.loudness);
+		(*n)->get_property (X_("loudness-range"), e.loudness_range);
+
+		string transients;
+		if ((*n)->get_property (X_("transients"), transients)) {
+			stringstream ss (transients);
+			samplepos_t  pos;
+			while (ss >> pos) {
+				e.transients.push_back (pos);
+			}
+		}
+	}
+}
+
+void
+AnalysisService::save_cache (string const& path, CacheMap const& cache)
+{
+	XMLNode* root = new XMLNode (X_("Analysis"));
+
+	for (CacheMap::const_iterator i = cache.begin (); i != cache.end (); ++i) {
+		XMLNode* child = root->add_child (X_("Result"));
+		child->set_property (X_("key"), i->first);
+		child->set_property (X_("loudness"), i->second.loudness);
+		child->set_property (X_("loudness-range"), i->second.loudness_range);
+
+		if (!i->second.transients.empty ()) {
+			stringstream ss;
+			for (AnalysisFeatureList::const_iterator t = i->second.transients.begin (); t != i->second.transients.end (); ++t) {
+				ss << *t << ' ';
+			}
+			child->set_property (X_("transients"), ss.str ());
+		}
+	}
+
+	XMLTree tree;
+	tree.set_root (root);
+	if (!tree.write (path)) {
+		warning << string_compose (_("Could not save analysis results to %1"), path) << endmsg;
+	}
+}
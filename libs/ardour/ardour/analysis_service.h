@@ -0,0 +1,195 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_analysis_service_h__
+#define __ardour_analysis_service_h__
+
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+
+#include <glibmm/threads.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include "pbd/signals.h"
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+class AudioRegion;
+class AudioSource;
+
+/** Background analysis of audio sources, using a pool of worker threads.
+ *
+ * Results are cached per source, range and analysis parameters, and
+ * saved next to the source's peak-file, so that unchanged audio is not
+ * analysed again.
+ *
+ * Worker threads are started when the first job is queued. They also
+ * read and write the cache-files, the calling thread only checks
+ * results that are already in memory.
+ */
+class LIBARDOUR_API AnalysisService
+{
+public:
+	enum Type {
+		Loudness,   ///< EBU-R128 integrated loudness and loudness-range
+		Transients  ///< transient (percussion onset) positions
+	};
+
+	class LIBARDOUR_API Job
+	{
+	public:
+		Type type () const { return _type; }
+
+		/** @return true when the analysis completed, failed or was cancelled */
+		bool finished () const;
+		/** @return true if the analysis failed or was cancelled */
+		bool failed () const;
+		/** @return true if the result was retrieved from the cache */
+		bool cached () const { return _cached; }
+
+		/** block until the job is finished */
+		void wait () const;
+		/** don't start this job, if it was not yet started */
+		void cancel ();
+
+		/* Results, valid when finished() and !failed() */
+
+		float loudness () const { return _loudness; }
+		float loudness_range () const { return _loudness_range; }
+
+		/** transient positions, relative to the start of the analysed range */
+		AnalysisFeatureList const& transients () const { return _transients; }
+
+		/** Emitted from a worker thread when the job is finished, also
+		 * for cached results. The job may be finished before a handler
+		 * is connected, so test finished() after connecting.
+		 */
+		PBD::Signal0<void> Finished;
+
+	private:
+		friend class AnalysisService;
+
+		Job (Type, std::vector<boost::shared_ptr<AudioSource> > const&, samplepos_t, samplecnt_t,
+		     float threshold = 0, uint32_t mode = 0, float sensitivity = 0);
+		Job (boost::shared_ptr<AudioRegion>);
+
+		void run ();
+		void finish (bool ok);
+
+		Type                                         _type;
+		std::string                                  _key;
+		std::vector<boost::weak_ptr<AudioSource> >   _sources;
+		boost::weak_ptr<AudioRegion>                 _region;
+		samplepos_t                                  _start;
+		samplecnt_t                                  _length;
+		bool                                         _read_region;
+
+		/* transient detector parameters */
+		float                                        _threshold;
+		uint32_t                                     _sensitivity_mode;
+		float                                        _sensitivity;
+
+		float                                        _loudness;
+		float                                        _loudness_range;
+		AnalysisFeatureList                          _transients;
+		bool                                         _cached;
+
+		enum State { Queued, Running, Done, Failed };
+		State                                        _state;
+		mutable Glib::Threads::Mutex                 _lock;
+		mutable Glib::Threads::Cond                  _cond;
+	};
+
+	typedef boost::shared_ptr<Job> JobPtr;
+
+	/** cancel queued jobs, stop the worker threads and save results */
+	static void cleanup ();
+
+	/** Queue EBU-R128 analysis of the given sources (one per channel) */
+	static JobPtr analyze_loudness (std::vector<boost::shared_ptr<AudioSource> > const&, samplepos_t start, samplecnt_t length);
+	/** Queue EBU-R128 analysis of all channels of a region, including
+	 * region gain, envelope and fades (like AnalysisGraph::analyze_region)
+	 */
+	static JobPtr analyze_region_loudness (boost::shared_ptr<AudioRegion>);
+
+	/** Queue transient detection of a single source.
+	 * @param threshold detection threshold, gain coefficient
+	 * @param mode sensitivity mode, see TransientDetector::set_sensitivity
+	 * @param sensitivity sensitivity in the given mode
+	 */
+	static JobPtr analyze_transients (boost::shared_ptr<AudioSource>, samplepos_t start, samplecnt_t length,
+	                                  float threshold, uint32_t mode, float sensitivity);
+
+	/** block until all given jobs are finished */
+	static void wait (std::list<JobPtr> const&);
+
+	/** remove all queued jobs, and clear the in-memory cache */
+	static void flush ();
+
+	/** @return the number of worker threads used */
+	static uint32_t n_workers ();
+
+private:
+	static void start ();
+	static void queue (JobPtr);
+	static void* _thread_work (void*);
+	static void thread_work ();
+
+	static bool lookup (Job&, bool load);
+	static void store (Job const&);
+	static void save_dirty ();
+
+	struct CacheEntry {
+		CacheEntry () : loudness (0), loudness_range (0) {}
+		float               loudness;
+		float               loudness_range;
+		AnalysisFeatureList transients;
+	};
+
+	/* job key -> result, for each cache-file */
+	typedef std::map<std::string, CacheEntry> CacheMap;
+	typedef std::map<std::string, CacheMap>   CacheFiles;
+
+	static std::string cache_path (boost::shared_ptr<AudioSource>);
+	static void load_cache (std::string const& path, boost::shared_ptr<AudioSource>);
+	static void read_cache (std::string const& path, boost::shared_ptr<AudioSource>, CacheMap&);
+	static void save_cache (std::string const& path, CacheMap const&);
+
+	static std::vector<pthread_t> _workers;
+	static bool                   _started;
+	static bool                   _quit;
+	static std::list<JobPtr>      _queue;
+	static Glib::Threads::Mutex   _queue_lock;
+	static Glib::Threads::Cond    _queue_cond;
+
+	static CacheFiles             _cache;
+	static std::set<std::string>  _dirty; ///< cache-files with unsaved results
+	static Glib::Threads::Mutex   _cache_lock;
+	static Glib::Threads::Mutex   _save_lock;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_analysis_service_h__ */
@@ -61,6 +61,10 @@ private:
 	ArdourZita::VMResampler _src;
 	Sample*                 _data;
 	bool                    _buf_valid;
+
+	/** resampled data of the connected port, set by PortManager for the current cycle */
+	Sample*                 _shared_input;
+	bool                    _src_idle; ///< _src was not used in the last cycle
 };
 
 } // namespace ARDOUR
@@ -79,6 +79,8 @@ class LIBARDOUR_API AudioSource : virtual public Source, public ARDOUR::AudioRea
 	int rename_peakfile (std::string newpath);
 	void touch_peakfile ();
 
+	std::string const& peak_path () const { return _peakpath; }
+
 	static void set_build_missing_peakfiles (bool yn) {
 		_build_missing_peakfiles = yn;
 	}
@@ -54,6 +54,12 @@ public:
 	void restart ();
 	void run (BufferSet&, ChanMapping const&, ChanMapping const&, pframes_t, samplecnt_t);
 
+	/** Process late partitions of all instances using a shared pool of
+	 * worker threads (default), or use dedicated threads per instance.
+	 * Takes effect with the next restart().
+	 */
+	static void set_shared_workers (bool);
+
 protected:
 	ArdourZita::Convproc _convproc;
 
@@ -113,6 +119,8 @@ private:
 	std::vector<ImpData> _impdata;
 	uint32_t             _n_inputs;
 	uint32_t             _n_outputs;
+
+	static bool _shared_workers;
 };
 
 class LIBARDOUR_API Convolver : public Convolution
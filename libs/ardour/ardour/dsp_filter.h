@@ -21,6 +21,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
+#include <vector>
 #include <glib.h>
 #include <glibmm.h>
 #include <fftw3.h>
@@ -128,6 +129,9 @@ namespace ARDOUR { namespace DSP {
 				return g_atomic_int_get (&(((int32_t*)_data)[off]));
 			}
 
+			/** @returns number of float or integer elements */
+			size_t size () const { return _size; }
+
 		private:
 			void* _data;
 			size_t _size;
@@ -261,6 +265,76 @@ namespace ARDOUR { namespace DSP {
 			float  _z1, _z2;
 			double _a1, _a2;
 			double _b0, _b1, _b2;
+
+			friend class BiquadCascade;
+	};
+
+	/** Cascade of Biquad Filters, applied to multiple channels.
+	 *
+	 * All channels share the same filter coefficients. Channels are
+	 * processed four at a time using SIMD instructions (SSE or NEON),
+	 * remaining channels are processed one by one.
+	 */
+	class LIBARDOUR_API BiquadCascade {
+		public:
+			/** Instantiate Biquad Filter Cascade
+			 *
+			 * @param samplerate Samplerate
+			 * @param n_channels number of channels to process
+			 * @param n_stages number of filters in series
+			 */
+			BiquadCascade (double samplerate, uint32_t n_channels, uint32_t n_stages);
+
+			/** process audio data, in place
+			 *
+			 * @param data array of n_channels () pointers to audio-data
+			 * @param n_samples number of samples to process
+			 */
+			void run (float* const* data, const uint32_t n_samples);
+
+			/** process audio data of a BufferSet, in place
+			 *
+			 * @param bufs buffers to process
+			 * @param map mapping of filter channels to audio buffers, unmapped channels are skipped
+			 * @param n_samples number of samples to process
+			 * @param offset sample offset in buffers
+			 */
+			void run_map (BufferSet* bufs, const ChanMapping& map, const uint32_t n_samples, const uint32_t offset = 0);
+
+			/** setup filter stage, compute coefficients
+			 *
+			 * @param stage filter index 0 .. n_stages - 1, other values are ignored
+			 * @param t filter type (LowPass, HighPass, etc)
+			 * @param freq filter frequency
+			 * @param Q filter quality
+			 * @param gain filter gain
+			 */
+			void compute (uint32_t stage, Biquad::Type t, double freq, double Q, double gain);
+
+			/** setup filter stage, set coefficients directly */
+			void configure (uint32_t stage, double a1, double a2, double b0, double b1, double b2);
+
+			/** filter transfer function of the complete cascade
+			 * @param freq frequency
+			 * @return gain at given frequency in dB (clamped to -120..+120)
+			 */
+			float dB_at_freq (float freq) const;
+
+			/** reset filter state of all channels */
+			void reset ();
+
+			uint32_t n_channels () const { return _n_channels; }
+			uint32_t n_stages () const { return _stages.size (); }
+
+		private:
+			void run_4 (float* const* data, float* state, const uint32_t n_samples);
+			void run_1 (float* data, float* state, const uint32_t lane, const uint32_t n_samples);
+
+			uint32_t            _n_channels;
+			std::vector<Biquad> _stages; ///< filter coefficients, used for computation and the transfer function
+			std::vector<float>  _coeff;  ///< a1[4], a2[4], b0[4], b1[4], b2[4] of each stage
+			std::vector<float>  _state;  ///< z1[4], z2[4] for each stage of each group of 4 channels
+			std::vector<float*> _ptrs;   ///< used by run_map
 	};
 
 	class LIBARDOUR_API FFTSpectrum {
@@ -291,6 +365,14 @@ namespace ARDOUR { namespace DSP {
 				return bin * _fft_freq_per_bin;
 			}
 
+			uint32_t window_size () const { return _fft_window_size; }
+
+			/** create the FFT plan for the given window size, if it does
+			 * not exist yet. Plans are shared by all FFTSpectrum and
+			 * FFTSpectrumBatch instances and kept until exit.
+			 */
+			static void preplan (uint32_t window_size);
+
 		private:
 			static Glib::Threads::Mutex fft_planner_lock;
 			float* hann_window;
@@ -307,6 +389,65 @@ namespace ARDOUR { namespace DSP {
 			float* _fft_power;
 
 			fftwf_plan _fftplan;
+
+			friend class FFTSpectrumBatch;
+			static fftwf_plan shared_plan (uint32_t window_size);
+	};
+
+	/** Spectral analysis of multiple channels.
+	 *
+	 * This uses FFT plans that are shared by all analysis objects of the
+	 * same window size (see FFTSpectrum::preplan). Only the first
+	 * instance of a given size needs to plan, others do not block on
+	 * the planner.
+	 */
+	class LIBARDOUR_API FFTSpectrumBatch {
+		public:
+			FFTSpectrumBatch (uint32_t window_size, double rate, uint32_t n_channels);
+			~FFTSpectrumBatch ();
+
+			/** set data to be analyzed and pre-process with hanning window
+			 * n_samples + offset must not be larger than the configured window_size,
+			 * excess samples are ignored.
+			 *
+			 * @param channel channel to set 0 .. n_channels - 1, other values are ignored
+			 * @param data raw audio data
+			 * @param n_samples number of samples to write to analysis buffer
+			 * @param offset destination offset
+			 */
+			void set_data_hann (const uint32_t channel, float const * const data, const uint32_t n_samples, const uint32_t offset = 0);
+
+			/** process current data of all channels */
+			void execute ();
+
+			/** query
+			 * @param channel the channel 0 .. n_channels - 1
+			 * @param bin the frequency bin 0 .. window_size / 2
+			 * @param norm gain factor (set equal to \p bin for 1/f normalization)
+			 * @return signal power at given bin (in dBFS), -inf if out of range
+			 */
+			float power_at_bin (const uint32_t channel, const uint32_t bin, const float norm = 1.f) const;
+
+			float freq_at_bin (const uint32_t bin) const {
+				return bin * _fft_freq_per_bin;
+			}
+
+			uint32_t window_size () const { return _fft_window_size; }
+			uint32_t n_channels () const { return _n_channels; }
+
+		private:
+			uint32_t _fft_window_size;
+			uint32_t _fft_data_size;
+			uint32_t _stride;
+			uint32_t _n_channels;
+			double   _fft_freq_per_bin;
+
+			float* _hann_window;
+			float* _fft_data_in;
+			float* _fft_data_out;
+			float* _fft_power;
+
+			fftwf_plan _fftplan;
 	};
 
 	class LIBARDOUR_API Generator {
@@ -337,5 +478,83 @@ namespace ARDOUR { namespace DSP {
 
 	};
 
+	/** Bounds-checked view of float[] sample data
+	 *
+	 * A SampleView references a contiguous range of samples of an
+	 * AudioBuffer or DspShm. No data is copied. This allows lua scripts to
+	 * process a complete buffer with a single call to the (CPU specific,
+	 * vectorized) C/C++ implementation instead of iterating over
+	 * individual samples.
+	 *
+	 * All operations are limited to the view's range. Operations that
+	 * involve two views use the smaller of both sizes.
+	 *
+	 * A view does not own the data and must not be used after the
+	 * underlying buffer is re-allocated, e.g. only use views of an
+	 * AudioBuffer during the process-callback that created it.
+	 */
+	class LIBARDOUR_API SampleView {
+		public:
+			SampleView ();
+			/** C++ only, the size cannot be verified.
+			 * Lua scripts use the audio_buffer() and shm() factories */
+			SampleView (float* data, uint32_t n_samples);
+
+			/** create a view of an AudioBuffer
+			 * @param buf the buffer to access
+			 * @param offset first sample
+			 * @param n_samples number of samples, clamped to the buffer's capacity
+			 */
+			static SampleView audio_buffer (AudioBuffer& buf, uint32_t offset, uint32_t n_samples);
+			/** create a view of a DspShm memory area
+			 * @param shm shared memory
+			 * @param offset first element
+			 * @param n_samples number of elements, clamped to the allocated size
+			 */
+			static SampleView shm (DspShm& shm, uint32_t offset, uint32_t n_samples);
+
+			bool valid () const { return _data != 0; }
+			uint32_t size () const { return _size; }
+
+			/** C++ only, a raw pointer would bypass bounds-checks in Lua.
+			 * @returns pointer to given sample, or NULL if out of bounds */
+			float* data (uint32_t off) const;
+			/** @returns a view of a sub-range, clamped to this view */
+			SampleView sub (uint32_t offset, uint32_t n_samples) const;
+
+			/** bounds-checked read, returns 0 if out of bounds */
+			float get (uint32_t i) const { return i < _size ? _data[i] : 0.f; }
+			/** bounds-checked write, out of bounds access is ignored */
+			void set (uint32_t i, float val) { if (i < _size) { _data[i] = val; } }
+
+			void fill (float val);
+			void clear ();
+			void apply_gain (float gain);
+			/** multiply every sample with the corresponding sample of \p other */
+			void mmult (SampleView const& other);
+			void copy_from (SampleView const& src);
+			void mix_from (SampleView const& src, float gain);
+
+			/** @returns the absolute peak, or \p current if that is larger */
+			float compute_peak (float current) const;
+			void peaks (float& min, float& max) const;
+			/** @returns the rms of the samples in this view */
+			float rms () const;
+
+			/** run biquad filter in-place */
+			void biquad (Biquad& bq);
+			/** pre-process view with hann window and write to the FFT's analysis buffer
+			 * @param fft analyzer, the view is clamped to its window-size
+			 * @param offset destination offset in the analysis buffer
+			 */
+			void fft_hann (FFTSpectrum& fft, uint32_t offset) const;
+			/** fill view using a noise generator */
+			void generate (Generator& gen);
+
+		private:
+			float*   _data;
+			uint32_t _size;
+	};
+
 } } /* namespace */
 #endif
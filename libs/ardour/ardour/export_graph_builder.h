@@ -28,7 +28,8 @@
 #include "audiographer/utils/identity_vertex.h"
 
 #include <boost/ptr_container/ptr_list.hpp>
-#include <glibmm/threadpool.h>
+#include <boost/scoped_ptr.hpp>
+#include <glibmm/threads.h>
 
 namespace AudioGrapher {
 	class SampleRateConverter;
@@ -45,7 +46,9 @@ namespace AudioGrapher {
 	template <typename T> class CmdPipeWriter;
 	template <typename T> class SilenceTrimmer;
 	template <typename T> class TmpFile;
+	class TmpFileBudget;
 	template <typename T> class Threader;
+	class ThreaderPool;
 	template <typename T> class AllocatingProcessContext;
 }
 
@@ -282,12 +285,15 @@ class LIBARDOUR_API ExportGraphBuilder
 
 	std::list<Intermediate *> intermediates;
 
+	// RAM shared by all in-memory intermediates of the current export
+	boost::shared_ptr<AudioGrapher::TmpFileBudget> tmp_budget;
+
 	AnalysisMap analysis_map;
 
 	bool        _realtime;
 	samplecnt_t _master_align;
 
-	Glib::ThreadPool     thread_pool;
+	boost::scoped_ptr<AudioGrapher::ThreaderPool> thread_pool;
 	Glib::Threads::Mutex engine_request_lock;
 };
 
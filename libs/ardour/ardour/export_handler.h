@@ -30,6 +30,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include "pbd/gstdio_compat.h"
+#include "pbd/microseconds.h"
 
 #include "ardour/export_pointers.h"
 #include "ardour/session.h"
@@ -159,6 +160,7 @@ class LIBARDOUR_API ExportHandler : public ExportElementFactory, public sigc::tr
 
 	PBD::ScopedConnection process_connection;
 	samplepos_t           process_position;
+	PBD::microseconds_t   pass_start;
 
 	/* CD Marker stuff */
 
@@ -29,6 +29,7 @@
 #include "ardour/export_analysis.h"
 #include "ardour/types.h"
 
+#include "pbd/microseconds.h"
 #include "pbd/signals.h"
 
 namespace ARDOUR
@@ -83,6 +84,11 @@ class LIBARDOUR_API ExportStatus {
 	volatile uint32_t       total_postprocessing_cycles;
 	volatile uint32_t       current_postprocessing_cycle;
 
+	/* Timing info, accumulated for all timespans [usec] */
+
+	volatile PBD::microseconds_t export_time;      ///< processing session output, incl. the 1st pass of normalization
+	volatile PBD::microseconds_t postprocess_time; ///< normalizing and encoding, reading back the intermediate
+
 	AnalysisResults         result_map;
 
   private:
@@ -30,6 +30,7 @@ namespace ARDOUR {
 	LIBARDOUR_API extern const char* const statefile_suffix;
 	LIBARDOUR_API extern const char* const pending_suffix;
 	LIBARDOUR_API extern const char* const peakfile_suffix;
+	LIBARDOUR_API extern const char* const analysisfile_suffix;
 	LIBARDOUR_API extern const char* const backup_suffix;
 	LIBARDOUR_API extern const char* const temp_suffix;
 	LIBARDOUR_API extern const char* const history_suffix;
@@ -256,6 +256,19 @@ namespace ARDOUR { namespace LuaAPI {
 	 */
 	int timecode_to_sample_lua (lua_State *L);
 
+	/**
+	 * Iterate over the events of a MidiBuffer without copying them
+	 * into a lua table.
+	 *
+	 * @code
+	 * for time, size, b0, b1, b2 in midi_buffer:events () do ... end
+	 * @endcode
+	 *
+	 * The iterator yields the event's time, size followed by all bytes
+	 * of the event. The buffer must not be modified while iterating.
+	 */
+	int midi_buffer_events (lua_State *L);
+
 	/**
 	 * Delay execution until next prcess cycle starts.
 	 * @param n_cycles process-cycles to wait for.
@@ -37,7 +37,9 @@
 #  include "pbd/reallocpool.h"
 #endif
 
+#include "pbd/g_atomic_compat.h"
 #include "pbd/stateful.h"
+#include "pbd/timing.h"
 
 #include "ardour/types.h"
 #include "ardour/plugin.h"
@@ -129,6 +131,20 @@ public:
 	DSP::DspShm* instance_shm () { return &lshm; }
 	LuaTableRef* instance_ref () { return &lref; }
 
+	/* runtime statistics of the Lua DSP function and the garbage
+	 * collector, per process cycle. see also PluginInsert::get_stats
+	 */
+	bool get_dsp_stats (PBD::microseconds_t& min, PBD::microseconds_t& max, double& avg, double& dev) const;
+	bool get_gc_stats (PBD::microseconds_t& min, PBD::microseconds_t& max, double& avg, double& dev) const;
+	void clear_stats ();
+
+	/** bytes allocated by the script during the most recent cycle */
+	size_t alloc_bytes_per_cycle () const { return g_atomic_int_get (&_cycle_alloc_bytes); }
+	/** peak bytes allocated by the script during a single cycle */
+	size_t max_alloc_bytes_per_cycle () const { return g_atomic_int_get (&_max_cycle_alloc_bytes); }
+	/** size of the pre-allocated memory arena */
+	size_t mempool_size () const { return _mempool_size; }
+
 private:
 	samplecnt_t plugin_latency() const { return _signal_latency; }
 	void find_presets ();
@@ -143,6 +159,11 @@ protected:
 	const std::string& origin() const { return _origin; }
 
 private:
+	static void* lalloc (void* ud, void* ptr, size_t osize, size_t nsize);
+
+	/* these need to be initialized before lua_newstate () is called */
+	size_t _mempool_size;
+	size_t _alloc_bytes;
 #ifdef USE_TLSF
 	PBD::TLSF _mempool;
 #else
@@ -198,12 +219,11 @@ private:
 	bool _has_midi_input;
 	bool _has_midi_output;
 
-
-#ifdef WITH_LUAPROC_STATS
-	int64_t _stats_avg[2];
-	int64_t _stats_max[2];
-	int64_t _stats_cnt;
-#endif
+	PBD::TimingStats _dsp_timing;
+	PBD::TimingStats _gc_timing;
+	GATOMIC_QUAL gint _stat_reset;
+	GATOMIC_QUAL gint _cycle_alloc_bytes;
+	GATOMIC_QUAL gint _max_cycle_alloc_bytes;
 };
 
 class LIBARDOUR_API LuaPluginInfo : public PluginInfo
@@ -83,6 +83,12 @@ public:
 
 	float meter_level (uint32_t n, MeterType type);
 
+	/** Incremented by the process thread whenever a meter-level changed.
+	 *  This allows the GUI to cheaply skip meters that have settled
+	 *  (silence, fully decayed) without querying each channel.
+	 */
+	guint level_serial () const { return (guint) g_atomic_int_get (&_level_serial); }
+
 	void      set_meter_type (MeterType t);
 	MeterType meter_type () const { return _meter_type; }
 
@@ -102,6 +108,7 @@ private:
 
 	GATOMIC_QUAL gint _reset_dpm;
 	GATOMIC_QUAL gint _reset_max;
+	GATOMIC_QUAL gint _level_serial;
 
 	uint32_t           _bufcnt;
 	std::vector<float> _peak_buffer;     // internal, integrate
@@ -177,6 +177,8 @@ protected:
 	static const uint32_t _resampler_quality; /* also latency of the resampler */
 
 private:
+	friend class PortManager; // change_connections (), reconnect_ports ()
+
 	std::string _name;  ///< port short name
 	PortFlags   _flags; ///< flags
 	bool        _last_monitor;
@@ -221,12 +221,17 @@ protected:
 
 	typedef std::map<std::string, BackendPortPtr>    PortMap;   // fast lookup in _ports
 	typedef std::set<BackendPortPtr, SortByPortName> PortIndex; // fast lookup in _ports
+	typedef std::set<BackendPortPtr>                 PortSet;   // lookup by pointer
 	SerializedRCUManager<PortMap>                  _portmap;
 	SerializedRCUManager<PortIndex>                _ports;
+	SerializedRCUManager<PortSet>                  _portset;
 
+	/* called from the process thread (get_buffer), so this must not
+	 * use the port's name, which may be modified concurrently.
+	 */
 	bool valid_port (BackendPortHandle port) const {
-		boost::shared_ptr<PortIndex> p = _ports.reader ();
-		return std::find (p->begin (), p->end (), port) != p->end ();
+		boost::shared_ptr<PortSet> p = _portset.reader ();
+		return p->find (port) != p->end ();
 	}
 
 	BackendPortPtr find_port (const std::string& port_name) const {
@@ -28,12 +28,15 @@
 #include <stdint.h>
 
 #include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
 
 #include "pbd/natsort.h"
 #include "pbd/rcu.h"
 #include "pbd/ringbuffer.h"
 #include "pbd/g_atomic_compat.h"
 
+#include "zita-resampler/vmresampler.h"
+
 #include "ardour/chan_count.h"
 #include "ardour/midiport_manager.h"
 #include "ardour/monitor_port.h"
@@ -43,10 +46,12 @@ namespace ARDOUR {
 
 class PortEngine;
 class AudioBackend;
+class AudioPort;
 class Session;
 
 class CircularSampleBuffer;
 class CircularEventBuffer;
+class RTTaskList;
 
 class LIBARDOUR_API PortManager
 {
@@ -145,6 +150,32 @@ public:
 	bool physically_connected (const std::string&);
 	int  get_connections (const std::string&, std::vector<std::string>&);
 
+	struct ConnectionChange {
+		ConnectionChange (std::string const& s, std::string const& d, bool c = true)
+			: source (s)
+			, destination (d)
+			, connect (c)
+			, result (0)
+		{}
+		std::string source;
+		std::string destination;
+		bool        connect; ///< false: disconnect
+		int         result;  ///< set by change_connections ()
+	};
+
+	typedef std::vector<ConnectionChange> ConnectionChanges;
+
+	/** Connect or disconnect many ports at once.
+	 *
+	 * Port names are resolved once, using a single snapshot of our ports.
+	 * A change that is requested more than once (e.g. from both ends of a
+	 * connection) is only passed to the backend once.
+	 *
+	 * @return number of changes that failed. The result of each change
+	 * is the same as connect () or disconnect () would return.
+	 */
+	int change_connections (ConnectionChanges&);
+
 	/* Naming */
 
 	boost::shared_ptr<Port> get_port_by_name (const std::string&);
@@ -301,9 +332,44 @@ protected:
 	void filter_midi_ports (std::vector<std::string>&, MidiPortFlags, MidiPortFlags);
 
 	void set_port_buffer_sizes (pframes_t);
+	/** to be called when Port::resampler_quality () changed, so that
+	 * the shared input resamplers match the latency of AudioPort's.
+	 */
+	void resampler_quality_changed ();
 
 private:
 	void run_input_meters (pframes_t, samplecnt_t);
+	static void run_input_meters_task (void*, pframes_t);
+
+	/* varispeed resampling of external ports that are connected to
+	 * more than one of our input ports. Those are resampled once per
+	 * cycle, rather than by each AudioPort.
+	 */
+	struct InputResampler {
+		InputResampler ();
+		~InputResampler ();
+
+		void setup (uint32_t quality);
+		void set_buffer_size (pframes_t);
+		void run (pframes_t);
+
+		ArdourZita::VMResampler src;
+		uint32_t                quality;
+		Sample*                 data;
+		Sample*                 input; ///< source-port buffer of the current cycle
+	};
+
+	struct ResampledInput {
+		PortEngine::PortPtr                      source;
+		boost::shared_ptr<InputResampler>        resampler;
+		std::vector<boost::weak_ptr<AudioPort> > readers;
+	};
+
+	typedef std::vector<ResampledInput> ResampledInputs;
+
+	void update_resampled_inputs ();
+	void resample_inputs (pframes_t, boost::shared_ptr<RTTaskList>);
+	static void resample_input_task (void*, pframes_t);
 	void set_pretty_names (std::vector<std::string> const&, DataType, bool);
 	void fill_midi_port_info_locked ();
 	void load_port_info ();
@@ -377,6 +443,11 @@ private:
 	SerializedRCUManager<AudioInputPorts> _audio_input_ports;
 	SerializedRCUManager<MIDIInputPorts>  _midi_input_ports;
 	GATOMIC_QUAL gint                     _reset_meters;
+	samplecnt_t                           _meter_rate; ///< nominal rate for run_input_meters_task
+
+	SerializedRCUManager<ResampledInputs> _resampled_inputs;
+	boost::shared_ptr<ResampledInputs>    _cycle_resampled_inputs;
+	GATOMIC_QUAL gint                     _resampled_inputs_dirty;
 };
 
 } // namespace ARDOUR
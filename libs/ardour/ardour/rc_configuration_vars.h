@@ -95,7 +95,9 @@ CONFIG_VARIABLE (float, audio_capture_buffer_seconds, "capture-buffer-seconds",
 CONFIG_VARIABLE (float, audio_playback_buffer_seconds, "playback-buffer-seconds", 5.0)
 CONFIG_VARIABLE (float, midi_track_buffer_seconds, "midi-track-buffer-seconds", 1.0)
 CONFIG_VARIABLE (uint32_t, disk_choice_space_threshold,  "disk-choice-space-threshold", 57600000)
+CONFIG_VARIABLE (uint32_t, import_threads, "import-threads", 0) // 0: one per CPU core
 CONFIG_VARIABLE (bool, auto_analyse_audio, "auto-analyse-audio", false)
+CONFIG_VARIABLE (uint32_t, analysis_threads, "analysis-threads", 0) // 0: one per CPU core
 CONFIG_VARIABLE (float, transient_sensitivity, "transient-sensitivity", 50)
 CONFIG_VARIABLE (float, max_transport_speed, "max-transport-speed", 2.0)
 
@@ -245,6 +247,8 @@ CONFIG_VARIABLE (bool, ask_setup_instrument, "ask-setup-instrument", true)
 CONFIG_VARIABLE (uint32_t, plugin_scan_timeout, "plugin-scan-timeout", 150) /* deci-seconds */
 CONFIG_VARIABLE (uint32_t, limit_n_automatables, "limit-n-automatables", 512)
 CONFIG_VARIABLE (uint32_t, plugin_cache_version, "plugin-cache-version", 0)
+CONFIG_VARIABLE (uint32_t, lua_dsp_pool_size, "lua-dsp-pool-size", 3145728) /* bytes, per Lua DSP instance */
+CONFIG_VARIABLE (uint32_t, lua_dsp_gc_budget, "lua-dsp-gc-budget", 0) /* microseconds per cycle, 0: single GC step */
 
 /* custom user plugin paths */
 CONFIG_VARIABLE (std::string, plugin_path_vst, "plugin-path-vst", "@default@")
@@ -282,3 +286,4 @@ CONFIG_VARIABLE (bool, show_video_server_dialog, "show-video-server-dialog", fal
 /* export */
 CONFIG_VARIABLE (float, export_preroll, "export-preroll", 2.0) // seconds
 CONFIG_VARIABLE (float, export_silence_threshold, "export-silence-threshold", -90) // dB
+CONFIG_VARIABLE (uint32_t, export_ram_budget, "export-ram-budget", 1024) // MiB, normalization intermediate kept in memory
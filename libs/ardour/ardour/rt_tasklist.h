@@ -20,6 +20,7 @@
 #define _ardour_rt_tasklist_h_
 
 #include <list>
+#include <vector>
 #include <boost/function.hpp>
 
 #include "pbd/semutils.h"
@@ -32,18 +33,60 @@
 
 namespace ARDOUR {
 
+/** Parallel executor for short, independent realtime tasks.
+ *
+ * Tasks are added to a preallocated array and processed by a pool of
+ * realtime threads and the calling thread, which pick the next task
+ * from a shared atomic index. Adding and processing tasks is
+ * realtime-safe (no allocation, no locks).
+ *
+ * Waking up worker threads has a cost, so tasks are processed in
+ * the calling thread, unless the measured cost of the tasks exceeds
+ * a threshold.
+ *
+ * Only a single thread may add and process tasks at a time.
+ */
 class LIBARDOUR_API RTTaskList
 {
 public:
-	RTTaskList ();
+	RTTaskList (size_t max_tasks = 4096);
 	~RTTaskList ();
 
-	// TODO use dedicated allocator of a boost::intrusive::list
+	/** A task calls `fn (arg, nframes)` */
+	struct Task {
+		Task (void (*f) (void*, pframes_t) = 0, void* a = 0, pframes_t n = 0) : fn (f), arg (a), nframes (n) {}
+		void (*fn) (void*, pframes_t);
+		void*     arg;
+		pframes_t nframes;
+	};
+
+	/** add a task to be run by the next call to process ().
+	 * @return false if the task-list is full. The caller has to
+	 * run the task itself in this case.
+	 */
+	bool push_back (Task const& t) {
+		if (_n_tasks >= _tasks.size ()) {
+			return false;
+		}
+		_tasks[_n_tasks++] = t;
+		return true;
+	}
+
+	/** process all added tasks in parallel, wait for them to complete,
+	 * and clear the task-list.
+	 */
+	void process ();
+
 	typedef std::list<boost::function<void ()> > TaskList;
 
 	/** process tasks in list in parallel, wait for them to complete */
 	void process (TaskList const&);
 
+	/** minimum expected total duration of all tasks in microseconds,
+	 * to process them in parallel
+	 */
+	void set_parallel_threshold (float usec) { _min_parallel_usec = usec; }
+
 private:
 	GATOMIC_QUAL gint      _threads_active;
 	std::vector<pthread_t> _threads;
@@ -51,17 +94,25 @@ private:
 	void reset_thread_list ();
 	void drop_threads ();
 
-	void process_tasklist ();
+	void run_tasks ();
 
 	static void* _thread_run (void *arg);
 	void run ();
 
-	Glib::Threads::Mutex _process_mutex;
-	Glib::Threads::Mutex _tasklist_mutex;
+	static void run_function (void*, pframes_t);
+
+	Glib::Threads::Mutex _thread_mutex;
 	PBD::Semaphore _task_run_sem;
 	PBD::Semaphore _task_end_sem;
 
-	TaskList _tasklist;
+	std::vector<Task> _tasks;
+	size_t            _n_tasks;
+
+	GATOMIC_QUAL gint _next_task;
+	GATOMIC_QUAL gint _busy_usec;
+
+	float _task_cost;         ///< average duration of a task in usec
+	float _min_parallel_usec;
 };
 
 } // namespace ARDOUR
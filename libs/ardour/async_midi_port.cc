@@ -330,13 +330,16 @@ AsyncMIDIPort::read (MIDI::byte *, size_t)
 	uint32_t size;
 	vector<MIDI::byte> buffer(input_fifo.capacity());
 
+	/* parse all pending input in one batch */
+	_parser->batch_begin ();
+
 	while (input_fifo.read (&time, &type, &size, &buffer[0])) {
 		_parser->set_timestamp (time);
-		for (uint32_t i = 0; i < size; ++i) {
-			_parser->scanner (buffer[i]);
-		}
+		_parser->scan (&buffer[0], size);
 	}
 
+	_parser->batch_end ();
+
 	return 0;
 }
 
@@ -40,6 +40,8 @@ AudioPort::AudioPort (const std::string& name, PortFlags flags)
 	: Port (name, DataType::AUDIO, flags)
 	, _buffer (new AudioBuffer (0))
 	, _data (0)
+	, _shared_input (0)
+	, _src_idle (false)
 {
 	assert (name.find_first_of (':') == string::npos);
 	_src.setup (_resampler_quality);
@@ -72,7 +74,15 @@ AudioPort::cycle_start (pframes_t nframes)
 		// TODO reset resampler only once
 		_src.reset ();
 		memset (_data, 0, _cycle_nframes * sizeof (float));
+	} else if (_shared_input) {
+		/* PortManager resampled the connected port, see PortManager::resample_inputs */
+		_src_idle = true;
 	} else {
+		if (_src_idle) {
+			/* drop stale history */
+			_src.reset ();
+			_src_idle = false;
+		}
 		_src.inp_data  = (float*)port_engine.get_buffer (_port_handle, nframes);
 		_src.inp_count = nframes;
 		_src.out_count = _cycle_nframes;
@@ -90,6 +100,8 @@ AudioPort::cycle_start (pframes_t nframes)
 void
 AudioPort::cycle_end (pframes_t nframes)
 {
+	_shared_input = 0;
+
 	if (sends_output() && !_buffer->written() && _port_handle) {
 		if (!_buffer->data (0)) {
 			get_audio_buffer (nframes);
@@ -139,7 +151,7 @@ AudioPort::get_audio_buffer (pframes_t nframes)
 		addr = (Sample *) port_engine.get_buffer (_port_handle, nframes);
 	} else {
 		/* _data was read and resampled as necessary in ::cycle_start */
-		addr = &_data[_global_port_buffer_offset];
+		addr = &(_shared_input ? _shared_input : _data)[_global_port_buffer_offset];
 	}
 
 	_buffer->set_data (addr, nframes);
@@ -17,9 +17,13 @@
  */
 
 #include <assert.h>
+#include <string.h>
 
 #include "pbd/error.h"
+#include "pbd/g_atomic_compat.h"
+#include "pbd/mpmc_queue.h"
 #include "pbd/pthread_utils.h"
+#include "pbd/semutils.h"
 
 #include "ardour/audio_buffer.h"
 #include "ardour/audioengine.h"
@@ -32,6 +36,7 @@
 #include "ardour/source_factory.h"
 #include "ardour/srcfilesource.h"
 #include "ardour/types.h"
+#include "ardour/utils.h"
 
 #include "pbd/i18n.h"
 
@@ -39,6 +44,147 @@ using namespace ARDOUR;
 using namespace ARDOUR::DSP;
 using namespace ArdourZita;
 
+/* Process the late (large) partitions of all Convolution instances
+ * using a shared pool of threads, one per DSP thread, instead of
+ * a dedicated thread for every partition-level of every instance.
+ *
+ * The workers run at a priority below the engine's process threads,
+ * and pick the job with the earliest deadline first: smaller
+ * partitions are due sooner.
+ */
+class ConvolutionWorkers : public Convsched
+{
+public:
+	static ConvolutionWorkers& instance ()
+	{
+		static ConvolutionWorkers workers;
+		return workers;
+	}
+
+	bool add_level (uint32_t parsize)
+	{
+		if (_threads.empty ()) {
+			return false;
+		}
+		/* every level has at most one job queued at any time */
+		GATOMIC_QUAL gint* cnt = &_n_levels[rank (parsize)];
+		if (g_atomic_int_add (cnt, 1) >= queue_size) {
+			g_atomic_int_add (cnt, -1);
+			return false;
+		}
+		return true;
+	}
+
+	void remove_level (uint32_t parsize)
+	{
+		g_atomic_int_add (&_n_levels[rank (parsize)], -1);
+	}
+
+	void schedule (Convlevel* level, uint32_t parsize)
+	{
+		_queue[rank (parsize)].push_back (level);
+		_sem.signal ();
+	}
+
+private:
+	static const int n_ranks    = 8;    // Convproc::MINPART .. Convproc::MAXPART
+	static const int queue_size = 1024; // max levels per rank
+
+	ConvolutionWorkers ()
+		: _sem ("convolution_workers", 0)
+	{
+		g_atomic_int_set (&_terminate, 0);
+		for (int r = 0; r < n_ranks; ++r) {
+			g_atomic_int_set (&_n_levels[r], 0);
+			_queue[r].reserve (queue_size);
+		}
+
+		const uint32_t num_threads = std::max<uint32_t> (1, how_many_dsp_threads ());
+		for (uint32_t i = 0; i < num_threads; ++i) {
+			pthread_t thread_id;
+			int rv = 1;
+			if (AudioEngine::instance ()->is_realtime ()) {
+				rv = pbd_realtime_pthread_create (PBD_SCHED_FIFO, AudioEngine::instance ()->client_real_time_priority () - 1, PBD_RT_STACKSIZE_HELP, &thread_id, _thread_run, this);
+			}
+			if (rv) {
+				rv = pbd_pthread_create (PBD_RT_STACKSIZE_HELP, &thread_id, _thread_run, this);
+			}
+			if (rv) {
+				PBD::warning << _("Convolution: cannot create worker thread, using per instance threads.") << endmsg;
+				break;
+			}
+			_threads.push_back (thread_id);
+		}
+	}
+
+	~ConvolutionWorkers ()
+	{
+		g_atomic_int_set (&_terminate, 1);
+		for (std::vector<pthread_t>::const_iterator i = _threads.begin (); i != _threads.end (); ++i) {
+			_sem.signal ();
+		}
+		for (std::vector<pthread_t>::const_iterator i = _threads.begin (); i != _threads.end (); ++i) {
+			pthread_join (*i, NULL);
+		}
+	}
+
+	static int rank (uint32_t parsize)
+	{
+		int r = 0;
+		for (parsize /= Convproc::MINPART; parsize > 1 && r < n_ranks - 1; parsize >>= 1) {
+			++r;
+		}
+		return r;
+	}
+
+	static void* _thread_run (void* arg)
+	{
+		pthread_set_name ("ConvWorker");
+		static_cast<ConvolutionWorkers*> (arg)->run ();
+		return 0;
+	}
+
+	void run ()
+	{
+		while (true) {
+			_sem.wait ();
+			if (g_atomic_int_get (&_terminate)) {
+				break;
+			}
+			Convlevel* level = 0;
+			/* every signal corresponds to a queued job */
+			while (!pop (level)) {
+				sched_yield ();
+			}
+			Convsched::run (level);
+		}
+	}
+
+	bool pop (Convlevel*& level)
+	{
+		for (int r = 0; r < n_ranks; ++r) {
+			if (_queue[r].pop_front (level)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	std::vector<pthread_t>      _threads;
+	PBD::Semaphore              _sem;
+	PBD::MPMCQueue<Convlevel*>  _queue[n_ranks];
+	GATOMIC_QUAL gint           _n_levels[n_ranks];
+	GATOMIC_QUAL gint           _terminate;
+};
+
+bool Convolution::_shared_workers = true;
+
+void
+Convolution::set_shared_workers (bool yn)
+{
+	_shared_workers = yn;
+}
+
 Convolution::Convolution (Session& session, uint32_t n_in, uint32_t n_out)
     : SessionHandleRef (session)
     , _n_samples (0)
@@ -158,6 +304,7 @@ Convolution::restart ()
 	}
 
 	if (rv == 0) {
+		_convproc.set_scheduler (_shared_workers ? &ConvolutionWorkers::instance () : 0);
 		rv = _convproc.start_process (pbd_absolute_rt_priority (PBD_SCHED_FIFO, AudioEngine::instance ()->client_real_time_priority () - 1), PBD_SCHED_FIFO);
 	}
 
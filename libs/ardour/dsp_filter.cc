@@ -18,11 +18,13 @@
  */
 
 #include <algorithm>
+#include <map>
 #include <stdlib.h>
 #include <cmath>
 #include <boost/math/special_functions/fpclassify.hpp>
 
 #include "ardour/dB.h"
+#include "ardour/audio_buffer.h"
 #include "ardour/buffer.h"
 #include "ardour/dsp_filter.h"
 #include "ardour/runtime_functions.h"
@@ -38,6 +40,14 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+#if defined(__x86_64__) || defined(__SSE__)
+#include <xmmintrin.h>
+#define DSP_FILTER_SSE
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DSP_FILTER_NEON
+#endif
+
 using namespace ARDOUR::DSP;
 
 void
@@ -333,8 +343,342 @@ Biquad::dB_at_freq (float freq) const
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+
+BiquadCascade::BiquadCascade (double samplerate, uint32_t n_channels, uint32_t n_stages)
+	: _n_channels (n_channels)
+	, _stages (n_stages, Biquad (samplerate))
+	, _coeff (20 * n_stages, 0.f)
+	, _state (8 * n_stages * ((n_channels + 3) / 4), 0.f)
+	, _ptrs (n_channels, (float*) 0)
+{
+	for (uint32_t s = 0; s < n_stages; ++s) {
+		configure (s, 0, 0, 1, 0, 0);
+	}
+}
+
+void
+BiquadCascade::configure (uint32_t stage, double a1, double a2, double b0, double b1, double b2)
+{
+	if (stage >= _stages.size ()) {
+		return;
+	}
+	_stages[stage].configure (a1, a2, b0, b1, b2);
+
+	float* c = &_coeff[20 * stage];
+	for (uint32_t l = 0; l < 4; ++l) {
+		c[l]      = a1;
+		c[l + 4]  = a2;
+		c[l + 8]  = b0;
+		c[l + 12] = b1;
+		c[l + 16] = b2;
+	}
+}
+
+void
+BiquadCascade::compute (uint32_t stage, Biquad::Type type, double freq, double Q, double gain)
+{
+	if (stage >= _stages.size ()) {
+		return;
+	}
+	Biquad& bq (_stages[stage]);
+	bq.compute (type, freq, Q, gain);
+	configure (stage, bq._a1, bq._a2, bq._b0, bq._b1, bq._b2);
+}
+
+float
+BiquadCascade::dB_at_freq (float freq) const
+{
+	float rv = 0;
+	for (std::vector<Biquad>::const_iterator i = _stages.begin (); i != _stages.end (); ++i) {
+		rv += i->dB_at_freq (freq);
+	}
+	return std::min (120.f, std::max (-120.f, rv));
+}
+
+void
+BiquadCascade::reset ()
+{
+	std::fill (_state.begin (), _state.end (), 0.f);
+}
+
+void
+BiquadCascade::run_map (BufferSet* bufs, const ChanMapping& map, const uint32_t n_samples, const uint32_t offset)
+{
+	for (uint32_t c = 0; c < _n_channels; ++c) {
+		bool valid;
+		uint32_t idx = map.get (DataType::AUDIO, c, &valid);
+		if (valid && idx < bufs->count ().n_audio ()) {
+			_ptrs[c] = bufs->get_audio (idx).data (offset);
+		} else {
+			_ptrs[c] = 0;
+		}
+	}
+	run (&_ptrs[0], n_samples);
+}
+
+void
+BiquadCascade::run (float* const* data, const uint32_t n_samples)
+{
+	const uint32_t n_stages = _stages.size ();
+	if (n_samples == 0 || n_stages == 0) {
+		return;
+	}
+
+	for (uint32_t c = 0; c < _n_channels; c += 4) {
+		float* state = &_state[8 * n_stages * (c / 4)];
+		if (c + 4 <= _n_channels && data[c] && data[c + 1] && data[c + 2] && data[c + 3]) {
+			run_4 (&data[c], state, n_samples);
+			continue;
+		}
+		for (uint32_t l = 0; l < 4 && c + l < _n_channels; ++l) {
+			if (data[c + l]) {
+				run_1 (data[c + l], state, l, n_samples);
+			}
+		}
+	}
+
+	for (std::vector<float>::iterator i = _state.begin (); i != _state.end (); ++i) {
+		if (!isfinite_local (*i)) { *i = 0; }
+		else if (!boost::math::isnormal (*i)) { *i = 0; }
+	}
+}
+
+/* process a single channel, using lane `l` of the state of its group */
+void
+BiquadCascade::run_1 (float* data, float* state, const uint32_t l, const uint32_t n_samples)
+{
+	const uint32_t n_stages = _stages.size ();
+
+	for (uint32_t s = 0; s < n_stages; ++s) {
+		float const* c  = &_coeff[20 * s];
+		const float  a1 = c[0];
+		const float  a2 = c[4];
+		const float  b0 = c[8];
+		const float  b1 = c[12];
+		const float  b2 = c[16];
+
+		float z1 = state[8 * s + l];
+		float z2 = state[8 * s + l + 4];
+
+		for (uint32_t i = 0; i < n_samples; ++i) {
+			const float xn = data[i];
+			const float z  = b0 * xn + z1;
+			z1             = b1 * xn - a1 * z + z2;
+			z2             = b2 * xn - a2 * z;
+			data[i]        = z;
+		}
+
+		state[8 * s + l]     = z1;
+		state[8 * s + l + 4] = z2;
+	}
+}
+
+#if defined(DSP_FILTER_SSE)
+
+/* one transposed direct form II step of 4 channels */
+static inline __m128
+biquad_step_4 (__m128 x, __m128& z1, __m128& z2, float const* c)
+{
+	const __m128 y = _mm_add_ps (_mm_mul_ps (_mm_loadu_ps (c + 8), x), z1);
+	z1 = _mm_add_ps (_mm_sub_ps (_mm_mul_ps (_mm_loadu_ps (c + 12), x), _mm_mul_ps (_mm_loadu_ps (c), y)), z2);
+	z2 = _mm_sub_ps (_mm_mul_ps (_mm_loadu_ps (c + 16), x), _mm_mul_ps (_mm_loadu_ps (c + 4), y));
+	return y;
+}
+
+#elif defined(DSP_FILTER_NEON)
+
+static inline float32x4_t
+biquad_step_4 (float32x4_t x, float32x4_t& z1, float32x4_t& z2, float const* c)
+{
+	const float32x4_t y = vmlaq_f32 (z1, vld1q_f32 (c + 8), x);
+	z1 = vmlsq_f32 (vmlaq_f32 (z2, vld1q_f32 (c + 12), x), vld1q_f32 (c), y);
+	z2 = vmlsq_f32 (vmulq_f32 (vld1q_f32 (c + 16), x), vld1q_f32 (c + 4), y);
+	return y;
+}
+
+static inline void
+transpose_4x4 (float32x4_t& r0, float32x4_t& r1, float32x4_t& r2, float32x4_t& r3)
+{
+	const float32x4x2_t t01 = vtrnq_f32 (r0, r1);
+	const float32x4x2_t t23 = vtrnq_f32 (r2, r3);
+	r0 = vcombine_f32 (vget_low_f32 (t01.val[0]), vget_low_f32 (t23.val[0]));
+	r1 = vcombine_f32 (vget_low_f32 (t01.val[1]), vget_low_f32 (t23.val[1]));
+	r2 = vcombine_f32 (vget_high_f32 (t01.val[0]), vget_high_f32 (t23.val[0]));
+	r3 = vcombine_f32 (vget_high_f32 (t01.val[1]), vget_high_f32 (t23.val[1]));
+}
+
+#endif
+
+/* process 4 channels at once, one channel per SIMD lane.
+ * Blocks of 4 samples are transposed, so that each vector holds
+ * one sample of all 4 channels.
+ */
+void
+BiquadCascade::run_4 (float* const* data, float* state, const uint32_t n_samples)
+{
+	const uint32_t n_stages = _stages.size ();
+
+#if defined(DSP_FILTER_SSE)
+	float* d0 = data[0];
+	float* d1 = data[1];
+	float* d2 = data[2];
+	float* d3 = data[3];
+
+	uint32_t i = 0;
+	for (; i + 4 <= n_samples; i += 4) {
+		__m128 x0 = _mm_loadu_ps (d0 + i);
+		__m128 x1 = _mm_loadu_ps (d1 + i);
+		__m128 x2 = _mm_loadu_ps (d2 + i);
+		__m128 x3 = _mm_loadu_ps (d3 + i);
+		_MM_TRANSPOSE4_PS (x0, x1, x2, x3);
+
+		for (uint32_t s = 0; s < n_stages; ++s) {
+			float const* c  = &_coeff[20 * s];
+			__m128       z1 = _mm_loadu_ps (state + 8 * s);
+			__m128       z2 = _mm_loadu_ps (state + 8 * s + 4);
+			x0 = biquad_step_4 (x0, z1, z2, c);
+			x1 = biquad_step_4 (x1, z1, z2, c);
+			x2 = biquad_step_4 (x2, z1, z2, c);
+			x3 = biquad_step_4 (x3, z1, z2, c);
+			_mm_storeu_ps (state + 8 * s, z1);
+			_mm_storeu_ps (state + 8 * s + 4, z2);
+		}
+
+		_MM_TRANSPOSE4_PS (x0, x1, x2, x3);
+		_mm_storeu_ps (d0 + i, x0);
+		_mm_storeu_ps (d1 + i, x1);
+		_mm_storeu_ps (d2 + i, x2);
+		_mm_storeu_ps (d3 + i, x3);
+	}
+
+	for (; i < n_samples; ++i) {
+		__m128 x = _mm_setr_ps (d0[i], d1[i], d2[i], d3[i]);
+		for (uint32_t s = 0; s < n_stages; ++s) {
+			__m128 z1 = _mm_loadu_ps (state + 8 * s);
+			__m128 z2 = _mm_loadu_ps (state + 8 * s + 4);
+			x = biquad_step_4 (x, z1, z2, &_coeff[20 * s]);
+			_mm_storeu_ps (state + 8 * s, z1);
+			_mm_storeu_ps (state + 8 * s + 4, z2);
+		}
+		float y[4];
+		_mm_storeu_ps (y, x);
+		d0[i] = y[0];
+		d1[i] = y[1];
+		d2[i] = y[2];
+		d3[i] = y[3];
+	}
+
+#elif defined(DSP_FILTER_NEON)
+	float* d0 = data[0];
+	float* d1 = data[1];
+	float* d2 = data[2];
+	float* d3 = data[3];
+
+	uint32_t i = 0;
+	for (; i + 4 <= n_samples; i += 4) {
+		float32x4_t x0 = vld1q_f32 (d0 + i);
+		float32x4_t x1 = vld1q_f32 (d1 + i);
+		float32x4_t x2 = vld1q_f32 (d2 + i);
+		float32x4_t x3 = vld1q_f32 (d3 + i);
+		transpose_4x4 (x0, x1, x2, x3);
+
+		for (uint32_t s = 0; s < n_stages; ++s) {
+			float const* c  = &_coeff[20 * s];
+			float32x4_t  z1 = vld1q_f32 (state + 8 * s);
+			float32x4_t  z2 = vld1q_f32 (state + 8 * s + 4);
+			x0 = biquad_step_4 (x0, z1, z2, c);
+			x1 = biquad_step_4 (x1, z1, z2, c);
+			x2 = biquad_step_4 (x2, z1, z2, c);
+			x3 = biquad_step_4 (x3, z1, z2, c);
+			vst1q_f32 (state + 8 * s, z1);
+			vst1q_f32 (state + 8 * s + 4, z2);
+		}
+
+		transpose_4x4 (x0, x1, x2, x3);
+		vst1q_f32 (d0 + i, x0);
+		vst1q_f32 (d1 + i, x1);
+		vst1q_f32 (d2 + i, x2);
+		vst1q_f32 (d3 + i, x3);
+	}
+
+	for (; i < n_samples; ++i) {
+		float y[4] = { d0[i], d1[i], d2[i], d3[i] };
+		float32x4_t x = vld1q_f32 (y);
+		for (uint32_t s = 0; s < n_stages; ++s) {
+			float32x4_t z1 = vld1q_f32 (state + 8 * s);
+			float32x4_t z2 = vld1q_f32 (state + 8 * s + 4);
+			x = biquad_step_4 (x, z1, z2, &_coeff[20 * s]);
+			vst1q_f32 (state + 8 * s, z1);
+			vst1q_f32 (state + 8 * s + 4, z2);
+		}
+		vst1q_f32 (y, x);
+		d0[i] = y[0];
+		d1[i] = y[1];
+		d2[i] = y[2];
+		d3[i] = y[3];
+	}
+
+#else
+	(void) n_stages;
+	for (uint32_t l = 0; l < 4; ++l) {
+		run_1 (data[l], state, l, n_samples);
+	}
+#endif
+}
+
+
 Glib::Threads::Mutex FFTSpectrum::fft_planner_lock;
 
+/* plans by window-size, protected by fft_planner_lock */
+static std::map<uint32_t, fftwf_plan> fft_plans;
+
+fftwf_plan
+FFTSpectrum::shared_plan (uint32_t window_size)
+{
+	Glib::Threads::Mutex::Lock lk (fft_planner_lock);
+
+	std::map<uint32_t, fftwf_plan>::const_iterator i = fft_plans.find (window_size);
+	if (i != fft_plans.end ()) {
+		return i->second;
+	}
+
+	/* Plans are executed with fftwf_execute_r2r () on other buffers.
+	 * Those are allocated with fftwf_malloc (), as are the ones used
+	 * for planning, so they have the same alignment.
+	 */
+	float* in  = (float *) fftwf_malloc (sizeof(float) * window_size);
+	float* out = (float *) fftwf_malloc (sizeof(float) * window_size);
+	fftwf_plan plan = fftwf_plan_r2r_1d (window_size, in, out, FFTW_R2HC, FFTW_MEASURE);
+	fftwf_free (in);
+	fftwf_free (out);
+
+	fft_plans[window_size] = plan;
+	return plan;
+}
+
+void
+FFTSpectrum::preplan (uint32_t window_size)
+{
+	assert (window_size > 0);
+	shared_plan (window_size);
+}
+
+static void
+compute_hann_window (float* window, uint32_t window_size)
+{
+	double sum = 0.0;
+
+	for (uint32_t i = 0; i < window_size; ++i) {
+		window[i] = 0.5f - (0.5f * (float) cos (2.0f * M_PI * (float)i / (float)(window_size)));
+		sum += window[i];
+	}
+	const double isum = 2.0 / sum;
+	for (uint32_t i = 0; i < window_size; ++i) {
+		window[i] *= isum;
+	}
+}
+
 FFTSpectrum::FFTSpectrum (uint32_t window_size, double rate)
 	: hann_window (0)
 {
@@ -343,10 +687,7 @@ FFTSpectrum::FFTSpectrum (uint32_t window_size, double rate)
 
 FFTSpectrum::~FFTSpectrum ()
 {
-	{
-		Glib::Threads::Mutex::Lock lk (fft_planner_lock);
-		fftwf_destroy_plan (_fftplan);
-	}
+	/* _fftplan is shared, and not destroyed */
 	fftwf_free (_fft_data_in);
 	fftwf_free (_fft_data_out);
 	free (_fft_power);
@@ -357,7 +698,6 @@ void
 FFTSpectrum::init (uint32_t window_size, double rate)
 {
 	assert (window_size > 0);
-	Glib::Threads::Mutex::Lock lk (fft_planner_lock);
 
 	_fft_window_size = window_size;
 	_fft_data_size   = window_size / 2;
@@ -369,19 +709,10 @@ FFTSpectrum::init (uint32_t window_size, double rate)
 
 	reset ();
 
-	_fftplan = fftwf_plan_r2r_1d (_fft_window_size, _fft_data_in, _fft_data_out, FFTW_R2HC, FFTW_MEASURE);
+	_fftplan = shared_plan (_fft_window_size);
 
 	hann_window  = (float *) malloc(sizeof(float) * window_size);
-	double sum = 0.0;
-
-	for (uint32_t i = 0; i < window_size; ++i) {
-		hann_window[i] = 0.5f - (0.5f * (float) cos (2.0f * M_PI * (float)i / (float)(window_size)));
-		sum += hann_window[i];
-	}
-	const double isum = 2.0 / sum;
-	for (uint32_t i = 0; i < window_size; ++i) {
-		hann_window[i] *= isum;
-	}
+	compute_hann_window (hann_window, window_size);
 }
 
 void
@@ -407,7 +738,7 @@ FFTSpectrum::set_data_hann (float const * const data, uint32_t n_samples, uint32
 void
 FFTSpectrum::execute ()
 {
-	fftwf_execute (_fftplan);
+	fftwf_execute_r2r (_fftplan, _fft_data_in, _fft_data_out);
 
 	_fft_power[0] = _fft_data_out[0] * _fft_data_out[0];
 
@@ -428,6 +759,81 @@ FFTSpectrum::power_at_bin (const uint32_t b, const float norm) const {
 	return a > 1e-12 ? 10.0 * fast_log10 (a) : -INFINITY;
 }
 
+FFTSpectrumBatch::FFTSpectrumBatch (uint32_t window_size, double rate, uint32_t n_channels)
+	: _fft_window_size (window_size)
+	, _fft_data_size (window_size / 2)
+	, _n_channels (n_channels)
+	, _fft_freq_per_bin (rate / (window_size / 2) / 2.f)
+{
+	assert (window_size > 0);
+
+	/* keep every channel's data aligned, like the planner's buffers */
+	_stride = (window_size + 15) & ~15;
+
+	_hann_window  = (float *) malloc (sizeof(float) * _fft_window_size);
+	_fft_data_in  = (float *) fftwf_malloc (sizeof(float) * _stride * std::max<uint32_t> (1, n_channels));
+	_fft_data_out = (float *) fftwf_malloc (sizeof(float) * _stride * std::max<uint32_t> (1, n_channels));
+	_fft_power    = (float *) calloc (_fft_data_size * std::max<uint32_t> (1, n_channels), sizeof(float));
+
+	memset (_fft_data_in, 0, sizeof(float) * _stride * std::max<uint32_t> (1, n_channels));
+	memset (_fft_data_out, 0, sizeof(float) * _stride * std::max<uint32_t> (1, n_channels));
+
+	compute_hann_window (_hann_window, _fft_window_size);
+
+	_fftplan = FFTSpectrum::shared_plan (_fft_window_size);
+}
+
+FFTSpectrumBatch::~FFTSpectrumBatch ()
+{
+	fftwf_free (_fft_data_in);
+	fftwf_free (_fft_data_out);
+	free (_fft_power);
+	free (_hann_window);
+}
+
+void
+FFTSpectrumBatch::set_data_hann (const uint32_t channel, float const * const data, uint32_t n_samples, uint32_t offset)
+{
+	if (channel >= _n_channels || offset >= _fft_window_size) {
+		return;
+	}
+	n_samples = std::min (n_samples, _fft_window_size - offset);
+	float* in = &_fft_data_in[channel * _stride];
+	for (uint32_t i = 0; i < n_samples; ++i) {
+		in[i + offset] = data[i] * _hann_window[i + offset];
+	}
+}
+
+void
+FFTSpectrumBatch::execute ()
+{
+	for (uint32_t c = 0; c < _n_channels; ++c) {
+		float* out   = &_fft_data_out[c * _stride];
+		float* power = &_fft_power[c * _fft_data_size];
+
+		fftwf_execute_r2r (_fftplan, &_fft_data_in[c * _stride], out);
+
+		power[0] = out[0] * out[0];
+
+#define FRe (out[i])
+#define FIm (out[_fft_window_size - i])
+		for (uint32_t i = 1; i < _fft_data_size - 1; ++i) {
+			power[i] = (FRe * FRe) + (FIm * FIm);
+		}
+#undef FRe
+#undef FIm
+	}
+}
+
+float
+FFTSpectrumBatch::power_at_bin (const uint32_t channel, const uint32_t b, const float norm) const {
+	if (channel >= _n_channels || b >= _fft_data_size) {
+		return -INFINITY;
+	}
+	const float a = _fft_power[channel * _fft_data_size + b] * norm;
+	return a > 1e-12 ? 10.0 * fast_log10 (a) : -INFINITY;
+}
+
 Generator::Generator ()
 	: _type (UniformWhiteNoise)
 	, _rseed (1)
@@ -509,3 +915,164 @@ Generator::grandf ()
 	_rn = r * x2;
 	return r * x1;
 }
+
+SampleView::SampleView ()
+	: _data (0)
+	, _size (0)
+{
+}
+
+SampleView::SampleView (float* data, uint32_t n_samples)
+	: _data (data)
+	, _size (data ? n_samples : 0)
+{
+}
+
+SampleView
+SampleView::audio_buffer (AudioBuffer& buf, uint32_t offset, uint32_t n_samples)
+{
+	if (offset >= buf.capacity ()) {
+		return SampleView ();
+	}
+	return SampleView (buf.data (offset), std::min<samplecnt_t> (n_samples, buf.capacity () - offset));
+}
+
+SampleView
+SampleView::shm (DspShm& shm, uint32_t offset, uint32_t n_samples)
+{
+	if (offset >= shm.size ()) {
+		return SampleView ();
+	}
+	return SampleView (shm.to_float (offset), std::min<size_t> (n_samples, shm.size () - offset));
+}
+
+float*
+SampleView::data (uint32_t off) const
+{
+	if (off >= _size) {
+		return 0;
+	}
+	return &_data[off];
+}
+
+SampleView
+SampleView::sub (uint32_t offset, uint32_t n_samples) const
+{
+	if (offset >= _size) {
+		return SampleView ();
+	}
+	return SampleView (&_data[offset], std::min (n_samples, _size - offset));
+}
+
+void
+SampleView::fill (float val)
+{
+	if (val == 0.f) {
+		clear ();
+	} else {
+		ARDOUR::DSP::memset (_data, val, _size);
+	}
+}
+
+void
+SampleView::clear ()
+{
+	if (_size > 0) {
+		::memset (_data, 0, sizeof (float) * _size);
+	}
+}
+
+void
+SampleView::apply_gain (float gain)
+{
+	if (_size > 0) {
+		ARDOUR::apply_gain_to_buffer (_data, _size, gain);
+	}
+}
+
+void
+SampleView::mmult (SampleView const& other)
+{
+	ARDOUR::DSP::mmult (_data, other._data, std::min (_size, other._size));
+}
+
+void
+SampleView::copy_from (SampleView const& src)
+{
+	uint32_t const n = std::min (_size, src._size);
+	if (n > 0 && _data != src._data) {
+		ARDOUR::copy_vector (_data, src._data, n);
+	}
+}
+
+void
+SampleView::mix_from (SampleView const& src, float gain)
+{
+	uint32_t const n = std::min (_size, src._size);
+	if (n == 0) {
+		return;
+	}
+	if (gain == 1.f) {
+		ARDOUR::mix_buffers_no_gain (_data, src._data, n);
+	} else {
+		ARDOUR::mix_buffers_with_gain (_data, src._data, n, gain);
+	}
+}
+
+float
+SampleView::compute_peak (float current) const
+{
+	if (_size == 0) {
+		return current;
+	}
+	return ARDOUR::compute_peak (_data, _size, current);
+}
+
+void
+SampleView::peaks (float& min, float& max) const
+{
+	if (_size > 0) {
+		ARDOUR::find_peaks (_data, _size, &min, &max);
+	}
+}
+
+float
+SampleView::rms () const
+{
+	if (_size == 0) {
+		return 0;
+	}
+	double sum = 0;
+	for (uint32_t i = 0; i < _size; ++i) {
+		sum += _data[i] * _data[i];
+	}
+	return sqrt (sum / _size);
+}
+
+void
+SampleView::biquad (Biquad& bq)
+{
+	if (_size > 0) {
+		bq.run (_data, _size);
+	}
+}
+
+void
+SampleView::fft_hann (FFTSpectrum& fft, uint32_t offset) const
+{
+	if (offset >= fft.window_size ()) {
+		return;
+	}
+	uint32_t const n = std::min (_size, fft.window_size () - offset);
+	if (n > 0) {
+		fft.set_data_hann (_data, n, offset);
+	}
+}
+
+void
+SampleView::generate (Generator& gen)
+{
+	if (_size > 0) {
+		gen.run (_data, _size);
+	}
+}
@@ -22,6 +22,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+#include <stdint.h>
 #include <vector>
 
 #include <glibmm/miscutils.h>
@@ -46,6 +48,7 @@
 #include "audiographer/general/silence_trimmer.h"
 #include "audiographer/general/threader.h"
 #include "audiographer/sndfile/tmp_file.h"
+#include "audiographer/sndfile/tmp_file_mem.h"
 #include "audiographer/sndfile/tmp_file_rt.h"
 #include "audiographer/sndfile/tmp_file_sync.h"
 #include "audiographer/sndfile/sndfile_writer.h"
@@ -70,7 +73,7 @@ namespace ARDOUR {
 
 ExportGraphBuilder::ExportGraphBuilder (Session const & session)
 	: session (session)
-	, thread_pool (hardware_concurrency())
+	, thread_pool (new ThreaderPool (hardware_concurrency()))
 {
 	process_buffer_samples = session.engine().samples_per_cycle();
 }
@@ -139,6 +142,7 @@ ExportGraphBuilder::reset ()
 	channel_configs.clear ();
 	channels.clear ();
 	intermediates.clear ();
+	tmp_budget.reset ();
 	analysis_map.clear();
 	_realtime = false;
 	_master_align = 0;
@@ -637,12 +641,22 @@ ExportGraphBuilder::Intermediate::Intermediate (ExportGraphBuilder & parent, Fil
 
 	peak_reader.reset (new PeakReader ());
 	loudness_reader.reset (new LoudnessReader (config.format->sample_rate(), channels, max_samples));
-	threader.reset (new Threader<Sample> (parent.thread_pool));
+	/* allow a few chunks to be queued, so that encoder branches
+	 * don't need to synchronize for every chunk.
+	 */
+	threader.reset (new Threader<Sample> (*parent.thread_pool, 4));
 
 	int format = ExportFormatBase::F_RAW | ExportFormatBase::SF_Float;
 
 	if (parent._realtime) {
 		tmp_file.reset (new TmpFileRt<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
+	} else if (Config->get_export_ram_budget () > 0) {
+		/* keep the intermediate in memory, spill to disk only when exceeding the budget */
+		if (!parent.tmp_budget) {
+			uint64_t budget = std::min<uint64_t> ((uint64_t) Config->get_export_ram_budget () << 20, SIZE_MAX);
+			parent.tmp_budget.reset (new TmpFileBudget (budget));
+		}
+		tmp_file.reset (new TmpFileMem<float> (new TmpFileStore (parent.tmp_budget, tmpfile_path), format, channels, config.format->sample_rate()));
 	} else {
 		tmp_file.reset (new TmpFileSync<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
 	}
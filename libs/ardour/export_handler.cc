@@ -116,6 +116,7 @@ ExportHandler::ExportHandler (Session & session)
   , graph_builder (new ExportGraphBuilder (session))
   , export_status (session.get_export_status ())
   , post_processing (false)
+  , pass_start (0)
   , cue_tracknum (0)
   , cue_indexnum (0)
 {
@@ -290,6 +291,11 @@ int
 ExportHandler::process_timespan (samplecnt_t samples)
 {
 	export_status->active_job = ExportStatus::Exporting;
+
+	if (process_position == current_timespan->get_start()) {
+		pass_start = PBD::get_microseconds ();
+	}
+
 	/* update position */
 
 	samplecnt_t samples_to_read = 0;
@@ -314,6 +320,10 @@ ExportHandler::process_timespan (samplecnt_t samples)
 
 	/* Start post-processing/normalizing if necessary */
 	if (last_cycle) {
+		PBD::microseconds_t now = PBD::get_microseconds ();
+		export_status->export_time += now - pass_start;
+		pass_start = now;
+
 		post_processing = graph_builder->need_postprocessing ();
 		if (post_processing) {
 			export_status->total_postprocessing_cycles = graph_builder->get_postprocessing_cycle_count();
@@ -331,6 +341,7 @@ int
 ExportHandler::post_process ()
 {
 	if (graph_builder->post_process ()) {
+		export_status->postprocess_time += PBD::get_microseconds () - pass_start;
 		finish_timespan ();
 		export_status->active_job = ExportStatus::Exporting;
 	} else {
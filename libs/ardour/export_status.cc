@@ -51,6 +51,9 @@ ExportStatus::init ()
 
 	total_postprocessing_cycles = 0;
 	current_postprocessing_cycle = 0;
+
+	export_time = 0;
+	postprocess_time = 0;
 	result_map.clear();
 }
 
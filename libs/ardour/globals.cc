@@ -96,6 +96,7 @@
 #include "LuaBridge/LuaBridge.h"
 
 #include "ardour/analyser.h"
+#include "ardour/analysis_service.h"
 #include "ardour/audio_backend.h"
 #include "ardour/audio_library.h"
 #include "ardour/audioengine.h"
@@ -131,6 +132,8 @@
 
 #include "audiographer/routines.h"
 
+#include "zita-resampler/resampler-table.h"
+
 #if defined(__APPLE__)
 #include <CoreFoundation/CoreFoundation.h>
 #endif
@@ -204,6 +207,8 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
 
+			ArdourZita::Resampler_kernels::use_avx_fma ();
+
 			generic_mix_functions = false;
 
 		} else
@@ -733,6 +738,7 @@ ARDOUR::cleanup ()
 	}
 
 	delete TriggerBox::worker;
+	AnalysisService::cleanup ();
 
 	release_dma_latency ();
 	config_connection.disconnect ();
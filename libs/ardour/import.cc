@@ -40,12 +40,17 @@
 #include "pbd/gstdio_compat.h"
 #include <glibmm.h>
 
+#include <deque>
+
+#include <boost/ptr_container/ptr_vector.hpp>
 #include <boost/scoped_array.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_array.hpp>
 
 #include "pbd/basename.h"
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
+#include "pbd/pthread_utils.h"
 
 #include "evoral/SMF.h"
 
@@ -253,7 +258,7 @@ compose_status_message (const string& path,
 }
 
 static void
-write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
+write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status, volatile float& progress,
                                vector<boost::shared_ptr<Source> >& newfiles)
 {
 	const samplecnt_t nframes = ResampledImportableSource::blocksize;
@@ -275,7 +280,7 @@ write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
 	boost::shared_ptr<AudioSource> s = boost::dynamic_pointer_cast<AudioSource> (newfiles[0]);
 	assert (s);
 
-	status.progress = 0.0f;
+	progress = 0.0f;
 	float progress_multiplier = 1;
 	float progress_base = 0;
 	const float progress_length = source->ratio() * source->length();
@@ -299,7 +304,7 @@ write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
 			peak = compute_peak (data.get(), nread, peak);
 
 			read_count += nread / channels;
-			status.progress = 0.5 * read_count / progress_length;
+			progress = 0.5 * read_count / progress_length;
 		}
 
 		if (peak >= 1) {
@@ -358,19 +363,19 @@ write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
 		}
 
 		read_count += nfread;
-		status.progress = progress_base + progress_multiplier * read_count / progress_length;
+		progress = progress_base + progress_multiplier * read_count / progress_length;
 	}
 }
 
 static void
-write_midi_data_to_new_files (Evoral::SMF* source, ImportStatus& status,
+write_midi_data_to_new_files (Evoral::SMF* source, ImportStatus& status, volatile float& progress,
                               vector<boost::shared_ptr<Source> >& newfiles,
                               bool split_midi_channels)
 {
 	uint32_t buf_size = 4;
 	uint8_t* buf      = (uint8_t*) malloc (buf_size);
 
-	status.progress = 0.0f;
+	progress = 0.0f;
 
 	bool type0 = source->smf_format()==0;
 
@@ -453,8 +458,8 @@ write_midi_data_to_new_files (Evoral::SMF* source, ImportStatus& status,
 						size,
 						buf));
 
-				if (status.progress < 0.99) {
-					status.progress += 0.01;
+				if (progress < 0.99) {
+					progress += 0.01;
 				}
 			}
 
@@ -500,6 +505,162 @@ write_midi_data_to_new_files (Evoral::SMF* source, ImportStatus& status,
 	}
 }
 
+namespace {
+
+/** A file that is being imported */
+struct ImportJob {
+	ImportJob () : progress (0), done (false) {}
+
+	std::string                         path;
+	boost::shared_ptr<ImportableSource> source;
+	vector<boost::shared_ptr<Source> >  newfiles;
+	std::string                         doing_what;
+	volatile float                      progress;
+	volatile bool                       done;
+};
+
+/** A bounded set of threads to decode, resample and write
+ * several audio files concurrently.
+ */
+class ImportWorkers
+{
+public:
+	ImportWorkers (ImportStatus& status, uint32_t n_threads)
+		: _status (status)
+		, _busy (0)
+		, _quit (false)
+	{
+		for (uint32_t i = 0; i < n_threads; ++i) {
+			pthread_t thread;
+			if (pthread_create_and_store ("ImportWorker", &thread, _run, this) == 0) {
+				_threads.push_back (thread);
+			}
+		}
+	}
+
+	~ImportWorkers ()
+	{
+		{
+			Glib::Threads::Mutex::Lock lm (_lock);
+			_quit = true;
+			_cond.broadcast ();
+		}
+		for (vector<pthread_t>::const_iterator i = _threads.begin (); i != _threads.end (); ++i) {
+			pthread_join (*i, 0);
+		}
+	}
+
+	/** true if a queued job would not be processed immediately */
+	bool full ()
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+		return _queue.size () + _busy >= _threads.size ();
+	}
+
+	void queue (ImportJob* job)
+	{
+		if (_threads.empty ()) {
+			process (job);
+			return;
+		}
+		Glib::Threads::Mutex::Lock lm (_lock);
+		_queue.push_back (job);
+		_cond.signal ();
+	}
+
+	/** wait until a job has completed, or the given timeout [usec] expired */
+	void wait (gint64 timeout)
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+		if (_queue.empty () && _busy == 0) {
+			return;
+		}
+		_done.wait_until (_lock, g_get_monotonic_time () + timeout);
+	}
+
+private:
+	static void* _run (void* arg)
+	{
+		static_cast<ImportWorkers*> (arg)->run ();
+		return 0;
+	}
+
+	void run ()
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+		while (true) {
+			/* finish all queued jobs before quitting, they
+			 * will return early when the import is cancelled.
+			 */
+			while (_queue.empty () && !_quit) {
+				_cond.wait (_lock);
+			}
+			if (_queue.empty ()) {
+				break;
+			}
+			ImportJob* job = _queue.front ();
+			_queue.pop_front ();
+			++_busy;
+
+			lm.release ();
+			process (job);
+			lm.acquire ();
+
+			--_busy;
+			_done.broadcast ();
+		}
+	}
+
+	void process (ImportJob* job)
+	{
+		try {
+			write_audio_data_to_new_files (job->source.get (), _status, job->progress, job->newfiles);
+		} catch (...) {
+			error << string_compose (_("Import: failed to import \"%1\""), job->path) << endmsg;
+			_status.cancel = true;
+		}
+		/* close the file (and decoder), keep the new sources */
+		job->source.reset ();
+		job->done = true;
+	}
+
+	ImportStatus&          _status;
+	vector<pthread_t>      _threads;
+	std::deque<ImportJob*> _queue;
+	size_t                 _busy;
+	bool                   _quit;
+
+	Glib::Threads::Mutex   _lock;
+	Glib::Threads::Cond    _cond;
+	Glib::Threads::Cond    _done;
+};
+
+/** Report progress of the first unfinished file, so that the
+ * file-counter only ever advances in order.
+ * @return true if all jobs are done
+ */
+bool
+update_import_progress (ImportStatus& status, boost::ptr_vector<ImportJob> const& jobs, uint32_t first)
+{
+	size_t i = 0;
+	while (i < jobs.size () && jobs[i].done) {
+		++i;
+	}
+
+	status.current = first + i;
+
+	if (i < jobs.size ()) {
+		if (status.doing_what != jobs[i].doing_what) {
+			status.doing_what = jobs[i].doing_what;
+		}
+		status.progress = jobs[i].progress;
+	}
+
+	return i == jobs.size ();
+}
+
+}
+
 static void
 remove_file_source (boost::shared_ptr<Source> source)
 {
@@ -605,8 +766,31 @@ Session::import_files (ImportStatus& status)
 
 	status.sources.clear ();
 
+	/* audio files are decoded, resampled and written by a pool of worker threads.
+	 * Opening files and creating new sources remains serialized here.
+	 */
+	uint32_t n_threads = Config->get_import_threads ();
+	if (n_threads == 0) {
+		n_threads = hardware_concurrency ();
+	}
+	n_threads = std::max<uint32_t> (1, std::min<uint32_t> (n_threads, status.paths.size ()));
+
+	boost::ptr_vector<ImportJob> jobs;
+	ImportWorkers workers (status, n_threads);
+	uint32_t const first = status.current;
+
 	for (vector<string>::const_iterator p = status.paths.begin(); p != status.paths.end() && !status.cancel; ++p) {
 
+		/* limit the number of files that are open at the same time */
+		while (workers.full () && !status.cancel) {
+			workers.wait (100000);
+			update_import_progress (status, jobs, first);
+		}
+
+		if (status.cancel) {
+			break;
+		}
+
 		boost::shared_ptr<ImportableSource> source;
 
 		const DataType type = SMFSource::safe_midi_file_extension (*p) ? DataType::MIDI : DataType::AUDIO;
@@ -618,8 +802,8 @@ Session::import_files (ImportStatus& status)
 				num_channels = source->channels();
 			} catch (const failed_constructor& err) {
 				error << string_compose(_("Import: cannot open input sound file \"%1\""), (*p)) << endmsg;
-				status.done = status.cancel = true;
-				return;
+				status.cancel = true;
+				break;
 			}
 
 		} else {
@@ -682,8 +866,8 @@ Session::import_files (ImportStatus& status)
 				}
 			} catch (...) {
 				error << _("Import: error opening MIDI file") << endmsg;
-				status.done = status.cancel = true;
-				return;
+				status.cancel = true;
+				break;
 			}
 		}
 
@@ -717,17 +901,28 @@ Session::import_files (ImportStatus& status)
 			}
 		}
 
+		ImportJob* job = new ImportJob;
+		job->path     = *p;
+		job->newfiles = newfiles;
+		jobs.push_back (job);
+
 		if (source) { // audio
-			status.doing_what = compose_status_message (*p, source->samplerate(),
-			                                            sample_rate(), status.current, status.total);
-			write_audio_data_to_new_files (source.get(), status, newfiles);
+			job->source = source;
+			job->doing_what = compose_status_message (*p, source->samplerate(),
+			                                          sample_rate(), first + jobs.size () - 1, status.total);
+			workers.queue (job);
 		} else if (smf_reader) { // midi
-			status.doing_what = string_compose(_("Loading MIDI file %1"), *p);
-			write_midi_data_to_new_files (smf_reader.get(), status, newfiles, status.split_midi_channels);
+			job->doing_what = string_compose(_("Loading MIDI file %1"), *p);
+			write_midi_data_to_new_files (smf_reader.get(), status, job->progress, newfiles, status.split_midi_channels);
+			job->done = true;
 		}
 
-		++status.current;
-		status.progress = 0;
+		update_import_progress (status, jobs, first);
+	}
+
+	/* wait for all workers to finish (or notice cancellation) */
+	while (!update_import_progress (status, jobs, first)) {
+		workers.wait (100000);
 	}
 
 	if (!status.cancel) {
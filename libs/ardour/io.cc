@@ -900,6 +900,7 @@ int
 IO::set_port_state_2X (const XMLNode& node, int /*version*/, bool in)
 {
 	XMLProperty const * prop;
+	PortManager::ConnectionChanges changes;
 
 	/* XXX: bundles ("connections" as was) */
 
@@ -937,7 +938,7 @@ IO::set_port_state_2X (const XMLNode& node, int /*version*/, bool in)
 						ports[x].replace (p, 4, "/audio_out");
 					}
 					if (NULL != nth(i).get())
-						nth(i)->connect (ports[x]);
+						changes.push_back (PortManager::ConnectionChange (nth(i)->name (), ports[x]));
 				}
 			}
 
@@ -980,7 +981,7 @@ IO::set_port_state_2X (const XMLNode& node, int /*version*/, bool in)
 						ports[x].replace (p, 3, "/audio_in");
 					}
 					if (NULL != nth(i).get())
-						nth(i)->connect (ports[x]);
+						changes.push_back (PortManager::ConnectionChange (nth(i)->name (), ports[x]));
 				}
 			}
 
@@ -989,6 +990,9 @@ IO::set_port_state_2X (const XMLNode& node, int /*version*/, bool in)
 		}
 	}
 
+	/* make all connections at once */
+	AudioEngine::instance()->change_connections (changes);
+
 	return 0;
 }
 
@@ -1052,6 +1056,8 @@ IO::set_ports (const string& str)
 		}
 	}
 
+	PortManager::ConnectionChanges changes;
+
 	string::size_type start  = 0;
 	string::size_type end    = 0;
 	string::size_type ostart = 0;
@@ -1070,14 +1076,24 @@ IO::set_ports (const string& str)
 
 		} else if (n > 0) {
 
-			for (int x = 0; x < n; ++x) {
-				connect (nth (i), ports[x], this);
+			boost::shared_ptr<Port> p = nth (i);
+			for (int x = 0; p && x < n; ++x) {
+				if (!ports[x].empty ()) {
+					changes.push_back (PortManager::ConnectionChange (p->name (), ports[x]));
+				}
 			}
 		}
 
 		ostart = end+1;
 	}
 
+	if (!changes.empty ()) {
+		/* make all connections at once, and notify only once */
+		AudioEngine::instance()->change_connections (changes);
+		changed (IOChange (IOChange::ConnectionsChanged), this); /* EMIT SIGNAL */
+		_session.set_dirty ();
+	}
+
 	return 0;
 }
 
@@ -32,6 +32,7 @@
 #include "ardour/lua_api.h"
 #include "ardour/luaproc.h"
 #include "ardour/luascripting.h"
+#include "ardour/midi_buffer.h"
 #include "ardour/plugin.h"
 #include "ardour/plugin_insert.h"
 #include "ardour/plugin_manager.h"
@@ -400,6 +401,54 @@ ARDOUR::LuaAPI::sample_to_timecode (lua_State *L)
 	return 4;
 }
 
+static int
+midi_buffer_events_next (lua_State *L)
+{
+	MidiBuffer const* const mb = static_cast<MidiBuffer const*> (lua_touserdata (L, lua_upvalueindex (1)));
+	size_t const offset = lua_tointeger (L, lua_upvalueindex (2));
+
+	if (!mb || offset >= mb->size ()) {
+		return 0;
+	}
+
+	/* access the buffer directly, Evoral::Event would copy the data */
+	MidiBuffer::const_iterator i (*mb, offset);
+	samplepos_t const    time = *i.timeptr ();
+	uint8_t const* const data = reinterpret_cast<uint8_t const*> (i.event_type_ptr () + 1);
+	int const            size = Evoral::midi_event_size (data);
+	if (size <= 0) {
+		return 0;
+	}
+	++i;
+
+	lua_pushinteger (L, i.offset);
+	lua_replace (L, lua_upvalueindex (2));
+
+	if (!lua_checkstack (L, size + 2)) {
+		return luaL_error (L, "MIDI event too large");
+	}
+
+	luabridge::Stack<samplepos_t>::push (L, time);
+	luabridge::Stack<int>::push (L, size);
+	for (int b = 0; b < size; ++b) {
+		lua_pushinteger (L, data[b]);
+	}
+	return size + 2;
+}
+
+int
+ARDOUR::LuaAPI::midi_buffer_events (lua_State *L)
+{
+	MidiBuffer const* const mb = luabridge::Userdata::get <MidiBuffer> (L, 1, true);
+	if (!mb) {
+		return luaL_argerror (L, 1, "invalid MidiBuffer");
+	}
+	lua_pushlightuserdata (L, const_cast<MidiBuffer*> (mb));
+	lua_pushinteger (L, 0);
+	lua_pushcclosure (L, &midi_buffer_events_next, 2);
+	return 1;
+}
+
 int
 ARDOUR::LuaAPI::timecode_to_sample (lua_State *L)
 {
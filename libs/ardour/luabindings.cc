@@ -32,6 +32,7 @@
 #include "evoral/ControlList.h"
 
 #include "ardour/amp.h"
+#include "ardour/analysis_service.h"
 #include "ardour/async_midi_port.h"
 #include "ardour/audioengine.h"
 #include "ardour/audioregion.h"
@@ -289,6 +290,7 @@ CLASSKEYS(boost::shared_ptr<std::vector<boost::shared_ptr<ARDOUR::Bundle> > >);
 
 CLASSKEYS(boost::shared_ptr<ARDOUR::AudioRegion>);
 CLASSKEYS(boost::shared_ptr<ARDOUR::AudioRom>);
+CLASSKEYS(boost::shared_ptr<ARDOUR::AnalysisService::Job>);
 CLASSKEYS(boost::shared_ptr<ARDOUR::AudioSource>);
 CLASSKEYS(boost::shared_ptr<ARDOUR::Automatable>);
 CLASSKEYS(boost::shared_ptr<ARDOUR::AutomatableSequence<Temporal::Beats> >);
@@ -1547,6 +1549,23 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("captured_for", &AudioSource::captured_for)
 		.endClass ()
 
+		.beginWSPtrClass <AnalysisService::Job> ("AnalysisJob")
+		.addFunction ("finished", &AnalysisService::Job::finished)
+		.addFunction ("failed", &AnalysisService::Job::failed)
+		.addFunction ("cached", &AnalysisService::Job::cached)
+		.addFunction ("wait", &AnalysisService::Job::wait)
+		.addFunction ("cancel", &AnalysisService::Job::cancel)
+		.addFunction ("loudness", &AnalysisService::Job::loudness)
+		.addFunction ("loudness_range", &AnalysisService::Job::loudness_range)
+		.addFunction ("transients", &AnalysisService::Job::transients)
+		.endClass ()
+
+		.beginClass <AnalysisService> ("AnalysisService")
+		.addStaticFunction ("analyze_region_loudness", &AnalysisService::analyze_region_loudness)
+		.addStaticFunction ("analyze_transients", &AnalysisService::analyze_transients)
+		.addStaticFunction ("n_workers", &AnalysisService::n_workers)
+		.endClass ()
+
 		.beginWSPtrClass <Latent> ("Latent")
 		.addFunction ("effective_latency", &Latent::effective_latency)
 		.addFunction ("user_latency", &Latent::user_latency)
@@ -2788,12 +2807,33 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("reset", &DSP::Biquad::reset)
 		.addFunction ("dB_at_freq", &DSP::Biquad::dB_at_freq)
 		.endClass ()
+		.beginClass <DSP::BiquadCascade> ("BiquadCascade")
+		.addConstructor <void (*) (double, uint32_t, uint32_t)> ()
+		.addFunction ("run_map", &DSP::BiquadCascade::run_map)
+		.addFunction ("compute", &DSP::BiquadCascade::compute)
+		.addFunction ("configure", &DSP::BiquadCascade::configure)
+		.addFunction ("reset", &DSP::BiquadCascade::reset)
+		.addFunction ("dB_at_freq", &DSP::BiquadCascade::dB_at_freq)
+		.addFunction ("n_channels", &DSP::BiquadCascade::n_channels)
+		.addFunction ("n_stages", &DSP::BiquadCascade::n_stages)
+		.endClass ()
 		.beginClass <DSP::FFTSpectrum> ("FFTSpectrum")
 		.addConstructor <void (*) (uint32_t, double)> ()
 		.addFunction ("set_data_hann", &DSP::FFTSpectrum::set_data_hann)
+		.addFunction ("window_size", &DSP::FFTSpectrum::window_size)
 		.addFunction ("execute", &DSP::FFTSpectrum::execute)
 		.addFunction ("power_at_bin", &DSP::FFTSpectrum::power_at_bin)
 		.addFunction ("freq_at_bin", &DSP::FFTSpectrum::freq_at_bin)
+		.addStaticFunction ("preplan", &DSP::FFTSpectrum::preplan)
+		.endClass ()
+		.beginClass <DSP::FFTSpectrumBatch> ("FFTSpectrumBatch")
+		.addConstructor <void (*) (uint32_t, double, uint32_t)> ()
+		.addFunction ("set_data_hann", &DSP::FFTSpectrumBatch::set_data_hann)
+		.addFunction ("window_size", &DSP::FFTSpectrumBatch::window_size)
+		.addFunction ("n_channels", &DSP::FFTSpectrumBatch::n_channels)
+		.addFunction ("execute", &DSP::FFTSpectrumBatch::execute)
+		.addFunction ("power_at_bin", &DSP::FFTSpectrumBatch::power_at_bin)
+		.addFunction ("freq_at_bin", &DSP::FFTSpectrumBatch::freq_at_bin)
 		.endClass ()
 		.beginClass <DSP::Generator> ("Generator")
 		.addVoidConstructor ()
@@ -2801,6 +2841,28 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("set_type", &DSP::Generator::set_type)
 		.endClass ()
 
+		.beginClass <DSP::SampleView> ("SampleView")
+		.addStaticFunction ("audio_buffer", &DSP::SampleView::audio_buffer)
+		.addStaticFunction ("shm", &DSP::SampleView::shm)
+		.addFunction ("valid", &DSP::SampleView::valid)
+		.addFunction ("size", &DSP::SampleView::size)
+		.addFunction ("sub", &DSP::SampleView::sub)
+		.addFunction ("get", &DSP::SampleView::get)
+		.addFunction ("set", &DSP::SampleView::set)
+		.addFunction ("fill", &DSP::SampleView::fill)
+		.addFunction ("clear", &DSP::SampleView::clear)
+		.addFunction ("apply_gain", &DSP::SampleView::apply_gain)
+		.addFunction ("mmult", &DSP::SampleView::mmult)
+		.addFunction ("copy_from", &DSP::SampleView::copy_from)
+		.addFunction ("mix_from", &DSP::SampleView::mix_from)
+		.addFunction ("compute_peak", &DSP::SampleView::compute_peak)
+		.addRefFunction ("peaks", &DSP::SampleView::peaks)
+		.addFunction ("rms", &DSP::SampleView::rms)
+		.addFunction ("biquad", &DSP::SampleView::biquad)
+		.addFunction ("fft_hann", &DSP::SampleView::fft_hann)
+		.addFunction ("generate", &DSP::SampleView::generate)
+		.endClass ()
+
 		.beginClass <ARDOUR::LTCReader> ("LTCReader")
 		.addConstructor <void (*) (int, LTC_TV_STANDARD)> ()
 		.addFunction ("write", &ARDOUR::LTCReader::write)
@@ -2876,6 +2938,7 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("to_int", &DSP::DspShm::to_int)
 		.addFunction ("atomic_set_int", &DSP::DspShm::atomic_set_int)
 		.addFunction ("atomic_get_int", &DSP::DspShm::atomic_get_int)
+		.addFunction ("size", &DSP::DspShm::size)
 		.endClass ()
 
 		.endNamespace () // DSP
@@ -2908,6 +2971,7 @@ LuaBindings::dsp (lua_State* L)
 		.addFunction ("push_back", (bool (MidiBuffer::*)(samplepos_t, Evoral::EventType, size_t, const uint8_t*))&MidiBuffer::push_back)
 		// TODO iterators..
 		.addExtCFunction ("table", &luabridge::CFunc::listToTable<const Evoral::Event<samplepos_t>, MidiBuffer>)
+		.addExtCFunction ("events", &ARDOUR::LuaAPI::midi_buffer_events)
 		.endClass()
 
 		.beginClass <BufferSet> ("BufferSet")
@@ -34,6 +34,7 @@
 #include "ardour/luascripting.h"
 #include "ardour/midi_buffer.h"
 #include "ardour/plugin.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session.h"
 
 #include "LuaBridge/LuaBridge.h"
@@ -47,13 +48,13 @@ LuaProc::LuaProc (AudioEngine& engine,
                   Session& session,
                   const std::string &script)
 	: Plugin (engine, session)
-	, _mempool ("LuaProc", 3145728)
-#ifdef USE_TLSF
-	, lua (lua_newstate (&PBD::TLSF::lalloc, &_mempool))
-#elif defined USE_MALLOC
+	, _mempool_size (std::max<size_t> (262144, Config->get_lua_dsp_pool_size ()))
+	, _alloc_bytes (0)
+	, _mempool ("LuaProc", _mempool_size)
+#ifdef USE_MALLOC
 	, lua ()
 #else
-	, lua (lua_newstate (&PBD::ReallocPool::lalloc, &_mempool))
+	, lua (lua_newstate (&LuaProc::lalloc, this))
 #endif
 	, _lua_dsp (0)
 	, _lua_latency (0)
@@ -68,6 +69,9 @@ LuaProc::LuaProc (AudioEngine& engine,
 	, _configured (false)
 	, _has_midi_input (false)
 	, _has_midi_output (false)
+	, _stat_reset (0)
+	, _cycle_alloc_bytes (0)
+	, _max_cycle_alloc_bytes (0)
 {
 	init ();
 
@@ -81,13 +85,13 @@ LuaProc::LuaProc (AudioEngine& engine,
 
 LuaProc::LuaProc (const LuaProc &other)
 	: Plugin (other)
-	, _mempool ("LuaProc", 3145728)
-#ifdef USE_TLSF
-	, lua (lua_newstate (&PBD::TLSF::lalloc, &_mempool))
-#elif defined USE_MALLOC
+	, _mempool_size (std::max<size_t> (262144, Config->get_lua_dsp_pool_size ()))
+	, _alloc_bytes (0)
+	, _mempool ("LuaProc", _mempool_size)
+#ifdef USE_MALLOC
 	, lua ()
 #else
-	, lua (lua_newstate (&PBD::ReallocPool::lalloc, &_mempool))
+	, lua (lua_newstate (&LuaProc::lalloc, this))
 #endif
 	, _lua_dsp (0)
 	, _lua_latency (0)
@@ -102,6 +106,9 @@ LuaProc::LuaProc (const LuaProc &other)
 	, _configured (false)
 	, _has_midi_input (false)
 	, _has_midi_output (false)
+	, _stat_reset (0)
+	, _cycle_alloc_bytes (0)
+	, _max_cycle_alloc_bytes (0)
 {
 	init ();
 
@@ -117,18 +124,18 @@ LuaProc::LuaProc (const LuaProc &other)
 
 LuaProc::~LuaProc () {
 #ifdef WITH_LUAPROC_STATS
-	if (_info && _stats_cnt > 0) {
-		printf ("LuaProc: '%s' run()  avg: %.3f  max: %.3f [ms] p: %.1f\n",
-				_info->name.c_str (),
-				0.0001f * _stats_avg[0] / (float) _stats_cnt,
-				0.0001f * _stats_max[0],
-				_stats_max[0] * (float)_stats_cnt / _stats_avg[0]);
-		printf ("LuaProc: '%s' gc()   avg: %.3f  max: %.3f [ms] p: %.1f\n",
-				_info->name.c_str (),
-				0.0001f * _stats_avg[1] / (float) _stats_cnt,
-				0.0001f * _stats_max[1],
-				_stats_max[1] * (float)_stats_cnt / _stats_avg[1]);
+	PBD::microseconds_t min, max;
+	double avg, dev;
+	if (_info && get_dsp_stats (min, max, avg, dev)) {
+		printf ("LuaProc: '%s' run()  avg: %.3f  max: %.3f [ms] dev: %.3f\n",
+				_info->name.c_str (), avg / 1000.0, max / 1000.0, dev / 1000.0);
+	}
+	if (_info && get_gc_stats (min, max, avg, dev)) {
+		printf ("LuaProc: '%s' gc()   avg: %.3f  max: %.3f [ms] dev: %.3f\n",
+				_info->name.c_str (), avg / 1000.0, max / 1000.0, dev / 1000.0);
 	}
+	printf ("LuaProc: '%s' max alloc per cycle: %zu bytes, pool size: %zu bytes\n",
+			_info ? _info->name.c_str () : "-", max_alloc_bytes_per_cycle (), _mempool_size);
 #endif
 	lua.collect_garbage ();
 	delete (_lua_dsp);
@@ -140,11 +147,6 @@ LuaProc::~LuaProc () {
 void
 LuaProc::init ()
 {
-#ifdef WITH_LUAPROC_STATS
-	_stats_avg[0] = _stats_avg[1] = _stats_max[0] = _stats_max[1] = 0;
-	_stats_cnt = -25;
-#endif
-
 	lua.Print.connect (sigc::mem_fun (*this, &LuaProc::lua_print));
 	// register session object
 	lua_State* L = lua.getState ();
@@ -669,9 +671,14 @@ LuaProc::connect_and_run (BufferSet& bufs,
 		}
 	}
 
-#ifdef WITH_LUAPROC_STATS
-	int64_t t0 = g_get_monotonic_time ();
-#endif
+	if (g_atomic_int_compare_and_exchange (&_stat_reset, 1, 0)) {
+		_dsp_timing.reset ();
+		_gc_timing.reset ();
+		g_atomic_int_set (&_max_cycle_alloc_bytes, 0);
+	}
+
+	_alloc_bytes = 0;
+	_dsp_timing.start ();
 
 	try {
 		if (_lua_does_channelmapping) {
@@ -789,25 +796,74 @@ LuaProc::connect_and_run (BufferSet& bufs,
 	} catch (...) {
 		return -1;
 	}
-#ifdef WITH_LUAPROC_STATS
-	int64_t t1 = g_get_monotonic_time ();
-#endif
+	_dsp_timing.update ();
 
-	lua.collect_garbage_step ();
-#ifdef WITH_LUAPROC_STATS
-	if (++_stats_cnt > 0) {
-		int64_t t2 = g_get_monotonic_time ();
-		int64_t ela0 = t1 - t0;
-		int64_t ela1 = t2 - t1;
-		if (ela0 > _stats_max[0]) _stats_max[0] = ela0;
-		if (ela1 > _stats_max[1]) _stats_max[1] = ela1;
-		_stats_avg[0] += ela0;
-		_stats_avg[1] += ela1;
+	gint const alloc_bytes = std::min<size_t> (_alloc_bytes, G_MAXINT);
+	g_atomic_int_set (&_cycle_alloc_bytes, alloc_bytes);
+	if (alloc_bytes > g_atomic_int_get (&_max_cycle_alloc_bytes)) {
+		g_atomic_int_set (&_max_cycle_alloc_bytes, alloc_bytes);
 	}
-#endif
+
+	_gc_timing.start ();
+
+	PBD::microseconds_t const budget = Config->get_lua_dsp_gc_budget ();
+	if (budget == 0) {
+		lua.collect_garbage_step ();
+	} else {
+		/* Perform small incremental GC steps until the time-budget
+		 * for this cycle is used up, or a GC cycle was completed.
+		 * The collector keeps its state, remaining work is continued
+		 * during the next cycle. Steps of the mark phase do not free
+		 * memory, but are needed to make progress.
+		 * At least one step is done, to keep up with allocations.
+		 */
+		PBD::microseconds_t const t0 = PBD::get_microseconds ();
+		do {
+			if (lua.collect_garbage_step ()) {
+				break;
+			}
+		} while (PBD::get_microseconds () - t0 < budget);
+	}
+
+	_gc_timing.update ();
 	return 0;
 }
 
+void*
+LuaProc::lalloc (void* ud, void* ptr, size_t osize, size_t nsize)
+{
+	LuaProc* self = static_cast<LuaProc*> (ud);
+	/* for new objects, osize is the lua type, not a size */
+	if (!ptr) {
+		self->_alloc_bytes += nsize;
+	} else if (nsize > osize) {
+		self->_alloc_bytes += nsize - osize;
+	}
+#ifdef USE_TLSF
+	return PBD::TLSF::lalloc (&self->_mempool, ptr, osize, nsize);
+#else
+	return PBD::ReallocPool::lalloc (&self->_mempool, ptr, osize, nsize);
+#endif
+}
+
+bool
+LuaProc::get_dsp_stats (PBD::microseconds_t& min, PBD::microseconds_t& max, double& avg, double& dev) const
+{
+	return _dsp_timing.get_stats (min, max, avg, dev);
+}
+
+bool
+LuaProc::get_gc_stats (PBD::microseconds_t& min, PBD::microseconds_t& max, double& avg, double& dev) const
+{
+	return _gc_timing.get_stats (min, max, avg, dev);
+}
+
+void
+LuaProc::clear_stats ()
+{
+	g_atomic_int_set (&_stat_reset, 1);
+}
+
 
 void
 LuaProc::add_state (XMLNode* root) const
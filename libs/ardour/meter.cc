@@ -55,6 +55,7 @@ PeakMeter::PeakMeter (Session& s, const std::string& name)
 
 	g_atomic_int_set (&_reset_dpm, 1);
 	g_atomic_int_set (&_reset_max, 1);
+	g_atomic_int_set (&_level_serial, 0);
 }
 
 PeakMeter::~PeakMeter ()
@@ -105,6 +106,9 @@ PeakMeter::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end
 
 	uint32_t n = 0;
 
+	/* publish a change to the GUI unless all meters have settled */
+	bool changed = reset_dpm;
+
 	const uint32_t zoh        = _session.nominal_sample_rate () * .021;
 	const float    falloff_dB = Config->get_meter_falloff () * nframes / _session.nominal_sample_rate ();
 
@@ -140,6 +144,7 @@ PeakMeter::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end
 		}
 		_peak_power[n]      = max (_peak_power[n], val);
 		_max_peak_signal[n] = 0;
+		changed |= _peak_power[n] > 0;
 	}
 
 	/* Audio Meters */
@@ -147,6 +152,7 @@ PeakMeter::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end
 		if (bufs.get_audio (i).silent ()) {
 			_peak_buffer[n] = 0;
 		} else {
+			changed             = true;
 			_peak_buffer[n]     = compute_peak (bufs.get_audio (i).data (), nframes, _peak_buffer[n]);
 			_peak_buffer[n]     = std::min (_peak_buffer[n], 100.f); // cut off at +40dBFS for falloff.
 			_max_peak_signal[n] = std::max (_peak_buffer[n], _max_peak_signal[n]);
@@ -167,6 +173,7 @@ PeakMeter::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end
 				_peak_power[n] = -std::numeric_limits<float>::infinity ();
 			}
 			_peak_power[n] = max (_peak_power[n], accurate_coefficient_to_dB (_peak_buffer[n]));
+			changed |= _peak_power[n] > -std::numeric_limits<float>::infinity ();
 			/* integration buffer, retain peaks > 49Hz */
 			if (_bufcnt > zoh) {
 				_peak_buffer[n] = 0;
@@ -189,6 +196,7 @@ PeakMeter::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end
 
 	/* Zero any excess peaks */
 	for (uint32_t i = n; i < _peak_power.size (); ++i) {
+		changed |= _peak_power[i] > -std::numeric_limits<float>::infinity ();
 		_peak_power[i]      = -std::numeric_limits<float>::infinity ();
 		_max_peak_signal[n] = 0;
 	}
@@ -196,6 +204,10 @@ PeakMeter::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end
 	if (_bufcnt > zoh) {
 		_bufcnt = 0;
 	}
+
+	if (changed) {
+		g_atomic_int_inc (&_level_serial);
+	}
 }
 
 void
@@ -221,6 +233,9 @@ PeakMeter::reset ()
 		_iec2meter[n]->reset ();
 		_vumeter[n]->reset ();
 	}
+
+	/* levels changed outside of run (), let the GUI pick them up */
+	g_atomic_int_inc (&_level_serial);
 }
 
 void
@@ -234,6 +249,7 @@ PeakMeter::reset_max ()
 		_max_peak_signal[i] = 0;
 		_peak_buffer[i]     = 0;
 	}
+	g_atomic_int_inc (&_level_serial);
 }
 
 bool
@@ -457,6 +473,7 @@ PeakMeter::set_meter_type (MeterType t)
 		}
 	}
 
+	g_atomic_int_inc (&_level_serial);
 	MeterTypeChanged (t); /* EMIT SIGNAL */
 }
 
@@ -156,15 +156,16 @@ Port::drop ()
 void
 Port::port_connected_or_disconnected (boost::weak_ptr<Port> w0, boost::weak_ptr<Port> w1, bool con)
 {
+	/* every port is called for every connection change, so
+	 * don't look up ourselves by name here.
+	 */
 	boost::shared_ptr<Port> p0 = w0.lock ();
 	boost::shared_ptr<Port> p1 = w1.lock ();
-	/* a cheaper, less hacky way to do boost::shared_from_this() ...  */
-	boost::shared_ptr<Port> pself = AudioEngine::instance()->get_port_by_name (name());
 
-	if (p0 == pself) {
+	if (p0 && p0.get () == this) {
 		ConnectedOrDisconnected (p0, p1, con); // emit signal
 	}
-	if (p1 == pself) {
+	if (p1 && p1.get () == this) {
 		ConnectedOrDisconnected (p1, p0, con); // emit signal
 	}
 }
@@ -270,6 +270,7 @@ PortEngineSharedImpl::PortEngineSharedImpl (PortManager& mgr, std::string const
 	: _instance_name (str)
 	, _portmap (new PortMap)
 	, _ports (new PortIndex)
+	, _portset (new PortSet)
 {
 	g_atomic_int_set (&_port_change_flag, 0);
 	pthread_mutex_init (&_port_callback_mutex, 0);
@@ -417,12 +418,14 @@ PortEngineSharedImpl::add_port (const std::string& name, ARDOUR::DataType type,
 	{
 		RCUWriter<PortIndex> index_writer (_ports);
 		RCUWriter<PortMap> map_writer (_portmap);
+		RCUWriter<PortSet> set_writer (_portset);
 
 		boost::shared_ptr<PortIndex> ps = index_writer.get_copy ();
 		boost::shared_ptr<PortMap> pm = map_writer.get_copy ();
 
 		ps->insert (port);
 		pm->insert (make_pair (name, port));
+		set_writer.get_copy ()->insert (port);
 	}
 
 	return port;
@@ -449,12 +452,16 @@ PortEngineSharedImpl::unregister_port (PortEngine::PortHandle port_handle)
 
 		disconnect_all (port_handle);
 
+		RCUWriter<PortSet> set_writer (_portset);
+		set_writer.get_copy ()->erase (port);
+
 		pm->erase (port->name());
 		ps->erase (i);
 	}
 
 	_ports.flush ();
 	_portmap.flush ();
+	_portset.flush ();
 }
 
 
@@ -469,9 +476,11 @@ PortEngineSharedImpl::unregister_ports (bool system_only)
 	{
 		RCUWriter<PortIndex> index_writer (_ports);
 		RCUWriter<PortMap> map_writer (_portmap);
+		RCUWriter<PortSet> set_writer (_portset);
 
 		boost::shared_ptr<PortIndex> ps = index_writer.get_copy ();
 		boost::shared_ptr<PortMap> pm = map_writer.get_copy ();
+		boost::shared_ptr<PortSet> pp = set_writer.get_copy ();
 
 
 		for (PortIndex::iterator i = ps->begin (); i != ps->end ();) {
@@ -480,6 +489,7 @@ PortEngineSharedImpl::unregister_ports (bool system_only)
 			if (! system_only || (port->is_physical () && port->is_terminal ())) {
 				port->disconnect_all (port);
 				pm->erase (port->name());
+				pp->erase (port);
 				ps->erase (cur);
 			}
 		}
@@ -487,6 +497,7 @@ PortEngineSharedImpl::unregister_ports (bool system_only)
 
 	_ports.flush ();
 	_portmap.flush ();
+	_portset.flush ();
 }
 
 void
@@ -495,9 +506,11 @@ PortEngineSharedImpl::clear_ports ()
 	{
 		RCUWriter<PortIndex> index_writer (_ports);
 		RCUWriter<PortMap> map_writer (_portmap);
+		RCUWriter<PortSet> set_writer (_portset);
 
 		boost::shared_ptr<PortIndex> ps = index_writer.get_copy();
 		boost::shared_ptr<PortMap> pm = map_writer.get_copy ();
+		boost::shared_ptr<PortSet> pp = set_writer.get_copy ();
 
 		if (ps->size () || pm->size ()) {
 			PBD::warning << _("PortEngineSharedImpl: recovering from unclean shutdown, port registry is not empty.") << endmsg;
@@ -508,10 +521,12 @@ PortEngineSharedImpl::clear_ports ()
 			ps->clear();
 			pm->clear();
 		}
+		pp->clear ();
 	}
 
 	_ports.flush ();
 	_portmap.flush ();
+	_portset.flush ();
 
 	g_atomic_int_set (&_port_change_flag, 0);
 	pthread_mutex_lock (&_port_callback_mutex);
@@ -19,6 +19,7 @@
  */
 
 #include <algorithm>
+#include <cmath>
 #include <vector>
 
 #ifdef COMPILER_MSVC
@@ -32,6 +33,7 @@
 #include <glibmm/miscutils.h>
 
 #include "pbd/error.h"
+#include "pbd/malign.h"
 #include "pbd/strsplit.h"
 #include "pbd/unwind.h"
 
@@ -68,6 +70,52 @@ PortManager::MIDIInputPort::MIDIInputPort (samplecnt_t sz)
 {
 }
 
+PortManager::InputResampler::InputResampler ()
+	: quality (0)
+	, data (0)
+	, input (0)
+{
+	setup (Port::resampler_quality ());
+}
+
+void
+PortManager::InputResampler::setup (uint32_t q)
+{
+	/* same as AudioPort, so that latency matches */
+	src.setup (q);
+	src.set_rrfilt (10);
+	quality = q;
+}
+
+PortManager::InputResampler::~InputResampler ()
+{
+	if (data) cache_aligned_free (data);
+}
+
+void
+PortManager::InputResampler::set_buffer_size (pframes_t nframes)
+{
+	if (data) cache_aligned_free (data);
+	cache_aligned_malloc ((void**) &data, sizeof (Sample) * lrint (floor (nframes * Config->get_max_transport_speed ())));
+}
+
+void
+PortManager::InputResampler::run (pframes_t nframes)
+{
+	/* see AudioPort::cycle_start */
+	src.inp_data  = input;
+	src.inp_count = nframes;
+	src.out_count = Port::cycle_nframes ();
+	src.set_rratio (Port::cycle_nframes () / (double)nframes);
+	src.out_data  = data;
+	src.process ();
+	while (src.out_count > 0) {
+		*src.out_data = src.out_data[-1];
+		++src.out_data;
+		--src.out_count;
+	}
+}
+
 PortManager::PortID::PortID (boost::shared_ptr<AudioBackend> b, DataType dt, bool in, std::string const& pn)
 	: backend (b->name ())
 	, port_name (pn)
@@ -145,8 +193,11 @@ PortManager::PortManager ()
 	, _midi_info_dirty (true)
 	, _audio_input_ports (new AudioInputPorts)
 	, _midi_input_ports (new MIDIInputPorts)
+	, _meter_rate (0)
+	, _resampled_inputs (new ResampledInputs)
 {
 	g_atomic_int_set (&_reset_meters, 1);
+	g_atomic_int_set (&_resampled_inputs_dirty, 0);
 	load_port_info ();
 }
 
@@ -678,6 +729,113 @@ PortManager::disconnect (const string& source, const string& destination)
 	return ret;
 }
 
+/** @param fullname non-relative port name
+ *  @return our port of the given name, without checking for 3rd party renames (unlike get_port_by_name)
+ */
+static boost::shared_ptr<Port>
+own_port (PortManager::Ports const& ports, std::string const& self, std::string const& fullname)
+{
+	if (fullname.compare (0, self.size (), self) != 0) {
+		return boost::shared_ptr<Port> ();
+	}
+	PortManager::Ports::const_iterator x = ports.find (fullname.substr (self.size ()));
+	if (x == ports.end ()) {
+		return boost::shared_ptr<Port> ();
+	}
+	return x->second;
+}
+
+int
+PortManager::change_connections (ConnectionChanges& changes)
+{
+	int failed = 0;
+
+	if (!_backend) {
+		for (ConnectionChanges::iterator i = changes.begin (); i != changes.end (); ++i) {
+			i->result = -1;
+		}
+		return changes.size ();
+	}
+
+	boost::shared_ptr<Ports> pr   = _ports.reader ();
+	std::string const        self = _backend->my_name () + ':';
+
+	/* (output, input, connect) -> result */
+	typedef std::map<std::pair<std::pair<std::string, std::string>, bool>, int> Done;
+	Done done;
+
+	for (ConnectionChanges::iterator i = changes.begin (); i != changes.end (); ++i) {
+		string s = make_port_name_non_relative (i->source);
+		string d = make_port_name_non_relative (i->destination);
+
+		boost::shared_ptr<Port> src = own_port (*pr, self, s);
+		boost::shared_ptr<Port> dst = own_port (*pr, self, d);
+
+		if (i->connect && (src || dst) && Port::connecting_blocked ()) {
+			i->result = 0;
+			continue;
+		}
+
+		/* the backend expects output -> input */
+		bool swap = (src && src->receives_input ()) || (dst && dst->sends_output ());
+
+		Done::key_type key (std::make_pair (swap ? d : s, swap ? s : d), i->connect);
+		Done::const_iterator x = done.find (key);
+
+		if (x != done.end ()) {
+			i->result = x->second;
+			if (i->result < 0) {
+				++failed;
+			}
+			continue;
+		}
+
+		if (i->connect) {
+			i->result = _backend->connect (key.first.first, key.first.second);
+		} else {
+			i->result = _backend->disconnect (key.first.first, key.first.second);
+		}
+
+		done[key] = i->result;
+
+		if (i->result < 0) {
+			if (i->connect) {
+				error << string_compose (_("AudioEngine: cannot connect %1 (%2) to %3 (%4)"),
+				                         i->source, s, i->destination, d)
+				      << endmsg;
+			}
+			++failed;
+			continue;
+		}
+
+		/* keep track of connections like Port::connect () and
+		 * Port::disconnect () do, the port named by source is "self".
+		 */
+		if (i->connect) {
+			if (src) {
+				src->_connections.insert (i->destination);
+				if (dst) {
+					dst->_connections.insert (src->name ());
+				}
+			} else if (dst) {
+				dst->_connections.insert (i->source);
+			}
+		} else {
+			if (src) {
+				src->_connections.erase (i->destination);
+				if (dst) {
+					dst->_connections.erase (src->name ());
+					src->ConnectedOrDisconnected (src, dst, false); // emit signal
+				}
+			} else if (dst) {
+				dst->_connections.erase (i->source);
+			}
+		}
+	}
+
+	return failed;
+}
+
 int
 PortManager::disconnect (boost::shared_ptr<Port> port)
 {
@@ -773,9 +931,41 @@ PortManager::reconnect_ports ()
 
 	DEBUG_TRACE (DEBUG::Ports, string_compose ("reconnect %1 ports\n", p->size ()));
 
+	/* Connections between our own ports are stored at both ends,
+	 * make all of them in one go, each only once. This is equivalent
+	 * to calling Port::reconnect () for every port.
+	 */
+	ConnectionChanges               changes;
+	vector<boost::shared_ptr<Port> > owner;
+
 	for (Ports::iterator i = p->begin (); i != p->end (); ++i) {
-		if (i->second->reconnect ()) {
-			PortConnectedOrDisconnected (i->second, i->first, boost::weak_ptr<Port> (), "", false);
+		std::set<string> const& c (i->second->_connections);
+		for (std::set<string>::const_iterator j = c.begin (); j != c.end (); ++j) {
+			changes.push_back (ConnectionChange (i->first, *j));
+			owner.push_back (i->second);
+		}
+	}
+
+	change_connections (changes);
+
+	/* forget connections that failed, and notify about ports that
+	 * could not be reconnected at all.
+	 */
+	std::map<boost::shared_ptr<Port>, bool> reconnected;
+
+	for (size_t n = 0; n < changes.size (); ++n) {
+		if (changes[n].result < 0) {
+			DEBUG_TRACE (DEBUG::Ports, string_compose ("reconnect: failed to connect %1 to %2\n", changes[n].source, changes[n].destination));
+			owner[n]->_connections.erase (changes[n].destination);
+			reconnected.insert (std::make_pair (owner[n], false));
+		} else {
+			reconnected[owner[n]] = true;
+		}
+	}
+
+	for (std::map<boost::shared_ptr<Port>, bool>::const_iterator i = reconnected.begin (); i != reconnected.end (); ++i) {
+		if (!i->second) {
+			PortConnectedOrDisconnected (i->first, i->first->name (), boost::weak_ptr<Port> (), "", false);
 		}
 	}
 
@@ -831,6 +1021,11 @@ PortManager::connect_callback (const string& a, const string& b, bool conn)
 		}
 	}
 
+	if (port_a || port_b) {
+		/* updated in graph_order_callback () */
+		g_atomic_int_set (&_resampled_inputs_dirty, 1);
+	}
+
 	PortConnectedOrDisconnected (
 	    port_a, a,
 	    port_b, b,
@@ -847,6 +1042,7 @@ PortManager::registration_callback ()
 	}
 
 	update_input_ports (false);
+	update_resampled_inputs ();
 
 	PortRegisteredOrUnregistered (); /* EMIT SIGNAL */
 }
@@ -1078,6 +1274,10 @@ PortManager::graph_order_callback ()
 {
 	DEBUG_TRACE (DEBUG::BackendCallbacks, "graph order callback\n");
 
+	if (g_atomic_int_compare_and_exchange (&_resampled_inputs_dirty, 1, 0)) {
+		update_resampled_inputs ();
+	}
+
 	if (!_port_remove_in_progress) {
 		GraphReordered (); /* EMIT SIGNAL */
 	}
@@ -1085,6 +1285,136 @@ PortManager::graph_order_callback ()
 	return 0;
 }
 
+void
+PortManager::resampler_quality_changed ()
+{
+	/* like registration_callback (), update right away */
+	update_resampled_inputs ();
+}
+
+void
+PortManager::update_resampled_inputs ()
+{
+	if (!_backend) {
+		return;
+	}
+
+	/* find external ports, that are the only connection of more than
+	 * one of our audio input ports. Data of those ports can be
+	 * resampled once, and used by all those input ports.
+	 */
+	typedef std::map<std::string, std::vector<boost::weak_ptr<AudioPort> > > Sources;
+	Sources sources;
+
+	boost::shared_ptr<Ports> pr = _ports.reader ();
+	for (Ports::iterator p = pr->begin (); p != pr->end (); ++p) {
+		boost::shared_ptr<AudioPort> ap = boost::dynamic_pointer_cast<AudioPort> (p->second);
+		if (!ap || !ap->receives_input () || (ap->flags () & TransportSyncPort) || ap->externally_connected () != 1) {
+			continue;
+		}
+		std::vector<std::string> c;
+		if (ap->get_connections (c) != 1) {
+			continue;
+		}
+		sources[c.front ()].push_back (ap);
+	}
+
+	RCUWriter<ResampledInputs>         writer (_resampled_inputs);
+	boost::shared_ptr<ResampledInputs> ri = writer.get_copy ();
+
+	ResampledInputs old;
+	old.swap (*ri);
+
+	for (Sources::const_iterator i = sources.begin (); i != sources.end (); ++i) {
+		if (i->second.size () < 2) {
+			continue;
+		}
+
+		ResampledInput r;
+		r.source = _backend->get_port_by_name (i->first);
+		if (!r.source) {
+			continue;
+		}
+		r.readers = i->second;
+
+		/* retain resampler state of known sources. A resampler with
+		 * a different quality is replaced, rather than set up again,
+		 * since it may be in use by the process thread.
+		 */
+		for (ResampledInputs::const_iterator o = old.begin (); o != old.end (); ++o) {
+			if (o->source == r.source) {
+				if (o->resampler->quality == Port::resampler_quality ()) {
+					r.resampler = o->resampler;
+				}
+				break;
+			}
+		}
+
+		if (!r.resampler) {
+			r.resampler.reset (new InputResampler);
+			r.resampler->set_buffer_size (AudioEngine::instance ()->samples_per_cycle ());
+		}
+
+		ri->push_back (r);
+	}
+
+	DEBUG_TRACE (DEBUG::Ports, string_compose ("%1 shared resampled inputs\n", ri->size ()));
+}
+
+/* called at the start of each cycle, before Port::cycle_start */
+void
+PortManager::resample_inputs (pframes_t nframes, boost::shared_ptr<RTTaskList> tl)
+{
+	_cycle_resampled_inputs = _resampled_inputs.reader ();
+
+	for (ResampledInputs::iterator i = _cycle_resampled_inputs->begin (); i != _cycle_resampled_inputs->end (); ++i) {
+		InputResampler* rs = i->resampler.get ();
+
+		rs->input = (Sample*)_backend->get_buffer (i->source, nframes);
+		if (!rs->input) {
+			continue;
+		}
+
+		for (std::vector<boost::weak_ptr<AudioPort> >::const_iterator r = i->readers.begin (); r != i->readers.end (); ++r) {
+			boost::shared_ptr<AudioPort> ap (r->lock ());
+			if (ap) {
+				/* reset in AudioPort::cycle_end */
+				ap->_shared_input = rs->data;
+			}
+		}
+
+		if (!tl || !tl->push_back (RTTaskList::Task (&PortManager::resample_input_task, rs, nframes))) {
+			rs->run (nframes);
+		}
+	}
+}
+
+void
+PortManager::resample_input_task (void* rs, pframes_t nframes)
+{
+	static_cast<InputResampler*> (rs)->run (nframes);
+}
+
+/* RTTaskList tasks */
+static void
+port_cycle_start (void* p, pframes_t nframes)
+{
+	static_cast<Port*> (p)->cycle_start (nframes);
+}
+
+static void
+port_cycle_end (void* p, pframes_t nframes)
+{
+	static_cast<Port*> (p)->cycle_end (nframes);
+}
+
+void
+PortManager::run_input_meters_task (void* pm, pframes_t nframes)
+{
+	PortManager* self = static_cast<PortManager*> (pm);
+	self->run_input_meters (nframes, self->_meter_rate);
+}
+
 void
 PortManager::cycle_start (pframes_t nframes, Session* s)
 {
@@ -1094,34 +1424,32 @@ PortManager::cycle_start (pframes_t nframes, Session* s)
 	_cycle_ports = _ports.reader ();
 
 	/* TODO optimize
-	 *  - when speed == 1.0, the resampler copies data without processing
-	 *   it may (or may not) be more efficient to just run all in sequence.
-	 *
 	 *  - single sequential task for 'lightweight' tasks would make sense
 	 *    (run it in parallel with 'heavy' resampling.
 	 *    * output ports (sends_output()) only set a flag
 	 *    * midi-ports only scale event timestamps
 	 *
-	 *  - a threshold parallel vs searial processing may be appropriate.
-	 *    amount of work (how many connected ports are there, how
-	 *    many resamplers need to run) vs. available CPU cores and semaphore
-	 *    synchronization overhead.
-	 *
-	 *  - input ports: it would make sense to resample each input only once
-	 *    (rather than resample into each ardour-owned input port).
-	 *    A single external source-port may be connected to many ardour
-	 *    input-ports. Currently re-sampling is per input.
+	 *  External ports that are connected to more than one of our input
+	 *  ports are resampled only once (see resample_inputs ()).
 	 */
 	if (s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
+		/* RTTaskList decides if it is worth to use multiple threads */
+		boost::shared_ptr<RTTaskList> tl (s->rt_tasklist ());
+		_meter_rate = s->nominal_sample_rate ();
+		resample_inputs (nframes, tl);
+		if (!tl->push_back (RTTaskList::Task (&PortManager::run_input_meters_task, this, nframes))) {
+			run_input_meters (nframes, _meter_rate);
+		}
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
-				tl.push_back (boost::bind (&Port::cycle_start, p->second, nframes));
+				if (!tl->push_back (RTTaskList::Task (&port_cycle_start, p->second.get (), nframes))) {
+					p->second->cycle_start (nframes);
+				}
 			}
 		}
-		tl.push_back (boost::bind (&PortManager::run_input_meters, this, nframes, s ? s->nominal_sample_rate () : 0));
-		s->rt_tasklist ()->process (tl);
+		tl->process ();
 	} else {
+		resample_inputs (nframes, boost::shared_ptr<RTTaskList> ());
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
 				p->second->cycle_start (nframes);
@@ -1136,13 +1464,15 @@ PortManager::cycle_end (pframes_t nframes, Session* s)
 {
 	// see optimzation note in ::cycle_start()
 	if (0 && s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
+		boost::shared_ptr<RTTaskList> tl (s->rt_tasklist ());
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
-				tl.push_back (boost::bind (&Port::cycle_end, p->second, nframes));
+				if (!tl->push_back (RTTaskList::Task (&port_cycle_end, p->second.get (), nframes))) {
+					p->second->cycle_end (nframes);
+				}
 			}
 		}
-		s->rt_tasklist ()->process (tl);
+		tl->process ();
 	} else {
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
@@ -1158,6 +1488,7 @@ PortManager::cycle_end (pframes_t nframes, Session* s)
 	}
 
 	_cycle_ports.reset ();
+	_cycle_resampled_inputs.reset ();
 
 	/* we are done */
 }
@@ -1244,13 +1575,15 @@ PortManager::cycle_end_fade_out (gain_t base_gain, gain_t gain_step, pframes_t n
 {
 	// see optimzation note in ::cycle_start()
 	if (0 && s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
+		boost::shared_ptr<RTTaskList> tl (s->rt_tasklist ());
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
-				tl.push_back (boost::bind (&Port::cycle_end, p->second, nframes));
+				if (!tl->push_back (RTTaskList::Task (&port_cycle_end, p->second.get (), nframes))) {
+					p->second->cycle_end (nframes);
+				}
 			}
 		}
-		s->rt_tasklist ()->process (tl);
+		tl->process ();
 	} else {
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
@@ -1276,6 +1609,7 @@ PortManager::cycle_end_fade_out (gain_t base_gain, gain_t gain_step, pframes_t n
 		}
 	}
 	_cycle_ports.reset ();
+	_cycle_resampled_inputs.reset ();
 	/* we are done */
 }
 
@@ -1722,6 +2056,10 @@ PortManager::set_port_buffer_sizes (pframes_t n)
 	for (Ports::iterator p = all->begin (); p != all->end (); ++p) {
 		p->second->set_buffer_size (n);
 	}
+	boost::shared_ptr<ResampledInputs> ri = _resampled_inputs.reader ();
+	for (ResampledInputs::iterator i = ri->begin (); i != ri->end (); ++i) {
+		i->resampler->set_buffer_size (n);
+	}
 	_monitor_port.set_buffer_size (n);
 }
 
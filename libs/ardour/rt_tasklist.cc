@@ -18,6 +18,7 @@
 
 #include <cstring>
 
+#include "pbd/microseconds.h"
 #include "pbd/pthread_utils.h"
 
 #include "ardour/audioengine.h"
@@ -29,11 +30,17 @@
 
 using namespace ARDOUR;
 
-RTTaskList::RTTaskList ()
+RTTaskList::RTTaskList (size_t max_tasks)
 	: _task_run_sem ("rt_task_run", 0)
 	, _task_end_sem ("rt_task_done", 0)
+	, _tasks (max_tasks)
+	, _n_tasks (0)
+	, _task_cost (0)
+	, _min_parallel_usec (40)
 {
 	g_atomic_int_set (&_threads_active, 0);
+	g_atomic_int_set (&_next_task, 0);
+	g_atomic_int_set (&_busy_usec, 0);
 	reset_thread_list ();
 }
 
@@ -45,7 +52,7 @@ RTTaskList::~RTTaskList ()
 void
 RTTaskList::drop_threads ()
 {
-	Glib::Threads::Mutex::Lock pm (_process_mutex);
+	Glib::Threads::Mutex::Lock tm (_thread_mutex);
 	g_atomic_int_set (&_threads_active, 0);
 
 	uint32_t nt = _threads.size ();
@@ -75,15 +82,16 @@ RTTaskList::reset_thread_list ()
 {
 	drop_threads ();
 
+	/* the thread calling process () also runs tasks */
 	const uint32_t num_threads = how_many_dsp_threads ();
 	if (num_threads < 2) {
 		return;
 	}
 
-	Glib::Threads::Mutex::Lock pm (_process_mutex);
+	Glib::Threads::Mutex::Lock tm (_thread_mutex);
 
 	g_atomic_int_set (&_threads_active, 1);
-	for (uint32_t i = 0; i < num_threads; ++i) {
+	for (uint32_t i = 0; i < num_threads - 1; ++i) {
 		pthread_t thread_id;
 		int rv = 1;
 		if (AudioEngine::instance()->is_realtime ()) {
@@ -104,76 +112,86 @@ RTTaskList::reset_thread_list ()
 void
 RTTaskList::run ()
 {
-	Glib::Threads::Mutex::Lock tm (_tasklist_mutex, Glib::Threads::NOT_LOCK);
-	bool wait = true;
-
 	while (true) {
-		if (wait) {
-			_task_run_sem.wait ();
-		}
+		_task_run_sem.wait ();
 
 		if (0 == g_atomic_int_get (&_threads_active)) {
-			_task_end_sem.signal ();
 			break;
 		}
 
-		wait = false;
-
-		boost::function<void ()> to_run;
-		tm.acquire ();
-		if (!_tasklist.empty ()) {
-			to_run = _tasklist.front();
-			_tasklist.pop_front ();
-		}
-		tm.release ();
-
-		if (!to_run.empty ()) {
-			to_run ();
-			continue;
-		}
-
-		if (!wait) {
-			_task_end_sem.signal ();
-		}
-
-		wait = true;
+		run_tasks ();
+		_task_end_sem.signal ();
 	}
 }
 
+/* called concurrently by the process thread and worker threads */
 void
-RTTaskList::process (TaskList const& tl)
+RTTaskList::run_tasks ()
 {
-	Glib::Threads::Mutex::Lock pm (_process_mutex);
-	Glib::Threads::Mutex::Lock tm (_tasklist_mutex, Glib::Threads::NOT_LOCK);
-
-	tm.acquire ();
-	_tasklist = tl;
-	tm.release ();
+	const gint    n  = _n_tasks;
+	const int64_t t0 = PBD::get_microseconds ();
 
-	process_tasklist ();
+	gint i;
+	while ((i = g_atomic_int_add (&_next_task, 1)) < n) {
+		_tasks[i].fn (_tasks[i].arg, _tasks[i].nframes);
+	}
 
-	tm.acquire ();
-	_tasklist.clear ();
-	tm.release ();
+	g_atomic_int_add (&_busy_usec, (gint) (PBD::get_microseconds () - t0));
 }
 
 void
-RTTaskList::process_tasklist ()
+RTTaskList::process ()
 {
-//	if (0 == g_atomic_int_get (&_threads_active) || _threads.size () == 0) {
-
-		for (TaskList::iterator i = _tasklist.begin (); i != _tasklist.end(); ++i) {
-			(*i)();
-		}
+	const size_t n = _n_tasks;
+	if (n == 0) {
 		return;
-//	}
+	}
+
+	g_atomic_int_set (&_next_task, 0);
+	g_atomic_int_set (&_busy_usec, 0);
 
-	uint32_t nt = std::min (_threads.size (), _tasklist.size ());
+	/* Wake up as many workers as the expected total cost of all
+	 * tasks justifies. Worker threads are not used (and their
+	 * wakeup latency avoided) for cheap tasks.
+	 */
+	const float expected = n * _task_cost;
+	uint32_t    nt       = 0;
+
+	if (g_atomic_int_get (&_threads_active) && expected > _min_parallel_usec) {
+		nt = std::min<size_t> (_threads.size (), n - 1);
+		nt = std::min<uint32_t> (nt, expected / _min_parallel_usec);
+	}
 
 	for (uint32_t i = 0; i < nt; ++i) {
 		_task_run_sem.signal ();
 	}
+
+	run_tasks ();
+
 	for (uint32_t i = 0; i < nt; ++i) {
 		_task_end_sem.wait ();
 	}
+
+	/* update average task cost (excluding worker wakeup latency) */
+	const float cost = g_atomic_int_get (&_busy_usec) / (float) n;
+	_task_cost += .1f * (cost - _task_cost);
+
+	_n_tasks = 0;
+}
+
+/*static*/ void
+RTTaskList::run_function (void* arg, pframes_t)
+{
+	(*static_cast<boost::function<void ()>*> (arg)) ();
+}
+
+void
+RTTaskList::process (TaskList const& tl)
+{
+	for (TaskList::const_iterator i = tl.begin (); i != tl.end (); ++i) {
+		if (!push_back (Task (&RTTaskList::run_function, const_cast<boost::function<void ()>*> (&(*i))))) {
+			(*i)();
+		}
+	}
+	process ();
 }
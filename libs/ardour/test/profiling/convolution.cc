@@ -0,0 +1,163 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "pbd/timing.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audio_buffer.h"
+#include "ardour/audioengine.h"
+#include "ardour/buffer_set.h"
+#include "ardour/chan_mapping.h"
+#include "ardour/convolver.h"
+#include "ardour/dsp_filter.h"
+#include "ardour/readable.h"
+#include "ardour/runtime_functions.h"
+#include "ardour/session.h"
+
+#include "test_ui.h"
+#include "test_util.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+/* Compare CPU usage of many long convolution reverbs, processing
+ * the late partitions using a shared pool of workers vs. using
+ * dedicated threads per instance.
+ */
+
+/* exponentially decaying noise, -60dB at the end */
+class NoiseIR : public AudioReadable
+{
+public:
+	NoiseIR (samplecnt_t len)
+		: _ir (len)
+	{
+		uint32_t rnd = 1;
+		for (samplecnt_t i = 0; i < len; ++i) {
+			rnd = rnd * 1664525 + 1013904223;
+			_ir[i] = (rnd / 4294967296.f - .5f) * expf (-6.9f * i / len);
+		}
+	}
+
+	samplecnt_t read (Sample* s, samplepos_t pos, samplecnt_t cnt, int) const {
+		cnt = std::max<samplecnt_t> (0, std::min<samplecnt_t> (cnt, _ir.size () - pos));
+		copy_vector (s, &_ir[pos], cnt);
+		return cnt;
+	}
+
+	samplecnt_t readable_length_samples () const { return _ir.size (); }
+	uint32_t n_channels () const { return 1; }
+
+private:
+	std::vector<Sample> _ir;
+};
+
+static double
+cpu_seconds ()
+{
+	struct rusage ru;
+	getrusage (RUSAGE_SELF, &ru);
+	return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec + 1e-6 * (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec);
+}
+
+static void
+bench (Session& s, boost::shared_ptr<AudioReadable> ir, uint32_t n_instances, bool shared, uint32_t cycles)
+{
+	const pframes_t n_samples = s.engine ().samples_per_cycle ();
+
+	DSP::Convolution::set_shared_workers (shared);
+
+	std::vector<DSP::Convolution*> conv;
+	for (uint32_t i = 0; i < n_instances; ++i) {
+		DSP::Convolution* c = new DSP::Convolution (s, 1, 1);
+		c->add_impdata (0, 0, ir);
+		c->restart ();
+		if (!c->ready ()) {
+			cerr << "Convolution failed to start\n";
+			exit (EXIT_FAILURE);
+		}
+		conv.push_back (c);
+	}
+
+	BufferSet bufs;
+	bufs.ensure_buffers (DataType::AUDIO, 1, n_samples);
+	ChanMapping map (ChanCount (DataType::AUDIO, 1));
+	DSP::Generator gen;
+
+	PBD::TimingStats stats;
+	double cpu = cpu_seconds ();
+
+	for (uint32_t n = 0; n < cycles; ++n) {
+		stats.start ();
+		for (std::vector<DSP::Convolution*>::const_iterator i = conv.begin (); i != conv.end (); ++i) {
+			gen.run (bufs.get_audio (0).data (), n_samples);
+			(*i)->run (bufs, map, map, n_samples, 0);
+		}
+		stats.update ();
+	}
+
+	cpu = cpu_seconds () - cpu;
+
+	for (std::vector<DSP::Convolution*>::const_iterator i = conv.begin (); i != conv.end (); ++i) {
+		delete *i;
+	}
+
+	PBD::microseconds_t min, max;
+	double avg, dev;
+	stats.get_stats (min, max, avg, dev);
+
+	const double audio_seconds = cycles * n_samples / (double) s.nominal_sample_rate ();
+
+	printf ("%2d IR %-9s process-thread: avg %8.1f max %8.1f [us/cycle]  total CPU: %6.1f%% of realtime\n",
+	        n_instances, shared ? "shared" : "dedicated", avg, (double) max, 100. * cpu / audio_seconds);
+}
+
+int
+main (int argc, char* argv[])
+{
+	float    ir_seconds = 10;
+	uint32_t cycles     = 2000;
+
+	if (argc > 1) {
+		ir_seconds = atof (argv[1]);
+	}
+	if (argc > 2) {
+		cycles = atoi (argv[2]);
+	}
+
+	if (ir_seconds <= 0 || cycles == 0) {
+		cerr << "Syntax: " << argv[0] << " [IR-length-seconds] [cycles]\n";
+		exit (EXIT_FAILURE);
+	}
+
+	ARDOUR::init (true, localedir);
+	TestUI* test_ui = new TestUI ();
+	create_and_start_dummy_backend ();
+
+	Session* session = load_session ("../libs/ardour/test/profiling/sessions/0tracks", "0tracks.ardour");
+
+	/* IR length is given for 96kHz */
+	boost::shared_ptr<AudioReadable> ir (new NoiseIR (ir_seconds * 96000));
+
+	printf ("IR: %d samples, %d samples/cycle, %d cycles\n",
+	        (int) ir->readable_length_samples (), (int) session->engine ().samples_per_cycle (), cycles);
+
+	const uint32_t instances[] = { 1, 8, 32 };
+	for (size_t i = 0; i < sizeof (instances) / sizeof (uint32_t); ++i) {
+		bench (*session, ir, instances[i], true, cycles);
+		bench (*session, ir, instances[i], false, cycles);
+	}
+
+	delete session;
+	stop_and_destroy_backend ();
+	delete test_ui;
+	ARDOUR::cleanup ();
+	return 0;
+}
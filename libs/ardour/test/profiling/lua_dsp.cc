@@ -0,0 +1,187 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "pbd/timing.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audio_buffer.h"
+#include "ardour/dsp_filter.h"
+#include "ardour/luabindings.h"
+#include "ardour/runtime_functions.h"
+
+#include "lua/luastate.h"
+#include "LuaBridge/LuaBridge.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+/* Compare per-sample lua loops, lua calls using DSP::SampleView and
+ * plain C++ for typical operations of lua DSP scripts.
+ */
+
+static const char* script =
+	"function gain_loop (buf, n, g)"
+	"  local a = buf:data (0):array ()"
+	"  for i = 1, n do a[i] = a[i] * g end"
+	"end "
+	"function gain_view (buf, n, g)"
+	"  ARDOUR.DSP.SampleView.audio_buffer (buf, 0, n):apply_gain (g)"
+	"end "
+	/* same algorithm as DSP::Biquad::run */
+	"local z1, z2 = 0, 0 "
+	"function eq_loop (buf, n, a1, a2, b0, b1, b2)"
+	"  local a = buf:data (0):array ()"
+	"  for i = 1, n do"
+	"    local x = a[i]"
+	"    local y = b0 * x + z1"
+	"    z1 = b1 * x - a1 * y + z2"
+	"    z2 = b2 * x - a2 * y"
+	"    a[i] = y"
+	"  end "
+	"end "
+	"function eq_view (buf, n, bq)"
+	"  ARDOUR.DSP.SampleView.audio_buffer (buf, 0, n):biquad (bq)"
+	"end "
+	"function analysis_loop (buf, n)"
+	"  local a = buf:data (0):array ()"
+	"  local peak, sum = 0, 0"
+	"  for i = 1, n do"
+	"    local s = a[i]"
+	"    peak = math.max (peak, math.abs (s))"
+	"    sum = sum + s * s"
+	"  end"
+	"  return peak, math.sqrt (sum / n)"
+	"end "
+	"function analysis_view (buf, n)"
+	"  local v = ARDOUR.DSP.SampleView.audio_buffer (buf, 0, n)"
+	"  return v:compute_peak (0), v:rms ()"
+	"end ";
+
+static void
+report (const char* name, PBD::microseconds_t lua_loop, PBD::microseconds_t lua_view, PBD::microseconds_t native, uint32_t cycles)
+{
+	printf ("%-10s lua-loop: %8.2f  lua-view: %8.2f  C++: %8.2f [us/cycle]\n", name,
+	        lua_loop / (double) cycles, lua_view / (double) cycles, native / (double) cycles);
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t n_samples = 1024;
+	uint32_t cycles    = 10000;
+
+	if (argc > 1) {
+		n_samples = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		cycles = atoi (argv[2]);
+	}
+
+	if (n_samples == 0 || cycles == 0) {
+		cerr << "Syntax: " << argv[0] << " [n-samples] [cycles]\n";
+		exit (EXIT_FAILURE);
+	}
+
+	ARDOUR::init (true, localedir);
+
+	LuaState lua;
+	lua_State* L = lua.getState ();
+	LuaBindings::stddef (L);
+	LuaBindings::common (L);
+	LuaBindings::dsp (L);
+	lua.tweak_rt_gc ();
+
+	if (lua.do_command (script)) {
+		cerr << "Failed to load lua script\n";
+		exit (EXIT_FAILURE);
+	}
+
+	luabridge::LuaRef gain_loop     = luabridge::getGlobal (L, "gain_loop");
+	luabridge::LuaRef gain_view     = luabridge::getGlobal (L, "gain_view");
+	luabridge::LuaRef eq_loop       = luabridge::getGlobal (L, "eq_loop");
+	luabridge::LuaRef eq_view       = luabridge::getGlobal (L, "eq_view");
+	luabridge::LuaRef analysis_loop = luabridge::getGlobal (L, "analysis_loop");
+	luabridge::LuaRef analysis_view = luabridge::getGlobal (L, "analysis_view");
+
+	AudioBuffer buf (n_samples);
+	DSP::Generator gen;
+	gen.run (buf.data (), n_samples);
+
+	/* 2nd order low-pass, 1kHz @ 48kHz, Q = 0.707 */
+	const double a1 = -1.815318, a2 = 0.830982;
+	const double b0 = 0.003916, b1 = 0.007832, b2 = 0.003916;
+	DSP::Biquad bq (48000);
+	bq.configure (a1, a2, b0, b1, b2);
+
+	PBD::microseconds_t t0, t1, t2, t3;
+
+	/* gain, alternate between +/- 0.1dB to keep the signal in range */
+	t0 = PBD::get_microseconds ();
+	for (uint32_t c = 0; c < cycles; ++c) {
+		gain_loop (&buf, n_samples, (c & 1) ? 1.0116f : 0.9886f);
+		lua.collect_garbage_step ();
+	}
+	t1 = PBD::get_microseconds ();
+	for (uint32_t c = 0; c < cycles; ++c) {
+		gain_view (&buf, n_samples, (c & 1) ? 1.0116f : 0.9886f);
+		lua.collect_garbage_step ();
+	}
+	t2 = PBD::get_microseconds ();
+	for (uint32_t c = 0; c < cycles; ++c) {
+		apply_gain_to_buffer (buf.data (), n_samples, (c & 1) ? 1.0116f : 0.9886f);
+	}
+	t3 = PBD::get_microseconds ();
+	report ("gain", t1 - t0, t2 - t1, t3 - t2, cycles);
+
+	/* EQ */
+	t0 = PBD::get_microseconds ();
+	for (uint32_t c = 0; c < cycles; ++c) {
+		gen.run (buf.data (), n_samples);
+		eq_loop (&buf, n_samples, a1, a2, b0, b1, b2);
+		lua.collect_garbage_step ();
+	}
+	t1 = PBD::get_microseconds ();
+	for (uint32_t c = 0; c < cycles; ++c) {
+		gen.run (buf.data (), n_samples);
+		eq_view (&buf, n_samples, &bq);
+		lua.collect_garbage_step ();
+	}
+	t2 = PBD::get_microseconds ();
+	for (uint32_t c = 0; c < cycles; ++c) {
+		gen.run (buf.data (), n_samples);
+		bq.run (buf.data (), n_samples);
+	}
+	t3 = PBD::get_microseconds ();
+	report ("EQ", t1 - t0, t2 - t1, t3 - t2, cycles);
+
+	/* analysis: peak and RMS */
+	gen.run (buf.data (), n_samples);
+	t0 = PBD::get_microseconds ();
+	for (uint32_t c = 0; c < cycles; ++c) {
+		analysis_loop (&buf, n_samples);
+		lua.collect_garbage_step ();
+	}
+	t1 = PBD::get_microseconds ();
+	for (uint32_t c = 0; c < cycles; ++c) {
+		analysis_view (&buf, n_samples);
+		lua.collect_garbage_step ();
+	}
+	t2 = PBD::get_microseconds ();
+	float peak = 0;
+	for (uint32_t c = 0; c < cycles; ++c) {
+		peak = compute_peak (buf.data (), n_samples, 0);
+		DSP::SampleView (buf.data (), n_samples).rms ();
+	}
+	t3 = PBD::get_microseconds ();
+	report ("analysis", t1 - t0, t2 - t1, t3 - t2, cycles);
+
+	if (peak < 0) {
+		cerr << "invalid peak\n";
+	}
+
+	ARDOUR::cleanup ();
+	return 0;
+}
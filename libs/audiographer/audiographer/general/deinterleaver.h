@@ -6,6 +6,7 @@
 #include "audiographer/source.h"
 #include "audiographer/sink.h"
 #include "audiographer/exception.h"
+#include "audiographer/type_utils.h"
 #include "audiographer/utils/identity_vertex.h"
 
 #include <vector>
@@ -40,10 +41,11 @@ class /*LIBAUDIOGRAPHER_API*/ DeInterleaver
 		reset();
 		channels = num_channels;
 		max_samples = max_samples_per_channel;
-		buffer = new T[max_samples];
+		buffer = new T[channels * max_samples];
 
 		for (unsigned int i = 0; i < channels; ++i) {
 			outputs.push_back (OutputPtr (new IdentityVertex<T>));
+			buffer_ptrs.push_back (&buffer[i * max_samples]);
 		}
 	}
 
@@ -73,15 +75,14 @@ class /*LIBAUDIOGRAPHER_API*/ DeInterleaver
 			throw Exception (*this, "too many samples given to process()");
 		}
 
+		/* Deinterleave all channels at once */
+		TypeUtils<T>::deinterleave (data, &buffer_ptrs[0], channels, samples_per_channel);
+
 		unsigned int channel = 0;
 		for (typename std::vector<OutputPtr>::iterator it = outputs.begin(); it != outputs.end(); ++it, ++channel) {
 			if (!*it) { continue; }
 
-			for (unsigned int i = 0; i < samples_per_channel; ++i) {
-				buffer[i] = data[channel + (channels * i)];
-			}
-
-			ProcessContext<T> c_out (c, buffer, samples_per_channel, 1);
+			ProcessContext<T> c_out (c, buffer_ptrs[channel], samples_per_channel, 1);
 			(*it)->process (c_out);
 		}
 	}
@@ -93,6 +94,7 @@ class /*LIBAUDIOGRAPHER_API*/ DeInterleaver
 	void reset ()
 	{
 		outputs.clear();
+		buffer_ptrs.clear();
 		delete [] buffer;
 		buffer = 0;
 		channels = 0;
@@ -100,6 +102,7 @@ class /*LIBAUDIOGRAPHER_API*/ DeInterleaver
 	}
 
 	std::vector<OutputPtr> outputs;
+	std::vector<T *> buffer_ptrs;
 	unsigned int channels;
 	samplecnt_t max_samples;
 	T * buffer;
@@ -6,6 +6,7 @@
 #include "audiographer/sink.h"
 #include "audiographer/exception.h"
 #include "audiographer/throwing.h"
+#include "audiographer/type_utils.h"
 #include "audiographer/utils/listed_source.h"
 
 #include <vector>
@@ -27,6 +28,7 @@ class /*LIBAUDIOGRAPHER_API*/ Interleaver
 	  : channels (0)
 	  , max_samples (0)
 	  , buffer (0)
+	  , planar (0)
 	{}
 
 	~Interleaver() { reset(); }
@@ -39,9 +41,11 @@ class /*LIBAUDIOGRAPHER_API*/ Interleaver
 		max_samples = max_samples_per_channel;
 
 		buffer = new T[channels * max_samples];
+		planar = new T[channels * max_samples];
 
 		for (unsigned int i = 0; i < channels; ++i) {
 			inputs.push_back (InputPtr (new Input (*this, i)));
+			planar_ptrs.push_back (&planar[i * max_samples]);
 		}
 	}
 
@@ -91,8 +95,11 @@ class /*LIBAUDIOGRAPHER_API*/ Interleaver
 	void reset ()
 	{
 		inputs.clear();
+		planar_ptrs.clear();
 		delete [] buffer;
+		delete [] planar;
 		buffer = 0;
+		planar = 0;
 		channels = 0;
 		max_samples = 0;
 	}
@@ -112,12 +119,14 @@ class /*LIBAUDIOGRAPHER_API*/ Interleaver
 			throw Exception (*this, "Too many samples given to an input");
 		}
 
-		for (unsigned int i = 0; i < c.samples(); ++i) {
-			buffer[channel + (channels * i)] = c.data()[i];
-		}
+		/* Collect the channels, and interleave them all at once
+		 * when the last one arrives.
+		 */
+		TypeUtils<T>::copy (c.data(), &planar[channel * max_samples], c.samples());
 
 		samplecnt_t const ready_samples = ready_to_output();
 		if (ready_samples) {
+			TypeUtils<T>::interleave (&planar_ptrs[0], buffer, channels, ready_samples / channels);
 			ProcessContext<T> c_out (c, buffer, ready_samples, channels);
 			ListedSource<T>::output (c_out);
 			reset_channels ();
@@ -143,9 +152,12 @@ class /*LIBAUDIOGRAPHER_API*/ Interleaver
 	typedef boost::shared_ptr<Input> InputPtr;
 	std::vector<InputPtr> inputs;
 
+	std::vector<T const *> planar_ptrs;
+
 	unsigned int channels;
 	samplecnt_t max_samples;
 	T * buffer;
+	T * planar;
 };
 
 } // namespace
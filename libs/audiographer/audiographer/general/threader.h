@@ -1,16 +1,17 @@
 #ifndef AUDIOGRAPHER_THREADER_H
 #define AUDIOGRAPHER_THREADER_H
 
-#include <glibmm/threadpool.h>
-#include <glibmm/timeval.h>
-#include <sigc++/slot.h>
+#include <glibmm/threads.h>
 #include <boost/format.hpp>
 
 #include <glib.h>
+#include <pthread.h>
 #include <vector>
 #include <algorithm>
 
 #include "pbd/g_atomic_compat.h"
+#include "pbd/mpmc_queue.h"
+#include "pbd/semutils.h"
 
 #include "audiographer/visibility.h"
 #include "audiographer/source.h"
@@ -33,99 +34,333 @@ class /*LIBAUDIOGRAPHER_API*/ ThreaderException : public Exception
 	{ }
 };
 
-/// Class for distributing processing across several threads
+/** A persistent set of worker threads, shared by Threaders.
+  *
+  * Tasks are handed to the workers using a lock-free queue of fixed size.
+  * Idle workers spin briefly before blocking on a semaphore.
+  */
+class LIBAUDIOGRAPHER_API ThreaderPool
+{
+  public:
+	struct Task {
+		Task () : run (0), arg (0), index (0) {}
+		Task (void (*r)(void*, unsigned int), void* a, unsigned int i) : run (r), arg (a), index (i) {}
+
+		void (*run)(void*, unsigned int);
+		void*        arg;
+		unsigned int index;
+	};
+
+	/** Constructor
+	  * \param n_workers number of threads to start
+	  * \param max_tasks number of tasks that can be queued at the same time
+	  */
+	ThreaderPool (unsigned int n_workers, unsigned int max_tasks = 1024);
+
+	/// Completes all queued tasks, then stops all workers
+	~ThreaderPool ();
+
+	unsigned int n_workers () const { return _workers.size (); }
+
+	/** Reserve space for \a n tasks that may be queued at the same time.
+	  * \return false if the queue is too small for all reservations,
+	  * some tasks will then be run inline (see push())
+	  * \n RT safe
+	  */
+	bool reserve (unsigned int n);
+
+	/// Release space reserved with reserve() \n RT safe
+	void release (unsigned int n);
+
+	/** Queue a task
+	  * \return false if the task was not queued, because there are no
+	  * workers or the queue is full. The caller then runs the task itself.
+	  * \n RT safe
+	  */
+	bool push (Task const &);
+
+  private:
+	static void* _run (void*);
+	void run ();
+
+	std::vector<pthread_t>  _workers;
+	PBD::MPMCQueue<Task>    _queue;
+	PBD::Semaphore          _sem;
+	gint                    _capacity;
+	GATOMIC_QUAL gint       _reserved;
+	GATOMIC_QUAL gint       _queued;
+	GATOMIC_QUAL gint       _idle;
+	GATOMIC_QUAL gint       _terminate;
+};
+
+/** Class for distributing processing across several threads
+  *
+  * Every output is processed by a worker of a ThreaderPool.
+  * Chunks are processed in order for each output, but different
+  * outputs may work on different chunks at the same time.
+  *
+  * With a \a max_chunks_in_flight > 1, process() copies the data and
+  * returns as soon as the chunk is queued, as long as no more than the
+  * given number of chunks are being processed. All outputs are always
+  * synchronized at the end of input (ProcessContext::EndOfInput).
+  */
 template <typename T = DefaultSampleType>
 class /*LIBAUDIOGRAPHER_API*/ Threader : public Source<T>, public Sink<T>
 {
   private:
 	typedef std::vector<typename Source<T>::SinkPtr> OutputVec;
 
+	struct Chunk {
+		Chunk () : samples (0), channels (0), pending (0) {}
+		std::vector<T>    data;
+		samplecnt_t       samples;
+		ChannelCount      channels;
+		FlagField         flags;
+		GATOMIC_QUAL gint pending;
+	};
+
+	struct OutputState {
+		OutputState () : read_pos (0), scheduled (0) {}
+		guint             read_pos;
+		GATOMIC_QUAL gint scheduled;
+	};
+
   public:
 
 	/** Constructor
 	  * \n RT safe
 	  * \param thread_pool a thread pool from which all tasks are scheduled
-	  * \param wait_timeout_milliseconds maximum time allowed for threads to use in processing
+	  * \param max_chunks_in_flight number of chunks that may be queued before process() blocks,
+	  *        1 to return only after all outputs have processed the chunk.
 	  */
-	Threader (Glib::ThreadPool & thread_pool, long wait_timeout_milliseconds = 500)
+	Threader (ThreaderPool & thread_pool, unsigned int max_chunks_in_flight = 1)
 	  : thread_pool (thread_pool)
-	  , wait_timeout (wait_timeout_milliseconds)
+	  , chunks (std::max (1U, max_chunks_in_flight))
+	  , write_pos (0)
 	{
-		g_atomic_int_set (&readers, 0);
+		g_atomic_int_set (&in_flight, 0);
+		g_atomic_int_set (&tasks, 0);
+		g_atomic_int_set (&waiters, 0);
 	}
 
-	virtual ~Threader () {}
+	virtual ~Threader ()
+	{
+		wait (0, true);
+		thread_pool.release (outputs.size ());
+	}
 
-	/// Adds output \n RT safe
-	void add_output (typename Source<T>::SinkPtr output) { outputs.push_back (output); }
+	/// Adds output \n Not RT safe
+	void add_output (typename Source<T>::SinkPtr output)
+	{
+		wait (0, true);
+		outputs.push_back (output);
+		state.resize (outputs.size ());
+		/* every output has at most one task queued */
+		thread_pool.reserve (1);
+	}
 
 	/// Clears outputs \n RT safe
-	void clear_outputs () { outputs.clear (); }
+	void clear_outputs ()
+	{
+		wait (0, true);
+		thread_pool.release (outputs.size ());
+		outputs.clear ();
+		state.clear ();
+	}
 
 	/// Removes a specific output \n RT safe
 	void remove_output (typename Source<T>::SinkPtr output) {
+		wait (0, true);
 		typename OutputVec::iterator new_end = std::remove(outputs.begin(), outputs.end(), output);
+		thread_pool.release (outputs.end () - new_end);
 		outputs.erase (new_end, outputs.end());
+		state.resize (outputs.size ());
+	}
+
+	/// Wait until all outputs have processed all queued chunks, rethrows exceptions from outputs
+	void flush ()
+	{
+		wait (0, true);
+		rethrow ();
 	}
 
-	/// Processes context concurrently by scheduling each output separately to the given thread pool
+	/// Queues the context to be processed by all outputs
 	void process (ProcessContext<T> const & c)
 	{
-		wait_mutex.lock();
+		rethrow ();
+
+		unsigned int const outs = outputs.size ();
+		if (outs == 0) {
+			return;
+		}
 
-		exception.reset();
+		/* at most chunks.size () - 1 chunks are in flight, so the next slot is available */
+		Chunk& chunk (chunks[(guint) g_atomic_int_get (&write_pos) % chunks.size ()]);
+		assert (g_atomic_int_get (&chunk.pending) == 0);
+
+		samplecnt_t const n = c.samples ();
+		if (chunk.data.size () < (size_t) std::max<samplecnt_t> (1, n)) {
+			chunk.data.resize (std::max<samplecnt_t> (1, n));
+		}
+		TypeUtils<T>::copy (c.data (), &chunk.data[0], n);
+		chunk.samples  = n;
+		chunk.channels = c.channels ();
+		chunk.flags    = c.flags ();
+		g_atomic_int_set (&chunk.pending, outs);
+		g_atomic_int_inc (&in_flight);
+
+		/* publish */
+		g_atomic_int_set (&write_pos, g_atomic_int_get (&write_pos) + 1);
 
-		unsigned int outs = outputs.size();
-		g_atomic_int_add (&readers, outs);
 		for (unsigned int i = 0; i < outs; ++i) {
-			thread_pool.push (sigc::bind (sigc::mem_fun (this, &Threader::process_output), c, i));
+			if (g_atomic_int_compare_and_exchange (&state[i].scheduled, 0, 1)) {
+				g_atomic_int_inc (&tasks);
+				if (!thread_pool.push (ThreaderPool::Task (&Threader::_process_output, this, i))) {
+					process_output (i);
+				}
+			}
 		}
 
-		wait();
+		if (c.has_flag (ProcessContext<T>::EndOfInput)) {
+			wait (0, true);
+		} else {
+			wait (chunks.size () - 1, false);
+		}
+
+		rethrow ();
 	}
 
 	using Sink<T>::process;
 
   private:
 
-	void wait()
+	/** Wait until no more than \a max_in_flight chunks are being processed.
+	  * if \a all_tasks is set, also wait until all tasks have finished.
+	  * Spins briefly before blocking.
+	  */
+	void wait (unsigned int max_in_flight, bool all_tasks)
 	{
-		while (g_atomic_int_get (&readers) != 0) {
-			gint64 end_time = g_get_monotonic_time () + (wait_timeout * G_TIME_SPAN_MILLISECOND);
-			wait_cond.wait_until(wait_mutex, end_time);
+		for (int spin = 0; spin < 1000; ++spin) {
+			if (done (max_in_flight, all_tasks)) {
+				if (all_tasks) {
+					/* a finishing task may still hold the lock, see process_output() */
+					Glib::Threads::Mutex::Lock lm (wait_mutex);
+				}
+				return;
+			}
 		}
 
-		wait_mutex.unlock();
+		Glib::Threads::Mutex::Lock lm (wait_mutex);
+		g_atomic_int_inc (&waiters);
+		while (!done (max_in_flight, all_tasks)) {
+			wait_cond.wait (wait_mutex);
+		}
+		g_atomic_int_add (&waiters, -1);
+	}
 
-		if (exception) {
-			throw *exception;
+	bool done (unsigned int max_in_flight, bool all_tasks) const
+	{
+		if ((unsigned int) g_atomic_int_get (&in_flight) > max_in_flight) {
+			return false;
 		}
+		return !all_tasks || g_atomic_int_get (&tasks) == 0;
 	}
 
-	void process_output(ProcessContext<T> const & c, unsigned int output)
+	/** Wake up wait(), if it is blocking.
+	  * Called after in_flight or tasks were updated; wait() registers
+	  * itself before checking them, so either it sees the update, or
+	  * this sees the waiter.
+	  */
+	void signal ()
 	{
-		try {
-			outputs[output]->process (c);
-		} catch (std::exception const & e) {
-			// Only first exception will be passed on
-			exception_mutex.lock();
-			if(!exception) { exception.reset (new ThreaderException (*this, e)); }
-			exception_mutex.unlock();
+		if (g_atomic_int_get (&waiters) == 0) {
+			return;
 		}
+		Glib::Threads::Mutex::Lock lm (wait_mutex);
+		wait_cond.signal ();
+	}
 
-		if (g_atomic_int_dec_and_test (&readers)) {
-			wait_cond.signal();
+	void rethrow ()
+	{
+		boost::shared_ptr<ThreaderException> e;
+		exception_mutex.lock();
+		e = exception;
+		exception_mutex.unlock();
+
+		if (!e) {
+			return;
+		}
+
+		wait (0, true);
+		exception.reset ();
+		throw *e;
+	}
+
+	static void _process_output (void* arg, unsigned int output)
+	{
+		static_cast<Threader*> (arg)->process_output (output);
+	}
+
+	void process_output (unsigned int output)
+	{
+		OutputState& s (state[output]);
+
+		while (true) {
+			while (s.read_pos != (guint) g_atomic_int_get (&write_pos)) {
+				Chunk& chunk (chunks[s.read_pos % chunks.size ()]);
+				ProcessContext<T> c (&chunk.data[0], chunk.samples, chunk.channels);
+				for (FlagField::iterator f = chunk.flags.begin (); f != chunk.flags.end (); ++f) {
+					c.set_flag (*f);
+				}
+				try {
+					outputs[output]->process (c);
+				} catch (std::exception const & e) {
+					// Only first exception will be passed on
+					exception_mutex.lock();
+					if(!exception) { exception.reset (new ThreaderException (*this, e)); }
+					exception_mutex.unlock();
+				}
+				++s.read_pos;
+				if (g_atomic_int_dec_and_test (&chunk.pending)) {
+					g_atomic_int_add (&in_flight, -1);
+					signal ();
+				}
+			}
+
+			/* once unscheduled, another task may take over this output */
+			guint const read_pos = s.read_pos;
+			g_atomic_int_set (&s.scheduled, 0);
+
+			/* a chunk may have been published after the last check,
+			 * while this output was still scheduled.
+			 */
+			if (read_pos == (guint) g_atomic_int_get (&write_pos)
+			    || !g_atomic_int_compare_and_exchange (&s.scheduled, 0, 1)) {
+				break;
+			}
 		}
+
+		/* the Threader may be destroyed as soon as the last task is done,
+		 * so this is done with the lock held, which wait() acquires.
+		 * This happens once per task, not per chunk.
+		 */
+		Glib::Threads::Mutex::Lock lm (wait_mutex);
+		g_atomic_int_add (&tasks, -1);
+		wait_cond.signal ();
 	}
 
-	OutputVec outputs;
+	OutputVec                outputs;
+	std::vector<OutputState> state;
 
-	Glib::ThreadPool&    thread_pool;
-	Glib::Threads::Mutex wait_mutex;
-	Glib::Threads::Cond  wait_cond;
+	ThreaderPool&            thread_pool;
+	std::vector<Chunk>       chunks;
+	GATOMIC_QUAL gint        write_pos;
+	GATOMIC_QUAL gint        in_flight;
+	GATOMIC_QUAL gint        tasks;
+	GATOMIC_QUAL gint        waiters;
 
-	GATOMIC_QUAL gint readers;
-	long         wait_timeout;
+	Glib::Threads::Mutex     wait_mutex;
+	Glib::Threads::Cond      wait_cond;
 
 	Glib::Threads::Mutex exception_mutex;
 	boost::shared_ptr<ThreaderException> exception;
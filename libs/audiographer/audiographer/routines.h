@@ -45,6 +45,24 @@ class LIBAUDIOGRAPHER_API Routines
 		(*_apply_gain_to_buffer) (data, samples, gain);
 	}
 
+	/** Interleaves non-interleaved channel data
+	 * \n RT safe
+	 * \param src array of \a channels pointers to the channel data
+	 * \param dst destination, must hold \a samples * \a channels values
+	 * \param channels number of channels
+	 * \param samples number of samples per channel
+	 */
+	static void interleave (float const * const * src, float * dst, uint_type channels, uint_type samples);
+
+	/** Deinterleaves interleaved data
+	 * \n RT safe
+	 * \param src interleaved data, \a samples * \a channels values
+	 * \param dst array of \a channels pointers to the destination of each channel
+	 * \param channels number of channels
+	 * \param samples number of samples per channel
+	 */
+	static void deinterleave (float const * src, float * const * dst, uint_type channels, uint_type samples);
+
   private:
 	static inline float default_compute_peak (float const * data, uint_type samples, float current_peak)
 	{
@@ -0,0 +1,149 @@
+#ifndef AUDIOGRAPHER_TMP_FILE_MEM_H
+#define AUDIOGRAPHER_TMP_FILE_MEM_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include <glibmm/threads.h>
+#include <boost/shared_ptr.hpp>
+
+#include "audiographer/visibility.h"
+
+#include "sndfile_writer.h"
+#include "sndfile_reader.h"
+#include "tmp_file.h"
+
+namespace AudioGrapher
+{
+
+/** Memory budget, that can be shared by several TmpFileStores */
+class LIBAUDIOGRAPHER_API TmpFileBudget
+{
+  public:
+	/** Constructor
+	  * \param bytes total number of bytes that may be kept in memory
+	  */
+	TmpFileBudget (uint64_t bytes) : _available (bytes) {}
+
+	/// reserve memory, \return false if the budget is exhausted
+	bool acquire (uint64_t bytes);
+	/// return memory that was reserved using acquire()
+	void release (uint64_t bytes);
+
+	uint64_t available () const;
+
+  private:
+	mutable Glib::Threads::Mutex _lock;
+	uint64_t                     _available;
+};
+
+/** Backing store of a TmpFileMem.
+  *
+  * Data is kept in memory as long as the budget allows. Data beyond
+  * that is spilled to a temporary file, which is deleted
+  * when the store is destroyed.
+  */
+class LIBAUDIOGRAPHER_API TmpFileStore
+{
+  public:
+	/** Constructor
+	  * \param budget max. number of bytes to keep in memory
+	  * \param spill_template path of the file to use when exceeding the budget,
+	  *        must match the requirements for mkstemp, i.e. end in "XXXXXX"
+	  */
+	TmpFileStore (size_t budget, std::string const & spill_template);
+	/** Constructor
+	  * \param budget memory budget, shared with other stores
+	  * \param spill_template see above
+	  */
+	TmpFileStore (boost::shared_ptr<TmpFileBudget> budget, std::string const & spill_template);
+	~TmpFileStore ();
+
+	static SF_VIRTUAL_IO& virtual_io ();
+
+	/// Total number of bytes stored
+	sf_count_t length () const { return _length; }
+	/// Number of bytes that are held in memory
+	size_t memory_used () const { return _blocks.size () * block_size; }
+	/// True if the budget was exceeded, and a file was used
+	bool spilled () const { return _spill != 0; }
+
+  private:
+	TmpFileStore (TmpFileStore const &);
+
+	static const size_t block_size = 1 << 20;
+
+	static sf_count_t _get_filelen (void*);
+	static sf_count_t _seek (sf_count_t, int, void*);
+	static sf_count_t _read (void*, sf_count_t, void*);
+	static sf_count_t _write (const void*, sf_count_t, void*);
+	static sf_count_t _tell (void*);
+
+	sf_count_t seek (sf_count_t, int);
+	sf_count_t read (void*, sf_count_t);
+	sf_count_t write (const void*, sf_count_t);
+
+	bool open_spill ();
+	bool seek_spill (sf_count_t, bool write);
+
+	boost::shared_ptr<TmpFileBudget> _budget;
+
+	std::vector<char*> _blocks;
+	sf_count_t         _mem_size; ///< bytes at the start that are kept in memory
+	sf_count_t         _length;
+	sf_count_t         _pos;
+
+	std::string        _spill_path;
+	FILE*              _spill;
+	bool               _spill_write; ///< last access to _spill was a write
+};
+
+/** A temporary file that is kept in memory, as long as
+  * it fits into a given budget.
+  */
+template<typename T = DefaultSampleType>
+class TmpFileMem
+	: public TmpFile<T>
+{
+  public:
+
+	/** Constructor
+	  * \param store backing store, ownership is transferred
+	  */
+	TmpFileMem (TmpFileStore* store, int format, ChannelCount channels, samplecnt_t samplerate)
+		: SndfileHandle (TmpFileStore::virtual_io (), store, SndfileBase::ReadWrite, format, channels, samplerate)
+		, _store (store)
+	{}
+
+	~TmpFileMem()
+	{
+		/* libsndfile may still access the store when closing */
+		SndfileBase::close();
+		delete _store;
+	}
+
+	void process (ProcessContext<T> const & c)
+	{
+		SndfileWriter<T>::process (c);
+
+		if (c.has_flag(ProcessContext<T>::EndOfInput)) {
+			TmpFile<T>::FileFlushed ();
+		}
+	}
+
+	using Sink<T>::process;
+
+	TmpFileStore const& store () const { return *_store; }
+
+  private:
+	TmpFileMem (TmpFileMem const & other);
+
+	TmpFileStore* _store;
+};
+
+} // namespace
+
+#endif // AUDIOGRAPHER_TMP_FILE_MEM_H
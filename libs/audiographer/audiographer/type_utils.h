@@ -9,6 +9,7 @@
 
 #include "audiographer/visibility.h"
 #include "audiographer/types.h"
+#include "audiographer/routines.h"
 
 namespace AudioGrapher
 {
@@ -64,8 +65,48 @@ class /*LIBAUDIOGRAPHER_API*/ TypeUtils : private TypeUtilsBase
 			std::copy_backward (source, &source[samples], destination + samples);
 		}
 	}
+
+	/** Interleaves \a samples frames of each of the \a channels buffers in \a source
+	  * into \a destination.
+	  * \n RT safe
+	  */
+	inline static void interleave (T const * const * source, T * destination, unsigned int channels, samplecnt_t samples)
+	{
+		for (samplecnt_t i = 0; i < samples; ++i) {
+			for (unsigned int c = 0; c < channels; ++c) {
+				destination[i * channels + c] = source[c][i];
+			}
+		}
+	}
+
+	/** Deinterleaves \a samples frames of \a channels channels from \a source
+	  * into the \a channels buffers in \a destination.
+	  * \n RT safe
+	  */
+	inline static void deinterleave (T const * source, T * const * destination, unsigned int channels, samplecnt_t samples)
+	{
+		for (samplecnt_t i = 0; i < samples; ++i) {
+			for (unsigned int c = 0; c < channels; ++c) {
+				destination[c][i] = source[i * channels + c];
+			}
+		}
+	}
 };
 
+/* floats use the vectorized routines */
+
+template<>
+inline void TypeUtils<float>::interleave (float const * const * source, float * destination, unsigned int channels, samplecnt_t samples)
+{
+	Routines::interleave (source, destination, channels, samples);
+}
+
+template<>
+inline void TypeUtils<float>::deinterleave (float const * source, float * const * destination, unsigned int channels, samplecnt_t samples)
+{
+	Routines::deinterleave (source, destination, channels, samples);
+}
+
 
 } // namespace
 
@@ -61,14 +61,293 @@ static const float shaped_bs[] = { 2.033f, -2.165f, 1.959f, -1.590f, 0.6149f };
 #define MIN_S24  -8388608
 #define SCALE_S24 8388608.0f
 
-inline static float gdither_noise ()
+#define GDITHER_RND_SEED 23232323
+#define GDITHER_RND_A    196314165U
+#define GDITHER_RND_C    907633515U
+
+inline static float gdither_noise (uint32_t *rnd)
+{
+	*rnd = (*rnd * GDITHER_RND_A) + GDITHER_RND_C;
+
+	return *rnd * 2.3283064365387e-10f;
+}
+
+/* Vectorized inner loop for the common integer formats.
+ *
+ * This produces the same output as the scalar loop below, bit for bit,
+ * including the noise sequence: four consecutive states of the noise
+ * generator are kept in a vector, and advanced four steps at once.
+ * Noise-shaping feeds back the quantization error of every sample and
+ * is left to the scalar loop.
+ */
+#if defined(__x86_64__) || defined(_M_X64)
+# include <emmintrin.h>
+# define GDITHER_VEC
+#elif defined(__aarch64__) || defined(_M_ARM64)
+# include <arm_neon.h>
+# define GDITHER_VEC
+#endif
+
+#ifdef GDITHER_VEC
+
+/* rnd[n+4] = A4 * rnd[n] + C4 */
+static const uint32_t GDITHER_RND_A4 = GDITHER_RND_A * GDITHER_RND_A * GDITHER_RND_A * GDITHER_RND_A;
+static const uint32_t GDITHER_RND_C4 = GDITHER_RND_C * (GDITHER_RND_A * GDITHER_RND_A * GDITHER_RND_A
+                                                        + GDITHER_RND_A * GDITHER_RND_A + GDITHER_RND_A + 1U);
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+static inline __m128i gdither_mullo_epi32 (__m128i a, __m128i b)
+{
+    /* SSE2 lacks pmulld */
+    const __m128i even = _mm_mul_epu32 (a, b);
+    const __m128i odd  = _mm_mul_epu32 (_mm_srli_epi64 (a, 32), _mm_srli_epi64 (b, 32));
+    return _mm_unpacklo_epi32 (_mm_shuffle_epi32 (even, _MM_SHUFFLE (0, 0, 2, 0)),
+                               _mm_shuffle_epi32 (odd, _MM_SHUFFLE (0, 0, 2, 0)));
+}
+
+static inline __m128 gdither_noise4 (__m128i rnd)
+{
+    /* uint32 -> float, rounded once like the scalar conversion */
+    const __m128 hi = _mm_cvtepi32_ps (_mm_srli_epi32 (rnd, 16));
+    const __m128 lo = _mm_cvtepi32_ps (_mm_and_si128 (rnd, _mm_set1_epi32 (0xffff)));
+    return _mm_mul_ps (_mm_add_ps (_mm_mul_ps (hi, _mm_set1_ps (65536.0f)), lo),
+                       _mm_set1_ps (2.3283064365387e-10f));
+}
+
+inline static uint32_t gdither_innner_loop_vec(const GDitherType dt,
+    const uint32_t stride, const float bias, const float scale,
+    const int bit_depth, const uint32_t channel, const uint32_t length,
+    float *ts, uint32_t *rnd, float const *x, void *y, const int clamp_u,
+    const int clamp_l)
+{
+    const uint32_t n = length & ~3U;
+    int16_t *o16 = (int16_t*) y;
+    int32_t *o32 = (int32_t*) y;
+    uint32_t pos, i;
+
+    const __m128 vscale = _mm_set1_ps (scale);
+    const __m128 vbias  = _mm_set1_ps (bias);
+    const __m128 vu     = _mm_set1_ps ((float) clamp_u);
+    const __m128 vl     = _mm_set1_ps ((float) clamp_l);
+    const __m128 vhalf  = _mm_set1_ps (0.5f);
+    const __m128 vabs   = _mm_castsi128_ps (_mm_set1_epi32 (0x7fffffff));
+    const __m128 vlim   = _mm_set1_ps (9223372036854775808.0f); /* 2^63 */
+    const __m128i va4   = _mm_set1_epi32 ((int) GDITHER_RND_A4);
+    const __m128i vc4   = _mm_set1_epi32 ((int) GDITHER_RND_C4);
+
+    __m128i vrnd = _mm_setzero_si128 ();
+    __m128i last = vrnd;
+    __m128  vts  = _mm_setzero_ps ();
+
+    if (n == 0) {
+	return 0;
+    }
+
+    if (dt == GDitherRect || dt == GDitherTri) {
+	uint32_t r0 = *rnd * GDITHER_RND_A + GDITHER_RND_C;
+	uint32_t r1 = r0 * GDITHER_RND_A + GDITHER_RND_C;
+	uint32_t r2 = r1 * GDITHER_RND_A + GDITHER_RND_C;
+	uint32_t r3 = r2 * GDITHER_RND_A + GDITHER_RND_C;
+	vrnd = _mm_setr_epi32 ((int) r0, (int) r1, (int) r2, (int) r3);
+    }
+    if (dt == GDitherTri) {
+	vts = _mm_set1_ps (ts[channel]);
+    }
+
+    i = channel;
+    for (pos = 0; pos < n; pos += 4, i += 4 * stride) {
+	__m128 tmp;
+	__m128i out;
+
+	if (stride == 1) {
+	    tmp = _mm_loadu_ps (x + i);
+	} else {
+	    tmp = _mm_setr_ps (x[i], x[i + stride], x[i + 2 * stride], x[i + 3 * stride]);
+	}
+	tmp = _mm_add_ps (_mm_mul_ps (tmp, vscale), vbias);
+
+	switch (dt) {
+	case GDitherRect:
+	    tmp = _mm_sub_ps (tmp, gdither_noise4 (vrnd));
+	    break;
+	case GDitherTri:
+	    {
+		const __m128 r    = _mm_sub_ps (gdither_noise4 (vrnd), vhalf);
+		const __m128 prev = _mm_move_ss (_mm_shuffle_ps (r, r, _MM_SHUFFLE (2, 1, 0, 0)), vts);
+		tmp = _mm_sub_ps (tmp, _mm_sub_ps (r, prev));
+		vts = _mm_shuffle_ps (r, r, _MM_SHUFFLE (3, 3, 3, 3));
+	    }
+	    break;
+	default:
+	    break;
+	}
+
+	if (dt == GDitherRect || dt == GDitherTri) {
+	    last = vrnd;
+	    vrnd = _mm_add_epi32 (gdither_mullo_epi32 (vrnd, va4), vc4);
+	}
+
+	/* clamp before rounding. lrintf() returns the "integer indefinite"
+	 * value for NaN and for anything out of int64 range, which the
+	 * scalar code then clamps to clamp_l.
+	 */
+	{
+	    const __m128 ovf = _mm_cmpnlt_ps (_mm_and_ps (tmp, vabs), vlim);
+	    tmp = _mm_min_ps (_mm_max_ps (tmp, vl), vu);
+	    tmp = _mm_or_ps (_mm_and_ps (ovf, vl), _mm_andnot_ps (ovf, tmp));
+	}
+	out = _mm_cvtps_epi32 (tmp);
+
+	if (bit_depth == 16) {
+	    out = _mm_packs_epi32 (out, out);
+	    if (stride == 1) {
+		_mm_storel_epi64 ((__m128i*) (o16 + i), out);
+	    } else {
+		o16[i]              = (int16_t) _mm_extract_epi16 (out, 0);
+		o16[i + stride]     = (int16_t) _mm_extract_epi16 (out, 1);
+		o16[i + 2 * stride] = (int16_t) _mm_extract_epi16 (out, 2);
+		o16[i + 3 * stride] = (int16_t) _mm_extract_epi16 (out, 3);
+	    }
+	} else {
+	    out = _mm_slli_epi32 (out, 8);
+	    if (stride == 1) {
+		_mm_storeu_si128 ((__m128i*) (o32 + i), out);
+	    } else {
+		o32[i]              = _mm_cvtsi128_si32 (out);
+		o32[i + stride]     = _mm_cvtsi128_si32 (_mm_shuffle_epi32 (out, _MM_SHUFFLE (1, 1, 1, 1)));
+		o32[i + 2 * stride] = _mm_cvtsi128_si32 (_mm_shuffle_epi32 (out, _MM_SHUFFLE (2, 2, 2, 2)));
+		o32[i + 3 * stride] = _mm_cvtsi128_si32 (_mm_shuffle_epi32 (out, _MM_SHUFFLE (3, 3, 3, 3)));
+	    }
+	}
+    }
+
+    if (dt == GDitherRect || dt == GDitherTri) {
+	*rnd = (uint32_t) _mm_cvtsi128_si32 (_mm_shuffle_epi32 (last, _MM_SHUFFLE (3, 3, 3, 3)));
+    }
+    if (dt == GDitherTri) {
+	ts[channel] = _mm_cvtss_f32 (vts);
+    }
+    return n;
+}
+
+#else /* NEON */
+
+inline static uint32_t gdither_innner_loop_vec(const GDitherType dt,
+    const uint32_t stride, const float bias, const float scale,
+    const int bit_depth, const uint32_t channel, const uint32_t length,
+    float *ts, uint32_t *rnd, float const *x, void *y, const int clamp_u,
+    const int clamp_l)
 {
-	static uint32_t rnd = 23232323;
-	rnd = (rnd * 196314165) + 907633515;
+    const uint32_t n = length & ~3U;
+    int16_t *o16 = (int16_t*) y;
+    int32_t *o32 = (int32_t*) y;
+    uint32_t pos, i;
+
+    const float32x4_t vscale = vdupq_n_f32 (scale);
+    const float32x4_t vbias  = vdupq_n_f32 (bias);
+    const float32x4_t vu     = vdupq_n_f32 ((float) clamp_u);
+    const float32x4_t vl     = vdupq_n_f32 ((float) clamp_l);
+    const float32x4_t vhalf  = vdupq_n_f32 (0.5f);
+    const float32x4_t vnorm  = vdupq_n_f32 (2.3283064365387e-10f);
+    const uint32x4_t  va4    = vdupq_n_u32 (GDITHER_RND_A4);
+    const uint32x4_t  vc4    = vdupq_n_u32 (GDITHER_RND_C4);
+
+    uint32x4_t  vrnd = vdupq_n_u32 (0);
+    uint32x4_t  last = vrnd;
+    float32x4_t vts  = vdupq_n_f32 (0.0f);
+
+    if (n == 0) {
+	return 0;
+    }
+
+    if (dt == GDitherRect || dt == GDitherTri) {
+	uint32_t r[4];
+	r[0] = *rnd * GDITHER_RND_A + GDITHER_RND_C;
+	r[1] = r[0] * GDITHER_RND_A + GDITHER_RND_C;
+	r[2] = r[1] * GDITHER_RND_A + GDITHER_RND_C;
+	r[3] = r[2] * GDITHER_RND_A + GDITHER_RND_C;
+	vrnd = vld1q_u32 (r);
+    }
+    if (dt == GDitherTri) {
+	vts = vdupq_n_f32 (ts[channel]);
+    }
+
+    i = channel;
+    for (pos = 0; pos < n; pos += 4, i += 4 * stride) {
+	float32x4_t tmp;
+	int32x4_t out;
+
+	if (stride == 1) {
+	    tmp = vld1q_f32 (x + i);
+	} else {
+	    const float in[4] = { x[i], x[i + stride], x[i + 2 * stride], x[i + 3 * stride] };
+	    tmp = vld1q_f32 (in);
+	}
+	tmp = vaddq_f32 (vmulq_f32 (tmp, vscale), vbias);
+
+	switch (dt) {
+	case GDitherRect:
+	    tmp = vsubq_f32 (tmp, vmulq_f32 (vcvtq_f32_u32 (vrnd), vnorm));
+	    break;
+	case GDitherTri:
+	    {
+		const float32x4_t r    = vsubq_f32 (vmulq_f32 (vcvtq_f32_u32 (vrnd), vnorm), vhalf);
+		const float32x4_t prev = vextq_f32 (vts, r, 3);
+		tmp = vsubq_f32 (tmp, vsubq_f32 (r, prev));
+		vts = vdupq_laneq_f32 (r, 3);
+	    }
+	    break;
+	default:
+	    break;
+	}
 
-	return rnd * 2.3283064365387e-10f;
+	if (dt == GDitherRect || dt == GDitherTri) {
+	    last = vrnd;
+	    vrnd = vmlaq_u32 (vc4, vrnd, va4);
+	}
+
+	/* clamp before rounding. On aarch64 lrintf() saturates, and
+	 * returns 0 for NaN, which vcvtnq_s32_f32() does as well.
+	 */
+	tmp = vminq_f32 (vmaxq_f32 (tmp, vl), vu);
+	out = vcvtnq_s32_f32 (tmp);
+
+	if (bit_depth == 16) {
+	    const int16x4_t o = vmovn_s32 (out);
+	    if (stride == 1) {
+		vst1_s16 (o16 + i, o);
+	    } else {
+		o16[i]              = vget_lane_s16 (o, 0);
+		o16[i + stride]     = vget_lane_s16 (o, 1);
+		o16[i + 2 * stride] = vget_lane_s16 (o, 2);
+		o16[i + 3 * stride] = vget_lane_s16 (o, 3);
+	    }
+	} else {
+	    out = vshlq_n_s32 (out, 8);
+	    if (stride == 1) {
+		vst1q_s32 (o32 + i, out);
+	    } else {
+		o32[i]              = vgetq_lane_s32 (out, 0);
+		o32[i + stride]     = vgetq_lane_s32 (out, 1);
+		o32[i + 2 * stride] = vgetq_lane_s32 (out, 2);
+		o32[i + 3 * stride] = vgetq_lane_s32 (out, 3);
+	    }
+	}
+    }
+
+    if (dt == GDitherRect || dt == GDitherTri) {
+	*rnd = vgetq_lane_u32 (last, 3);
+    }
+    if (dt == GDitherTri) {
+	ts[channel] = vgetq_lane_f32 (vts, 3);
+    }
+    return n;
 }
 
+#endif
+#endif /* GDITHER_VEC */
+
 GDither gdither_new(GDitherType type, uint32_t channels,
 
 		    GDitherSize bit_depth, int dither_depth)
@@ -79,6 +358,7 @@ GDither gdither_new(GDitherType type, uint32_t channels,
     s->type = type;
     s->channels = channels;
     s->bit_depth = (int)bit_depth;
+    s->rnd = GDITHER_RND_SEED;
 
     if (dither_depth <= 0 || dither_depth > (int)bit_depth) {
 	dither_depth = (int)bit_depth;
@@ -177,9 +457,9 @@ inline static void gdither_innner_loop(const GDitherType dt,
     const uint32_t post_scale, const int bit_depth,
     const uint32_t channel, const uint32_t length, float *ts,
 
-    GDitherShapedState *ss, float const *x, void *y, const int clamp_u,
+    uint32_t *rnd, GDitherShapedState *ss, float const *x, void *y,
 
-    const int clamp_l)
+    const int clamp_u, const int clamp_l)
 {
     uint32_t pos, i;
     uint8_t *o8 = (uint8_t*) y;
@@ -188,18 +468,29 @@ inline static void gdither_innner_loop(const GDitherType dt,
     float tmp, r, ideal;
     int64_t clamped;
 
-    i = channel;
-    for (pos = 0; pos < length; pos++, i += stride) {
+    pos = 0;
+#ifdef GDITHER_VEC
+    if (dt != GDitherShaped &&
+        ((bit_depth == 16 && post_scale == 1) ||
+         (bit_depth == 32 && post_scale == 256 && clamp_u == MAX_S24 && clamp_l == MIN_S24))) {
+	pos = gdither_innner_loop_vec (dt, stride, bias, scale, bit_depth,
+	                               channel, length, ts, rnd, x, y,
+	                               clamp_u, clamp_l);
+    }
+#endif
+
+    i = channel + pos * stride;
+    for (; pos < length; pos++, i += stride) {
 	tmp = x[i] * scale + bias;
 
 	switch (dt) {
 	case GDitherNone:
 	    break;
 	case GDitherRect:
-	    tmp -= gdither_noise ();
+	    tmp -= gdither_noise (rnd);
 	    break;
 	case GDitherTri:
-	    r = gdither_noise () - 0.5f;
+	    r = gdither_noise (rnd) - 0.5f;
 	    tmp -= r - ts[channel];
 	    ts[channel] = r;
 	    break;
@@ -209,7 +500,7 @@ inline static void gdither_innner_loop(const GDitherType dt,
 	    ideal = tmp;
 
 	    /* Run FIR and add white noise */
-	    ss->buffer[ss->phase] = gdither_noise () * 0.5f;
+	    ss->buffer[ss->phase] = gdither_noise (rnd) * 0.5f;
 	    tmp += ss->buffer[ss->phase] * shaped_bs[0]
 		   + ss->buffer[(ss->phase - 1) & GDITHER_SH_BUF_MASK]
 		     * shaped_bs[1]
@@ -254,9 +545,9 @@ inline static void gdither_innner_loop_fp(const GDitherType dt,
     const float post_scale, const int bit_depth,
     const uint32_t channel, const uint32_t length, float *ts,
 
-    GDitherShapedState *ss, float const *x, void *y, const int clamp_u,
+    uint32_t *rnd, GDitherShapedState *ss, float const *x, void *y,
 
-    const int clamp_l)
+    const int clamp_u, const int clamp_l)
 {
     uint32_t pos, i;
     float *oflt = (float*) y;
@@ -272,10 +563,10 @@ inline static void gdither_innner_loop_fp(const GDitherType dt,
 	case GDitherNone:
 	    break;
 	case GDitherRect:
-	    tmp -= gdither_noise ();
+	    tmp -= gdither_noise (rnd);
 	    break;
 	case GDitherTri:
-	    r = gdither_noise () - 0.5f;
+	    r = gdither_noise (rnd) - 0.5f;
 	    tmp -= r - ts[channel];
 	    ts[channel] = r;
 	    break;
@@ -285,7 +576,7 @@ inline static void gdither_innner_loop_fp(const GDitherType dt,
 	    ideal = tmp;
 
 	    /* Run FIR and add white noise */
-	    ss->buffer[ss->phase] = gdither_noise () * 0.5f;
+	    ss->buffer[ss->phase] = gdither_noise (rnd) * 0.5f;
 	    tmp += ss->buffer[ss->phase] * shaped_bs[0]
 		   + ss->buffer[(ss->phase - 1) & GDITHER_SH_BUF_MASK]
 		     * shaped_bs[1]
@@ -360,18 +651,14 @@ void gdither_run(GDither s, uint32_t channel, uint32_t length,
     }
 }
 
-void gdither_runf(GDither s, uint32_t channel, uint32_t length,
-                 float const *x, void *y)
+static void gdither_runf_stride(GDither s, uint32_t channel, uint32_t stride,
+                                uint32_t length, float const *x, void *y)
 {
     uint32_t pos, i;
     float tmp;
     int64_t clamped;
     GDitherShapedState *ss = NULL;
 
-    if (!s || channel >= s->channels) {
-	return;
-    }
-
     if (s->shaped_state) {
 	ss = s->shaped_state + channel;
     }
@@ -380,7 +667,7 @@ void gdither_runf(GDither s, uint32_t channel, uint32_t length,
 	int32_t *o32 = (int32_t*) y;
 
         for (pos = 0; pos < length; pos++) {
-            i = channel + (pos * s->channels);
+            i = channel + (pos * stride);
             tmp = x[i] * 8388608.0f;
 
             clamped = lrintf(tmp);
@@ -401,82 +688,112 @@ void gdither_runf(GDither s, uint32_t channel, uint32_t length,
     if (s->bit_depth == 8 && s->dither_depth == 8) {
 	switch (s->type) {
 	case GDitherNone:
-	    gdither_innner_loop(GDitherNone, s->channels, 128.0f, SCALE_U8,
-				1, 8, channel, length, NULL, NULL, x, y,
+	    gdither_innner_loop(GDitherNone, stride, 128.0f, SCALE_U8,
+				1, 8, channel, length, NULL, &s->rnd, NULL, x, y,
 				MAX_U8, MIN_U8);
 	    break;
 	case GDitherRect:
-	    gdither_innner_loop(GDitherRect, s->channels, 128.0f, SCALE_U8,
-				1, 8, channel, length, NULL, NULL, x, y,
+	    gdither_innner_loop(GDitherRect, stride, 128.0f, SCALE_U8,
+				1, 8, channel, length, NULL, &s->rnd, NULL, x, y,
 				MAX_U8, MIN_U8);
 	    break;
 	case GDitherTri:
-	    gdither_innner_loop(GDitherTri, s->channels, 128.0f, SCALE_U8,
+	    gdither_innner_loop(GDitherTri, stride, 128.0f, SCALE_U8,
 				1, 8, channel, length, s->tri_state,
-				NULL, x, y, MAX_U8, MIN_U8);
+				&s->rnd, NULL, x, y, MAX_U8, MIN_U8);
 	    break;
 	case GDitherShaped:
-	    gdither_innner_loop(GDitherShaped, s->channels, 128.0f, SCALE_U8,
+	    gdither_innner_loop(GDitherShaped, stride, 128.0f, SCALE_U8,
 			        1, 8, channel, length, NULL,
-				ss, x, y, MAX_U8, MIN_U8);
+				&s->rnd, ss, x, y, MAX_U8, MIN_U8);
 	    break;
 	}
     } else if (s->bit_depth == 16 && s->dither_depth == 16) {
 	switch (s->type) {
 	case GDitherNone:
-	    gdither_innner_loop(GDitherNone, s->channels, 0.0f, SCALE_S16,
-				1, 16, channel, length, NULL, NULL, x, y,
+	    gdither_innner_loop(GDitherNone, stride, 0.0f, SCALE_S16,
+				1, 16, channel, length, NULL, &s->rnd, NULL, x, y,
 				MAX_S16, MIN_S16);
 	    break;
 	case GDitherRect:
-	    gdither_innner_loop(GDitherRect, s->channels, 0.0f, SCALE_S16,
-				1, 16, channel, length, NULL, NULL, x, y,
+	    gdither_innner_loop(GDitherRect, stride, 0.0f, SCALE_S16,
+				1, 16, channel, length, NULL, &s->rnd, NULL, x, y,
 				MAX_S16, MIN_S16);
 	    break;
 	case GDitherTri:
-	    gdither_innner_loop(GDitherTri, s->channels, 0.0f, SCALE_S16,
+	    gdither_innner_loop(GDitherTri, stride, 0.0f, SCALE_S16,
 				1, 16, channel, length, s->tri_state,
-				NULL, x, y, MAX_S16, MIN_S16);
+				&s->rnd, NULL, x, y, MAX_S16, MIN_S16);
 	    break;
 	case GDitherShaped:
-	    gdither_innner_loop(GDitherShaped, s->channels, 0.0f,
+	    gdither_innner_loop(GDitherShaped, stride, 0.0f,
 				SCALE_S16, 1, 16, channel, length, NULL,
-				ss, x, y, MAX_S16, MIN_S16);
+				&s->rnd, ss, x, y, MAX_S16, MIN_S16);
 	    break;
 	}
     } else if (s->bit_depth == 32 && s->dither_depth == 24) {
 	switch (s->type) {
 	case GDitherNone:
-	    gdither_innner_loop(GDitherNone, s->channels, 0.0f, SCALE_S24,
-				256, 32, channel, length, NULL, NULL, x,
+	    gdither_innner_loop(GDitherNone, stride, 0.0f, SCALE_S24,
+				256, 32, channel, length, NULL, &s->rnd, NULL, x,
 				y, MAX_S24, MIN_S24);
 	    break;
 	case GDitherRect:
-	    gdither_innner_loop(GDitherRect, s->channels, 0.0f, SCALE_S24,
-				256, 32, channel, length, NULL, NULL, x,
+	    gdither_innner_loop(GDitherRect, stride, 0.0f, SCALE_S24,
+				256, 32, channel, length, NULL, &s->rnd, NULL, x,
 				y, MAX_S24, MIN_S24);
 	    break;
 	case GDitherTri:
-	    gdither_innner_loop(GDitherTri, s->channels, 0.0f, SCALE_S24,
+	    gdither_innner_loop(GDitherTri, stride, 0.0f, SCALE_S24,
 				256, 32, channel, length, s->tri_state,
-				NULL, x, y, MAX_S24, MIN_S24);
+				&s->rnd, NULL, x, y, MAX_S24, MIN_S24);
 	    break;
 	case GDitherShaped:
-	    gdither_innner_loop(GDitherShaped, s->channels, 0.0f, SCALE_S24,
+	    gdither_innner_loop(GDitherShaped, stride, 0.0f, SCALE_S24,
 				256, 32, channel, length,
-				NULL, ss, x, y, MAX_S24, MIN_S24);
+				NULL, &s->rnd, ss, x, y, MAX_S24, MIN_S24);
 	    break;
 	}
     } else if (s->bit_depth == GDitherFloat || s->bit_depth == GDitherDouble) {
-	gdither_innner_loop_fp(s->type, s->channels, s->bias, s->scale,
+	gdither_innner_loop_fp(s->type, stride, s->bias, s->scale,
 			    s->post_scale_fp, s->bit_depth, channel, length,
-			    s->tri_state, ss, x, y, s->clamp_u, s->clamp_l);
+			    s->tri_state, &s->rnd, ss, x, y, s->clamp_u, s->clamp_l);
     } else {
 	/* no special case handling, just process it from the struct */
 
-	gdither_innner_loop(s->type, s->channels, s->bias, s->scale,
+	gdither_innner_loop(s->type, stride, s->bias, s->scale,
 			    s->post_scale, s->bit_depth, channel,
-			    length, s->tri_state, ss, x, y, s->clamp_u,
+			    length, s->tri_state, &s->rnd, ss, x, y, s->clamp_u,
 			    s->clamp_l);
     }
 }
+
+void gdither_runf(GDither s, uint32_t channel, uint32_t length,
+                 float const *x, void *y)
+{
+    if (!s || channel >= s->channels) {
+	return;
+    }
+
+    gdither_runf_stride(s, channel, s->channels, length, x, y);
+}
+
+void gdither_runf_interleaved(GDither s, uint32_t length,
+                              float const *x, void *y)
+{
+    uint32_t channel;
+
+    if (!s) {
+	return;
+    }
+
+    if (s->type == GDitherNone) {
+	/* no state, process all channels at once */
+	gdither_runf_stride(s, 0, 1, length * s->channels, x, y);
+	return;
+    }
+
+    for (channel = 0; channel < s->channels; ++channel) {
+	gdither_runf_stride(s, channel, s->channels, length, x, y);
+    }
+}
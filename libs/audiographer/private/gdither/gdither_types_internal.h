@@ -66,6 +66,7 @@ typedef struct GDither_s {
     int   clamp_l;
     float *tri_state;
     GDitherShapedState *shaped_state;
+    uint32_t rnd;
 } *GDither;
 
 #ifdef __cplusplus
@@ -140,8 +140,12 @@ SampleFormatConverter<TOut>::process (ProcessContext<float> const & c_in)
 
 	/* Do conversion */
 
-	for (uint32_t chn = 0; chn < c_in.channels(); ++chn) {
-		gdither_runf (dither, chn, c_in.samples_per_channel (), data, data_out);
+	if (c_in.channels () == channels) {
+		gdither_runf_interleaved (dither, c_in.samples_per_channel (), data, data_out);
+	} else {
+		for (uint32_t chn = 0; chn < c_in.channels(); ++chn) {
+			gdither_runf (dither, chn, c_in.samples_per_channel (), data, data_out);
+		}
 	}
 
 	/* Write forward */
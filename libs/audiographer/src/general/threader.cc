@@ -0,0 +1,130 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "pbd/pthread_utils.h"
+
+#include "audiographer/general/threader.h"
+
+namespace AudioGrapher
+{
+
+ThreaderPool::ThreaderPool (unsigned int n_workers, unsigned int max_tasks)
+	: _queue (max_tasks)
+	, _sem ("ThreaderPool", 0)
+	, _capacity (PBD::MPMCQueue<Task>::power_of_two_size (max_tasks))
+{
+	g_atomic_int_set (&_reserved, 0);
+	g_atomic_int_set (&_queued, 0);
+	g_atomic_int_set (&_idle, 0);
+	g_atomic_int_set (&_terminate, 0);
+
+	for (unsigned int i = 0; i < std::max (1U, n_workers); ++i) {
+		pthread_t thread;
+		if (pthread_create_and_store ("ExportWorker", &thread, _run, this) == 0) {
+			_workers.push_back (thread);
+		}
+	}
+}
+
+ThreaderPool::~ThreaderPool ()
+{
+	g_atomic_int_set (&_terminate, 1);
+
+	for (unsigned int i = 0; i < _workers.size (); ++i) {
+		_sem.signal ();
+	}
+	for (std::vector<pthread_t>::const_iterator i = _workers.begin (); i != _workers.end (); ++i) {
+		pthread_join (*i, 0);
+	}
+}
+
+bool
+ThreaderPool::reserve (unsigned int n)
+{
+	/* the queue is never resized, workers may use it concurrently */
+	return g_atomic_int_add (&_reserved, n) + (gint) n <= _capacity;
+}
+
+void
+ThreaderPool::release (unsigned int n)
+{
+	g_atomic_int_add (&_reserved, -(gint) n);
+}
+
+bool
+ThreaderPool::push (Task const & task)
+{
+	if (_workers.empty ()) {
+		return false;
+	}
+
+	/* claim a slot first, MPMCQueue::push_back must not be called when full */
+	if (g_atomic_int_add (&_queued, 1) >= _capacity) {
+		g_atomic_int_add (&_queued, -1);
+		return false;
+	}
+
+	_queue.push_back (task);
+
+	if (g_atomic_int_get (&_idle) > 0) {
+		_sem.signal ();
+	}
+	return true;
+}
+
+void*
+ThreaderPool::_run (void* arg)
+{
+	static_cast<ThreaderPool*> (arg)->run ();
+	return 0;
+}
+
+void
+ThreaderPool::run ()
+{
+	Task task;
+
+	while (true) {
+		/* spin for a short time, before going to sleep */
+		bool have_task = false;
+		for (int spin = 0; spin < 1000 && !have_task; ++spin) {
+			have_task = _queue.pop_front (task);
+		}
+
+		if (!have_task) {
+			/* announce that this thread is idle, and check once
+			 * more to not miss a task that was pushed meanwhile.
+			 */
+			g_atomic_int_inc (&_idle);
+			have_task = _queue.pop_front (task);
+			if (!have_task) {
+				if (g_atomic_int_get (&_terminate)) {
+					g_atomic_int_add (&_idle, -1);
+					break;
+				}
+				_sem.wait ();
+			}
+			g_atomic_int_add (&_idle, -1);
+		}
+
+		if (have_task) {
+			g_atomic_int_add (&_queued, -1);
+			task.run (task.arg, task.index);
+		}
+	}
+}
+
+} // namespace
@@ -0,0 +1,278 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include <glib.h>
+
+#include "pbd/gstdio_compat.h"
+
+#include "audiographer/sndfile/tmp_file_mem.h"
+
+using namespace AudioGrapher;
+
+#ifdef PLATFORM_WINDOWS
+# define ftell64 _ftelli64
+# define fseek64 _fseeki64
+#else
+# define ftell64 ftello
+# define fseek64 fseeko
+#endif
+
+bool
+TmpFileBudget::acquire (uint64_t bytes)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	if (bytes > _available) {
+		return false;
+	}
+	_available -= bytes;
+	return true;
+}
+
+void
+TmpFileBudget::release (uint64_t bytes)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	_available += bytes;
+}
+
+uint64_t
+TmpFileBudget::available () const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	return _available;
+}
+
+TmpFileStore::TmpFileStore (size_t budget, std::string const & spill_template)
+	: _budget (new TmpFileBudget (budget))
+	, _mem_size (std::numeric_limits<sf_count_t>::max ())
+	, _length (0)
+	, _pos (0)
+	, _spill_path (spill_template)
+	, _spill (0)
+	, _spill_write (false)
+{
+}
+
+TmpFileStore::TmpFileStore (boost::shared_ptr<TmpFileBudget> budget, std::string const & spill_template)
+	: _budget (budget)
+	, _mem_size (std::numeric_limits<sf_count_t>::max ())
+	, _length (0)
+	, _pos (0)
+	, _spill_path (spill_template)
+	, _spill (0)
+	, _spill_write (false)
+{
+}
+
+TmpFileStore::~TmpFileStore ()
+{
+	for (std::vector<char*>::const_iterator i = _blocks.begin (); i != _blocks.end (); ++i) {
+		free (*i);
+	}
+	_budget->release ((uint64_t) _blocks.size () * block_size);
+	if (_spill) {
+		fclose (_spill);
+		std::remove (_spill_path.c_str ());
+	}
+}
+
+SF_VIRTUAL_IO&
+TmpFileStore::virtual_io ()
+{
+	static SF_VIRTUAL_IO vio = { &_get_filelen, &_seek, &_read, &_write, &_tell };
+	return vio;
+}
+
+sf_count_t
+TmpFileStore::_get_filelen (void* arg)
+{
+	return static_cast<TmpFileStore*> (arg)->_length;
+}
+
+sf_count_t
+TmpFileStore::_seek (sf_count_t offset, int whence, void* arg)
+{
+	return static_cast<TmpFileStore*> (arg)->seek (offset, whence);
+}
+
+sf_count_t
+TmpFileStore::_read (void* ptr, sf_count_t count, void* arg)
+{
+	return static_cast<TmpFileStore*> (arg)->read (ptr, count);
+}
+
+sf_count_t
+TmpFileStore::_write (const void* ptr, sf_count_t count, void* arg)
+{
+	return static_cast<TmpFileStore*> (arg)->write (ptr, count);
+}
+
+sf_count_t
+TmpFileStore::_tell (void* arg)
+{
+	return static_cast<TmpFileStore*> (arg)->_pos;
+}
+
+sf_count_t
+TmpFileStore::seek (sf_count_t offset, int whence)
+{
+	switch (whence) {
+		case SEEK_SET:
+			break;
+		case SEEK_CUR:
+			offset += _pos;
+			break;
+		case SEEK_END:
+			offset += _length;
+			break;
+		default:
+			return -1;
+	}
+	if (offset < 0) {
+		return -1;
+	}
+	_pos = offset;
+	return _pos;
+}
+
+sf_count_t
+TmpFileStore::read (void* ptr, sf_count_t count)
+{
+	char*            dst = static_cast<char*> (ptr);
+	sf_count_t const mem = _mem_size;
+	sf_count_t       n   = std::max<sf_count_t> (0, std::min (count, _length - _pos));
+	sf_count_t       rv  = 0;
+
+	/* in-memory part */
+	while (n > 0 && _pos < mem) {
+		size_t const     b   = _pos / block_size;
+		size_t const     off = _pos % block_size;
+		sf_count_t const len = std::min<sf_count_t> (n, block_size - off);
+		if (b < _blocks.size ()) {
+			memcpy (dst, _blocks[b] + off, len);
+		} else {
+			/* seek beyond the end, then written */
+			memset (dst, 0, len);
+		}
+		dst  += len;
+		_pos += len;
+		rv   += len;
+		n    -= len;
+	}
+
+	/* spilled part */
+	if (n > 0) {
+		if (!seek_spill (_pos - mem, false)) {
+			return rv;
+		}
+		size_t const len = fread (dst, 1, n, _spill);
+		_pos += len;
+		rv   += len;
+	}
+
+	return rv;
+}
+
+sf_count_t
+TmpFileStore::write (const void* ptr, sf_count_t count)
+{
+	const char*      src = static_cast<const char*> (ptr);
+	sf_count_t       n   = count;
+	sf_count_t       rv  = 0;
+
+	while (n > 0 && _pos < _mem_size) {
+		size_t const     b   = _pos / block_size;
+		size_t const     off = _pos % block_size;
+		sf_count_t const len = std::min<sf_count_t> (n, block_size - off);
+		while (b >= _blocks.size ()) {
+			char* block = 0;
+			if (_budget->acquire (block_size)) {
+				block = (char*) calloc (block_size, 1);
+				if (!block) {
+					_budget->release (block_size);
+				}
+			}
+			if (!block) {
+				/* budget exceeded or out of memory, use the file from now on */
+				_mem_size = (sf_count_t) _blocks.size () * block_size;
+				return rv + write (src, n);
+			}
+			_blocks.push_back (block);
+		}
+		memcpy (_blocks[b] + off, src, len);
+		src  += len;
+		_pos += len;
+		rv   += len;
+		n    -= len;
+	}
+
+	if (n > 0 && seek_spill (_pos - _mem_size, true)) {
+		size_t const len = fwrite (src, 1, n, _spill);
+		_pos += len;
+		rv   += len;
+	}
+
+	_length = std::max (_length, _pos);
+	return rv;
+}
+
+bool
+TmpFileStore::open_spill ()
+{
+	if (_spill) {
+		return true;
+	}
+
+	std::vector<char> path_buf (_spill_path.begin (), _spill_path.end ());
+	path_buf.push_back ('\0');
+
+	int fd = g_mkstemp (&path_buf[0]);
+	if (fd < 0) {
+		return false;
+	}
+	g_close (fd, NULL);
+
+	_spill_path = &path_buf[0];
+	_spill      = g_fopen (_spill_path.c_str (), "w+b");
+
+	if (!_spill) {
+		std::remove (_spill_path.c_str ());
+		return false;
+	}
+	return true;
+}
+
+bool
+TmpFileStore::seek_spill (sf_count_t offset, bool write)
+{
+	if (!open_spill ()) {
+		return false;
+	}
+	/* switching between reading and writing requires a seek (C11 7.21.5.3) */
+	if (write == _spill_write && ftell64 (_spill) == offset) {
+		return true;
+	}
+	if (0 != fseek64 (_spill, offset, SEEK_SET)) {
+		return false;
+	}
+	_spill_write = write;
+	return true;
+}
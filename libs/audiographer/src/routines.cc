@@ -19,8 +19,125 @@
 
 #include "audiographer/routines.h"
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE__)
+# include <xmmintrin.h>
+# define INTERLEAVE_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+# define INTERLEAVE_NEON
+#endif
+
 namespace AudioGrapher
 {
 Routines::compute_peak_t Routines::_compute_peak = &Routines::default_compute_peak;
 Routines::apply_gain_to_buffer_t Routines::_apply_gain_to_buffer = &Routines::default_apply_gain_to_buffer;
+
+void
+Routines::interleave (float const * const * src, float * dst, uint_type channels, uint_type samples)
+{
+	uint_type i = 0;
+
+#if defined(INTERLEAVE_SSE)
+	if (channels == 2) {
+		float const * const a = src[0];
+		float const * const b = src[1];
+		for (; i + 4 <= samples; i += 4) {
+			__m128 const va = _mm_loadu_ps (a + i);
+			__m128 const vb = _mm_loadu_ps (b + i);
+			_mm_storeu_ps (dst + 2 * i,     _mm_unpacklo_ps (va, vb));
+			_mm_storeu_ps (dst + 2 * i + 4, _mm_unpackhi_ps (va, vb));
+		}
+	} else if (channels == 4) {
+		for (; i + 4 <= samples; i += 4) {
+			__m128 v0 = _mm_loadu_ps (src[0] + i);
+			__m128 v1 = _mm_loadu_ps (src[1] + i);
+			__m128 v2 = _mm_loadu_ps (src[2] + i);
+			__m128 v3 = _mm_loadu_ps (src[3] + i);
+			_MM_TRANSPOSE4_PS (v0, v1, v2, v3);
+			_mm_storeu_ps (dst + 4 * i,      v0);
+			_mm_storeu_ps (dst + 4 * i + 4,  v1);
+			_mm_storeu_ps (dst + 4 * i + 8,  v2);
+			_mm_storeu_ps (dst + 4 * i + 12, v3);
+		}
+	}
+#elif defined(INTERLEAVE_NEON)
+	if (channels == 2) {
+		for (; i + 4 <= samples; i += 4) {
+			float32x4x2_t v;
+			v.val[0] = vld1q_f32 (src[0] + i);
+			v.val[1] = vld1q_f32 (src[1] + i);
+			vst2q_f32 (dst + 2 * i, v);
+		}
+	} else if (channels == 4) {
+		for (; i + 4 <= samples; i += 4) {
+			float32x4x4_t v;
+			v.val[0] = vld1q_f32 (src[0] + i);
+			v.val[1] = vld1q_f32 (src[1] + i);
+			v.val[2] = vld1q_f32 (src[2] + i);
+			v.val[3] = vld1q_f32 (src[3] + i);
+			vst4q_f32 (dst + 4 * i, v);
+		}
+	}
+#endif
+
+	for (; i < samples; ++i) {
+		for (uint_type c = 0; c < channels; ++c) {
+			dst[i * channels + c] = src[c][i];
+		}
+	}
 }
+
+void
+Routines::deinterleave (float const * src, float * const * dst, uint_type channels, uint_type samples)
+{
+	uint_type i = 0;
+
+#if defined(INTERLEAVE_SSE)
+	if (channels == 2) {
+		float * const a = dst[0];
+		float * const b = dst[1];
+		for (; i + 4 <= samples; i += 4) {
+			__m128 const v0 = _mm_loadu_ps (src + 2 * i);
+			__m128 const v1 = _mm_loadu_ps (src + 2 * i + 4);
+			_mm_storeu_ps (a + i, _mm_shuffle_ps (v0, v1, _MM_SHUFFLE (2, 0, 2, 0)));
+			_mm_storeu_ps (b + i, _mm_shuffle_ps (v0, v1, _MM_SHUFFLE (3, 1, 3, 1)));
+		}
+	} else if (channels == 4) {
+		for (; i + 4 <= samples; i += 4) {
+			__m128 v0 = _mm_loadu_ps (src + 4 * i);
+			__m128 v1 = _mm_loadu_ps (src + 4 * i + 4);
+			__m128 v2 = _mm_loadu_ps (src + 4 * i + 8);
+			__m128 v3 = _mm_loadu_ps (src + 4 * i + 12);
+			_MM_TRANSPOSE4_PS (v0, v1, v2, v3);
+			_mm_storeu_ps (dst[0] + i, v0);
+			_mm_storeu_ps (dst[1] + i, v1);
+			_mm_storeu_ps (dst[2] + i, v2);
+			_mm_storeu_ps (dst[3] + i, v3);
+		}
+	}
+#elif defined(INTERLEAVE_NEON)
+	if (channels == 2) {
+		for (; i + 4 <= samples; i += 4) {
+			float32x4x2_t const v = vld2q_f32 (src + 2 * i);
+			vst1q_f32 (dst[0] + i, v.val[0]);
+			vst1q_f32 (dst[1] + i, v.val[1]);
+		}
+	} else if (channels == 4) {
+		for (; i + 4 <= samples; i += 4) {
+			float32x4x4_t const v = vld4q_f32 (src + 4 * i);
+			vst1q_f32 (dst[0] + i, v.val[0]);
+			vst1q_f32 (dst[1] + i, v.val[1]);
+			vst1q_f32 (dst[2] + i, v.val[2]);
+			vst1q_f32 (dst[3] + i, v.val[3]);
+		}
+	}
+#endif
+
+	for (; i < samples; ++i) {
+		for (uint_type c = 0; c < channels; ++c) {
+			dst[c][i] = src[i * channels + c];
+		}
+	}
+}
+
+} // namespace
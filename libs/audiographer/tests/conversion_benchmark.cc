@@ -0,0 +1,123 @@
+/* Benchmark for SampleFormatConverter, Interleaver and DeInterleaver
+ *
+ * Reports throughput of the sample-format conversion for the common
+ * integer formats and dither types, and of (de)interleaving.
+ * usage: conversion-benchmark [channels] [chunks]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <glib.h>
+
+#include "tests/utils.h"
+
+#include "audiographer/general/deinterleaver.h"
+#include "audiographer/general/interleaver.h"
+#include "audiographer/general/sample_format_converter.h"
+
+using namespace AudioGrapher;
+
+template<typename T>
+class NullSink : public Sink<T>
+{
+  public:
+	void process (ProcessContext<T> const &) {}
+	using Sink<T>::process;
+};
+
+static void
+report (char const* what, gint64 usec, samplecnt_t samples, unsigned int n_chunks)
+{
+	printf ("%-28s %9.2f ms  %8.1f Msamples/sec\n", what, usec / 1000.0, (double) samples * n_chunks / usec);
+}
+
+template<typename TOut>
+static void
+run_converter (char const* name, int type, int data_width, float* data, samplecnt_t samples, ChannelCount channels, unsigned int n_chunks)
+{
+	SampleFormatConverter<TOut> sfc (channels);
+	sfc.init (samples, type, data_width);
+	sfc.add_output (boost::shared_ptr<NullSink<TOut> > (new NullSink<TOut>()));
+
+	ProcessContext<float> const c (data, samples, channels);
+
+	gint64 const t0 = g_get_monotonic_time ();
+	for (unsigned int i = 0; i < n_chunks; ++i) {
+		sfc.process (c);
+	}
+	report (name, g_get_monotonic_time () - t0, samples, n_chunks);
+}
+
+static void
+run_interleaver (float* data, samplecnt_t samples, ChannelCount channels, unsigned int n_chunks)
+{
+	samplecnt_t const spc = samples / channels;
+
+	Interleaver<float> il;
+	il.init (channels, spc);
+	il.add_output (boost::shared_ptr<NullSink<float> > (new NullSink<float>()));
+
+	gint64 const t0 = g_get_monotonic_time ();
+	for (unsigned int i = 0; i < n_chunks; ++i) {
+		for (ChannelCount c = 0; c < channels; ++c) {
+			il.input (c)->process (ProcessContext<float> (&data[c * spc], spc, 1));
+		}
+	}
+	report ("Interleaver", g_get_monotonic_time () - t0, samples, n_chunks);
+}
+
+static void
+run_deinterleaver (float* data, samplecnt_t samples, ChannelCount channels, unsigned int n_chunks)
+{
+	DeInterleaver<float> dil;
+	dil.init (channels, samples / channels);
+	boost::shared_ptr<NullSink<float> > sink (new NullSink<float>());
+	for (ChannelCount c = 0; c < channels; ++c) {
+		dil.output (c)->add_output (sink);
+	}
+
+	ProcessContext<float> const c (data, samples, channels);
+
+	gint64 const t0 = g_get_monotonic_time ();
+	for (unsigned int i = 0; i < n_chunks; ++i) {
+		dil.process (c);
+	}
+	report ("DeInterleaver", g_get_monotonic_time () - t0, samples, n_chunks);
+}
+
+int
+main (int argc, char** argv)
+{
+	unsigned int channels = 2;
+	unsigned int n_chunks = 20000;
+
+	if (argc > 1) {
+		channels = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		n_chunks = atoi (argv[2]);
+	}
+	if (channels == 0 || n_chunks == 0) {
+		fprintf (stderr, "usage: %s [channels] [chunks]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	samplecnt_t const samples = 8192 - (8192 % channels);
+	float* data = TestUtils::init_random_data (samples, 1.0);
+
+	printf ("%u channels, %u chunks of %ld samples\n", channels, n_chunks, (long) samples);
+
+	run_converter<int16_t> ("int16, no dither",    D_None, 16, data, samples, channels, n_chunks);
+	run_converter<int16_t> ("int16, rectangular",  D_Rect, 16, data, samples, channels, n_chunks);
+	run_converter<int16_t> ("int16, triangular",   D_Tri,  16, data, samples, channels, n_chunks);
+	run_converter<int16_t> ("int16, shaped",       D_Shaped, 16, data, samples, channels, n_chunks);
+	run_converter<int32_t> ("int24, no dither",    D_None, 24, data, samples, channels, n_chunks);
+	run_converter<int32_t> ("int24, rectangular",  D_Rect, 24, data, samples, channels, n_chunks);
+	run_converter<int32_t> ("int24, triangular",   D_Tri,  24, data, samples, channels, n_chunks);
+	run_interleaver (data, samples, channels, n_chunks);
+	run_deinterleaver (data, samples, channels, n_chunks);
+
+	delete [] data;
+	return 0;
+}
@@ -0,0 +1,89 @@
+/* Benchmark for AudioGrapher::Threader
+ *
+ * Simulates the second pass of a normalized export: one source feeding
+ * many encoder branches (dither + sample-format conversion).
+ * usage: export-benchmark [branches] [chunks]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <glib.h>
+
+#include "tests/utils.h"
+
+#include "audiographer/general/sample_format_converter.h"
+#include "audiographer/general/threader.h"
+
+using namespace AudioGrapher;
+
+template<typename T>
+class NullSink : public Sink<T>
+{
+  public:
+	void process (ProcessContext<T> const &) {}
+	using Sink<T>::process;
+};
+
+static double
+run (ThreaderPool& pool, unsigned int depth, unsigned int branches, unsigned int n_chunks, float* data, samplecnt_t samples, ChannelCount channels)
+{
+	Threader<float> threader (pool, depth);
+
+	std::vector<boost::shared_ptr<SampleFormatConverter<int16_t> > > sfc;
+	boost::shared_ptr<NullSink<int16_t> > sink (new NullSink<int16_t>());
+
+	for (unsigned int b = 0; b < branches; ++b) {
+		boost::shared_ptr<SampleFormatConverter<int16_t> > s (new SampleFormatConverter<int16_t> (channels));
+		s->init (samples, D_Tri, 16);
+		s->add_output (sink);
+		threader.add_output (s);
+		sfc.push_back (s);
+	}
+
+	gint64 const t0 = g_get_monotonic_time ();
+	for (unsigned int i = 0; i < n_chunks; ++i) {
+		ProcessContext<float> c (data, samples, channels);
+		if (i == n_chunks - 1) {
+			c.set_flag (ProcessContext<float>::EndOfInput);
+		}
+		threader.process (c);
+	}
+	return (g_get_monotonic_time () - t0) / 1000.0;
+}
+
+int
+main (int argc, char** argv)
+{
+	unsigned int branches = 8;
+	unsigned int n_chunks = 20000;
+
+	if (argc > 1) {
+		branches = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		n_chunks = atoi (argv[2]);
+	}
+	if (branches == 0 || n_chunks == 0) {
+		fprintf (stderr, "usage: %s [branches] [chunks]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	ChannelCount const channels = 2;
+	samplecnt_t const  samples  = 4086 - (4086 % channels); // see ExportGraphBuilder::Intermediate
+	float* data = TestUtils::init_random_data (samples, 1.0);
+
+	ThreaderPool pool (g_get_num_processors ());
+
+	printf ("%u branches, %u chunks of %ld samples, %u workers\n",
+	        branches, n_chunks, (long) samples, pool.n_workers ());
+
+	unsigned int const depths[] = { 1, 2, 4, 8 };
+	for (size_t d = 0; d < sizeof (depths) / sizeof (depths[0]); ++d) {
+		double ms = run (pool, depths[d], branches, n_chunks, data, samples, channels);
+		printf ("chunks in flight: %u  %9.2f ms  %8.2f us/chunk\n", depths[d], ms, 1000.0 * ms / n_chunks);
+	}
+
+	delete [] data;
+	return 0;
+}
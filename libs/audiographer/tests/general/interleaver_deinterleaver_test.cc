@@ -10,6 +10,7 @@ class InterleaverDeInterleaverTest : public CppUnit::TestFixture
   CPPUNIT_TEST_SUITE (InterleaverDeInterleaverTest);
   CPPUNIT_TEST (testInterleavedInput);
   CPPUNIT_TEST (testDeInterleavedInput);
+  CPPUNIT_TEST (testChannelLayouts);
   CPPUNIT_TEST_SUITE_END ();
 
   public:
@@ -96,6 +97,50 @@ class InterleaverDeInterleaverTest : public CppUnit::TestFixture
 
 	}
 
+	void testChannelLayouts()
+	{
+		/* 2 and 4 channels use vectorized code, with a scalar tail */
+		samplecnt_t const spc = 127;
+
+		for (unsigned int ch = 1; ch <= 6; ++ch) {
+			float* data = TestUtils::init_random_data (spc * ch, 1.0);
+
+			Interleaver<float> il;
+			DeInterleaver<float> dil;
+			il.init (ch, spc);
+			dil.init (ch, spc);
+
+			boost::shared_ptr<VectorSink<float> > interleaved (new VectorSink<float>());
+			il.add_output (interleaved);
+
+			std::vector<boost::shared_ptr<VectorSink<float> > > sinks;
+			for (unsigned int c = 0; c < ch; ++c) {
+				sinks.push_back (boost::shared_ptr<VectorSink<float> > (new VectorSink<float>()));
+				dil.output (c)->add_output (sinks.back ());
+			}
+
+			/* channel c is data[c * spc .. (c + 1) * spc) */
+			for (unsigned int c = 0; c < ch; ++c) {
+				il.input (c)->process (ProcessContext<float> (&data[c * spc], spc, 1));
+			}
+
+			CPPUNIT_ASSERT_EQUAL (spc * ch, (samplecnt_t) interleaved->get_data().size());
+			for (samplecnt_t i = 0; i < spc; ++i) {
+				for (unsigned int c = 0; c < ch; ++c) {
+					CPPUNIT_ASSERT_EQUAL (data[c * spc + i], interleaved->get_data()[i * ch + c]);
+				}
+			}
+
+			std::vector<float> il_data (interleaved->get_data());
+			dil.process (ProcessContext<float> (&il_data[0], spc * ch, ch));
+			for (unsigned int c = 0; c < ch; ++c) {
+				CPPUNIT_ASSERT (TestUtils::array_equals (&data[c * spc], sinks[c]->get_array(), spc));
+			}
+
+			delete [] data;
+		}
+	}
+
   private:
 	boost::shared_ptr<Interleaver<float> > interleaver;
 	boost::shared_ptr<DeInterleaver<float> > deinterleaver;
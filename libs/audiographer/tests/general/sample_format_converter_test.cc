@@ -1,9 +1,64 @@
 #include "tests/utils.h"
 
+#include <cmath>
+
 #include "audiographer/general/sample_format_converter.h"
 
 using namespace AudioGrapher;
 
+/* Scalar reference of the gdither conversion to 16 bit, and 24 bit
+ * in a 32 bit word, used to check that the optimized conversion
+ * is bit-exact.
+ */
+struct ReferenceConverter
+{
+	ReferenceConverter (int type, int bits, ChannelCount channels)
+		: type (type), bits (bits), channels (channels), rnd (23232323), tri_state (channels, 0.f)
+	{}
+
+	float noise ()
+	{
+		rnd = (rnd * 196314165) + 907633515;
+		return rnd * 2.3283064365387e-10f;
+	}
+
+	template<typename T>
+	void process (float const * x, T * y, samplecnt_t samples_per_channel)
+	{
+		float const   scale      = bits == 16 ? 32768.0f : 8388608.0f;
+		int64_t const clamp_u    = bits == 16 ? 32767 : 8388607;
+		int64_t const clamp_l    = bits == 16 ? -32768 : -8388608;
+		int64_t const post_scale = bits == 16 ? 1 : 256;
+
+		for (ChannelCount c = 0; c < channels; ++c) {
+			for (samplecnt_t pos = 0; pos < samples_per_channel; ++pos) {
+				samplecnt_t const i = c + pos * channels;
+				float tmp = x[i] * scale + 0.0f;
+				if (type == D_Rect) {
+					tmp -= noise ();
+				} else if (type == D_Tri) {
+					float const r = noise () - 0.5f;
+					tmp -= r - tri_state[c];
+					tri_state[c] = r;
+				}
+				int64_t clamped = lrintf (tmp);
+				if (clamped > clamp_u) {
+					clamped = clamp_u;
+				} else if (clamped < clamp_l) {
+					clamped = clamp_l;
+				}
+				y[i] = (T) (clamped * post_scale);
+			}
+		}
+	}
+
+	int                type;
+	int                bits;
+	ChannelCount       channels;
+	uint32_t           rnd;
+	std::vector<float> tri_state;
+};
+
 class SampleFormatConverterTest : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE (SampleFormatConverterTest);
@@ -15,6 +70,8 @@ class SampleFormatConverterTest : public CppUnit::TestFixture
   CPPUNIT_TEST (testInt16);
   CPPUNIT_TEST (testUint8);
   CPPUNIT_TEST (testChannelCount);
+  CPPUNIT_TEST (testBitExactInt16);
+  CPPUNIT_TEST (testBitExactInt24);
   CPPUNIT_TEST_SUITE_END ();
 
   public:
@@ -204,8 +261,57 @@ class SampleFormatConverterTest : public CppUnit::TestFixture
 		CPPUNIT_ASSERT (TestUtils::array_filled(sink->get_array(), pc.samples()));
 	}
 
+	void testBitExactInt16()
+	{
+		testBitExact<int16_t> (16);
+	}
+
+	void testBitExactInt24()
+	{
+		testBitExact<int32_t> (24);
+	}
+
   private:
 
+	template<typename T>
+	void testBitExact (int bits)
+	{
+		int const          types[]    = { D_None, D_Rect, D_Tri };
+		ChannelCount const channels[] = { 1, 2, 3, 4 };
+		samplecnt_t const  max_spc    = 1021;
+
+		for (size_t t = 0; t < sizeof (types) / sizeof (types[0]); ++t) {
+			for (size_t n = 0; n < sizeof (channels) / sizeof (channels[0]); ++n) {
+				ChannelCount const ch = channels[n];
+				float* data = TestUtils::init_random_data (max_spc * ch, 1.0);
+
+				// Make sure a few samples are clipped
+				data[5]  = 1.5;
+				data[17] = -1.5;
+
+				boost::shared_ptr<SampleFormatConverter<T> > converter (new SampleFormatConverter<T>(ch));
+				boost::shared_ptr<VectorSink<T> > sink (new VectorSink<T>());
+				converter->init (max_spc * ch, types[t], bits);
+				converter->add_output (sink);
+
+				ReferenceConverter ref (types[t], bits, ch);
+				std::vector<T> expected (max_spc * ch);
+
+				/* dither state must be carried over, use a few odd sizes */
+				samplecnt_t const spc[] = { max_spc, 3, 64, 517 };
+				for (size_t i = 0; i < sizeof (spc) / sizeof (spc[0]); ++i) {
+					ProcessContext<float> pc (data, spc[i] * ch, ch);
+					converter->process (pc);
+					ref.process (data, &expected[0], spc[i]);
+					CPPUNIT_ASSERT_EQUAL (spc[i] * ch, (samplecnt_t) sink->get_data().size());
+					CPPUNIT_ASSERT (TestUtils::array_equals (&expected[0], sink->get_array(), spc[i] * ch));
+				}
+
+				delete [] data;
+			}
+		}
+	}
+
 	float * random_data;
 	samplecnt_t samples;
 };
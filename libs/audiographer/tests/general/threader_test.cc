@@ -11,6 +11,8 @@ class ThreaderTest : public CppUnit::TestFixture
   CPPUNIT_TEST (testRemoveOutput);
   CPPUNIT_TEST (testClearOutputs);
   CPPUNIT_TEST (testExceptions);
+  CPPUNIT_TEST (testPipelined);
+  CPPUNIT_TEST (testQueueFull);
   CPPUNIT_TEST_SUITE_END ();
 
   public:
@@ -22,7 +24,7 @@ class ThreaderTest : public CppUnit::TestFixture
 		zero_data = new float[samples];
 		memset (zero_data, 0, samples * sizeof(float));
 
-		thread_pool = new Glib::ThreadPool (3);
+		thread_pool = new ThreaderPool (3);
 		threader.reset (new Threader<float> (*thread_pool));
 
 		sink_a.reset (new VectorSink<float>());
@@ -40,7 +42,7 @@ class ThreaderTest : public CppUnit::TestFixture
 		delete [] random_data;
 		delete [] zero_data;
 
-		thread_pool->shutdown();
+		threader.reset ();
 		delete thread_pool;
 	}
 
@@ -134,8 +136,66 @@ class ThreaderTest : public CppUnit::TestFixture
 		CPPUNIT_ASSERT (TestUtils::array_equals(random_data, sink_e->get_array(), samples));
 	}
 
+	void testPipelined()
+	{
+		threader.reset (new Threader<float> (*thread_pool, 4));
+
+		boost::shared_ptr<AppendingVectorSink<float> > sink_x (new AppendingVectorSink<float>());
+		boost::shared_ptr<AppendingVectorSink<float> > sink_y (new AppendingVectorSink<float>());
+		threader->add_output (sink_x);
+		threader->add_output (sink_y);
+
+		/* process() may return before the data was processed, but
+		 * the threader must not depend on the caller's buffer.
+		 */
+		float * data = new float[samples];
+		unsigned int const n_chunks = 10;
+		for (unsigned int i = 0; i < n_chunks; ++i) {
+			memcpy (data, random_data, samples * sizeof(float));
+			ProcessContext<float> c (data, samples, 1);
+			if (i == n_chunks - 1) {
+				c.set_flag (ProcessContext<float>::EndOfInput);
+			}
+			threader->process (c);
+			memset (data, 0, samples * sizeof(float));
+		}
+		delete [] data;
+
+		// all chunks must have been processed at the end of input
+		CPPUNIT_ASSERT_EQUAL ((size_t) (n_chunks * samples), sink_x->get_data().size());
+		CPPUNIT_ASSERT_EQUAL ((size_t) (n_chunks * samples), sink_y->get_data().size());
+		for (unsigned int i = 0; i < n_chunks; ++i) {
+			CPPUNIT_ASSERT (TestUtils::array_equals(random_data, &sink_x->get_data()[i * samples], samples));
+			CPPUNIT_ASSERT (TestUtils::array_equals(random_data, &sink_y->get_data()[i * samples], samples));
+		}
+	}
+
+	void testQueueFull()
+	{
+		/* more outputs than the queue can hold, tasks are run inline */
+		ThreaderPool small_pool (1, 2);
+		threader.reset (new Threader<float> (small_pool, 2));
+
+		threader->add_output (sink_a);
+		threader->add_output (sink_b);
+		threader->add_output (sink_c);
+		threader->add_output (sink_d);
+		threader->add_output (sink_e);
+		threader->add_output (sink_f);
+
+		ProcessContext<float> c (random_data, samples, 1);
+		c.set_flag (ProcessContext<float>::EndOfInput);
+		threader->process (c);
+
+		CPPUNIT_ASSERT (TestUtils::array_equals(random_data, sink_a->get_array(), samples));
+		CPPUNIT_ASSERT (TestUtils::array_equals(random_data, sink_c->get_array(), samples));
+		CPPUNIT_ASSERT (TestUtils::array_equals(random_data, sink_f->get_array(), samples));
+
+		threader.reset ();
+	}
+
   private:
-	Glib::ThreadPool * thread_pool;
+	ThreaderPool * thread_pool;
 
 	boost::shared_ptr<Threader<float> > threader;
 	boost::shared_ptr<VectorSink<float> > sink_a;
@@ -1,5 +1,8 @@
+#include <glibmm/miscutils.h>
+
 #include "tests/utils.h"
 #include "audiographer/sndfile/tmp_file_sync.h"
+#include "audiographer/sndfile/tmp_file_mem.h"
 
 using namespace AudioGrapher;
 
@@ -7,6 +10,10 @@ class TmpFileTest : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE (TmpFileTest);
   CPPUNIT_TEST (testProcess);
+  CPPUNIT_TEST (testMemory);
+  CPPUNIT_TEST (testSpill);
+  CPPUNIT_TEST (testSpillBoundary);
+  CPPUNIT_TEST (testSharedBudget);
   CPPUNIT_TEST_SUITE_END ();
 
   public:
@@ -19,6 +26,7 @@ class TmpFileTest : public CppUnit::TestFixture
 	void tearDown()
 	{
 		delete [] random_data;
+		mem_file.reset ();
 	}
 
 	void testProcess()
@@ -36,8 +44,118 @@ class TmpFileTest : public CppUnit::TestFixture
 		CPPUNIT_ASSERT (TestUtils::array_equals (random_data, c.data(), c.samples()));
 	}
 
+	void testMemory()
+	{
+		uint32_t channels = 2;
+		mem_file.reset (new TmpFileMem<float>(new TmpFileStore (1 << 20, spill_template ()), SF_FORMAT_RAW | SF_FORMAT_FLOAT, channels, 44100));
+		write_read (*mem_file, channels);
+		CPPUNIT_ASSERT (!mem_file->store ().spilled ());
+	}
+
+	void testSpill()
+	{
+		uint32_t channels = 2;
+		/* no memory budget, everything is written to a file */
+		mem_file.reset (new TmpFileMem<float>(new TmpFileStore (0, spill_template ()), SF_FORMAT_RAW | SF_FORMAT_FLOAT, channels, 44100));
+		write_read (*mem_file, channels);
+		CPPUNIT_ASSERT (mem_file->store ().spilled ());
+		CPPUNIT_ASSERT_EQUAL ((size_t) 0, mem_file->store ().memory_used ());
+	}
+
+	void testSpillBoundary()
+	{
+		uint32_t channels = 2;
+		samplecnt_t const chunk = 4096;
+		/* 1.5 MiB, of which 1 MiB is kept in memory */
+		samplecnt_t const n = 3 * (1 << 20) / 2 / sizeof (float);
+		float* data = TestUtils::init_random_data (n);
+
+		mem_file.reset (new TmpFileMem<float>(new TmpFileStore (1 << 20, spill_template ()), SF_FORMAT_RAW | SF_FORMAT_FLOAT, channels, 44100));
+		for (samplecnt_t s = 0; s < n; s += chunk) {
+			ProcessContext<float> c (&data[s], chunk, channels);
+			if (s + chunk >= n) {
+				c.set_flag (ProcessContext<float>::EndOfInput);
+			}
+			mem_file->process (c);
+		}
+		CPPUNIT_ASSERT (mem_file->store ().spilled ());
+		CPPUNIT_ASSERT_EQUAL ((size_t) 1 << 20, mem_file->store ().memory_used ());
+
+		/* read everything, across the memory/spill boundary */
+		AllocatingProcessContext<float> c (n, channels);
+		mem_file->seek (0, SEEK_SET);
+		CPPUNIT_ASSERT_EQUAL (n, mem_file->read (c));
+		CPPUNIT_ASSERT (TestUtils::array_equals (data, c.data(), n));
+
+		/* write into the spilled part, and read the following data
+		 * without seeking in between.
+		 */
+		samplecnt_t const pos = n - 2 * chunk; // in spilled part
+		mem_file->seek (pos / channels, SEEK_SET);
+		ProcessContext<float> w (&data[pos], chunk, channels);
+		mem_file->process (w);
+
+		AllocatingProcessContext<float> r (chunk, channels);
+		CPPUNIT_ASSERT_EQUAL (chunk, mem_file->read (r));
+		CPPUNIT_ASSERT (TestUtils::array_equals (&data[pos + chunk], r.data(), chunk));
+
+		/* read a range that straddles the boundary */
+		samplecnt_t const boundary = (1 << 20) / sizeof (float);
+		mem_file->seek ((boundary - chunk) / channels, SEEK_SET);
+		AllocatingProcessContext<float> b (2 * chunk, channels);
+		CPPUNIT_ASSERT_EQUAL (2 * chunk, mem_file->read (b));
+		CPPUNIT_ASSERT (TestUtils::array_equals (&data[boundary - chunk], b.data(), 2 * chunk));
+
+		delete [] data;
+	}
+
+	void testSharedBudget()
+	{
+		uint32_t channels = 2;
+		boost::shared_ptr<TmpFileBudget> budget (new TmpFileBudget (1 << 20));
+
+		/* the first store uses the complete budget */
+		mem_file.reset (new TmpFileMem<float>(new TmpFileStore (budget, spill_template ()), SF_FORMAT_RAW | SF_FORMAT_FLOAT, channels, 44100));
+		write_read (*mem_file, channels);
+		CPPUNIT_ASSERT (!mem_file->store ().spilled ());
+		CPPUNIT_ASSERT_EQUAL ((uint64_t) 0, budget->available ());
+
+		/* so the second one has to use a file */
+		boost::shared_ptr<TmpFileMem<float> > other (new TmpFileMem<float>(new TmpFileStore (budget, spill_template ()), SF_FORMAT_RAW | SF_FORMAT_FLOAT, channels, 44100));
+		write_read (*other, channels);
+		CPPUNIT_ASSERT (other->store ().spilled ());
+
+		/* memory is returned to the budget */
+		mem_file.reset ();
+		CPPUNIT_ASSERT_EQUAL ((uint64_t) 1 << 20, budget->available ());
+	}
+
   private:
+	std::string spill_template ()
+	{
+		return Glib::build_filename (Glib::get_tmp_dir (), "audiographer-XXXXXX");
+	}
+
+	void write_read (TmpFile<float> & tmp, uint32_t channels)
+	{
+		/* write in several chunks */
+		for (samplecnt_t s = 0; s < samples; s += channels * 16) {
+			ProcessContext<float> c (&random_data[s], channels * 16, channels);
+			if (s + channels * 16 >= samples) {
+				c.set_flag (ProcessContext<float>::EndOfInput);
+			}
+			tmp.process (c);
+		}
+		CPPUNIT_ASSERT_EQUAL (samples, tmp.get_samples_written ());
+
+		AllocatingProcessContext<float> c (samples, channels);
+		tmp.seek (0, SEEK_SET);
+		CPPUNIT_ASSERT_EQUAL (samples, tmp.read (c));
+		CPPUNIT_ASSERT (TestUtils::array_equals (random_data, c.data(), c.samples()));
+	}
+
 	boost::shared_ptr<TmpFileSync<float> > file;
+	boost::shared_ptr<TmpFileMem<float> > mem_file;
 
 	float * random_data;
 	samplecnt_t samples;
@@ -1121,7 +1121,15 @@ AlsaAudioBackend::stop ()
 	stop_listen_for_midi_device_changes ();
 
 	while (!_rmidi_out.empty ()) {
-		AlsaMidiIO* m = _rmidi_out.back ();
+		AlsaMidiOut* m = _rmidi_out.back ();
+		uint64_t n;
+		int64_t  min, max;
+		double   avg, dev;
+		m->jitter_stats (n, min, max, avg, dev);
+		if (n > 0) {
+			PBD::info << string_compose (_("AlsaMidiOut: '%1' sent %2 events, timing error min: %3 max: %4 avg: %5 dev: %6 [usec]"),
+			                             m->name (), n, min, max, avg, dev) << endmsg;
+		}
 		m->stop ();
 		_rmidi_out.pop_back ();
 		delete m;
@@ -1132,6 +1140,7 @@ AlsaAudioBackend::stop ()
 		_rmidi_in.pop_back ();
 		delete m;
 	}
+	_midi_io.stop ();
 
 	while (!_slaves.empty ()) {
 		AudioSlave* s = _slaves.back ();
@@ -1139,6 +1148,9 @@ AlsaAudioBackend::stop ()
 		delete s;
 	}
 
+	_capt_ports.clear ();
+	_capt_buffers.clear ();
+	_play_buffers.clear ();
 	unregister_ports ();
 	delete _pcmi;
 	_pcmi = 0;
@@ -1295,6 +1307,10 @@ AlsaAudioBackend::register_system_audio_ports ()
 
 	const uint32_t lcpp = (_periods_per_cycle - 2) * _samples_per_period;
 
+	_capt_ports.clear ();
+	_capt_buffers.clear ();
+	_play_buffers.clear ();
+
 	/* audio ports */
 	lr.min = lr.max = (_measure_latency ? 0 : _systemic_audio_input_latency);
 	for (int i = 1; i <= a_ins; ++i) {
@@ -1307,6 +1323,9 @@ AlsaAudioBackend::register_system_audio_ports ()
 		BackendPortPtr ap = boost::dynamic_pointer_cast<BackendPort> (p);
 		ap->set_hw_port_name (string_compose (_("Main In %1"), i));
 		_system_inputs.push_back (ap);
+		AlsaAudioPort* aap = static_cast<AlsaAudioPort*> (ap.get ());
+		_capt_ports.push_back (aap);
+		_capt_buffers.push_back (aap->buffer ());
 	}
 
 	lr.min = lr.max = lcpp + (_measure_latency ? 0 : _systemic_audio_output_latency);
@@ -1324,6 +1343,7 @@ AlsaAudioBackend::register_system_audio_ports ()
 			ap->set_hw_port_name (string_compose (_("Main Out %1"), i));
 		}
 		_system_outputs.push_back (ap);
+		_play_buffers.push_back (static_cast<AlsaAudioPort*> (ap.get ())->buffer ());
 	}
 	return 0;
 }
@@ -1564,7 +1584,7 @@ AlsaAudioBackend::register_system_midi_ports (const std::string device)
 		} else {
 			mout->setup_timing (_samples_per_period, _samplerate);
 			mout->sync_time (g_get_monotonic_time ());
-			if (mout->start ()) {
+			if (mout->start (_midi_io)) {
 				PBD::warning << string_compose (_("AlsaMidiOut: failed to start midi device '%1'."), i->second) << endmsg;
 				delete mout;
 			} else {
@@ -1607,7 +1627,7 @@ AlsaAudioBackend::register_system_midi_ports (const std::string device)
 		} else {
 			midin->setup_timing (_samples_per_period, _samplerate);
 			midin->sync_time (g_get_monotonic_time ());
-			if (midin->start ()) {
+			if (midin->start (_midi_io)) {
 				PBD::warning << string_compose (_("AlsaMidiIn: failed to start midi device '%1'."), i->second) << endmsg;
 				delete midin;
 			} else {
@@ -1919,11 +1939,22 @@ AlsaAudioBackend::main_process_thread ()
 				clock1         = g_get_monotonic_time ();
 				no_proc_errors = 0;
 
+				/* With non-interleaved float devices, the capture ports
+				 * directly use the mmapped area during the process callback.
+				 * Otherwise all channels are converted in one pass.
+				 */
 				_pcmi->capt_init (_samples_per_period);
-				for (std::vector<BackendPortPtr>::const_iterator it = _system_inputs.begin (); it != _system_inputs.end (); ++it, ++i) {
-					_pcmi->capt_chan (i, (float*)(*it)->get_buffer (_samples_per_period), _samples_per_period);
+				const bool capt_alias = !_capt_ports.empty () && _pcmi->capt_area (0);
+				if (capt_alias) {
+					for (i = 0; i < _capt_ports.size (); ++i) {
+						_capt_ports[i]->set_alias (_pcmi->capt_area (i));
+					}
+				} else {
+					if (!_capt_buffers.empty ()) {
+						_pcmi->capt_chans (&_capt_buffers[0], _capt_buffers.size (), _samples_per_period);
+					}
+					_pcmi->capt_done (_samples_per_period);
 				}
-				_pcmi->capt_done (_samples_per_period);
 
 				for (AudioSlaves::iterator s = _slaves.begin (); s != _slaves.end (); ++s) {
 					if (!(*s)->active) {
@@ -1967,6 +1998,13 @@ AlsaAudioBackend::main_process_thread ()
 					return 0;
 				}
 
+				if (capt_alias) {
+					for (i = 0; i < _capt_ports.size (); ++i) {
+						_capt_ports[i]->set_alias (0);
+					}
+					_pcmi->capt_done (_samples_per_period);
+				}
+
 				/* only used when adding/removing MIDI device/system ports */
 				pthread_mutex_lock (&_device_port_mutex);
 				for (std::vector<BackendPortPtr>::iterator it = _system_midi_out.begin (); it != _system_midi_out.end (); ++it) {
@@ -1987,14 +2025,8 @@ AlsaAudioBackend::main_process_thread ()
 				pthread_mutex_unlock (&_device_port_mutex);
 
 				/* write back audio */
-				i = 0;
 				_pcmi->play_init (_samples_per_period);
-				for (std::vector<BackendPortPtr>::const_iterator it = _system_outputs.begin (); it != _system_outputs.end (); ++it, ++i) {
-					_pcmi->play_chan (i, (const float*)(*it)->get_buffer (_samples_per_period), _samples_per_period);
-				}
-				for (; i < _pcmi->nplay (); ++i) {
-					_pcmi->clear_chan (i, _samples_per_period);
-				}
+				_pcmi->play_chans (_play_buffers.empty () ? 0 : &_play_buffers[0], _play_buffers.size (), _samples_per_period);
 				_pcmi->play_done (_samples_per_period);
 
 				for (AudioSlaves::iterator s = _slaves.begin (); s != _slaves.end (); ++s) {
@@ -2300,6 +2332,7 @@ extern "C" ARDOURBACKEND_API ARDOUR::AudioBackendInfo* descriptor ()
 
 AlsaAudioPort::AlsaAudioPort (AlsaAudioBackend& b, const std::string& name, PortFlags flags)
 	: BackendPort (b, name, flags)
+	, _alias (0)
 {
 	memset (_buffer, 0, sizeof (_buffer));
 	mlock (_buffer, sizeof (_buffer));
@@ -2331,6 +2364,9 @@ AlsaAudioPort::get_buffer (pframes_t n_samples)
 				}
 			}
 		}
+	} else if (_alias) {
+		/* system capture port, read-only */
+		return const_cast<Sample*> (_alias);
 	}
 	return _buffer;
 }
@@ -73,11 +73,16 @@ class AlsaAudioPort : public BackendPort {
 		DataType type () const { return DataType::AUDIO; };
 
 		Sample* buffer () { return _buffer; }
-		const Sample* const_buffer () const { return _buffer; }
+		const Sample* const_buffer () const { return _alias ? _alias : _buffer; }
 		void* get_buffer (pframes_t nframes);
 
+		/* use the device's capture area instead of _buffer,
+		 * valid only during the current cycle */
+		void set_alias (const Sample* a) { _alias = a; }
+
 	private:
 		Sample _buffer[8192];
+		const Sample* _alias;
 }; // class AlsaAudioPort
 
 class AlsaMidiPort : public BackendPort {
@@ -311,6 +316,11 @@ class AlsaAudioBackend : public AudioBackend, public PortEngineSharedImpl
 		uint32_t _n_inputs;
 		uint32_t _n_outputs;
 
+		/* system port buffers, for block transfer to/from the device */
+		std::vector<AlsaAudioPort*> _capt_ports;
+		std::vector<float*>         _capt_buffers;
+		std::vector<const float*>   _play_buffers;
+
 		uint32_t _systemic_audio_input_latency;
 		uint32_t _systemic_audio_output_latency;
 
@@ -370,6 +380,7 @@ class AlsaAudioBackend : public AudioBackend, public PortEngineSharedImpl
 		int register_system_midi_ports (const std::string device = "");
 		void update_system_port_latencies ();
 
+		AlsaMidiIOThread           _midi_io;
 		std::vector<AlsaMidiOut *> _rmidi_out;
 		std::vector<AlsaMidiIn  *> _rmidi_in;
 
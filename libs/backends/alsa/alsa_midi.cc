@@ -18,10 +18,20 @@
 
 #include <unistd.h>
 
+#include <algorithm>
+#include <cmath>
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
 #include <glibmm.h>
 
 #include "alsa_midi.h"
 
+#include "pbd/compose.h"
 #include "pbd/error.h"
 #include "pbd/pthread_utils.h"
 #include "pbd/i18n.h"
@@ -35,17 +45,15 @@ using namespace ARDOUR;
 #endif
 
 AlsaMidiIO::AlsaMidiIO ()
-	: _state (-1)
-	, _running (false)
+	: _io_thread (0)
+	, _state (-1)
+	, _npfds (0)
 	, _pfds (0)
 	, _sample_length_us (1e6 / 48000.0)
 	, _period_length_us (1.024e6 / 48000.0)
 	, _samples_per_period (1024)
 	, _rb (0)
 {
-	pthread_mutex_init (&_notify_mutex, 0);
-	pthread_cond_init (&_notify_ready, 0);
-
 	// MIDI (hw port) 31.25 kbaud
 	// worst case here is  8192 SPP and 8KSPS for which we'd need
 	// 4000 bytes sans MidiEventHeader.
@@ -55,60 +63,32 @@ AlsaMidiIO::AlsaMidiIO ()
 
 AlsaMidiIO::~AlsaMidiIO ()
 {
+	assert (!_io_thread);
 	delete _rb;
-	pthread_mutex_destroy (&_notify_mutex);
-	pthread_cond_destroy (&_notify_ready);
 	free (_pfds);
 }
 
-static void * pthread_process (void *arg)
-{
-	AlsaMidiIO *d = static_cast<AlsaMidiIO *>(arg);
-	pthread_set_name ("AlsaMidiIO");
-	d->main_process_thread ();
-	pthread_exit (0);
-	return 0;
-}
-
 int
-AlsaMidiIO::start ()
+AlsaMidiIO::start (AlsaMidiIOThread& t)
 {
-	if (pbd_realtime_pthread_create (PBD_SCHED_FIFO, PBD_RT_PRI_MIDI, PBD_RT_STACKSIZE_HELP,
-				&_main_thread, pthread_process, this))
-	{
-		if (pbd_pthread_create (PBD_RT_STACKSIZE_HELP, &_main_thread, pthread_process, this)) {
-			PBD::error << _("AlsaMidiIO: Failed to create process thread.") << endmsg;
-			return -1;
-		} else {
-			PBD::warning << _("AlsaMidiIO: Cannot acquire realtime permissions.") << endmsg;
-		}
+	if (_io_thread) {
+		return 0;
 	}
-	int timeout = 5000;
-	while (!_running && --timeout > 0) { Glib::usleep (1000); }
-	if (timeout == 0 || !_running) {
+	if (t.add (this)) {
 		return -1;
 	}
+	_io_thread = &t;
 	return 0;
 }
 
 int
 AlsaMidiIO::stop ()
 {
-	void *status;
-	if (!_running) {
+	if (!_io_thread) {
 		return 0;
 	}
-
-	_running = false;
-
-	pthread_mutex_lock (&_notify_mutex);
-	pthread_cond_signal (&_notify_ready);
-	pthread_mutex_unlock (&_notify_mutex);
-
-	if (pthread_join (_main_thread, &status)) {
-		PBD::error << _("AlsaMidiIO: Failed to terminate.") << endmsg;
-		return -1;
-	}
+	_io_thread->remove (this);
+	_io_thread = 0;
 	return 0;
 }
 
@@ -140,6 +120,13 @@ AlsaMidiIO::sync_time (const uint64_t tme)
 
 AlsaMidiOut::AlsaMidiOut ()
 	: AlsaMidiIO ()
+	, _pending (0, 0)
+	, _need_drain (0)
+	, _jitter_n (0)
+	, _jitter_min (0)
+	, _jitter_max (0)
+	, _jitter_sum (0)
+	, _jitter_sum2 (0)
 {
 }
 
@@ -155,13 +142,111 @@ AlsaMidiOut::send_event (const pframes_t time, const uint8_t *data, const size_t
 	_rb->write ((uint8_t*) &h, sizeof(MidiEventHeader));
 	_rb->write (data, size);
 
-	if (pthread_mutex_trylock (&_notify_mutex) == 0) {
-		pthread_cond_signal (&_notify_ready);
-		pthread_mutex_unlock (&_notify_mutex);
+	if (_io_thread) {
+		_io_thread->wakeup ();
 	}
 	return 0;
 }
 
+/* events due within this time [usec] are sent together */
+#define MIDI_OUT_TOLERANCE (100)
+
+int
+AlsaMidiOut::service (uint64_t now, uint64_t& next)
+{
+	next = 0;
+	while (true) {
+		if (_pending.size == 0) {
+			struct MidiEventHeader h (0, 0);
+			PBD::RingBuffer<uint8_t>::rw_vector vector;
+			if (_rb->read_space () <= sizeof(MidiEventHeader)) {
+				break;
+			}
+			/* peek, keep the event in the buffer until it is due */
+			_rb->get_read_vector (&vector);
+			if (vector.len[0] >= sizeof(MidiEventHeader)) {
+				memcpy ((uint8_t*)&h, vector.buf[0], sizeof(MidiEventHeader));
+			} else {
+				if (vector.len[0] > 0) {
+					memcpy ((uint8_t*)&h, vector.buf[0], vector.len[0]);
+				}
+				memcpy (((uint8_t*)&h) + vector.len[0], vector.buf[1], sizeof(MidiEventHeader) - vector.len[0]);
+			}
+			if (h.time > now + MIDI_OUT_TOLERANCE) {
+				next = h.time;
+				break;
+			}
+			_rb->increment_read_idx (sizeof(MidiEventHeader));
+			if (h.size > MaxAlsaMidiEventSize) {
+				_rb->increment_read_idx (h.size);
+				_DEBUGPRINT("AlsaMidiOut: MIDI event too large!\n");
+				continue;
+			}
+			if (_rb->read (&_data[0], h.size) != h.size) {
+				_DEBUGPRINT("AlsaMidiOut: Garbled MIDI EVENT DATA!!\n");
+				return -1;
+			}
+			_pending = h;
+		}
+
+		ssize_t err = write_event (_data, _pending.size);
+		if (err < 0) {
+			return -1;
+		}
+		if (err == 0) {
+			/* device is busy, retry in 1ms */
+			next = now + 1000;
+			return 0;
+		}
+		if ((size_t) err < _pending.size) {
+			_DEBUGPRINT("AlsaMidiOut: short write\n");
+			memmove (&_data[0], &_data[err], _pending.size - err);
+			_pending.size -= err;
+			continue;
+		}
+
+		const int64_t jitter = (int64_t)(now - _pending.time);
+		if (_jitter_n == 0) {
+			_jitter_min = _jitter_max = jitter;
+		} else {
+			_jitter_min = std::min (_jitter_min, jitter);
+			_jitter_max = std::max (_jitter_max, jitter);
+		}
+		++_jitter_n;
+		_jitter_sum  += jitter;
+		_jitter_sum2 += (double)jitter * jitter;
+
+		if ((_need_drain += _pending.size) >= 64) {
+			drain ();
+			_need_drain = 0;
+		}
+		_pending.size = 0;
+	}
+
+	if (_need_drain > 0) {
+		drain ();
+		_need_drain = 0;
+	}
+	return 0;
+}
+
+void
+AlsaMidiOut::jitter_stats (uint64_t& n_events, int64_t& min, int64_t& max, double& avg, double& dev) const
+{
+	AlsaMidiIOThread* t = _io_thread;
+	if (t) {
+		pthread_mutex_lock (&t->lock ());
+	}
+	n_events = _jitter_n;
+	min      = _jitter_min;
+	max      = _jitter_max;
+	avg      = _jitter_n > 0 ? _jitter_sum / _jitter_n : 0;
+	dev      = _jitter_n > 1 ? sqrt (std::max (0.0, (_jitter_sum2 - _jitter_sum * avg) / (_jitter_n - 1))) : 0;
+	if (t) {
+		pthread_mutex_unlock (&t->lock ());
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 AlsaMidiIn::AlsaMidiIn ()
@@ -243,3 +328,265 @@ AlsaMidiIn::queue_event (const uint64_t time, const uint8_t *data, const size_t
 	_rb->write (data, size);
 	return 0;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+AlsaMidiIOThread::AlsaMidiIOThread ()
+	: _running (false)
+	, _epfd (-1)
+	, _timerfd (-1)
+	, _eventfd (-1)
+	, _notified (0)
+{
+	pthread_mutex_init (&_lock, 0);
+}
+
+AlsaMidiIOThread::~AlsaMidiIOThread ()
+{
+	stop ();
+	pthread_mutex_destroy (&_lock);
+}
+
+void*
+AlsaMidiIOThread::_thread (void* arg)
+{
+	AlsaMidiIOThread* self = static_cast<AlsaMidiIOThread*> (arg);
+	pthread_set_name ("AlsaMidiIO");
+	self->main_loop ();
+	pthread_exit (0);
+	return 0;
+}
+
+int
+AlsaMidiIOThread::start ()
+{
+	if (_running) {
+		return 0;
+	}
+
+	_epfd    = epoll_create1 (EPOLL_CLOEXEC);
+	_timerfd = timerfd_create (CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	_eventfd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	struct epoll_event ev;
+	bool ok = _epfd >= 0 && _timerfd >= 0 && _eventfd >= 0;
+
+	if (ok) {
+		ev.events   = EPOLLIN;
+		ev.data.ptr = &_timerfd;
+		ok = 0 == epoll_ctl (_epfd, EPOLL_CTL_ADD, _timerfd, &ev);
+	}
+	if (ok) {
+		ev.events   = EPOLLIN;
+		ev.data.ptr = &_eventfd;
+		ok = 0 == epoll_ctl (_epfd, EPOLL_CTL_ADD, _eventfd, &ev);
+	}
+
+	if (!ok) {
+		PBD::error << _("AlsaMidiIO: Failed to set up event polling.") << endmsg;
+		stop ();
+		return -1;
+	}
+
+	_running = true;
+	if (pbd_realtime_pthread_create (PBD_SCHED_FIFO, PBD_RT_PRI_MIDI, PBD_RT_STACKSIZE_HELP,
+				&_thread_id, _thread, this))
+	{
+		if (pbd_pthread_create (PBD_RT_STACKSIZE_HELP, &_thread_id, _thread, this)) {
+			PBD::error << _("AlsaMidiIO: Failed to create process thread.") << endmsg;
+			_running = false;
+			stop ();
+			return -1;
+		} else {
+			PBD::warning << _("AlsaMidiIO: Cannot acquire realtime permissions.") << endmsg;
+		}
+	}
+	return 0;
+}
+
+int
+AlsaMidiIOThread::stop ()
+{
+	int rv = 0;
+	if (_running) {
+		assert (_inputs.empty () && _outputs.empty ());
+		void* status;
+		_running = false;
+		g_atomic_int_set (&_notified, 0);
+		wakeup ();
+		if (pthread_join (_thread_id, &status)) {
+			PBD::error << _("AlsaMidiIO: Failed to terminate.") << endmsg;
+			rv = -1;
+		}
+	}
+	if (_epfd >= 0) {
+		close (_epfd);
+		_epfd = -1;
+	}
+	if (_timerfd >= 0) {
+		close (_timerfd);
+		_timerfd = -1;
+	}
+	if (_eventfd >= 0) {
+		close (_eventfd);
+		_eventfd = -1;
+	}
+	return rv;
+}
+
+int
+AlsaMidiIOThread::add (AlsaMidiIO* m)
+{
+	if (start ()) {
+		return -1;
+	}
+
+	pthread_mutex_lock (&_lock);
+	if (m->is_input ()) {
+		for (int i = 0; i < m->npfds (); ++i) {
+			struct epoll_event ev;
+			ev.events   = EPOLLIN;
+			ev.data.ptr = m;
+			if (epoll_ctl (_epfd, EPOLL_CTL_ADD, m->pfds ()[i].fd, &ev)) {
+				for (int k = 0; k < i; ++k) {
+					epoll_ctl (_epfd, EPOLL_CTL_DEL, m->pfds ()[k].fd, &ev);
+				}
+				pthread_mutex_unlock (&_lock);
+				PBD::error << string_compose (_("AlsaMidiIO: Cannot poll device '%1'."), m->name ()) << endmsg;
+				return -1;
+			}
+		}
+		_inputs.push_back (m);
+	} else {
+		_outputs.push_back (m);
+	}
+	pthread_mutex_unlock (&_lock);
+	return 0;
+}
+
+void
+AlsaMidiIOThread::drop (AlsaMidiIO* m)
+{
+	/* _lock must be held */
+	std::vector<AlsaMidiIO*>::iterator i;
+	if ((i = std::find (_inputs.begin (), _inputs.end (), m)) != _inputs.end ()) {
+		for (int k = 0; k < m->npfds (); ++k) {
+			struct epoll_event ev;
+			epoll_ctl (_epfd, EPOLL_CTL_DEL, m->pfds ()[k].fd, &ev);
+		}
+		_inputs.erase (i);
+	}
+	if ((i = std::find (_outputs.begin (), _outputs.end (), m)) != _outputs.end ()) {
+		_outputs.erase (i);
+	}
+}
+
+void
+AlsaMidiIOThread::remove (AlsaMidiIO* m)
+{
+	pthread_mutex_lock (&_lock);
+	drop (m);
+	pthread_mutex_unlock (&_lock);
+}
+
+void
+AlsaMidiIOThread::wakeup ()
+{
+	if (g_atomic_int_compare_and_exchange (&_notified, 0, 1)) {
+		uint64_t one = 1;
+		if (write (_eventfd, &one, sizeof (one)) != sizeof (one)) {
+			g_atomic_int_set (&_notified, 0);
+		}
+	}
+}
+
+void
+AlsaMidiIOThread::service_outputs ()
+{
+	/* _lock must be held */
+	uint64_t now      = g_get_monotonic_time ();
+	uint64_t earliest = 0;
+
+	for (std::vector<AlsaMidiIO*>::iterator i = _outputs.begin (); i != _outputs.end ();) {
+		uint64_t next;
+		if ((*i)->service (now, next)) {
+			PBD::error << string_compose (_("AlsaMidiOut: write to '%1' failed. Device removed."), (*i)->name ()) << endmsg;
+			i = _outputs.erase (i);
+			continue;
+		}
+		if (next > 0 && (earliest == 0 || next < earliest)) {
+			earliest = next;
+		}
+		++i;
+	}
+
+	/* arm the timer for the next event, or disarm it */
+	struct itimerspec ts;
+	memset (&ts, 0, sizeof (ts));
+	if (earliest > 0) {
+		ts.it_value.tv_sec  = earliest / 1000000;
+		ts.it_value.tv_nsec = (earliest % 1000000) * 1000;
+	}
+	timerfd_settime (_timerfd, TFD_TIMER_ABSTIME, &ts, NULL);
+}
+
+void
+AlsaMidiIOThread::main_loop ()
+{
+	struct epoll_event events[64];
+
+	while (_running) {
+		int n = epoll_wait (_epfd, events, 64, -1);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			PBD::error << _("AlsaMidiIO: Error polling devices. Terminating Midi Thread.") << endmsg;
+			break;
+		}
+
+		/* timestamp all input of this wakeup alike */
+		const uint64_t now = g_get_monotonic_time ();
+		bool service_out   = false;
+
+		pthread_mutex_lock (&_lock);
+
+		for (int i = 0; i < n; ++i) {
+			void* p = events[i].data.ptr;
+			if (p == &_timerfd) {
+				uint64_t expired;
+				if (read (_timerfd, &expired, sizeof (expired))) {}
+				service_out = true;
+			} else if (p == &_eventfd) {
+				uint64_t cnt;
+				g_atomic_int_set (&_notified, 0);
+				if (read (_eventfd, &cnt, sizeof (cnt))) {}
+				service_out = true;
+			} else {
+				AlsaMidiIO* m = static_cast<AlsaMidiIO*> (p);
+				if (std::find (_inputs.begin (), _inputs.end (), m) == _inputs.end ()) {
+					/* removed since epoll_wait () returned */
+					continue;
+				}
+				if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+					PBD::error << string_compose (_("AlsaMidiIn: poll error on '%1'. Device removed."), m->name ()) << endmsg;
+					drop (m);
+					continue;
+				}
+				uint64_t unused;
+				if (m->service (now, unused)) {
+					PBD::error << string_compose (_("AlsaMidiIn: read from '%1' failed. Device removed."), m->name ()) << endmsg;
+					drop (m);
+				}
+			}
+		}
+
+		if (service_out) {
+			service_outputs ();
+		}
+
+		pthread_mutex_unlock (&_lock);
+	}
+
+	_DEBUGPRINT("AlsaMidiIO: MIDI I/O THREAD STOPPED\n");
+}
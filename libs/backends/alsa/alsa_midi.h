@@ -22,7 +22,12 @@
 #include <stdint.h>
 #include <poll.h>
 #include <pthread.h>
+#include <sys/types.h>
 
+#include <string>
+#include <vector>
+
+#include "pbd/g_atomic_compat.h"
 #include "pbd/ringbuffer.h"
 #include "ardour/types.h"
 
@@ -32,29 +37,39 @@
 
 namespace ARDOUR {
 
+class AlsaMidiIOThread;
+
 class AlsaMidiIO {
 public:
 	AlsaMidiIO ();
 	virtual ~AlsaMidiIO ();
 
 	int state (void) const { return _state; }
-	int start ();
+	int start (AlsaMidiIOThread&);
 	int stop ();
 
 	void setup_timing (const size_t samples_per_period, const float samplerate);
 	void sync_time(uint64_t);
 
-	virtual void* main_process_thread () = 0;
-
 	const std::string & name () const { return _name; }
 
+	/* called from the MIDI I/O thread */
+	virtual bool is_input () const = 0;
+
+	/* inputs: read all pending data from the device,
+	 * outputs: send all events that are due at the given time,
+	 * and set `next` to the time of the next event (or 0).
+	 * return < 0 on error, the device is then removed.
+	 */
+	virtual int service (uint64_t now, uint64_t& next) = 0;
+
+	int npfds () const { return _npfds; }
+	const struct pollfd* pfds () const { return _pfds; }
+
 protected:
-	pthread_t _main_thread;
-	pthread_mutex_t _notify_mutex;
-	pthread_cond_t _notify_ready;
+	AlsaMidiIOThread* _io_thread;
 
 	int  _state;
-	bool  _running;
 
 	int _npfds;
 	struct pollfd *_pfds;
@@ -86,6 +101,29 @@ public:
 	AlsaMidiOut ();
 
 	int send_event (const pframes_t, const uint8_t *, const size_t);
+
+	bool is_input () const { return false; }
+	int  service (uint64_t now, uint64_t& next);
+
+	/* difference of actual and scheduled time of events sent
+	 * since start [usec], late events are positive */
+	void jitter_stats (uint64_t& n_events, int64_t& min, int64_t& max, double& avg, double& dev) const;
+
+protected:
+	/* return bytes written, 0 if the device is busy, < 0 on error */
+	virtual ssize_t write_event (const uint8_t *, const size_t) = 0;
+	virtual void drain () = 0;
+
+private:
+	struct MidiEventHeader _pending;
+	uint8_t  _data[MaxAlsaMidiEventSize];
+	size_t   _need_drain;
+
+	uint64_t _jitter_n;
+	int64_t  _jitter_min;
+	int64_t  _jitter_max;
+	double   _jitter_sum;
+	double   _jitter_sum2;
 };
 
 class AlsaMidiIn : virtual public AlsaMidiIO
@@ -95,10 +133,56 @@ public:
 
 	size_t recv_event (pframes_t &, uint8_t *, size_t &);
 
+	bool is_input () const { return true; }
+
 protected:
 	int queue_event (const uint64_t, const uint8_t *, const size_t);
 };
 
+/** A single thread that services all MIDI devices of a backend.
+ *
+ * Inputs are read when their poll descriptors become readable,
+ * outputs are serviced when new events are queued, and at the time
+ * of the next scheduled event (timerfd). Data is passed to and from
+ * the process thread using the lock-free ringbuffers of each device.
+ */
+class AlsaMidiIOThread {
+public:
+	AlsaMidiIOThread ();
+	~AlsaMidiIOThread ();
+
+	int  add (AlsaMidiIO*);
+	void remove (AlsaMidiIO*);
+
+	/* stop the thread, all devices must have been removed */
+	int stop ();
+
+	/* realtime-safe, called after queuing output events */
+	void wakeup ();
+
+	/* serialize access to stats of devices */
+	pthread_mutex_t& lock () { return _lock; }
+
+private:
+	int  start ();
+	void main_loop ();
+	void service_outputs ();
+	void drop (AlsaMidiIO*);
+
+	static void* _thread (void*);
+
+	pthread_t       _thread_id;
+	pthread_mutex_t _lock;
+	bool            _running;
+	int             _epfd;
+	int             _timerfd;
+	int             _eventfd;
+	GATOMIC_QUAL gint _notified;
+
+	std::vector<AlsaMidiIO*> _inputs;
+	std::vector<AlsaMidiIO*> _outputs;
+};
+
 } // namespace
 
 #endif
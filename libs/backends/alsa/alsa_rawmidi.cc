@@ -21,7 +21,6 @@
 #include <unistd.h>
 #include <glibmm.h>
 
-#include "select_sleep.h"
 #include "alsa_rawmidi.h"
 
 #include "pbd/error.h"
@@ -111,123 +110,36 @@ AlsaRawMidiOut::AlsaRawMidiOut (const std::string &name, const char *device)
 {
 }
 
-void *
-AlsaRawMidiOut::main_process_thread ()
+ssize_t
+AlsaRawMidiOut::write_event (const uint8_t *data, const size_t size)
 {
-	_running = true;
-	pthread_mutex_lock (&_notify_mutex);
-	unsigned int need_drain = 0;
-	while (_running) {
-		bool have_data = false;
-		struct MidiEventHeader h(0,0);
-		uint8_t data[MaxAlsaMidiEventSize];
-
-		const uint32_t read_space = _rb->read_space();
-
-		if (read_space > sizeof(MidiEventHeader)) {
-			if (_rb->read ((uint8_t*)&h, sizeof(MidiEventHeader)) != sizeof(MidiEventHeader)) {
-				_DEBUGPRINT("AlsaRawMidiOut: Garbled MIDI EVENT HEADER!!\n");
-				break;
-			}
-			assert (read_space >= h.size);
-			if (h.size > MaxAlsaMidiEventSize) {
-				_rb->increment_read_idx (h.size);
-				_DEBUGPRINT("AlsaRawMidiOut: MIDI event too large!\n");
-				continue;
-			}
-			if (_rb->read (&data[0], h.size) != h.size) {
-				_DEBUGPRINT("AlsaRawMidiOut: Garbled MIDI EVENT DATA!!\n");
-				break;
-			}
-			have_data = true;
-		}
-
-		if (!have_data) {
-			if (need_drain > 0) {
-				snd_rawmidi_drain (_device);
-				need_drain = 0;
-			}
-			pthread_cond_wait (&_notify_ready, &_notify_mutex);
-			continue;
-		}
-
-		uint64_t now = g_get_monotonic_time();
-		while (h.time > now + 500) {
-			if (need_drain > 0) {
-				snd_rawmidi_drain (_device);
-				need_drain = 0;
-			} else {
-				select_sleep(h.time - now);
-			}
-			now = g_get_monotonic_time();
-		}
-
-retry:
-		int perr = poll (_pfds, _npfds, 10 /* ms */);
-		if (perr < 0) {
-			PBD::error << _("AlsaRawMidiOut: Error polling device. Terminating Midi Thread.") << endmsg;
-			break;
-		}
-		if (perr == 0) {
-			_DEBUGPRINT("AlsaRawMidiOut: poll() timed out.\n");
-			goto retry;
-		}
-
-		unsigned short revents = 0;
-		if (snd_rawmidi_poll_descriptors_revents (_device, _pfds, _npfds, &revents)) {
-			PBD::error << _("AlsaRawMidiOut: Failed to poll device. Terminating Midi Thread.") << endmsg;
-			break;
-		}
-
-		if (revents & (POLLERR | POLLHUP | POLLNVAL)) {
-			PBD::error << _("AlsaRawMidiOut: poll error. Terminating Midi Thread.") << endmsg;
-			break;
-		}
-
-		if (!(revents & POLLOUT)) {
-			_DEBUGPRINT("AlsaRawMidiOut: POLLOUT not ready.\n");
-			select_sleep (1000);
-			goto retry;
-		}
-
-		ssize_t err = snd_rawmidi_write (_device, data, h.size);
+	ssize_t err = snd_rawmidi_write (_device, data, size);
 
 #if 0 // DEBUG -- not rt-safe
-		printf("TX [%ld | %ld]", h.size, err);
-		for (size_t i = 0; i < h.size; ++i) {
-			printf (" %02x", data[i]);
-		}
-		printf ("\n");
+	printf("TX [%ld | %ld]", size, err);
+	for (size_t i = 0; i < size; ++i) {
+		printf (" %02x", data[i]);
+	}
+	printf ("\n");
 #endif
 
-		if (err == -EAGAIN) {
-			snd_rawmidi_drain (_device);
-			goto retry;
-		}
-		if (err == -EWOULDBLOCK) {
-			select_sleep (1000);
-			goto retry;
-		}
-		if (err < 0) {
-			PBD::error << _("AlsaRawMidiOut: write failed. Terminating Midi Thread.") << endmsg;
-			break;
-		}
-		if ((size_t) err < h.size) {
-			_DEBUGPRINT("AlsaRawMidiOut: short write\n");
-			memmove(&data[0], &data[err], err);
-			h.size -= err;
-			goto retry;
-		}
-
-		if ((need_drain += h.size) >= 64) {
-			snd_rawmidi_drain (_device);
-			need_drain = 0;
-		}
+#if EAGAIN != EWOULDBLOCK
+	if ((err == -EAGAIN) || (err == -EWOULDBLOCK))  {
+#else
+	if (err == -EAGAIN) {
+#endif
+		return 0;
 	}
+	return err;
+}
 
-	pthread_mutex_unlock (&_notify_mutex);
-	_DEBUGPRINT("AlsaRawMidiOut: MIDI OUT THREAD STOPPED\n");
-	return 0;
+void
+AlsaRawMidiOut::drain ()
+{
+	/* The device is non-blocking, written data is sent by the driver.
+	 * snd_rawmidi_drain () waits until transmission is complete,
+	 * which would stall all other devices of the I/O thread.
+	 */
 }
 
 
@@ -245,40 +157,12 @@ AlsaRawMidiIn::AlsaRawMidiIn (const std::string &name, const char *device)
 {
 }
 
-void *
-AlsaRawMidiIn::main_process_thread ()
+int
+AlsaRawMidiIn::service (uint64_t now, uint64_t&)
 {
-	_running = true;
-	while (_running) {
-		unsigned short revents = 0;
-
-		int perr = poll (_pfds, _npfds, 100 /* ms */);
-		if (perr < 0) {
-			PBD::error << _("AlsaRawMidiIn: Error polling device. Terminating Midi Thread.") << endmsg;
-			break;
-		}
-		if (perr == 0) {
-			continue;
-		}
-
-		if (snd_rawmidi_poll_descriptors_revents (_device, _pfds, _npfds, &revents)) {
-			PBD::error << _("AlsaRawMidiIn: Failed to poll device. Terminating Midi Thread.") << endmsg;
-			break;
-		}
+	uint8_t data[MaxAlsaMidiEventSize];
 
-		if (revents & (POLLERR | POLLHUP | POLLNVAL)) {
-			PBD::error << _("AlsaRawMidiIn: poll error. Terminating Midi Thread.") << endmsg;
-			break;
-		}
-
-		if (!(revents & POLLIN)) {
-			_DEBUGPRINT("AlsaRawMidiOut: POLLIN not ready.\n");
-			select_sleep (1000);
-			continue;
-		}
-
-		uint8_t data[MaxAlsaMidiEventSize];
-		uint64_t time = g_get_monotonic_time();
+	while (true) {
 		ssize_t err = snd_rawmidi_read (_device, data, sizeof(data));
 
 #if EAGAIN != EWOULDBLOCK
@@ -286,26 +170,22 @@ AlsaRawMidiIn::main_process_thread ()
 #else
 		if (err == -EAGAIN) {
 #endif
-		    continue;
+			return 0;
 		}
 		if (err < 0) {
-			PBD::error << _("AlsaRawMidiIn: read error. Terminating Midi") << endmsg;
-			break;
+			return -1;
 		}
 		if (err == 0) {
 			_DEBUGPRINT("AlsaRawMidiIn: zero read\n");
-			continue;
+			return 0;
 		}
 
 #if 0
-		queue_event (time, data, err);
+		queue_event (now, data, err);
 #else
-		parse_events (time, data, err);
+		parse_events (now, data, err);
 #endif
 	}
-
-	_DEBUGPRINT("AlsaRawMidiIn: MIDI IN THREAD STOPPED\n");
-	return 0;
 }
 
 int
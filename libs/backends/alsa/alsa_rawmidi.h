@@ -47,7 +47,10 @@ class AlsaRawMidiOut : public AlsaRawMidiIO, public AlsaMidiOut
 {
 public:
 	AlsaRawMidiOut (const std::string &name, const char *device);
-	void* main_process_thread ();
+
+protected:
+	ssize_t write_event (const uint8_t *, const size_t);
+	void drain ();
 };
 
 class AlsaRawMidiIn : public AlsaRawMidiIO, public AlsaMidiIn
@@ -55,7 +58,7 @@ class AlsaRawMidiIn : public AlsaRawMidiIO, public AlsaMidiIn
 public:
 	AlsaRawMidiIn (const std::string &name, const char *device);
 
-	void* main_process_thread ();
+	int service (uint64_t now, uint64_t& next);
 
 protected:
 	int queue_event (const uint64_t, const uint8_t *, const size_t);
@@ -20,7 +20,6 @@
 #include <unistd.h>
 #include <glibmm.h>
 
-#include "select_sleep.h"
 #include "alsa_sequencer.h"
 
 #include "pbd/error.h"
@@ -37,13 +36,19 @@ using namespace ARDOUR;
 AlsaSeqMidiIO::AlsaSeqMidiIO (const std::string &name, const char *device, const bool input)
 	: AlsaMidiIO()
 	, _seq (0)
+	, _codec (0)
 {
 	_name = name;
 	init (device, input);
+	snd_midi_event_new (MaxAlsaMidiEventSize, &_codec);
 }
 
 AlsaSeqMidiIO::~AlsaSeqMidiIO ()
 {
+	if (_codec) {
+		snd_midi_event_free (_codec);
+		_codec = 0;
+	}
 	if (_seq) {
 		snd_seq_close (_seq);
 		_seq = 0;
@@ -121,106 +126,46 @@ AlsaSeqMidiOut::AlsaSeqMidiOut (const std::string &name, const char *device)
 {
 }
 
-void *
-AlsaSeqMidiOut::main_process_thread ()
+ssize_t
+AlsaSeqMidiOut::write_event (const uint8_t *data, const size_t size)
 {
-	_running = true;
-	bool need_drain = false;
-	snd_midi_event_t *alsa_codec = NULL;
-	snd_midi_event_new (MaxAlsaMidiEventSize, &alsa_codec);
-	pthread_mutex_lock (&_notify_mutex);
-	while (_running) {
-		bool have_data = false;
-		struct MidiEventHeader h(0,0);
-		uint8_t data[MaxAlsaMidiEventSize];
-
-		const uint32_t read_space = _rb->read_space();
-
-		if (read_space > sizeof(MidiEventHeader)) {
-			if (_rb->read ((uint8_t*)&h, sizeof(MidiEventHeader)) != sizeof(MidiEventHeader)) {
-				_DEBUGPRINT("AlsaSeqMidiOut: Garbled MIDI EVENT HEADER!!\n");
-				break;
-			}
-			assert (read_space >= h.size);
-			if (h.size > MaxAlsaMidiEventSize) {
-				_rb->increment_read_idx (h.size);
-				_DEBUGPRINT("AlsaSeqMidiOut: MIDI event too large!\n");
-				continue;
-			}
-			if (_rb->read (&data[0], h.size) != h.size) {
-				_DEBUGPRINT("AlsaSeqMidiOut: Garbled MIDI EVENT DATA!!\n");
-				break;
-			}
-			have_data = true;
-		}
-
-		if (!have_data) {
-			if (need_drain) {
-				snd_seq_drain_output (_seq);
-				need_drain = false;
-			}
-			pthread_cond_wait (&_notify_ready, &_notify_mutex);
-			continue;
-		}
-
-		snd_seq_event_t alsa_event;
-		snd_seq_ev_clear (&alsa_event);
-		snd_midi_event_reset_encode (alsa_codec);
-		if (!snd_midi_event_encode (alsa_codec, data, h.size, &alsa_event)) {
-			PBD::error << _("AlsaSeqMidiOut: Invalid Midi Event.") << endmsg;
-			continue;
-		}
+	if (!_codec) {
+		return -1;
+	}
 
-		snd_seq_ev_set_source (&alsa_event, _port);
-		snd_seq_ev_set_subs (&alsa_event);
-		snd_seq_ev_set_direct (&alsa_event);
-
-		uint64_t now = g_get_monotonic_time();
-		while (h.time > now + 500) {
-			if (need_drain) {
-				snd_seq_drain_output (_seq);
-				need_drain = false;
-			} else {
-				select_sleep(h.time - now);
-			}
-			now = g_get_monotonic_time();
-		}
+	snd_seq_event_t alsa_event;
+	snd_seq_ev_clear (&alsa_event);
+	snd_midi_event_reset_encode (_codec);
+	if (!snd_midi_event_encode (_codec, data, size, &alsa_event)) {
+		PBD::error << _("AlsaSeqMidiOut: Invalid Midi Event.") << endmsg;
+		/* skip it */
+		return size;
+	}
 
-retry:
-		int perr = poll (_pfds, _npfds, 10 /* ms */);
-		if (perr < 0) {
-			PBD::error << _("AlsaSeqMidiOut: Error polling device. Terminating Midi Thread.") << endmsg;
-			break;
-		}
-		if (perr == 0) {
-			_DEBUGPRINT("AlsaSeqMidiOut: poll() timed out.\n");
-			goto retry;
-		}
+	snd_seq_ev_set_source (&alsa_event, _port);
+	snd_seq_ev_set_subs (&alsa_event);
+	snd_seq_ev_set_direct (&alsa_event);
 
-		ssize_t err = snd_seq_event_output(_seq, &alsa_event);
+	ssize_t err = snd_seq_event_output (_seq, &alsa_event);
 
-		if (err == -EAGAIN) {
-			snd_seq_drain_output (_seq);
-			goto retry;
-		}
-		if (err == -EWOULDBLOCK) {
-			select_sleep (1000);
-			goto retry;
-		}
-		if (err < 0) {
-			PBD::error << _("AlsaSeqMidiOut: write failed. Terminating Midi Thread.") << endmsg;
-			break;
-		}
-		need_drain = true;
+#if EAGAIN != EWOULDBLOCK
+	if ((err == -EAGAIN) || (err == -EWOULDBLOCK))  {
+#else
+	if (err == -EAGAIN) {
+#endif
+		snd_seq_drain_output (_seq);
+		return 0;
 	}
-
-	pthread_mutex_unlock (&_notify_mutex);
-
-	if (alsa_codec) {
-		snd_midi_event_free(alsa_codec);
+	if (err < 0) {
+		return err;
 	}
-	_DEBUGPRINT("AlsaSeqMidiOut: MIDI OUT THREAD STOPPED\n");
-	return 0;
+	return size;
+}
+
+void
+AlsaSeqMidiOut::drain ()
+{
+	snd_seq_drain_output (_seq);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -231,31 +176,15 @@ AlsaSeqMidiIn::AlsaSeqMidiIn (const std::string &name, const char *device)
 {
 }
 
-void *
-AlsaSeqMidiIn::main_process_thread ()
+int
+AlsaSeqMidiIn::service (uint64_t now, uint64_t&)
 {
-	_running = true;
-	bool do_poll = true;
-	snd_midi_event_t *alsa_codec = NULL;
-	snd_midi_event_new (MaxAlsaMidiEventSize, &alsa_codec);
-
-	while (_running) {
-
-		if (do_poll) {
-			snd_seq_poll_descriptors (_seq, _pfds, _npfds, POLLIN);
-			int perr = poll (_pfds, _npfds, 100 /* ms */);
-
-			if (perr < 0) {
-				PBD::error << _("AlsaSeqMidiIn: Error polling device. Terminating Midi Thread.") << endmsg;
-				break;
-			}
-			if (perr == 0) {
-				continue;
-			}
-		}
+	if (!_codec) {
+		return -1;
+	}
 
+	while (true) {
 		snd_seq_event_t *event;
-		uint64_t time = g_get_monotonic_time();
 		ssize_t err = snd_seq_event_input (_seq, &event);
 
 #if EAGAIN == EWOULDBLOCK
@@ -263,32 +192,26 @@ AlsaSeqMidiIn::main_process_thread ()
 #else
 		if ((err == -EAGAIN) || (err == -EWOULDBLOCK)) {
 #endif
-			do_poll = true;
-			continue;
+			return 0;
 		}
 		if (err == -ENOSPC) {
-			PBD::error << _("AlsaSeqMidiIn: FIFO overrun.") << endmsg;
-			do_poll = true;
-			continue;
+			_DEBUGPRINT("AlsaSeqMidiIn: FIFO overrun.\n");
+			return 0;
 		}
 		if (err < 0) {
-			PBD::error << _("AlsaSeqMidiIn: read error. Terminating Midi") << endmsg;
-			break;
+			return -1;
 		}
 
 		uint8_t data[MaxAlsaMidiEventSize];
-		snd_midi_event_reset_decode (alsa_codec);
-		ssize_t size = snd_midi_event_decode (alsa_codec, data, sizeof(data), event);
+		snd_midi_event_reset_decode (_codec);
+		ssize_t size = snd_midi_event_decode (_codec, data, sizeof(data), event);
 
 		if (size > 0) {
-			queue_event (time, data, size);
+			queue_event (now, data, size);
+		}
+		if (err == 0) {
+			/* no more events in the input buffer */
+			return 0;
 		}
-		do_poll = (0 == err);
-	}
-
-	if (alsa_codec) {
-		snd_midi_event_free(alsa_codec);
 	}
-	_DEBUGPRINT("AlsaSeqMidiIn: MIDI IN THREAD STOPPED\n");
-	return 0;
 }
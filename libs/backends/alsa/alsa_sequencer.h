@@ -38,6 +38,7 @@ public:
 
 protected:
 	snd_seq_t *_seq;
+	snd_midi_event_t *_codec;
 	int _port;
 
 private:
@@ -48,7 +49,10 @@ class AlsaSeqMidiOut : public AlsaSeqMidiIO, public AlsaMidiOut
 {
 public:
 	AlsaSeqMidiOut (const std::string &name, const char *port_name);
-	void* main_process_thread ();
+
+protected:
+	ssize_t write_event (const uint8_t *, const size_t);
+	void drain ();
 };
 
 class AlsaSeqMidiIn : public AlsaSeqMidiIO, public AlsaMidiIn
@@ -56,7 +60,7 @@ class AlsaSeqMidiIn : public AlsaSeqMidiIO, public AlsaMidiIn
 public:
 	AlsaSeqMidiIn (const std::string &name, const char *port_name);
 
-	void* main_process_thread ();
+	int service (uint64_t now, uint64_t& next);
 };
 
 } // namespace
@@ -236,16 +236,12 @@ AlsaAudioSlave::process_thread ()
 				PBD::RingBuffer<float>::rw_vector vec;
 				_rb_capture.get_write_vector (&vec);
 				if (vec.len[0] >= nchn * spp) {
-					for (uint32_t c = 0; c < nchn; ++c) {
-						_pcmi.capt_chan (c, vec.buf[0] + c, spp, nchn);
-					}
+					_pcmi.capt_intlv (vec.buf[0], spp);
 				} else {
 					uint32_t c;
 					/* first copy continuous area */
 					uint32_t k = vec.len[0] / nchn;
-					for (c = 0; c < nchn; ++c) {
-						_pcmi.capt_chan (c, vec.buf[0] + c, k, nchn);
-					}
+					_pcmi.capt_intlv (vec.buf[0], k);
 
 					/* possible samples at end of first buffer chunk, 
 					 * incomplete audio-sample */
@@ -294,15 +290,11 @@ AlsaAudioSlave::process_thread ()
 				PBD::RingBuffer<float>::rw_vector vec;
 				_rb_playback.get_read_vector (&vec);
 				if (vec.len[0] >= nchn * spp) {
-					for (uint32_t c = 0; c < nchn; ++c) {
-						_pcmi.play_chan (c, vec.buf[0] + c, spp, nchn);
-					}
+					_pcmi.play_intlv (vec.buf[0], spp);
 				} else {
 					uint32_t c;
 					uint32_t k = vec.len[0] / nchn;
-					for (c = 0; c < nchn; ++c) {
-						_pcmi.play_chan (c, vec.buf[0] + c, k, nchn);
-					}
+					_pcmi.play_intlv (vec.buf[0], k);
 
 					uint32_t s = vec.len[0] - k * nchn;
 					assert (s < nchn);
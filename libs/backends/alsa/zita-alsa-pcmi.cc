@@ -23,8 +23,17 @@
 #include <endian.h>
 #endif
 #include "zita-alsa-pcmi.h"
+#include <string.h>
 #include <sys/time.h>
 
+#if defined(__x86_64__) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PCMI_SSE
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PCMI_NEON
+#endif
+
 /* Public members *************************************************************/
 
 Alsa_pcmi::Alsa_pcmi (
@@ -333,6 +342,365 @@ Alsa_pcmi::capt_chan (int chan, float* dst, int len, int step)
 	_capt_ptr[chan] = (this->*Alsa_pcmi::_capt_func) (_capt_ptr[chan], dst, len, step);
 }
 
+/* Block transfer of all channels *******************************************/
+
+/* Conversion of 32bit samples, native byte-order. Same range as capt_32,
+ * play_32, but capture multiplies by the reciprocal instead of dividing,
+ * which may differ from capt_32 by one ulp. */
+#define S32_SCALE (1.f / (float)0x7fffff00)
+
+static inline float
+s32_to_float (const char* src)
+{
+	return (float)*((int const*)src) * S32_SCALE;
+}
+
+static inline int
+float_to_s32 (float s)
+{
+	int d;
+	if (s > 1) {
+		d = 0x007fffff;
+	} else if (s < -1) {
+		d = 0x00800001;
+	} else {
+		d = (int)((float)0x007fffff * s);
+	}
+	return d << 8;
+}
+
+/* contiguous samples */
+static void
+capt_run (const char* src, float* dst, int nsmp, bool is_float)
+{
+	int i = 0;
+	if (is_float) {
+		memcpy (dst, src, nsmp * sizeof (float));
+		return;
+	}
+#if defined(PCMI_SSE)
+	const __m128 sc = _mm_set1_ps (S32_SCALE);
+	for (; i + 4 <= nsmp; i += 4) {
+		__m128i v = _mm_loadu_si128 ((__m128i const*)(src + 4 * i));
+		_mm_storeu_ps (dst + i, _mm_mul_ps (_mm_cvtepi32_ps (v), sc));
+	}
+#elif defined(PCMI_NEON)
+	for (; i + 4 <= nsmp; i += 4) {
+		int32x4_t v = vld1q_s32 ((int32_t const*)(src + 4 * i));
+		vst1q_f32 (dst + i, vmulq_n_f32 (vcvtq_f32_s32 (v), S32_SCALE));
+	}
+#endif
+	for (; i < nsmp; ++i) {
+		dst[i] = s32_to_float (src + 4 * i);
+	}
+}
+
+static void
+play_run (const float* src, char* dst, int nsmp, bool is_float)
+{
+	int i = 0;
+	if (is_float) {
+		memcpy (dst, src, nsmp * sizeof (float));
+		return;
+	}
+#if defined(PCMI_SSE)
+	const __m128 p1 = _mm_set1_ps (1.f);
+	const __m128 m1 = _mm_set1_ps (-1.f);
+	const __m128 sc = _mm_set1_ps ((float)0x007fffff);
+	for (; i + 4 <= nsmp; i += 4) {
+		__m128 v = _mm_min_ps (_mm_max_ps (_mm_loadu_ps (src + i), m1), p1);
+		__m128i d = _mm_slli_epi32 (_mm_cvttps_epi32 (_mm_mul_ps (v, sc)), 8);
+		_mm_storeu_si128 ((__m128i*)(dst + 4 * i), d);
+	}
+#elif defined(PCMI_NEON)
+	const float32x4_t p1 = vdupq_n_f32 (1.f);
+	const float32x4_t m1 = vdupq_n_f32 (-1.f);
+	for (; i + 4 <= nsmp; i += 4) {
+		float32x4_t v = vminq_f32 (vmaxq_f32 (vld1q_f32 (src + i), m1), p1);
+		int32x4_t   d = vshlq_n_s32 (vcvtq_s32_f32 (vmulq_n_f32 (v, (float)0x007fffff)), 8);
+		vst1q_s32 ((int32_t*)(dst + 4 * i), d);
+	}
+#endif
+	for (; i < nsmp; ++i) {
+		*((int*)(dst + 4 * i)) = float_to_s32 (src[i]);
+	}
+}
+
+#if defined(PCMI_NEON)
+static inline void
+transpose_4x4 (float32x4_t& r0, float32x4_t& r1, float32x4_t& r2, float32x4_t& r3)
+{
+	const float32x4x2_t t01 = vtrnq_f32 (r0, r1);
+	const float32x4x2_t t23 = vtrnq_f32 (r2, r3);
+	r0 = vcombine_f32 (vget_low_f32 (t01.val[0]), vget_low_f32 (t23.val[0]));
+	r1 = vcombine_f32 (vget_low_f32 (t01.val[1]), vget_low_f32 (t23.val[1]));
+	r2 = vcombine_f32 (vget_high_f32 (t01.val[0]), vget_high_f32 (t23.val[0]));
+	r3 = vcombine_f32 (vget_high_f32 (t01.val[1]), vget_high_f32 (t23.val[1]));
+}
+#endif
+
+/* 4 adjacent channels of interleaved hardware, to 4 separate buffers */
+static void
+capt_intlv_4 (const char* src, int step, float* const* dst, int nfrm, bool is_float)
+{
+	int i = 0;
+#if defined(PCMI_SSE)
+	const __m128 sc = _mm_set1_ps (is_float ? 1.f : S32_SCALE);
+	for (; i + 4 <= nfrm; i += 4) {
+		const char* s = src + i * step;
+		__m128 r0, r1, r2, r3;
+		if (is_float) {
+			r0 = _mm_loadu_ps ((float const*)(s));
+			r1 = _mm_loadu_ps ((float const*)(s + step));
+			r2 = _mm_loadu_ps ((float const*)(s + 2 * step));
+			r3 = _mm_loadu_ps ((float const*)(s + 3 * step));
+		} else {
+			r0 = _mm_mul_ps (_mm_cvtepi32_ps (_mm_loadu_si128 ((__m128i const*)(s))), sc);
+			r1 = _mm_mul_ps (_mm_cvtepi32_ps (_mm_loadu_si128 ((__m128i const*)(s + step))), sc);
+			r2 = _mm_mul_ps (_mm_cvtepi32_ps (_mm_loadu_si128 ((__m128i const*)(s + 2 * step))), sc);
+			r3 = _mm_mul_ps (_mm_cvtepi32_ps (_mm_loadu_si128 ((__m128i const*)(s + 3 * step))), sc);
+		}
+		_MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+		_mm_storeu_ps (dst[0] + i, r0);
+		_mm_storeu_ps (dst[1] + i, r1);
+		_mm_storeu_ps (dst[2] + i, r2);
+		_mm_storeu_ps (dst[3] + i, r3);
+	}
+#elif defined(PCMI_NEON)
+	const float sc = is_float ? 1.f : S32_SCALE;
+	for (; i + 4 <= nfrm; i += 4) {
+		const char* s = src + i * step;
+		float32x4_t r0, r1, r2, r3;
+		if (is_float) {
+			r0 = vld1q_f32 ((float const*)(s));
+			r1 = vld1q_f32 ((float const*)(s + step));
+			r2 = vld1q_f32 ((float const*)(s + 2 * step));
+			r3 = vld1q_f32 ((float const*)(s + 3 * step));
+		} else {
+			r0 = vmulq_n_f32 (vcvtq_f32_s32 (vld1q_s32 ((int32_t const*)(s))), sc);
+			r1 = vmulq_n_f32 (vcvtq_f32_s32 (vld1q_s32 ((int32_t const*)(s + step))), sc);
+			r2 = vmulq_n_f32 (vcvtq_f32_s32 (vld1q_s32 ((int32_t const*)(s + 2 * step))), sc);
+			r3 = vmulq_n_f32 (vcvtq_f32_s32 (vld1q_s32 ((int32_t const*)(s + 3 * step))), sc);
+		}
+		transpose_4x4 (r0, r1, r2, r3);
+		vst1q_f32 (dst[0] + i, r0);
+		vst1q_f32 (dst[1] + i, r1);
+		vst1q_f32 (dst[2] + i, r2);
+		vst1q_f32 (dst[3] + i, r3);
+	}
+#endif
+	for (; i < nfrm; ++i) {
+		const char* s = src + i * step;
+		for (int c = 0; c < 4; ++c) {
+			dst[c][i] = is_float ? *((float const*)(s + 4 * c)) : s32_to_float (s + 4 * c);
+		}
+	}
+}
+
+/* 4 separate buffers, to 4 adjacent channels of interleaved hardware */
+static void
+play_intlv_4 (const float* const* src, char* dst, int step, int nfrm, bool is_float)
+{
+	int i = 0;
+#if defined(PCMI_SSE)
+	const __m128 p1 = _mm_set1_ps (1.f);
+	const __m128 m1 = _mm_set1_ps (-1.f);
+	const __m128 sc = _mm_set1_ps ((float)0x007fffff);
+	for (; i + 4 <= nfrm; i += 4) {
+		__m128 r0 = _mm_loadu_ps (src[0] + i);
+		__m128 r1 = _mm_loadu_ps (src[1] + i);
+		__m128 r2 = _mm_loadu_ps (src[2] + i);
+		__m128 r3 = _mm_loadu_ps (src[3] + i);
+		_MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+		char* d = dst + i * step;
+		if (is_float) {
+			_mm_storeu_ps ((float*)(d), r0);
+			_mm_storeu_ps ((float*)(d + step), r1);
+			_mm_storeu_ps ((float*)(d + 2 * step), r2);
+			_mm_storeu_ps ((float*)(d + 3 * step), r3);
+		} else {
+#define PCMI_S32(R) _mm_slli_epi32 (_mm_cvttps_epi32 (_mm_mul_ps (_mm_min_ps (_mm_max_ps (R, m1), p1), sc)), 8)
+			_mm_storeu_si128 ((__m128i*)(d), PCMI_S32 (r0));
+			_mm_storeu_si128 ((__m128i*)(d + step), PCMI_S32 (r1));
+			_mm_storeu_si128 ((__m128i*)(d + 2 * step), PCMI_S32 (r2));
+			_mm_storeu_si128 ((__m128i*)(d + 3 * step), PCMI_S32 (r3));
+#undef PCMI_S32
+		}
+	}
+#elif defined(PCMI_NEON)
+	const float32x4_t p1 = vdupq_n_f32 (1.f);
+	const float32x4_t m1 = vdupq_n_f32 (-1.f);
+	for (; i + 4 <= nfrm; i += 4) {
+		float32x4_t r0 = vld1q_f32 (src[0] + i);
+		float32x4_t r1 = vld1q_f32 (src[1] + i);
+		float32x4_t r2 = vld1q_f32 (src[2] + i);
+		float32x4_t r3 = vld1q_f32 (src[3] + i);
+		transpose_4x4 (r0, r1, r2, r3);
+		char* d = dst + i * step;
+		if (is_float) {
+			vst1q_f32 ((float*)(d), r0);
+			vst1q_f32 ((float*)(d + step), r1);
+			vst1q_f32 ((float*)(d + 2 * step), r2);
+			vst1q_f32 ((float*)(d + 3 * step), r3);
+		} else {
+#define PCMI_S32(R) vshlq_n_s32 (vcvtq_s32_f32 (vmulq_n_f32 (vminq_f32 (vmaxq_f32 (R, m1), p1), (float)0x007fffff)), 8)
+			vst1q_s32 ((int32_t*)(d), PCMI_S32 (r0));
+			vst1q_s32 ((int32_t*)(d + step), PCMI_S32 (r1));
+			vst1q_s32 ((int32_t*)(d + 2 * step), PCMI_S32 (r2));
+			vst1q_s32 ((int32_t*)(d + 3 * step), PCMI_S32 (r3));
+#undef PCMI_S32
+		}
+	}
+#endif
+	for (; i < nfrm; ++i) {
+		char* d = dst + i * step;
+		for (int c = 0; c < 4; ++c) {
+			if (is_float) {
+				*((float*)(d + 4 * c)) = src[c][i];
+			} else {
+				*((int*)(d + 4 * c)) = float_to_s32 (src[c][i]);
+			}
+		}
+	}
+}
+
+/* Transfer nfrm frames of channels 0 .. nchan-1.
+ * Native 32bit integer and float formats are handled in bulk,
+ * others per channel.
+ */
+void
+Alsa_pcmi::capt_block (float* const* dst, int nchan, int nfrm, int step)
+{
+	const bool is_float = _capt_func == &Alsa_pcmi::capt_float;
+	const bool is_s32   = _capt_func == &Alsa_pcmi::capt_32;
+
+	if (nchan > (int)_capt_nchan) {
+		nchan = _capt_nchan;
+	}
+
+	bool intlv = (is_float || is_s32) && _capt_step == (int)(4 * _capt_nchan);
+	for (int c = 1; intlv && c < nchan; ++c) {
+		intlv = _capt_ptr[c] == _capt_ptr[0] + 4 * c;
+	}
+
+	if ((is_float || is_s32) && _capt_step == 4 && step == 1) {
+		/* non-interleaved, each channel is contiguous */
+		for (int c = 0; c < nchan; ++c) {
+			capt_run (_capt_ptr[c], dst[c], nfrm, is_float);
+			_capt_ptr[c] += nfrm * 4;
+		}
+		return;
+	}
+
+	if (intlv && nchan == (int)_capt_nchan && step == nchan && dst[0] + nchan - 1 == dst[nchan - 1]) {
+		/* interleaved to interleaved */
+		capt_run (_capt_ptr[0], dst[0], nfrm * nchan, is_float);
+		for (int c = 0; c < nchan; ++c) {
+			_capt_ptr[c] += nfrm * _capt_step;
+		}
+		return;
+	}
+
+	int c = 0;
+	if (intlv && step == 1) {
+		for (; c + 4 <= nchan; c += 4) {
+			capt_intlv_4 (_capt_ptr[c], _capt_step, &dst[c], nfrm, is_float);
+			for (int k = c; k < c + 4; ++k) {
+				_capt_ptr[k] += nfrm * _capt_step;
+			}
+		}
+	}
+	for (; c < nchan; ++c) {
+		capt_chan (c, dst[c], nfrm, step);
+	}
+}
+
+void
+Alsa_pcmi::play_block (const float* const* src, int nchan, int nfrm, int step)
+{
+	const bool is_float = _play_func == &Alsa_pcmi::play_float;
+	const bool is_s32   = _play_func == &Alsa_pcmi::play_32;
+
+	if (nchan > (int)_play_nchan) {
+		nchan = _play_nchan;
+	}
+
+	bool intlv = (is_float || is_s32) && _play_step == (int)(4 * _play_nchan);
+	for (int c = 1; intlv && c < nchan; ++c) {
+		intlv = _play_ptr[c] == _play_ptr[0] + 4 * c;
+	}
+
+	if ((is_float || is_s32) && _play_step == 4 && step == 1) {
+		for (int c = 0; c < nchan; ++c) {
+			play_run (src[c], _play_ptr[c], nfrm, is_float);
+			_play_ptr[c] += nfrm * 4;
+		}
+	} else if (intlv && nchan == (int)_play_nchan && step == nchan && src[0] + nchan - 1 == src[nchan - 1]) {
+		play_run (src[0], _play_ptr[0], nfrm * nchan, is_float);
+		for (int c = 0; c < nchan; ++c) {
+			_play_ptr[c] += nfrm * _play_step;
+		}
+	} else {
+		int c = 0;
+		if (intlv && step == 1) {
+			for (; c + 4 <= nchan; c += 4) {
+				play_intlv_4 (&src[c], _play_ptr[c], _play_step, nfrm, is_float);
+				for (int k = c; k < c + 4; ++k) {
+					_play_ptr[k] += nfrm * _play_step;
+				}
+			}
+		}
+		for (; c < nchan; ++c) {
+			play_chan (c, src[c], nfrm, step);
+		}
+	}
+
+	for (int c = nchan; c < (int)_play_nchan; ++c) {
+		clear_chan (c, nfrm);
+	}
+}
+
+void
+Alsa_pcmi::capt_chans (float* const* dst, int nchan, int len)
+{
+	capt_block (dst, nchan, len, 1);
+}
+
+void
+Alsa_pcmi::play_chans (const float* const* src, int nchan, int len)
+{
+	play_block (src, nchan, len, 1);
+}
+
+void
+Alsa_pcmi::capt_intlv (float* dst, int len)
+{
+	float* d[MAXCHAN];
+	for (unsigned int c = 0; c < _capt_nchan; ++c) {
+		d[c] = dst + c;
+	}
+	capt_block (d, _capt_nchan, len, _capt_nchan);
+}
+
+void
+Alsa_pcmi::play_intlv (const float* src, int len)
+{
+	const float* s[MAXCHAN];
+	for (unsigned int c = 0; c < _play_nchan; ++c) {
+		s[c] = src + c;
+	}
+	play_block (s, _play_nchan, len, _play_nchan);
+}
+
+const float*
+Alsa_pcmi::capt_area (int chan) const
+{
+	if (_capt_func != &Alsa_pcmi::capt_float || _capt_step != 4 || chan >= (int)_capt_nchan) {
+		return 0;
+	}
+	return (const float*)_capt_ptr[chan];
+}
+
 int
 Alsa_pcmi::play_done (int len)
 {
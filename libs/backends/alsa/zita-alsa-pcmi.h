@@ -68,6 +68,25 @@ public:
 	void capt_chan (int chan, float* dst, int len, int step = 1);
 	int  capt_done (int len);
 
+	/* Transfer the first nchan channels in a single pass.
+	 * For interleaved hardware this reads/writes each frame
+	 * once, rather than once per channel. play_chans() clears
+	 * remaining channels.
+	 */
+	void capt_chans (float* const* dst, int nchan, int len);
+	void play_chans (const float* const* src, int nchan, int len);
+
+	/* interleaved buffers with ncapt() or nplay() channels */
+	void capt_intlv (float* dst, int len);
+	void play_intlv (const float* src, int len);
+
+	/* Direct access to captured data of a channel between
+	 * capt_init() and capt_done(). Only available if the
+	 * hardware provides non-interleaved native float samples,
+	 * NULL otherwise.
+	 */
+	const float* capt_area (int chan) const;
+
 	int play_avail (void)
 	{
 		return snd_pcm_avail (_play_handle);
@@ -142,6 +161,9 @@ private:
 	const char* capt_24swap (const char* src, float* dst, int nfrm, int step);
 	const char* capt_16swap (const char* src, float* dst, int nfrm, int step);
 
+	void capt_block (float* const* dst, int nchan, int nfrm, int step);
+	void play_block (const float* const* src, int nchan, int nfrm, int step);
+
 	unsigned int         _fsamp;
 	snd_pcm_uframes_t    _fsize;
 	unsigned int         _play_nfrag;
@@ -90,6 +90,7 @@ DummyAudioBackend::DummyAudioBackend (AudioEngine& e, AudioBackendInfo& info)
 		_driver_speed.push_back (DriverSpeed (_("15x Speed"),    0.06666f));
 		_driver_speed.push_back (DriverSpeed (_("20x Speed"),    0.05f));
 		_driver_speed.push_back (DriverSpeed (_("50x Speed"),    0.02f));
+		_driver_speed.push_back (DriverSpeed (_("Unbounded (Benchmark)"), 0.f));
 	}
 
 }
@@ -462,6 +463,8 @@ DummyAudioBackend::_start (bool /*for_latency_measurement*/)
 	engine.reconnect_ports ();
 	g_atomic_int_set (&_port_change_flag, 0);
 
+	_benchmark.init (_samplerate, _samples_per_period, _speedup);
+
 	if (pbd_pthread_create (PBD_RT_STACKSIZE_PROC, &_main_thread, pthread_process, this)) {
 		PBD::error << _("DummyAudioBackend: cannot start.") << endmsg;
 	}
@@ -490,6 +493,7 @@ DummyAudioBackend::stop ()
 		PBD::error << _("DummyAudioBackend: failed to terminate.") << endmsg;
 		return -1;
 	}
+	_benchmark.finish ();
 	unregister_ports();
 	return 0;
 }
@@ -561,6 +565,7 @@ DummyAudioBackend::create_process_thread (boost::function<void()> func)
 	}
 
 	_threads.push_back (thread_id);
+	_benchmark.add_thread (thread_id);
 	return 0;
 }
 
@@ -569,6 +574,8 @@ DummyAudioBackend::join_process_threads ()
 {
 	int rv = 0;
 
+	_benchmark.clear_threads ();
+
 	for (std::vector<pthread_t>::const_iterator i = _threads.begin (); i != _threads.end (); ++i)
 	{
 		void *status;
@@ -948,6 +955,10 @@ DummyAudioBackend::main_process_thread ()
 			boost::dynamic_pointer_cast<DummyPort>(*it)->next_period ();
 		}
 
+		_benchmark.cycle_start ();
+		/* part of the measured cycle, like the engine's process callback */
+		_benchmark.simulate_load ();
+
 		if (engine.process_callback (samples_per_period)) {
 			return 0;
 		}
@@ -986,10 +997,13 @@ DummyAudioBackend::main_process_thread ()
 			_dsp_load_calc.set_start_timestamp_us (clock1);
 			_dsp_load_calc.set_stop_timestamp_us (_x_get_monotonic_usec());
 			_dsp_load = _dsp_load_calc.get_dsp_load_unbound ();
+			_benchmark.cycle_end (_dsp_load);
 
 			const int64_t elapsed_time = _dsp_load_calc.elapsed_time_us ();
 			const int64_t nominal_time = _dsp_load_calc.get_max_time_us ();
-			if (elapsed_time < nominal_time) {
+			if (_speedup == 0) {
+				/* benchmark, run as fast as possible */
+			} else if (elapsed_time < nominal_time) {
 				const int64_t sleepy = _speedup * (nominal_time - elapsed_time);
 				Glib::usleep (std::max ((int64_t) 100, sleepy));
 			} else {
@@ -997,6 +1011,7 @@ DummyAudioBackend::main_process_thread ()
 			}
 		} else {
 			_dsp_load = 1.0f;
+			_benchmark.cycle_end (_dsp_load);
 			Glib::usleep (100); // don't hog cpu
 		}
 
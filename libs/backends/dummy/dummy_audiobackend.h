@@ -39,6 +39,8 @@
 #include "ardour/dsp_load_calculator.h"
 #include "ardour/port_engine_shared.h"
 
+#include "dummy_benchmark.h"
+
 namespace ARDOUR {
 
 class DummyAudioBackend;
@@ -384,6 +386,8 @@ class DummyAudioBackend : public AudioBackend, public PortEngineSharedImpl {
 
 		samplecnt_t _processed_samples;
 
+		DummyBenchmark _benchmark;
+
 		pthread_t _main_thread;
 
 		/* process threads */
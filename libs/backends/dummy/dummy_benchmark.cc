@@ -0,0 +1,331 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <unistd.h>
+
+#include <glib.h>
+#include <glibmm.h>
+
+#ifdef PLATFORM_WINDOWS
+#include <pbd/windows_timer_utils.h>
+#endif
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+
+#include "dummy_benchmark.h"
+
+#include "pbd/i18n.h"
+
+#if !defined(PLATFORM_WINDOWS) && defined(_POSIX_THREAD_CPUTIME) && _POSIX_THREAD_CPUTIME >= 0
+#define DUMMY_THREAD_CPUTIME
+#endif
+
+using namespace ARDOUR;
+
+static int64_t
+monotonic_usec ()
+{
+#ifdef PLATFORM_WINDOWS
+	return PBD::get_microseconds ();
+#endif
+	return g_get_monotonic_time ();
+}
+
+DummyBenchmark::DummyBenchmark ()
+	: _enabled (false)
+	, _samplerate (48000)
+	, _samples_per_period (1024)
+	, _speedup (1.0)
+	, _max_cycles (0)
+	, _n_cycles (0)
+	, _profile_pos (0)
+	, _n_threads (0)
+	, _n_threads_max (0)
+	, _n_threads_cycle (0)
+{
+}
+
+void
+DummyBenchmark::init (float samplerate, size_t samples_per_period, float speedup)
+{
+	_samplerate         = samplerate;
+	_samples_per_period = samples_per_period;
+	_speedup            = speedup;
+	_n_cycles           = 0;
+	_n_threads_max      = 0;
+	_profile_pos        = 0;
+
+	_profile.clear ();
+	if (const char* p = getenv ("ARDOUR_DUMMY_LOAD_PROFILE")) {
+		FILE* f = fopen (p, "r");
+		if (!f) {
+			PBD::warning << string_compose (_("DummyAudioBackend: cannot open load profile '%1'."), p) << endmsg;
+		} else {
+			char line[1024];
+			while (fgets (line, sizeof (line), f)) {
+				/* either a single value, or "cycle,usec,..." */
+				char const* v = strchr (line, ',');
+				v = v ? v + 1 : line;
+				char* end;
+				float us = strtof (v, &end);
+				if (end != v && us >= 0) {
+					_profile.push_back (us);
+				}
+			}
+			fclose (f);
+			PBD::info << string_compose (_("DummyAudioBackend: using load profile with %1 cycles."), _profile.size ()) << endmsg;
+		}
+	}
+
+	const char* r = getenv ("ARDOUR_DUMMY_BENCHMARK");
+	_enabled      = r && strlen (r) > 0;
+	if (!_enabled) {
+		_cycle_start.clear ();
+		_process_us.clear ();
+		_dsp_load.clear ();
+		_thread_us.clear ();
+		return;
+	}
+
+	_report     = r;
+	_max_cycles = 10000;
+	if (const char* c = getenv ("ARDOUR_DUMMY_BENCHMARK_CYCLES")) {
+		_max_cycles = std::max (1, atoi (c));
+	}
+
+	_cycle_start.resize (_max_cycles);
+	_process_us.resize (_max_cycles);
+	_dsp_load.resize (_max_cycles);
+	_thread_us.assign (_max_cycles * MaxThreads, 0.f);
+}
+
+void
+DummyBenchmark::add_thread (pthread_t t)
+{
+	int n = g_atomic_int_get (&_n_threads);
+	if (n >= MaxThreads) {
+		return;
+	}
+#ifdef DUMMY_THREAD_CPUTIME
+	if (pthread_getcpuclockid (t, &_clk[n])) {
+		return;
+	}
+#endif
+	g_atomic_int_set (&_n_threads, n + 1);
+}
+
+void
+DummyBenchmark::clear_threads ()
+{
+	g_atomic_int_set (&_n_threads, 0);
+}
+
+int64_t
+DummyBenchmark::thread_time (int i) const
+{
+#ifdef DUMMY_THREAD_CPUTIME
+	struct timespec ts;
+	if (0 == clock_gettime (_clk[i], &ts)) {
+		return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+	}
+#endif
+	return 0;
+}
+
+void
+DummyBenchmark::simulate_load ()
+{
+	if (_profile.empty ()) {
+		return;
+	}
+	const int64_t until = monotonic_usec () + (int64_t)_profile[_profile_pos];
+	if (++_profile_pos >= _profile.size ()) {
+		_profile_pos = 0;
+	}
+	while (monotonic_usec () < until) {
+		/* busy wait */
+	}
+}
+
+void
+DummyBenchmark::cycle_start ()
+{
+	if (!recording ()) {
+		return;
+	}
+	_n_threads_cycle = g_atomic_int_get (&_n_threads);
+	for (int i = 0; i < _n_threads_cycle; ++i) {
+		_t0[i] = thread_time (i);
+	}
+	_cycle_start[_n_cycles] = monotonic_usec ();
+}
+
+void
+DummyBenchmark::cycle_end (float dsp_load)
+{
+	if (!recording ()) {
+		return;
+	}
+
+	const size_t c = _n_cycles;
+	_process_us[c] = monotonic_usec () - _cycle_start[c];
+	_dsp_load[c]   = dsp_load;
+
+	/* threads that were removed meanwhile report no time */
+	const int n_threads = std::min (_n_threads_cycle, (int)g_atomic_int_get (&_n_threads));
+	for (int i = 0; i < n_threads; ++i) {
+		_thread_us[c * MaxThreads + i] = std::max<int64_t> (0, thread_time (i) - _t0[i]);
+	}
+	_n_threads_max = std::max (_n_threads_max, n_threads);
+
+	/* recording () is false once all cycles were recorded. The report
+	 * is written by finish () when the backend stops, not here in
+	 * the process thread.
+	 */
+	++_n_cycles;
+}
+
+void
+DummyBenchmark::finish ()
+{
+	if (!_enabled || _n_cycles == 0) {
+		return;
+	}
+
+	int rv;
+	if (_report.size () > 5 && _report.substr (_report.size () - 5) == ".json") {
+		rv = write_json (_report);
+	} else {
+		rv = write_csv (_report);
+	}
+
+	if (rv) {
+		PBD::error << string_compose (_("DummyAudioBackend: cannot write benchmark report '%1'."), _report) << endmsg;
+	} else {
+		PBD::info << string_compose (_("DummyAudioBackend: wrote benchmark report of %1 cycles to '%2'."), _n_cycles, _report) << endmsg;
+	}
+
+	/* report only once */
+	_enabled = false;
+}
+
+int
+DummyBenchmark::write_csv (std::string const& path) const
+{
+	FILE* f = fopen (path.c_str (), "w");
+	if (!f) {
+		return -1;
+	}
+	fprintf (f, "cycle,process_us,dsp_load");
+	for (int t = 0; t < _n_threads_max; ++t) {
+		fprintf (f, ",thread%d_us", t);
+	}
+	fprintf (f, "\n");
+	for (size_t c = 0; c < _n_cycles; ++c) {
+		fprintf (f, "%zu,%.1f,%.4f", c, _process_us[c], _dsp_load[c]);
+		for (int t = 0; t < _n_threads_max; ++t) {
+			fprintf (f, ",%.1f", _thread_us[c * MaxThreads + t]);
+		}
+		fprintf (f, "\n");
+	}
+	return fclose (f) ? -1 : 0;
+}
+
+int
+DummyBenchmark::write_json (std::string const& path) const
+{
+	FILE* f = fopen (path.c_str (), "w");
+	if (!f) {
+		return -1;
+	}
+
+	const size_t n       = _n_cycles;
+	const double nominal = 1e6 * _samples_per_period / _samplerate;
+	const double wall    = n > 1 ? (double)(_cycle_start[n - 1] - _cycle_start[0]) : 0;
+
+	std::vector<float> sorted (_process_us.begin (), _process_us.begin () + n);
+	std::sort (sorted.begin (), sorted.end ());
+
+	double sum  = 0;
+	double sum2 = 0;
+	size_t over = 0;
+	for (size_t c = 0; c < n; ++c) {
+		sum  += _process_us[c];
+		sum2 += (double)_process_us[c] * _process_us[c];
+		if (_process_us[c] > nominal) {
+			++over;
+		}
+	}
+	const double avg = sum / n;
+	const double dev = n > 1 ? sqrt (std::max (0.0, (sum2 - sum * avg) / (n - 1))) : 0;
+
+#define PERCENTILE(P) sorted[std::min (n - 1, (size_t)floor ((P) * 0.01 * n))]
+
+	fprintf (f, "{\n");
+	fprintf (f, "  \"backend\": \"Dummy\",\n");
+	fprintf (f, "  \"samplerate\": %.0f,\n", _samplerate);
+	fprintf (f, "  \"samples_per_period\": %zu,\n", _samples_per_period);
+	fprintf (f, "  \"speedup\": %g,\n", _speedup);
+	fprintf (f, "  \"load_profile_cycles\": %zu,\n", _profile.size ());
+	fprintf (f, "  \"cycles\": %zu,\n", n);
+	fprintf (f, "  \"nominal_us\": %.1f,\n", nominal);
+	fprintf (f, "  \"wall_us\": %.0f,\n", wall);
+	fprintf (f, "  \"overruns\": %zu,\n", over);
+	fprintf (f, "  \"process_us\": { \"min\": %.1f, \"max\": %.1f, \"avg\": %.2f, \"stddev\": %.2f, \"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"p999\": %.1f },\n",
+	         sorted[0], sorted[n - 1], avg, dev,
+	         PERCENTILE (50), PERCENTILE (90), PERCENTILE (99), PERCENTILE (99.9));
+
+#undef PERCENTILE
+
+	/* histogram of the process time, relative to the nominal cycle
+	 * duration. 50 bins from 0 to 200%, the last bin includes overflow. */
+	const int nbins = 50;
+	size_t    hist[nbins];
+	memset (hist, 0, sizeof (hist));
+	for (size_t c = 0; c < n; ++c) {
+		int b = floor (_process_us[c] * nbins / (2.0 * nominal));
+		hist[std::max (0, std::min (nbins - 1, b))] += 1;
+	}
+	fprintf (f, "  \"histogram\": { \"bin_us\": %.2f, \"counts\": [", 2.0 * nominal / nbins);
+	for (int b = 0; b < nbins; ++b) {
+		fprintf (f, "%s%zu", b > 0 ? ", " : "", hist[b]);
+	}
+	fprintf (f, "] },\n");
+
+	/* CPU time of each process thread, relative to the process time */
+	fprintf (f, "  \"threads\": [");
+	for (int t = 0; t < _n_threads_max; ++t) {
+		double cpu = 0;
+		double max = 0;
+		for (size_t c = 0; c < n; ++c) {
+			cpu += _thread_us[c * MaxThreads + t];
+			max = std::max<double> (max, _thread_us[c * MaxThreads + t]);
+		}
+		fprintf (f, "%s\n    { \"thread\": %d, \"cpu_us_avg\": %.2f, \"cpu_us_max\": %.1f, \"utilization\": %.4f }",
+		         t > 0 ? "," : "", t, cpu / n, max, sum > 0 ? cpu / sum : 0);
+	}
+	fprintf (f, "%s]\n", _n_threads_max > 0 ? "\n  " : "");
+	fprintf (f, "}\n");
+
+	return fclose (f) ? -1 : 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __libbackend_dummy_benchmark_h__
+#define __libbackend_dummy_benchmark_h__
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "pbd/g_atomic_compat.h"
+
+namespace ARDOUR {
+
+/** Per-cycle statistics and load simulation for the Dummy backend.
+ *
+ * Enabled using environment variables, so that headless tools can
+ * use it without linking against the backend:
+ *
+ *  ARDOUR_DUMMY_BENCHMARK         report file, ".json" or ".csv"
+ *  ARDOUR_DUMMY_BENCHMARK_CYCLES  number of cycles to record (default 10000)
+ *  ARDOUR_DUMMY_LOAD_PROFILE      additional load per cycle [usec],
+ *                                 one value per line (or the 2nd column
+ *                                 of a CSV report), replayed cyclically
+ *
+ * Recording ends once the given number of cycles have been recorded,
+ * the report is written when the backend is stopped.
+ */
+class DummyBenchmark
+{
+public:
+	DummyBenchmark ();
+
+	/* read the environment, allocate buffers. Not realtime-safe */
+	void init (float samplerate, size_t samples_per_period, float speedup);
+
+	bool enabled () const { return _enabled; }
+	bool recording () const { return _enabled && _n_cycles < _max_cycles; }
+
+	/* process threads, to sample their CPU time */
+	void add_thread (pthread_t);
+	void clear_threads ();
+
+	/* busy-wait for the duration given by the load-profile */
+	void simulate_load ();
+
+	void cycle_start ();
+	void cycle_end (float dsp_load);
+
+	/* write the report if any cycles were recorded, and reset.
+	 * Not realtime-safe, called after the process thread terminated.
+	 */
+	void finish ();
+
+private:
+	enum { MaxThreads = 64 };
+
+	int64_t thread_time (int) const;
+	int     write_csv (std::string const&) const;
+	int     write_json (std::string const&) const;
+
+	bool        _enabled;
+	std::string _report;
+	float       _samplerate;
+	size_t      _samples_per_period;
+	float       _speedup;
+
+	size_t _max_cycles;
+	size_t _n_cycles;
+
+	std::vector<float> _profile;
+	size_t             _profile_pos;
+
+	std::vector<int64_t> _cycle_start; ///< monotonic time [usec]
+	std::vector<float>   _process_us;
+	std::vector<float>   _dsp_load;
+	std::vector<float>   _thread_us;   ///< [cycle][thread] CPU time [usec]
+
+#ifndef PLATFORM_WINDOWS
+	clockid_t           _clk[MaxThreads];
+#endif
+	int64_t             _t0[MaxThreads];
+	GATOMIC_QUAL gint   _n_threads;
+	int                 _n_threads_max;
+	int                 _n_threads_cycle;
+};
+
+} // namespace ARDOUR
+
+#endif /* __libbackend_dummy_benchmark_h__ */
@@ -34,7 +34,7 @@ public:
 	int do_command (std::string);
 	int do_file (std::string);
 	void collect_garbage ();
-	void collect_garbage_step (int debt = 0);
+	bool collect_garbage_step (int debt = 0); // true if a GC cycle was completed
 	void tweak_rt_gc ();
 	void sandbox (bool rt_safe = false);
 
@@ -76,9 +76,9 @@ LuaState::collect_garbage () {
 	lua_gc (L, LUA_GCCOLLECT, 0);
 }
 
-void
+bool
 LuaState::collect_garbage_step (int debt) {
-	lua_gc (L, LUA_GCSTEP, debt);
+	return lua_gc (L, LUA_GCSTEP, debt) == 1;
 }
 
 void
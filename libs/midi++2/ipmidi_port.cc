@@ -332,9 +332,7 @@ IPMIDIPort::parse (samplecnt_t timestamp)
 
 		_parser->set_timestamp (timestamp);
 
-		for (int i = 0; i < r; ++i) {
-			_parser->scanner (buf[i]);
-		}
+		_parser->scan (buf, r);
 	} else {
 		::perror ("failed to recv from socket");
 	}
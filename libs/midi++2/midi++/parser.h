@@ -24,6 +24,7 @@
 
 #include <string>
 #include <iostream>
+#include <vector>
 
 #include "pbd/signals.h"
 
@@ -112,6 +113,23 @@ class LIBMIDIPP_API Parser {
 
 	void scanner (byte c);
 
+	/* Parse a buffer. This is equivalent to calling ::scanner() for
+	   each byte, except that channel messages are collected, and
+	   only signals that have subscribers are emitted for them, once
+	   the buffer has been parsed (or at batch_end()). Other messages
+	   are handled immediately, in order.
+
+	   batch_begin() and batch_end() can be used to parse several
+	   buffers (e.g. with different timestamps) in one batch.
+	   Subscribers connected during a batch are only considered from
+	   the next batch on. If ::edit has subscribers, messages are
+	   not collected.
+	*/
+
+	void scan (byte const* buf, size_t len);
+	void batch_begin ();
+	void batch_end ();
+
 	size_t *message_counts() { return message_counter; }
 	const char *midi_event_type_name (MIDI::eventType);
 	void trace (bool onoff, std::ostream *o, const std::string &prefix = "");
@@ -194,6 +212,36 @@ class LIBMIDIPP_API Parser {
 	bool possible_mmc (byte *msg, size_t msglen);
 	bool possible_mtc (byte *msg, size_t msglen);
 	void process_mtc_quarter_frame (byte *msg);
+
+	/* batch parsing */
+
+	struct ChannelEvent {
+		samplecnt_t time;
+		byte        msg[3];
+		byte        len;
+		byte        type; ///< index into _dispatch
+	};
+
+	enum DispatchFlags {
+		DispatchPre     = 0x01, ///< channel_active_preparse
+		DispatchType    = 0x02, ///< e.g. controller
+		DispatchChannel = 0x04, ///< e.g. channel_controller
+		DispatchPost    = 0x08, ///< channel_active_postparse
+	};
+
+	bool                      _batch;
+	std::vector<ChannelEvent> _events;
+	std::vector<ChannelEvent> _dispatch_events;
+	uint8_t                   _dispatch[7][16]; ///< [(status >> 4) - 8][channel]
+	bool                      _dispatch_any;
+
+	void update_dispatch_table ();
+	void dispatch_events ();
+	void flush_events () {
+		if (!_events.empty ()) {
+			dispatch_events ();
+		}
+	}
 };
 
 } // namespace MIDI
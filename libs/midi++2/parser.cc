@@ -123,6 +123,12 @@ Parser::Parser ()
 
 	pre_variable_state = NEEDSTATUS;
 	pre_variable_msgtype = none;
+
+	_batch = false;
+	_dispatch_any = false;
+	memset (_dispatch, 0, sizeof (_dispatch));
+	_events.reserve (256);
+	_dispatch_events.reserve (256);
 }
 
 Parser::~Parser ()
@@ -335,6 +341,7 @@ Parser::scanner (unsigned char inbyte)
 	*/
 
 	if (inbyte == 0xfe) {
+		flush_events ();
 	        message_counter[inbyte]++;
 		if (!_offline) {
 			active_sense (*this);
@@ -388,6 +395,7 @@ Parser::scanner (unsigned char inbyte)
 	}
 
 	if (rtmsg) {
+		flush_events ();
 		boost::optional<int> res = edit (&inbyte, 1);
 
 		if (res.value_or (1) >= 0 && !_offline) {
@@ -410,6 +418,8 @@ Parser::scanner (unsigned char inbyte)
 
 		/* The message has ended, so process it */
 
+		flush_events ();
+
 		/* add EOX to any sysex message */
 
 		if (inbyte == MIDI::eox) {
@@ -501,7 +511,9 @@ Parser::scanner (unsigned char inbyte)
 	case NEEDONEBYTE:
 		/* We've completed a 1 or 2 byte message. */
 
-                edit_result = edit (msgbuf, msgindex);
+		if (!_batch) {
+			edit_result = edit (msgbuf, msgindex);
+		}
 
 		if (edit_result.value_or (1)) {
 
@@ -648,6 +660,7 @@ Parser::system_msg (unsigned char inbyte)
 		break;
 	case 0xf6:
 		if (!_offline) {
+			flush_events ();
 			tune (*this);
 		}
 		state = NEEDSTATUS;
@@ -667,6 +680,34 @@ Parser::signal (MIDI::byte *msg, size_t len)
 	channel_t chan = msg[0]&0xF;
 	int chan_i = chan;
 
+	if (_batch) {
+		switch (msgtype) {
+		case off:
+		case on:
+		case polypress:
+		case MIDI::controller:
+		case program:
+		case chanpress:
+		case MIDI::pitchbend:
+			{
+				/* note-on with velocity 0 is dispatched as note-off */
+				const int t = (msgtype == on && msg[2] == 0) ? 0 : (msgtype >> 4) - 8;
+				if (_dispatch_any || _dispatch[t][chan_i]) {
+					ChannelEvent ev;
+					ev.time = _timestamp;
+					ev.len = len;
+					ev.type = t;
+					memcpy (ev.msg, msg, sizeof (ev.msg));
+					_events.push_back (ev);
+				}
+			}
+			return;
+		default:
+			flush_events ();
+			break;
+		}
+	}
+
 	switch (msgtype) {
 	case none:
 		break;
@@ -797,3 +838,167 @@ Parser::set_offline (bool yn)
 		state = NEEDSTATUS;
 	}
 }
+
+void
+Parser::scan (MIDI::byte const* buf, size_t len)
+{
+	const bool own_batch = !_batch;
+
+	if (own_batch) {
+		batch_begin ();
+	}
+
+	for (size_t n = 0; n < len; ++n) {
+		scanner (buf[n]);
+	}
+
+	if (own_batch) {
+		batch_end ();
+	}
+}
+
+void
+Parser::batch_begin ()
+{
+	if (!edit.empty ()) {
+		/* editors may modify or cancel each message as it is parsed */
+		_batch = false;
+		return;
+	}
+	update_dispatch_table ();
+	_batch = true;
+}
+
+void
+Parser::batch_end ()
+{
+	_batch = false;
+	flush_events ();
+}
+
+void
+Parser::update_dispatch_table ()
+{
+	TwoByteSignal* const two_byte[] = { &note_off, &note_on, &poly_pressure, &controller };
+	TwoByteSignal* const channel_two_byte[] = { channel_note_off, channel_note_on, channel_poly_pressure, channel_controller };
+
+	_dispatch_any = !any.empty ();
+
+	for (int c = 0; c < 16; ++c) {
+		uint8_t f = 0;
+		if (!channel_active_preparse[c].empty ()) {
+			f |= DispatchPre;
+		}
+		if (!channel_active_postparse[c].empty ()) {
+			f |= DispatchPost;
+		}
+
+		for (int t = 0; t < 4; ++t) {
+			_dispatch[t][c] = f;
+			if (!two_byte[t]->empty ()) {
+				_dispatch[t][c] |= DispatchType;
+			}
+			if (!channel_two_byte[t][c].empty ()) {
+				_dispatch[t][c] |= DispatchChannel;
+			}
+		}
+
+		_dispatch[4][c] = f | (program_change.empty () ? 0 : DispatchType) | (channel_program_change[c].empty () ? 0 : DispatchChannel);
+		_dispatch[5][c] = f | (pressure.empty () ? 0 : DispatchType) | (channel_pressure[c].empty () ? 0 : DispatchChannel);
+		_dispatch[6][c] = f | (pitchbend.empty () ? 0 : DispatchType) | (channel_pitchbend[c].empty () ? 0 : DispatchChannel);
+	}
+}
+
+/** Emit the signals for all collected channel messages, in the same
+ * order as ::signal() does, skipping signals without subscribers.
+ */
+void
+Parser::dispatch_events ()
+{
+	const samplecnt_t timestamp = _timestamp;
+
+	_dispatch_events.swap (_events);
+
+	for (std::vector<ChannelEvent>::iterator i = _dispatch_events.begin (); i != _dispatch_events.end (); ++i) {
+		MIDI::byte*   msg = i->msg;
+		const int     c   = msg[0] & 0xf;
+		const int     t   = i->type;
+		const uint8_t f   = _dispatch[t][c];
+
+		_timestamp = i->time;
+
+		if (f & DispatchPre) {
+			channel_active_preparse[c] (*this);
+		}
+
+		switch (t) {
+		case 0:
+			if (f & DispatchType) {
+				note_off (*this, (EventTwoBytes *) &msg[1]);
+			}
+			if (f & DispatchChannel) {
+				channel_note_off[c] (*this, (EventTwoBytes *) &msg[1]);
+			}
+			break;
+		case 1:
+			if (f & DispatchType) {
+				note_on (*this, (EventTwoBytes *) &msg[1]);
+			}
+			if (f & DispatchChannel) {
+				channel_note_on[c] (*this, (EventTwoBytes *) &msg[1]);
+			}
+			break;
+		case 2:
+			if (f & DispatchType) {
+				poly_pressure (*this, (EventTwoBytes *) &msg[1]);
+			}
+			if (f & DispatchChannel) {
+				channel_poly_pressure[c] (*this, (EventTwoBytes *) &msg[1]);
+			}
+			break;
+		case 3:
+			if (f & DispatchType) {
+				controller (*this, (EventTwoBytes *) &msg[1]);
+			}
+			if (f & DispatchChannel) {
+				channel_controller[c] (*this, (EventTwoBytes *) &msg[1]);
+			}
+			break;
+		case 4:
+			if (f & DispatchType) {
+				program_change (*this, msg[1]);
+			}
+			if (f & DispatchChannel) {
+				channel_program_change[c] (*this, msg[1]);
+			}
+			break;
+		case 5:
+			if (f & DispatchType) {
+				pressure (*this, msg[1]);
+			}
+			if (f & DispatchChannel) {
+				channel_pressure[c] (*this, msg[1]);
+			}
+			break;
+		case 6:
+			if (f & DispatchType) {
+				pitchbend (*this, (msg[2]<<7)|msg[1]);
+			}
+			if (f & DispatchChannel) {
+				channel_pitchbend[c] (*this, (msg[2]<<7)|msg[1]);
+			}
+			break;
+		}
+
+		if (f & DispatchPost) {
+			channel_active_postparse[c] (*this);
+		}
+
+		if (_dispatch_any) {
+			any (*this, msg, i->len, i->time);
+		}
+	}
+
+	_dispatch_events.clear ();
+	_timestamp = timestamp;
+}
@@ -0,0 +1,172 @@
+/* Benchmark for MIDI::Parser input parsing
+ *
+ * Compares byte-wise ::scanner() with batch ::scan() for dense
+ * controller streams (14-bit CCs with running status, and MPE with
+ * per-channel pitchbend, pressure and timbre), with a single
+ * subscriber (e.g. one MIDI binding) and with many subscribers.
+ * usage: parser-benchmark [n-bytes] [iterations]
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <glib.h>
+
+#include "pbd/pbd.h"
+#include "pbd/signals.h"
+
+#include "midi++/parser.h"
+
+using namespace MIDI;
+
+struct Counter {
+	Counter () : events (0), sum (0) {}
+
+	void two_byte (Parser&, EventTwoBytes* tb) { ++events; sum += tb->controller_number + tb->value; }
+	void one_byte (Parser&, byte b) { ++events; sum += b; }
+	void bend (Parser&, pitchbend_t pb) { ++events; sum += pb; }
+	void any (Parser&, byte* msg, size_t len, samplecnt_t) { ++events; sum += msg[len - 1]; }
+
+	uint64_t events;
+	uint64_t sum;
+};
+
+static void
+fill_14bit_cc (std::vector<byte>& buf, size_t n_bytes)
+{
+	buf.clear ();
+	int v = 0;
+	while (buf.size () + 20 <= n_bytes) {
+		for (int c = 0; c < 4; ++c) {
+			/* MSB and LSB of a fader, using running status */
+			buf.push_back (0xb0 | c);
+			buf.push_back (7);
+			buf.push_back ((v >> 7) & 0x7f);
+			buf.push_back (39);
+			buf.push_back (v & 0x7f);
+		}
+		v = (v + 97) & 0x3fff;
+	}
+}
+
+static void
+fill_mpe (std::vector<byte>& buf, size_t n_bytes)
+{
+	buf.clear ();
+	int v = 0;
+	while (buf.size () + 11 <= n_bytes) {
+		const byte c = 1 + (v % 15);
+		buf.push_back (0xe0 | c); /* pitchbend */
+		buf.push_back (v & 0x7f);
+		buf.push_back ((v >> 7) & 0x7f);
+		buf.push_back (0xd0 | c); /* channel pressure */
+		buf.push_back (v & 0x7f);
+		buf.push_back (0xb0 | c); /* timbre */
+		buf.push_back (74);
+		buf.push_back ((v >> 3) & 0x7f);
+		if (v % 16 == 0) {
+			buf.push_back (0x90 | c);
+			buf.push_back (60 + c);
+			buf.push_back (100);
+		} else if (v % 16 == 8) {
+			/* note-off as note-on with velocity 0 */
+			buf.push_back (0x90 | c);
+			buf.push_back (60 + c);
+			buf.push_back (0);
+		}
+		v = (v + 1) & 0x3fff;
+	}
+}
+
+static void
+subscribe (Parser& p, Counter& cnt, PBD::ScopedConnectionList& cl, bool dense)
+{
+	p.channel_controller[1].connect_same_thread (cl, boost::bind (&Counter::two_byte, &cnt, _1, _2));
+	if (!dense) {
+		return;
+	}
+	p.controller.connect_same_thread (cl, boost::bind (&Counter::two_byte, &cnt, _1, _2));
+	p.note_on.connect_same_thread (cl, boost::bind (&Counter::two_byte, &cnt, _1, _2));
+	p.note_off.connect_same_thread (cl, boost::bind (&Counter::two_byte, &cnt, _1, _2));
+	p.pressure.connect_same_thread (cl, boost::bind (&Counter::one_byte, &cnt, _1, _2));
+	p.pitchbend.connect_same_thread (cl, boost::bind (&Counter::bend, &cnt, _1, _2));
+	p.any.connect_same_thread (cl, boost::bind (&Counter::any, &cnt, _1, _2, _3, _4));
+}
+
+static bool
+run (char const* name, std::vector<byte> const& buf, bool dense, int iterations)
+{
+	const size_t block = 1024; /* e.g. IPMIDIPort::parse */
+
+	Parser ref;
+	Parser bat;
+	Counter c_ref;
+	Counter c_bat;
+	PBD::ScopedConnectionList cl;
+
+	subscribe (ref, c_ref, cl, dense);
+	subscribe (bat, c_bat, cl, dense);
+
+	int64_t t0 = g_get_monotonic_time ();
+	for (int i = 0; i < iterations; ++i) {
+		for (size_t n = 0; n < buf.size (); ++n) {
+			ref.scanner (buf[n]);
+		}
+	}
+	int64_t t1 = g_get_monotonic_time ();
+	for (int i = 0; i < iterations; ++i) {
+		for (size_t n = 0; n < buf.size (); n += block) {
+			bat.scan (&buf[n], std::min (block, buf.size () - n));
+		}
+	}
+	int64_t t2 = g_get_monotonic_time ();
+
+	const double mb     = (double)buf.size () * iterations / 1e6;
+	const double us_ref = std::max<int64_t> (1, t1 - t0);
+	const double us_bat = std::max<int64_t> (1, t2 - t1);
+	const bool   match  = c_ref.events == c_bat.events && c_ref.sum == c_bat.sum;
+
+	printf ("%-6s %-6s scanner: %8.2f MB/s  scan: %8.2f MB/s  speedup: %5.2f  callbacks: %lu %s\n",
+	        name, dense ? "dense" : "sparse",
+	        mb * 1e6 / us_ref, mb * 1e6 / us_bat, us_ref / us_bat,
+	        (unsigned long)c_bat.events, match ? "" : "MISMATCH");
+
+	return match;
+}
+
+int
+main (int argc, char* argv[])
+{
+	size_t n_bytes    = 65536;
+	int    iterations = 100;
+
+	if (argc > 1) {
+		n_bytes = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		iterations = atoi (argv[2]);
+	}
+	if (n_bytes < 32 || iterations < 1) {
+		fprintf (stderr, "Usage: %s [n-bytes] [iterations]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (!PBD::init ()) {
+		return EXIT_FAILURE;
+	}
+
+	std::vector<byte> buf;
+	bool              ok = true;
+
+	fill_14bit_cc (buf, n_bytes);
+	ok &= run ("14bit", buf, false, iterations);
+	ok &= run ("14bit", buf, true, iterations);
+
+	fill_mpe (buf, n_bytes);
+	ok &= run ("MPE", buf, false, iterations);
+	ok &= run ("MPE", buf, true, iterations);
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -27,10 +27,6 @@
 #include <iostream>
 #include <string>
 
-#ifdef COMPILER_MSVC
-#include <malloc.h>
-#endif
-
 #include "pbd/cartesian.h"
 #include "pbd/compose.h"
 
@@ -65,24 +61,18 @@ panner_descriptor ()
 	return &_descriptor;
 }
 
-VBAPanner::Signal::Signal (VBAPanner&, uint32_t, uint32_t n_speakers)
+VBAPanner::Signal::Signal (VBAPanner&, uint32_t)
+	: gains_azi (-1)
+	, gains_ele (-1)
+	, gains_generation (0)
 {
-	resize_gains (n_speakers);
-
 	desired_gains[0] = desired_gains[1] = desired_gains[2] = 0;
-	outputs[0] = outputs[1] = outputs[2] = -1;
 	desired_outputs[0] = desired_outputs[1] = desired_outputs[2] = -1;
 }
 
-void
-VBAPanner::Signal::resize_gains (uint32_t n)
-{
-	gains.assign (n, 0.0);
-}
-
 VBAPanner::VBAPanner (boost::shared_ptr<Pannable> p, boost::shared_ptr<Speakers> s)
 	: Panner (p)
-	, _speakers (new VBAPSpeakers (s))
+	, _speakers (VBAPSpeakers::instance (s))
 {
 	_pannable->pan_azimuth_control->Changed.connect_same_thread (*this, boost::bind (&VBAPanner::update, this));
 	_pannable->pan_elevation_control->Changed.connect_same_thread (*this, boost::bind (&VBAPanner::update, this));
@@ -116,10 +106,14 @@ VBAPanner::configure_io (ChanCount in, ChanCount /* ignored - we use Speakers */
 	clear_signals ();
 
 	for (uint32_t i = 0; i < n; ++i) {
-		Signal* s = new Signal (*this, i, _speakers->n_speakers ());
+		Signal* s = new Signal (*this, i);
 		_signals.push_back (s);
 	}
 
+	_matrix.configure (n, _speakers->n_speakers ());
+	_inputs.resize (n);
+	_outputs.resize (_speakers->n_speakers ());
+
 	update ();
 }
 
@@ -150,7 +144,7 @@ VBAPanner::update ()
 			signal_direction -= (double)over;
 
 			signal->direction = AngularVector (signal_direction * 360.0, elevation);
-			compute_gains (signal->desired_gains, signal->desired_outputs, signal->direction.azi, signal->direction.ele);
+			compute_gains (signal);
 			signal_direction += grd_step_per_signal;
 		}
 	} else if (_signals.size () == 1) {
@@ -160,200 +154,76 @@ VBAPanner::update ()
 
 		Signal* s    = _signals.front ();
 		s->direction = AngularVector (center, elevation);
-		compute_gains (s->desired_gains, s->desired_outputs, s->direction.azi, s->direction.ele);
+		compute_gains (s);
 	}
 
 	SignalPositionChanged (); /* emit */
 }
 
 void
-VBAPanner::compute_gains (double gains[3], int speaker_ids[3], int azi, int ele)
+VBAPanner::compute_gains (Signal* signal)
 {
-	/* calculates gain factors using loudspeaker setup and given direction */
-	double    cartdir[3];
-	double    power;
-	int       i, j, k;
-	double    small_g;
-	double    big_sm_g, gtmp[3];
-	const int dimension = _speakers->dimension ();
-	assert (dimension == 2 || dimension == 3);
-
-	spherical_to_cartesian (azi, ele, 1.0, cartdir[0], cartdir[1], cartdir[2]);
-	big_sm_g = -100000.0;
-
-	gains[0] = gains[1] = gains[2] = 0;
-	speaker_ids[0] = speaker_ids[1] = speaker_ids[2] = 0;
-
-	for (i = 0; i < _speakers->n_tuples (); i++) {
-		small_g = 10000000.0;
-
-		for (j = 0; j < dimension; j++) {
-			gtmp[j] = 0.0;
-
-			for (k = 0; k < dimension; k++) {
-				gtmp[j] += cartdir[k] * _speakers->matrix (i)[j * dimension + k];
-			}
-
-			if (gtmp[j] < small_g) {
-				small_g = gtmp[j];
-			}
-		}
-
-		if (small_g > big_sm_g) {
-			big_sm_g = small_g;
-
-			gains[0] = gtmp[0];
-			gains[1] = gtmp[1];
+	const int      azi = signal->direction.azi;
+	const int      ele = signal->direction.ele;
+	const uint32_t gen = _speakers->generation ();
 
-			speaker_ids[0] = _speakers->speaker_for_tuple (i, 0);
-			speaker_ids[1] = _speakers->speaker_for_tuple (i, 1);
-
-			if (_speakers->dimension () == 3) {
-				gains[2]       = gtmp[2];
-				speaker_ids[2] = _speakers->speaker_for_tuple (i, 2);
-			} else {
-				gains[2]       = 0.0;
-				speaker_ids[2] = -1;
-			}
-		}
+	if (azi == signal->gains_azi && ele == signal->gains_ele && gen == signal->gains_generation) {
+		/* same direction and speakers as before */
+		return;
 	}
 
-	power = sqrt (gains[0] * gains[0] + gains[1] * gains[1] + gains[2] * gains[2]);
+	_speakers->compute_gains (signal->desired_gains, signal->desired_outputs, azi, ele);
 
-	if (power > 0) {
-		gains[0] /= power;
-		gains[1] /= power;
-		gains[2] /= power;
-	}
+	signal->gains_azi        = azi;
+	signal->gains_ele        = ele;
+	signal->gains_generation = gen;
 }
 
 void
 VBAPanner::distribute (BufferSet& inbufs, BufferSet& obufs, gain_t gain_coefficient, pframes_t nframes)
 {
-	uint32_t                  n;
-	vector<Signal*>::iterator s;
-
 	assert (inbufs.count ().n_audio () == _signals.size ());
 
-	for (s = _signals.begin (), n = 0; s != _signals.end (); ++s, ++n) {
-		Signal* signal (*s);
-
-		distribute_one (inbufs.get_audio (n), obufs, gain_coefficient, nframes, n);
-
-		memcpy (signal->outputs, signal->desired_outputs, sizeof (signal->outputs));
-	}
-}
-
-void
-VBAPanner::distribute_one (AudioBuffer& srcbuf, BufferSet& obufs, gain_t gain_coefficient, pframes_t nframes, uint32_t which)
-{
-	Sample* const src = srcbuf.data ();
-	Signal*       signal (_signals[which]);
-
-	/* VBAP may distribute the signal across up to 3 speakers depending on
+	/* VBAP may distribute each signal across up to 3 speakers depending on
 	 * the configuration of the speakers.
 	 *
 	 * But the set of speakers in use "this time" may be different from
-	 * the set of speakers "the last time". So we have up to 6 speakers
-	 * involved, and we have to interpolate so that those no longer
-	 * in use are rapidly faded to silence and those newly in use
-	 * are rapidly faded to their correct level. This prevents clicks
-	 * as we change the set of speakers used to put the signal in
-	 * a given position.
+	 * the set of speakers "the last time". The gain matrix interpolates
+	 * all gains from the previous to the current value, so that
+	 * speakers no longer in use are rapidly faded to silence and those
+	 * newly in use are rapidly faded to their correct level. This
+	 * prevents clicks as we change the set of speakers used to put the
+	 * signal in a given position.
 	 *
-	 * However, the speakers are represented by output buffers, and other
-	 * speakers may write to the same buffers, so we cannot use
-	 * anything here that will simply assign new (sample) values
-	 * to the output buffers - everything must be done via mixing
-	 * functions and not assignment/copying.
+	 * Other panners may write to the same output buffers, so everything
+	 * is mixed into the outputs, which were silenced by the PannerShell.
 	 */
 
-	vector<double>::size_type sz = signal->gains.size ();
-
-	assert (sz == obufs.count ().n_audio ());
-
-	int8_t* outputs = (int8_t*)alloca (sz); // on the stack, no malloc
-
-	/* set initial state of each output "record"
-         */
-
-	for (uint32_t o = 0; o < sz; ++o) {
-		outputs[o] = 0;
+	if (_signals.empty () || _matrix.n_signals () != _signals.size () || _matrix.n_speakers () != obufs.count ().n_audio ()) {
+		/* speaker configuration changed, not yet re-configured */
+		return;
 	}
 
-	/* for all outputs used this time and last time,
-				 * change the output record to show what has
-				 * happened.
-				 */
-
-	for (int o = 0; o < 3; ++o) {
-		if (signal->outputs[o] != -1) {
-			/* used last time */
-			outputs[signal->outputs[o]] |= 1;
-		}
-
-		if (signal->desired_outputs[o] != -1) {
-			/* used this time */
-			outputs[signal->desired_outputs[o]] |= 1 << 1;
-		}
+	for (uint32_t n = 0; n < _signals.size (); ++n) {
+		Signal* signal (_signals[n]);
+		_matrix.set_target (n, signal->desired_outputs, signal->desired_gains, gain_coefficient);
+		AudioBuffer const& src (inbufs.get_audio (n));
+		_inputs[n] = src.data ();
 	}
 
-	/* at this point, we can test a speaker's status:
-	 *
-	 * (*outputs[o] & 1)      <= in use before
-	 * (*outputs[o] & 2)      <= in use this time
-	 * (*outputs[o] & 3) == 3 <= in use both times
-	 * *outputs[o] == 0      <= not in use either time
-	 *
-	 */
-
-	for (int o = 0; o < 3; ++o) {
-		pan_t pan;
-		int   output = signal->desired_outputs[o];
-
-		if (output == -1) {
-			continue;
-		}
-
-		pan = gain_coefficient * signal->desired_gains[o];
-
-		if (pan == 0.0 && signal->gains[output] == 0.0) {
-			/* nothing deing delivered to this output */
-
-			signal->gains[output] = 0.0;
-
-		} else if (fabs (pan - signal->gains[output]) > 0.00001) {
-			/* signal to this output but the gain coefficient has changed, so
-			 * interpolate between them.
-			 */
-
-			AudioBuffer& buf (obufs.get_audio (output));
-			buf.accumulate_with_ramped_gain_from (srcbuf.data (), nframes, signal->gains[output], pan, 0);
-			signal->gains[output] = pan;
-
-		} else {
-			/* signal to this output, same gain as before so just copy with gain */
-
-			mix_buffers_with_gain (obufs.get_audio (output).data (), src, nframes, pan);
-			signal->gains[output] = pan;
-		}
+	for (uint32_t o = 0; o < _outputs.size (); ++o) {
+		AudioBuffer& buf (obufs.get_audio (o));
+		_outputs[o] = buf.data ();
+		buf.set_written (true);
 	}
 
-	/* clean up the outputs that were used last time but not this time */
-
-	for (uint32_t o = 0; o < sz; ++o) {
-		if (outputs[o] == 1) {
-			/* take signal and deliver with a rapid fade out */
-			AudioBuffer& buf (obufs.get_audio (o));
-			buf.accumulate_with_ramped_gain_from (srcbuf.data (), nframes, signal->gains[o], 0.0, 0);
-			signal->gains[o] = 0.0;
-		}
-	}
+	_matrix.run (&_inputs[0], &_outputs[0], nframes);
+}
 
-	/* note that the output buffers were all silenced at some point
-	 * so anything we didn't write to with this signal (or any others)
-	 * is just as it should be.
-	 */
+void
+VBAPanner::distribute_one (AudioBuffer& /*src*/, BufferSet& /*obufs*/, gain_t /*gain_coeff*/, pframes_t /*nframes*/, uint32_t /*which*/)
+{
+	/* unused, distribute () processes all signals at once */
 }
 
 void
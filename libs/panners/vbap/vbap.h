@@ -28,6 +28,7 @@
 #include "ardour/panner.h"
 #include "ardour/panner_shell.h"
 
+#include "vbap_matrix.h"
 #include "vbap_speakers.h"
 
 namespace ARDOUR
@@ -66,21 +67,27 @@ public:
 
 private:
 	struct Signal {
-		PBD::AngularVector  direction;
-		std::vector<double> gains; /* most recently used gain for all speakers */
+		PBD::AngularVector direction;
 
-		int    outputs[3];         /* most recent set of outputs used (2 or 3, depending on dimension) */
 		int    desired_outputs[3]; /* outputs to use the next time we distribute */
 		double desired_gains[3];   /* target gains for desired_outputs */
 
-		Signal (VBAPanner&, uint32_t which, uint32_t n_speakers);
-		void resize_gains (uint32_t n_speakers);
+		/* direction and speaker configuration, desired_gains were computed for */
+		int      gains_azi;
+		int      gains_ele;
+		uint32_t gains_generation;
+
+		Signal (VBAPanner&, uint32_t which);
 	};
 
 	std::vector<Signal*>            _signals;
 	boost::shared_ptr<VBAPSpeakers> _speakers;
 
-	void compute_gains (double g[3], int ls[3], int azi, int ele);
+	VBAPGainMatrix                  _matrix;
+	std::vector<Sample const*>      _inputs;
+	std::vector<Sample*>            _outputs;
+
+	void compute_gains (Signal*);
 	void update ();
 	void clear_signals ();
 
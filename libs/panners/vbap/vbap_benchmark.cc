@@ -0,0 +1,216 @@
+/* Benchmark for the VBAP output stage
+ *
+ * Compares the gain-matrix mixer with per-signal mixing (the previous
+ * implementation), for a range of object and speaker counts.
+ * All objects are moving, so gains are interpolated in every cycle.
+ * usage: vbap-benchmark [n-samples] [cycles]
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "pbd/timing.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audio_buffer.h"
+#include "ardour/runtime_functions.h"
+#include "ardour/speakers.h"
+
+#include "vbap_matrix.h"
+#include "vbap_speakers.h"
+
+using namespace ARDOUR;
+using namespace PBD;
+
+static const char* localedir = LOCALEDIR;
+
+struct Object {
+	Object (uint32_t n_speakers)
+		: gains (n_speakers, 0.f)
+	{
+		outputs[0] = outputs[1] = outputs[2] = -1;
+		desired_outputs[0] = desired_outputs[1] = desired_outputs[2] = -1;
+	}
+
+	std::vector<float> gains;
+	int                outputs[3];
+	int                desired_outputs[3];
+	double             desired_gains[3];
+};
+
+/* previous VBAPanner::distribute_one () */
+static void
+distribute_one (Object& obj, AudioBuffer& src, std::vector<AudioBuffer*>& obufs, pframes_t nframes)
+{
+	const uint32_t   sz = obj.gains.size ();
+	std::vector<int> outputs (sz, 0);
+
+	for (int o = 0; o < 3; ++o) {
+		if (obj.outputs[o] != -1) {
+			outputs[obj.outputs[o]] |= 1;
+		}
+		if (obj.desired_outputs[o] != -1) {
+			outputs[obj.desired_outputs[o]] |= 1 << 1;
+		}
+	}
+
+	for (int o = 0; o < 3; ++o) {
+		int output = obj.desired_outputs[o];
+		if (output == -1) {
+			continue;
+		}
+		pan_t pan = obj.desired_gains[o];
+		if (pan == 0.0 && obj.gains[output] == 0.0) {
+			obj.gains[output] = 0.0;
+		} else if (fabs (pan - obj.gains[output]) > 0.00001) {
+			obufs[output]->accumulate_with_ramped_gain_from (src.data (), nframes, obj.gains[output], pan, 0);
+			obj.gains[output] = pan;
+		} else {
+			mix_buffers_with_gain (obufs[output]->data (), src.data (), nframes, pan);
+			obj.gains[output] = pan;
+		}
+	}
+
+	for (uint32_t o = 0; o < sz; ++o) {
+		if (outputs[o] == 1) {
+			obufs[o]->accumulate_with_ramped_gain_from (src.data (), nframes, obj.gains[o], 0.0, 0);
+			obj.gains[o] = 0.0;
+		}
+	}
+
+	memcpy (obj.outputs, obj.desired_outputs, sizeof (obj.outputs));
+}
+
+static void
+run (char const* layout, boost::shared_ptr<Speakers> spk, uint32_t n_objects, pframes_t nframes, uint32_t cycles)
+{
+	boost::shared_ptr<VBAPSpeakers> vbap = VBAPSpeakers::instance (spk);
+	const uint32_t                  n_speakers = vbap->n_speakers ();
+
+	std::vector<AudioBuffer*> in;
+	std::vector<AudioBuffer*> out_ref;
+	std::vector<AudioBuffer*> out;
+	std::vector<Sample const*> in_ptrs;
+	std::vector<Sample*>       out_ptrs;
+	std::vector<Object>        objects (n_objects, Object (n_speakers));
+
+	for (uint32_t i = 0; i < n_objects; ++i) {
+		in.push_back (new AudioBuffer (nframes));
+		for (pframes_t n = 0; n < nframes; ++n) {
+			in[i]->data ()[n] = sinf (0.01f * (i + 1) * n);
+		}
+		in_ptrs.push_back (in[i]->data ());
+	}
+	for (uint32_t o = 0; o < n_speakers; ++o) {
+		out_ref.push_back (new AudioBuffer (nframes));
+		out.push_back (new AudioBuffer (nframes));
+		out_ptrs.push_back (out[o]->data ());
+	}
+
+	VBAPGainMatrix matrix;
+	matrix.configure (n_objects, n_speakers);
+
+	PBD::TimingStats t_ref;
+	PBD::TimingStats t_mtx;
+	float            max_diff = 0;
+
+	for (uint32_t c = 0; c < cycles; ++c) {
+		/* move all objects, 1 degree per cycle */
+		for (uint32_t i = 0; i < n_objects; ++i) {
+			vbap->compute_gains (objects[i].desired_gains, objects[i].desired_outputs, (c + i * 360 / n_objects) % 360, (vbap->dimension () == 3) ? 20 : 0);
+		}
+
+		for (uint32_t o = 0; o < n_speakers; ++o) {
+			out_ref[o]->silence (nframes);
+			out[o]->silence (nframes);
+		}
+
+		t_ref.start ();
+		for (uint32_t i = 0; i < n_objects; ++i) {
+			distribute_one (objects[i], *in[i], out_ref, nframes);
+		}
+		t_ref.update ();
+
+		t_mtx.start ();
+		for (uint32_t i = 0; i < n_objects; ++i) {
+			matrix.set_target (i, objects[i].desired_outputs, objects[i].desired_gains, 1.f);
+		}
+		matrix.run (&in_ptrs[0], &out_ptrs[0], nframes);
+		t_mtx.update ();
+
+		for (uint32_t o = 0; o < n_speakers; ++o) {
+			for (pframes_t n = 0; n < nframes; ++n) {
+				max_diff = std::max (max_diff, fabsf (out_ref[o]->data ()[n] - out[o]->data ()[n]));
+			}
+		}
+	}
+
+	PBD::microseconds_t min, max;
+	double              avg_ref, avg_mtx, dev;
+	t_ref.get_stats (min, max, avg_ref, dev);
+	t_mtx.get_stats (min, max, avg_mtx, dev);
+
+	printf ("%-6s %2d speakers %3d objects  per-signal: %8.2f  matrix: %8.2f [us/cycle]  max-diff: %g\n",
+	        layout, n_speakers, n_objects, avg_ref, avg_mtx, max_diff);
+
+	for (uint32_t i = 0; i < n_objects; ++i) {
+		delete in[i];
+	}
+	for (uint32_t o = 0; o < n_speakers; ++o) {
+		delete out_ref[o];
+		delete out[o];
+	}
+}
+
+int
+main (int argc, char* argv[])
+{
+	pframes_t nframes = 1024;
+	uint32_t  cycles  = 2000;
+
+	if (argc > 1) {
+		nframes = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		cycles = atoi (argv[2]);
+	}
+	if (nframes == 0 || cycles < 2) {
+		fprintf (stderr, "Usage: %s [n-samples] [cycles]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	ARDOUR::init (true, localedir);
+
+	/* 2D, regular 8 speaker ring */
+	boost::shared_ptr<Speakers> ring (new Speakers);
+	ring->setup_default_speakers (8);
+
+	/* 22.2 (ITU-R BS.2051 system H) without the LFE channels */
+	const double o = 180.0;
+	const double layout_22_2[][2] = {
+		{   0, 0 }, {  30, 0 }, { -30, 0 }, {  60, 0 }, { -60, 0 },
+		{  90, 0 }, { -90, 0 }, { 135, 0 }, { -135, 0 }, { 180, 0 },
+		{   0, 45 }, {  45, 45 }, { -45, 45 }, {  90, 45 }, { -90, 45 },
+		{ 135, 45 }, { -135, 45 }, { 180, 45 }, { 0, 90 },
+		{   0, -30 }, {  45, -30 }, { -45, -30 }
+	};
+	boost::shared_ptr<Speakers> immersive (new Speakers);
+	for (size_t i = 0; i < sizeof (layout_22_2) / sizeof (layout_22_2[0]); ++i) {
+		immersive->add_speaker (AngularVector (o + layout_22_2[i][0], layout_22_2[i][1]));
+	}
+
+	const uint32_t objects[] = { 1, 8, 16, 64 };
+
+	for (size_t i = 0; i < sizeof (objects) / sizeof (uint32_t); ++i) {
+		run ("8.0", ring, objects[i], nframes, cycles);
+	}
+	for (size_t i = 0; i < sizeof (objects) / sizeof (uint32_t); ++i) {
+		run ("22.2", immersive, objects[i], nframes, cycles);
+	}
+
+	ARDOUR::cleanup ();
+	return 0;
+}
@@ -0,0 +1,216 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cassert>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__SSE__)
+#include <xmmintrin.h>
+#define VBAP_SSE
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VBAP_NEON
+#endif
+
+#include "vbap_matrix.h"
+
+using namespace ARDOUR;
+
+VBAPGainMatrix::VBAPGainMatrix ()
+	: _n_signals (0)
+	, _n_speakers (0)
+{
+}
+
+void
+VBAPGainMatrix::configure (uint32_t n_signals, uint32_t n_speakers)
+{
+	_n_signals  = n_signals;
+	_n_speakers = n_speakers;
+	_gains.assign (n_signals * n_speakers, 0.f);
+	_target.assign (n_signals * n_speakers, 0.f);
+	_entries.resize (n_signals);
+}
+
+void
+VBAPGainMatrix::set_target (uint32_t signal, int const speaker_ids[3], double const gains[3], gain_t gain_coeff)
+{
+	assert (signal < _n_signals);
+
+	for (uint32_t o = 0; o < _n_speakers; ++o) {
+		_target[o * _n_signals + signal] = 0.f;
+	}
+
+	for (int i = 0; i < 3; ++i) {
+		if (speaker_ids[i] >= 0 && (uint32_t)speaker_ids[i] < _n_speakers) {
+			_target[speaker_ids[i] * _n_signals + signal] = gain_coeff * gains[i];
+		}
+	}
+}
+
+void
+VBAPGainMatrix::run (Sample const* const* in, Sample* const* out, pframes_t nframes)
+{
+	if (nframes == 0) {
+		return;
+	}
+
+	for (uint32_t o = 0; o < _n_speakers; ++o) {
+		float*       g0       = &_gains[o * _n_signals];
+		float const* g1       = &_target[o * _n_signals];
+		uint32_t     n_active = 0;
+
+		for (uint32_t s = 0; s < _n_signals; ++s) {
+			if (g0[s] == g1[s]) {
+				if (g1[s] == 0) {
+					/* nothing delivered to this speaker, now or before */
+					continue;
+				}
+				/* same gain as before */
+				Entry& e = _entries[n_active++];
+				e.src    = in[s];
+				e.gain   = g1[s];
+				e.delta  = 0;
+			} else if (fabsf (g1[s] - g0[s]) > 0.00001f) {
+				/* gain has changed, interpolate. This also fades out
+				 * speakers that are no longer in use.
+				 */
+				Entry& e = _entries[n_active++];
+				e.src    = in[s];
+				e.gain   = g0[s];
+				e.delta  = (g1[s] - g0[s]) / nframes;
+			} else if (g1[s] != 0) {
+				/* negligible change */
+				Entry& e = _entries[n_active++];
+				e.src    = in[s];
+				e.gain   = g1[s];
+				e.delta  = 0;
+			}
+			g0[s] = g1[s];
+		}
+
+		/* mix four signals at a time, to read and write the output only once */
+		uint32_t e = 0;
+		for (; e + 4 <= n_active; e += 4) {
+			mix_ramped_4 (out[o], &_entries[e], nframes);
+		}
+		for (; e < n_active; ++e) {
+			mix_ramped_1 (out[o], _entries[e], nframes);
+		}
+	}
+}
+
+/* dst[i] += src[i] * (gain + i * delta) */
+void
+VBAPGainMatrix::mix_ramped_1 (Sample* dst, Entry const& e, pframes_t nframes)
+{
+	Sample const* src = e.src;
+	pframes_t     i   = 0;
+
+#if defined(VBAP_SSE)
+	const __m128 g    = _mm_set1_ps (e.gain);
+	const __m128 d    = _mm_set1_ps (e.delta);
+	const __m128 four = _mm_set1_ps (4.f);
+	__m128       idx  = _mm_setr_ps (0.f, 1.f, 2.f, 3.f);
+
+	for (; i + 4 <= nframes; i += 4) {
+		__m128 gain = _mm_add_ps (g, _mm_mul_ps (idx, d));
+		__m128 y    = _mm_add_ps (_mm_loadu_ps (dst + i), _mm_mul_ps (_mm_loadu_ps (src + i), gain));
+		_mm_storeu_ps (dst + i, y);
+		idx = _mm_add_ps (idx, four);
+	}
+#elif defined(VBAP_NEON)
+	const float32x4_t g    = vdupq_n_f32 (e.gain);
+	const float32x4_t d    = vdupq_n_f32 (e.delta);
+	const float32x4_t four = vdupq_n_f32 (4.f);
+	static const float ramp[4] = { 0.f, 1.f, 2.f, 3.f };
+	float32x4_t       idx  = vld1q_f32 (ramp);
+
+	for (; i + 4 <= nframes; i += 4) {
+		float32x4_t gain = vmlaq_f32 (g, idx, d);
+		vst1q_f32 (dst + i, vmlaq_f32 (vld1q_f32 (dst + i), vld1q_f32 (src + i), gain));
+		idx = vaddq_f32 (idx, four);
+	}
+#endif
+
+	for (; i < nframes; ++i) {
+		dst[i] += src[i] * (e.gain + (float)i * e.delta);
+	}
+}
+
+/* dst[i] += sum_{k=0..3} src_k[i] * (gain_k + i * delta_k) */
+void
+VBAPGainMatrix::mix_ramped_4 (Sample* dst, Entry const* e, pframes_t nframes)
+{
+	Sample const* s0 = e[0].src;
+	Sample const* s1 = e[1].src;
+	Sample const* s2 = e[2].src;
+	Sample const* s3 = e[3].src;
+	pframes_t     i  = 0;
+
+#if defined(VBAP_SSE)
+	const __m128 g0   = _mm_set1_ps (e[0].gain);
+	const __m128 g1   = _mm_set1_ps (e[1].gain);
+	const __m128 g2   = _mm_set1_ps (e[2].gain);
+	const __m128 g3   = _mm_set1_ps (e[3].gain);
+	const __m128 d0   = _mm_set1_ps (e[0].delta);
+	const __m128 d1   = _mm_set1_ps (e[1].delta);
+	const __m128 d2   = _mm_set1_ps (e[2].delta);
+	const __m128 d3   = _mm_set1_ps (e[3].delta);
+	const __m128 four = _mm_set1_ps (4.f);
+	__m128       idx  = _mm_setr_ps (0.f, 1.f, 2.f, 3.f);
+
+	for (; i + 4 <= nframes; i += 4) {
+		__m128 y = _mm_loadu_ps (dst + i);
+		y = _mm_add_ps (y, _mm_mul_ps (_mm_loadu_ps (s0 + i), _mm_add_ps (g0, _mm_mul_ps (idx, d0))));
+		y = _mm_add_ps (y, _mm_mul_ps (_mm_loadu_ps (s1 + i), _mm_add_ps (g1, _mm_mul_ps (idx, d1))));
+		y = _mm_add_ps (y, _mm_mul_ps (_mm_loadu_ps (s2 + i), _mm_add_ps (g2, _mm_mul_ps (idx, d2))));
+		y = _mm_add_ps (y, _mm_mul_ps (_mm_loadu_ps (s3 + i), _mm_add_ps (g3, _mm_mul_ps (idx, d3))));
+		_mm_storeu_ps (dst + i, y);
+		idx = _mm_add_ps (idx, four);
+	}
+#elif defined(VBAP_NEON)
+	const float32x4_t g0   = vdupq_n_f32 (e[0].gain);
+	const float32x4_t g1   = vdupq_n_f32 (e[1].gain);
+	const float32x4_t g2   = vdupq_n_f32 (e[2].gain);
+	const float32x4_t g3   = vdupq_n_f32 (e[3].gain);
+	const float32x4_t d0   = vdupq_n_f32 (e[0].delta);
+	const float32x4_t d1   = vdupq_n_f32 (e[1].delta);
+	const float32x4_t d2   = vdupq_n_f32 (e[2].delta);
+	const float32x4_t d3   = vdupq_n_f32 (e[3].delta);
+	const float32x4_t four = vdupq_n_f32 (4.f);
+	static const float ramp[4] = { 0.f, 1.f, 2.f, 3.f };
+	float32x4_t       idx  = vld1q_f32 (ramp);
+
+	for (; i + 4 <= nframes; i += 4) {
+		float32x4_t y = vld1q_f32 (dst + i);
+		y = vmlaq_f32 (y, vld1q_f32 (s0 + i), vmlaq_f32 (g0, idx, d0));
+		y = vmlaq_f32 (y, vld1q_f32 (s1 + i), vmlaq_f32 (g1, idx, d1));
+		y = vmlaq_f32 (y, vld1q_f32 (s2 + i), vmlaq_f32 (g2, idx, d2));
+		y = vmlaq_f32 (y, vld1q_f32 (s3 + i), vmlaq_f32 (g3, idx, d3));
+		vst1q_f32 (dst + i, y);
+		idx = vaddq_f32 (idx, four);
+	}
+#endif
+
+	for (; i < nframes; ++i) {
+		const float fi = i;
+		dst[i] += s0[i] * (e[0].gain + fi * e[0].delta)
+		        + s1[i] * (e[1].gain + fi * e[1].delta)
+		        + s2[i] * (e[2].gain + fi * e[2].delta)
+		        + s3[i] * (e[3].gain + fi * e[3].delta);
+	}
+}
@@ -0,0 +1,78 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __libardour_vbap_matrix_h__
+#define __libardour_vbap_matrix_h__
+
+#include <vector>
+
+#include "ardour/types.h"
+
+namespace ARDOUR
+{
+
+/** Gain matrix of signals to speakers.
+ *
+ * Every cycle, each speaker output receives the sum of all signals,
+ * with the gain linearly interpolated from the gain used in the
+ * previous cycle to the current target gain. Signal/speaker pairs
+ * with zero gain in both cycles are skipped.
+ */
+class VBAPGainMatrix
+{
+public:
+	VBAPGainMatrix ();
+
+	/** allocate the matrix and reset all gains to zero, not realtime-safe */
+	void configure (uint32_t n_signals, uint32_t n_speakers);
+
+	uint32_t n_signals () const  { return _n_signals; }
+	uint32_t n_speakers () const { return _n_speakers; }
+
+	/** set the target gains of a signal for the next run ()
+	 * @param speaker_ids up to 3 speakers, -1 for unused entries
+	 * @param gains gain factor for each speaker
+	 * @param gain_coeff common gain factor, applied to all speakers
+	 */
+	void set_target (uint32_t signal, int const speaker_ids[3], double const gains[3], gain_t gain_coeff);
+
+	/** mix all signals into the speaker outputs, and make the
+	 * target gains the current gains.
+	 * @param in n_signals () input buffers
+	 * @param out n_speakers () output buffers, mixed into
+	 */
+	void run (Sample const* const* in, Sample* const* out, pframes_t nframes);
+
+private:
+	struct Entry {
+		Sample const* src;
+		float         gain;
+		float         delta; ///< gain increment per sample
+	};
+
+	uint32_t           _n_signals;
+	uint32_t           _n_speakers;
+	std::vector<float> _gains;   ///< gains used in the previous cycle, [speaker][signal]
+	std::vector<float> _target;  ///< gains for the next cycle, [speaker][signal]
+	std::vector<Entry> _entries; ///< active signals of one speaker, scratch space
+
+	static void mix_ramped_1 (Sample* dst, Entry const& e, pframes_t nframes);
+	static void mix_ramped_4 (Sample* dst, Entry const* e, pframes_t nframes);
+};
+
+} // namespace ARDOUR
+
+#endif /* __libardour_vbap_matrix_h__ */
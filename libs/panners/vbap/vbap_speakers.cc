@@ -32,6 +32,7 @@
 */
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <stdlib.h>
 
@@ -45,8 +46,35 @@ using namespace std;
 
 const double VBAPSpeakers::MIN_VOL_P_SIDE_LGTH = 0.01;
 
+VBAPSpeakers::Instances VBAPSpeakers::_instances;
+Glib::Threads::Mutex    VBAPSpeakers::_instance_lock;
+
+boost::shared_ptr<VBAPSpeakers>
+VBAPSpeakers::instance (boost::shared_ptr<Speakers> s)
+{
+	Glib::Threads::Mutex::Lock lm (_instance_lock);
+
+	for (Instances::iterator i = _instances.begin (); i != _instances.end ();) {
+		if (i->second.expired ()) {
+			_instances.erase (i++);
+		} else {
+			++i;
+		}
+	}
+
+	Instances::const_iterator i = _instances.find (s.get ());
+	if (i != _instances.end ()) {
+		return i->second.lock ();
+	}
+
+	boost::shared_ptr<VBAPSpeakers> vs (new VBAPSpeakers (s));
+	_instances[s.get ()] = vs;
+	return vs;
+}
+
 VBAPSpeakers::VBAPSpeakers (boost::shared_ptr<Speakers> s)
-	: _dimension (2)
+	: _generation (0)
+	, _dimension (2)
 	, _parent (s)
 {
 	_parent->Changed.connect_same_thread (speaker_connection, boost::bind (&VBAPSpeakers::update, this));
@@ -62,6 +90,7 @@ VBAPSpeakers::update ()
 {
 	int dim = 2;
 
+	++_generation;
 	_speakers = _parent->speakers ();
 
 	for (vector<Speaker>::const_iterator i = _speakers.begin (); i != _speakers.end (); ++i) {
@@ -90,6 +119,69 @@ VBAPSpeakers::update ()
 	}
 }
 
+void
+VBAPSpeakers::compute_gains (double gains[3], int speaker_ids[3], int azi, int ele) const
+{
+	/* calculates gain factors using loudspeaker setup and given direction */
+	double    cartdir[3];
+	double    power;
+	int       i, j, k;
+	double    small_g;
+	double    big_sm_g, gtmp[3];
+	const int dimension = _dimension;
+	assert (dimension == 2 || dimension == 3);
+
+	spherical_to_cartesian (azi, ele, 1.0, cartdir[0], cartdir[1], cartdir[2]);
+	big_sm_g = -100000.0;
+
+	gains[0] = gains[1] = gains[2] = 0;
+	speaker_ids[0] = speaker_ids[1] = speaker_ids[2] = 0;
+
+	for (i = 0; i < n_tuples (); i++) {
+		const dvector& mx = _matrices[i];
+
+		small_g = 10000000.0;
+
+		for (j = 0; j < dimension; j++) {
+			gtmp[j] = 0.0;
+
+			for (k = 0; k < dimension; k++) {
+				gtmp[j] += cartdir[k] * mx[j * dimension + k];
+			}
+
+			if (gtmp[j] < small_g) {
+				small_g = gtmp[j];
+			}
+		}
+
+		if (small_g > big_sm_g) {
+			big_sm_g = small_g;
+
+			gains[0] = gtmp[0];
+			gains[1] = gtmp[1];
+
+			speaker_ids[0] = speaker_for_tuple (i, 0);
+			speaker_ids[1] = speaker_for_tuple (i, 1);
+
+			if (dimension == 3) {
+				gains[2]       = gtmp[2];
+				speaker_ids[2] = speaker_for_tuple (i, 2);
+			} else {
+				gains[2]       = 0.0;
+				speaker_ids[2] = -1;
+			}
+		}
+	}
+
+	power = sqrt (gains[0] * gains[0] + gains[1] * gains[1] + gains[2] * gains[2]);
+
+	if (power > 0) {
+		gains[0] /= power;
+		gains[1] /= power;
+		gains[2] /= power;
+	}
+}
+
 void
 VBAPSpeakers::choose_speaker_triplets (struct ls_triplet_chain** ls_triplets)
 {
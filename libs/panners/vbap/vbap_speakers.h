@@ -19,10 +19,14 @@
 #ifndef __libardour_vbap_speakers_h__
 #define __libardour_vbap_speakers_h__
 
+#include <map>
 #include <string>
 #include <vector>
 
 #include <boost/utility.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <glibmm/threads.h>
 
 #include <pbd/signals.h>
 
@@ -36,11 +40,14 @@ class Speakers;
 class VBAPSpeakers : public boost::noncopyable
 {
 public:
-	VBAPSpeakers (boost::shared_ptr<Speakers>);
+	/** Triangulation of the given speakers, shared by all panners
+	 * using the same speaker configuration.
+	 */
+	static boost::shared_ptr<VBAPSpeakers> instance (boost::shared_ptr<Speakers>);
 
 	typedef std::vector<double> dvector;
 
-	const dvector matrix (int tuple) const
+	const dvector& matrix (int tuple) const
 	{
 		return _matrices[tuple];
 	}
@@ -70,10 +77,29 @@ public:
 		return _parent;
 	}
 
+	/** incremented whenever the speaker configuration changes */
+	uint32_t generation () const
+	{
+		return _generation;
+	}
+
+	/** calculate gain factors for a given direction.
+	 * @param gains gain factors of up to 3 speakers
+	 * @param speaker_ids speakers to use, -1 if unused
+	 */
+	void compute_gains (double gains[3], int speaker_ids[3], int azi, int ele) const;
+
 	~VBAPSpeakers ();
 
 private:
+	VBAPSpeakers (boost::shared_ptr<Speakers>);
+
+	typedef std::map<Speakers const*, boost::weak_ptr<VBAPSpeakers> > Instances;
+	static Instances            _instances;
+	static Glib::Threads::Mutex _instance_lock;
+
 	static const double         MIN_VOL_P_SIDE_LGTH;
+	uint32_t                    _generation;
 	int                         _dimension;
 	boost::shared_ptr<Speakers> _parent;
 	std::vector<Speaker>        _speakers;
@@ -120,6 +120,11 @@ OSC::OSC (Session& s, uint32_t port)
 	, bank_dirty (false)
 	, observer_busy (true)
 	, scrub_speed (0)
+	, _feedback_interval (100)
+	, _meter_decimation (1)
+	, _meter_count (0)
+	, _feedback_sent (0)
+	, _feedback_dropped (0)
 	, gui (0)
 {
 	_instance = this;
@@ -326,6 +331,10 @@ OSC::stop ()
 	}
 	_surface.clear();
 
+	/* send what the observers cleared, release destinations */
+	flush_feedback (true);
+	drop_feedback ();
+
 	/* stop main loop */
 	if (local_server) {
 		g_source_destroy (local_server);
@@ -1185,6 +1194,11 @@ OSC::get_surfaces ()
 		PBD::info << string_compose ("	Personal monitor flag %1,   Aux master: %2,   Number of sends: %3\n", sur->cue, sur->aux, sur->sends.size());
 		PBD::info << string_compose ("	Linkset: %1   Device Id: %2\n", sur->linkset, sur->linkid);
 	}
+	{
+		Glib::Threads::Mutex::Lock lo (_lo_lock);
+		PBD::info << string_compose ("\nFeedback: %1 messages sent, %2 dropped   Interval: %3 ms   Meter decimation: %4\n", \
+			_feedback_sent, _feedback_dropped, _feedback_interval, _meter_decimation);
+	}
 	PBD::info << string_compose ("\nList of LinkSets (%1):\n", link_sets.size());
 	std::map<uint32_t, LinkSet>::iterator it;
 	for (it = link_sets.begin(); it != link_sets.end(); it++) {
@@ -5877,6 +5891,7 @@ bool
 OSC::periodic (void)
 {
 	if (observer_busy) {
+		flush_feedback (false);
 		return true;
 	}
 	if (!tick) {
@@ -5894,9 +5909,14 @@ OSC::periodic (void)
 			bank_dirty = false;
 			tick = true;
 		}
+		flush_feedback (false);
 		return true;
 	}
 
+	if (++_meter_count >= _meter_decimation) {
+		_meter_count = 0;
+	}
+
 	if (scrub_speed != 0) {
 		// for those jog wheels that don't have 0 on release (touch), time out.
 		int64_t now = PBD::get_microseconds ();
@@ -5940,6 +5960,8 @@ OSC::periodic (void)
 			x++;
 		}
 	}
+
+	flush_feedback (false);
 	return true;
 }
 
@@ -5956,6 +5978,8 @@ OSC::get_state ()
 	node.set_property (X_("gainmode"), default_gainmode);
 	node.set_property (X_("send-page-size"), default_send_size);
 	node.set_property (X_("plug-page-size"), default_plugin_size);
+	node.set_property (X_("feedback-interval"), _feedback_interval);
+	node.set_property (X_("meter-decimation"), _meter_decimation);
 	return node;
 }
 
@@ -5978,6 +6002,10 @@ OSC::set_state (const XMLNode& node, int version)
 	node.get_property (X_("gainmode"), default_gainmode);
 	node.get_property (X_("send-page-size"), default_send_size);
 	node.get_property (X_("plugin-page-size"), default_plugin_size);
+	node.get_property (X_("feedback-interval"), _feedback_interval);
+	if (node.get_property (X_("meter-decimation"), _meter_decimation)) {
+		_meter_decimation = std::max<uint32_t> (1, _meter_decimation);
+	}
 
 	global_init = true;
 	tick = false;
@@ -6501,112 +6529,207 @@ OSC::cue_send_enable (uint32_t id, float state, lo_message msg)
 int
 OSC::float_message (string path, float val, lo_address addr)
 {
-	_lo_lock.lock ();
-
 	lo_message reply;
 	reply = lo_message_new ();
 	lo_message_add_float (reply, (float) val);
 
-	lo_send_message (addr, path.c_str(), reply);
-	Glib::usleep(1);
-	lo_message_free (reply);
-	_lo_lock.unlock ();
-
+	queue_message (path, path, reply, addr);
 	return 0;
 }
 
 int
 OSC::float_message_with_id (std::string path, uint32_t ssid, float value, bool in_line, lo_address addr)
 {
-	_lo_lock.lock ();
 	lo_message msg = lo_message_new ();
+	std::string key;
 	if (in_line) {
 		path = string_compose ("%1/%2", path, ssid);
+		key = path;
 	} else {
 		lo_message_add_int32 (msg, ssid);
+		key = string_compose ("%1 %2", path, ssid);
 	}
 	lo_message_add_float (msg, value);
 
-	lo_send_message (addr, path.c_str(), msg);
-	Glib::usleep(1);
-	lo_message_free (msg);
-	_lo_lock.unlock ();
+	queue_message (path, key, msg, addr);
 	return 0;
 }
 
 int
 OSC::int_message (string path, int val, lo_address addr)
 {
-	_lo_lock.lock ();
-
 	lo_message reply;
 	reply = lo_message_new ();
 	lo_message_add_int32 (reply, (float) val);
 
-	lo_send_message (addr, path.c_str(), reply);
-	Glib::usleep(1);
-	lo_message_free (reply);
-	_lo_lock.unlock ();
-
+	queue_message (path, path, reply, addr);
 	return 0;
 }
 
 int
 OSC::int_message_with_id (std::string path, uint32_t ssid, int value, bool in_line, lo_address addr)
 {
-	_lo_lock.lock ();
 	lo_message msg = lo_message_new ();
+	std::string key;
 	if (in_line) {
 		path = string_compose ("%1/%2", path, ssid);
+		key = path;
 	} else {
 		lo_message_add_int32 (msg, ssid);
+		key = string_compose ("%1 %2", path, ssid);
 	}
 	lo_message_add_int32 (msg, value);
 
-	lo_send_message (addr, path.c_str(), msg);
-	Glib::usleep(1);
-	lo_message_free (msg);
-	_lo_lock.unlock ();
+	queue_message (path, key, msg, addr);
 	return 0;
 }
 
 int
 OSC::text_message (string path, string val, lo_address addr)
 {
-	_lo_lock.lock ();
-
 	lo_message reply;
 	reply = lo_message_new ();
 	lo_message_add_string (reply, val.c_str());
 
-	lo_send_message (addr, path.c_str(), reply);
-	Glib::usleep(1);
-	lo_message_free (reply);
-	_lo_lock.unlock ();
-
+	queue_message (path, path, reply, addr);
 	return 0;
 }
 
 int
 OSC::text_message_with_id (std::string path, uint32_t ssid, std::string val, bool in_line, lo_address addr)
 {
-	_lo_lock.lock ();
 	lo_message msg = lo_message_new ();
+	std::string key;
 	if (in_line) {
 		path = string_compose ("%1/%2", path, ssid);
+		key = path;
 	} else {
 		lo_message_add_int32 (msg, ssid);
+		key = string_compose ("%1 %2", path, ssid);
 	}
 
 	lo_message_add_string (msg, val.c_str());
 
-	lo_send_message (addr, path.c_str(), msg);
-	Glib::usleep(1);
-	lo_message_free (msg);
-	_lo_lock.unlock ();
+	queue_message (path, key, msg, addr);
 	return 0;
 }
 
+/* Feedback is not sent right away, but queued per destination URL
+ * (several observers of a surface each have their own lo_address).
+ * periodic () sends the queue as bundles, a newer value for the same
+ * path and id replaces the queued one.
+ */
+void
+OSC::queue_message (std::string const& path, std::string const& key, lo_message msg, lo_address addr)
+{
+	char* url = lo_address_get_url (addr);
+	if (!url) {
+		lo_message_free (msg);
+		return;
+	}
+
+	Glib::Threads::Mutex::Lock lm (_lo_lock);
+
+	FeedbackQueue& q (_feedback_queues[url]);
+	if (!q.addr) {
+		q.addr = lo_address_new_from_url (url);
+	}
+	free (url);
+
+	std::map<std::string, size_t>::const_iterator i = q.index.find (key);
+	if (i != q.index.end ()) {
+		FeedbackMessage& m (q.messages[i->second]);
+		lo_message_free (m.msg);
+		m.msg = msg;
+		++_feedback_dropped;
+		return;
+	}
+
+	FeedbackMessage m;
+	m.path = path;
+	m.msg = msg;
+	q.index[key] = q.messages.size ();
+	q.messages.push_back (m);
+}
+
+void
+OSC::send_bundle (lo_address addr, std::vector<FeedbackMessage>::const_iterator b, std::vector<FeedbackMessage>::const_iterator e)
+{
+	lo_bundle bundle = lo_bundle_new (LO_TT_IMMEDIATE);
+	uint32_t n = 0;
+
+	for (; b != e; ++b, ++n) {
+		lo_bundle_add_message (bundle, b->path.c_str(), b->msg);
+	}
+
+	if (lo_send_bundle (addr, bundle) < 0) {
+		_feedback_dropped += n;
+	} else {
+		_feedback_sent += n;
+	}
+	Glib::usleep(1);
+
+	/* the bundle owns the messages now (this also works with liblo < 0.27,
+	 * which does not copy the paths, nor ref-count messages)
+	 */
+	lo_bundle_free_messages (bundle);
+}
+
+void
+OSC::flush_feedback (bool force)
+{
+	/* stay below a typical MTU, so that bundles are not fragmented */
+	const size_t max_bundle_size = 1400;
+	/* periodic () runs every 100ms */
+	const uint32_t interval = std::max<uint32_t> (1, (_feedback_interval + 50) / 100);
+
+	Glib::Threads::Mutex::Lock lm (_lo_lock);
+
+	for (FeedbackQueues::iterator i = _feedback_queues.begin (); i != _feedback_queues.end (); ++i) {
+		FeedbackQueue& q (i->second);
+		if (++q.ticks < interval && !force) {
+			continue;
+		}
+		if (q.messages.empty ()) {
+			continue;
+		}
+		q.ticks = 0;
+
+		std::vector<FeedbackMessage>::const_iterator b = q.messages.begin ();
+		size_t size = 16; // "#bundle" and time tag
+
+		for (std::vector<FeedbackMessage>::const_iterator m = q.messages.begin (); m != q.messages.end (); ++m) {
+			size_t len = 4 + lo_message_length (m->msg, m->path.c_str());
+			if (m != b && size + len > max_bundle_size) {
+				send_bundle (q.addr, b, m);
+				b = m;
+				size = 16;
+			}
+			size += len;
+		}
+		send_bundle (q.addr, b, q.messages.end ());
+
+		q.messages.clear ();
+		q.index.clear ();
+	}
+}
+
+void
+OSC::drop_feedback ()
+{
+	Glib::Threads::Mutex::Lock lm (_lo_lock);
+
+	for (FeedbackQueues::iterator i = _feedback_queues.begin (); i != _feedback_queues.end (); ++i) {
+		FeedbackQueue& q (i->second);
+		for (std::vector<FeedbackMessage>::const_iterator m = q.messages.begin (); m != q.messages.end (); ++m) {
+			lo_message_free (m->msg);
+		}
+		_feedback_dropped += q.messages.size ();
+		lo_address_free (q.addr);
+	}
+	_feedback_queues.clear ();
+}
+
 // we have to have a sorted list of stripables that have sends pointed at our aux
 // we can use the one in osc.cc to get an aux list
 OSC::Sorted
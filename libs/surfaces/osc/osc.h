@@ -28,6 +28,7 @@
 #include <string>
 #include <vector>
 #include <bitset>
+#include <map>
 
 #include <sys/time.h>
 #include <pthread.h>
@@ -101,6 +102,9 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	int int_message_with_id (std::string, uint32_t ssid, int value, bool in_line, lo_address addr);
 	int text_message_with_id (std::string path, uint32_t ssid, std::string val, bool in_line, lo_address addr);
 
+	/* meters are only sent every n-th periodic tick */
+	bool meter_due () const { return _meter_count == 0; }
+
 	int send_group_list (lo_address addr);
 
 	int start ();
@@ -261,6 +265,10 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	void get_surfaces ();
 	std::string get_remote_port () { return remote_port; }
 	void set_remote_port (std::string pt) { remote_port = pt; }
+	int get_feedback_interval () { return _feedback_interval; }
+	void set_feedback_interval (int ms) { _feedback_interval = ms; }
+	int get_meter_decimation () { return _meter_decimation; }
+	void set_meter_decimation (int n) { _meter_decimation = n > 0 ? n : 1; }
 
   protected:
         void thread_init ();
@@ -295,6 +303,11 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	double scrub_place;		// place of play head at latest jog/scrub wheel tick
 	int64_t scrub_time;		// when did the wheel move last?
 	bool global_init;
+	uint32_t _feedback_interval;	// min time between feedback bundles to a surface [ms]
+	uint32_t _meter_decimation;	// send meters every n-th tick
+	uint32_t _meter_count;
+	uint64_t _feedback_sent;	// feedback messages sent
+	uint64_t _feedback_dropped;	// feedback messages replaced by a newer value, or failed to send
 	boost::shared_ptr<ARDOUR::Stripable> _select;	// which stripable out of /surface/stripables is gui selected
 
 	void register_callbacks ();
@@ -732,6 +745,31 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	int osc_toggle_roll (bool ret2strt);
 	bool periodic (void);
 	sigc::connection periodic_connection;
+
+	/* Feedback is queued per destination, and sent as OSC bundles
+	 * from periodic (). A newer value for the same path (and id)
+	 * replaces the queued one.
+	 */
+	struct FeedbackMessage {
+		std::string path;
+		lo_message msg;
+	};
+
+	struct FeedbackQueue {
+		FeedbackQueue () : addr (0), ticks (0) {}
+		lo_address addr;
+		uint32_t ticks;	// periodic () calls since the last flush
+		std::vector<FeedbackMessage> messages;
+		std::map<std::string, size_t> index;	// path/id -> messages
+	};
+
+	typedef std::map<std::string, FeedbackQueue> FeedbackQueues;
+	FeedbackQueues _feedback_queues;
+
+	void queue_message (std::string const& path, std::string const& key, lo_message msg, lo_address addr);
+	void send_bundle (lo_address addr, std::vector<FeedbackMessage>::const_iterator, std::vector<FeedbackMessage>::const_iterator);
+	void flush_feedback (bool force);
+	void drop_feedback ();
 	PBD::ScopedConnectionList session_connections;
 
 	void debugmsg (const char *prefix, const char *path, const char* types, lo_arg **argv, int argc);
@@ -301,7 +301,7 @@ OSCGlobalObserver::tick ()
 			_osc.float_message (X_("/heartbeat"), 0.0, addr);
 		}
 	}
-	if (feedback[7] || feedback[8] || feedback[9]) { // meters enabled
+	if ((feedback[7] || feedback[8] || feedback[9]) && _osc.meter_due ()) { // meters enabled
 		// the only meter here is master
 		float now_meter = session->master_out()->peak_meter()->meter_level(0, MeterMCP);
 		if (now_meter < -94) now_meter = -193;
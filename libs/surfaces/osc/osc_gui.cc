@@ -130,6 +130,28 @@ OSC_GUI::OSC_GUI (OSC& p)
 
 	++n;
 
+	// feedback rate limit
+	label = manage (new Gtk::Label(_("Feedback Interval (ms):")));
+	label->set_alignment(1, .5);
+	table->attach (*label, 0, 1, n, n+1, AttachOptions(FILL|EXPAND), AttachOptions(0));
+	table->attach (fb_interval_entry, 1, 2, n, n+1, AttachOptions(FILL|EXPAND), AttachOptions(0), 0, 0);
+	fb_interval_entry.set_range (100, 5000);
+	fb_interval_entry.set_increments (100, 500);
+	fb_interval_entry.set_value (cp.get_feedback_interval());
+
+	++n;
+
+	// meter decimation
+	label = manage (new Gtk::Label(_("Meter Decimation:")));
+	label->set_alignment(1, .5);
+	table->attach (*label, 0, 1, n, n+1, AttachOptions(FILL|EXPAND), AttachOptions(0));
+	table->attach (meter_decimation_entry, 1, 2, n, n+1, AttachOptions(FILL|EXPAND), AttachOptions(0), 0, 0);
+	meter_decimation_entry.set_range (1, 50);
+	meter_decimation_entry.set_increments (1, 5);
+	meter_decimation_entry.set_value (cp.get_meter_decimation());
+
+	++n;
+
 	// Gain Mode
 	label = manage (new Gtk::Label(_("Gain Mode:")));
 	label->set_alignment(1, .5);
@@ -193,6 +215,8 @@ OSC_GUI::OSC_GUI (OSC& p)
 	bank_entry.signal_changed().connect (sigc::mem_fun (*this, &OSC_GUI::bank_changed));
 	send_page_entry.signal_changed().connect (sigc::mem_fun (*this, &OSC_GUI::send_page_changed));
 	plugin_page_entry.signal_changed().connect (sigc::mem_fun (*this, &OSC_GUI::plugin_page_changed));
+	fb_interval_entry.signal_changed().connect (sigc::mem_fun (*this, &OSC_GUI::fb_interval_changed));
+	meter_decimation_entry.signal_changed().connect (sigc::mem_fun (*this, &OSC_GUI::meter_decimation_changed));
 
 	// Strip Types Calculate Page
 	int stn = 0; // table row
@@ -577,6 +601,26 @@ OSC_GUI::plugin_page_changed ()
 
 }
 
+void
+OSC_GUI::fb_interval_changed ()
+{
+	uint32_t interval = atoi (fb_interval_entry.get_text ());
+	fb_interval_entry.set_text (string_compose ("%1", interval));
+	cp.set_feedback_interval (interval);
+	save_user ();
+
+}
+
+void
+OSC_GUI::meter_decimation_changed ()
+{
+	uint32_t decimation = atoi (meter_decimation_entry.get_text ());
+	meter_decimation_entry.set_text (string_compose ("%1", decimation));
+	cp.set_meter_decimation (decimation);
+	save_user ();
+
+}
+
 void
 OSC_GUI::gainmode_changed ()
 {
@@ -636,6 +680,10 @@ OSC_GUI::factory_reset ()
 	send_page_entry.set_text ("0");
 	cp.set_plugin_size (0);
 	plugin_page_entry.set_text ("0");
+	cp.set_feedback_interval (100);
+	fb_interval_entry.set_text ("100");
+	cp.set_meter_decimation (1);
+	meter_decimation_entry.set_text ("1");
 	cp.set_defaultstrip (31);
 	cp.set_defaultfeedback (0);
 	reshow_values ();
@@ -895,6 +943,14 @@ OSC_GUI::save_user ()
 	child->set_property ("value", cp.get_gainmode());
 	node->add_child_nocopy (*child);
 
+	child = new XMLNode ("Feedback-Interval");
+	child->set_property ("value", cp.get_feedback_interval());
+	node->add_child_nocopy (*child);
+
+	child = new XMLNode ("Meter-Decimation");
+	child->set_property ("value", cp.get_meter_decimation());
+	node->add_child_nocopy (*child);
+
 	XMLTree tree;
 	tree.set_root (node);
 
@@ -991,6 +1047,20 @@ OSC_GUI::load_preset (std::string preset)
 			cp.set_gainmode (atoi (prop->value().c_str()));
 			gainmode_combo.set_active (atoi (prop->value().c_str()));
 		}
+		if ((child = root->child ("Feedback-Interval")) == 0 || (prop = child->property ("value")) == 0) {
+			cp.set_feedback_interval (sesn_fb_interval);
+			fb_interval_entry.set_text (string_compose("%1", sesn_fb_interval));
+		} else {
+			cp.set_feedback_interval (atoi (prop->value().c_str()));
+			fb_interval_entry.set_text (prop->value().c_str());
+		}
+		if ((child = root->child ("Meter-Decimation")) == 0 || (prop = child->property ("value")) == 0) {
+			cp.set_meter_decimation (sesn_meter_decimation);
+			meter_decimation_entry.set_text (string_compose("%1", sesn_meter_decimation));
+		} else {
+			cp.set_meter_decimation (atoi (prop->value().c_str()));
+			meter_decimation_entry.set_text (prop->value().c_str());
+		}
 		cp.gui_changed();
 		clear_device ();
 
@@ -1008,6 +1078,8 @@ OSC_GUI::get_session ()
 	sesn_strips = cp.get_defaultstrip ();
 	sesn_feedback = cp.get_defaultfeedback ();
 	sesn_gainmode = cp.get_gainmode ();
+	sesn_fb_interval = cp.get_feedback_interval ();
+	sesn_meter_decimation = cp.get_meter_decimation ();
 }
 
 void
@@ -1028,4 +1100,8 @@ OSC_GUI::restore_sesn_values ()
 	reshow_values ();
 	cp.set_gainmode (sesn_gainmode);
 	gainmode_combo.set_active (sesn_gainmode);
+	cp.set_feedback_interval (sesn_fb_interval);
+	fb_interval_entry.set_text (string_compose ("%1", sesn_fb_interval));
+	cp.set_meter_decimation (sesn_meter_decimation);
+	meter_decimation_entry.set_text (string_compose ("%1", sesn_meter_decimation));
 }
@@ -45,6 +45,8 @@ private:
 	Gtk::SpinButton bank_entry;
 	Gtk::SpinButton send_page_entry;
 	Gtk::SpinButton plugin_page_entry;
+	Gtk::SpinButton fb_interval_entry;
+	Gtk::SpinButton meter_decimation_entry;
 	Gtk::ComboBoxText gainmode_combo;
 	Gtk::ComboBoxText preset_combo;
 	std::vector<std::string> preset_options;
@@ -60,6 +62,8 @@ private:
 	uint32_t sesn_strips;
 	uint32_t sesn_feedback;
 	uint32_t sesn_gainmode;
+	uint32_t sesn_fb_interval;
+	uint32_t sesn_meter_decimation;
 	void save_user ();
 	void scan_preset_files ();
 	void load_preset (std::string preset);
@@ -75,6 +79,8 @@ private:
 	void bank_changed ();
 	void send_page_changed ();
 	void plugin_page_changed ();
+	void fb_interval_changed ();
+	void meter_decimation_changed ();
 	void strips_changed ();
 	void feedback_changed ();
 	void preset_changed ();
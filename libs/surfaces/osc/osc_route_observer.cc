@@ -382,7 +382,7 @@ OSCRouteObserver::tick ()
 		return;
 	}
 	_tick_busy = true;
-	if (feedback[7] || feedback[8] || feedback[9]) { // meters enabled
+	if ((feedback[7] || feedback[8] || feedback[9]) && _osc.meter_due ()) { // meters enabled
 		// the only meter here is master
 		/* XXXX need to add send meter for send mode or
 		 * disable for send mode
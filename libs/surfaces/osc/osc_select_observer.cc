@@ -576,7 +576,7 @@ OSCSelectObserver::tick ()
 		return;
 	}
 	_tick_busy = true;
-	if (feedback[7] || feedback[8] || feedback[9]) { // meters enabled
+	if ((feedback[7] || feedback[8] || feedback[9]) && _osc.meter_due ()) { // meters enabled
 		float now_meter;
 		if (_strip->peak_meter()) {
 			now_meter = _strip->peak_meter()->meter_level(0, MeterMCP);
@@ -16,12 +16,23 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cstring>
 #include <sstream>
 
 #include "client.h"
 
 using namespace ArdourSurface;
 
+ClientOutputMessage::ClientOutputMessage (const std::string& payload, size_t pre, bool binary)
+    : _buf (new std::vector<unsigned char> (pre + payload.size ()))
+    , _pre (pre)
+    , _binary (binary)
+{
+	if (!payload.empty ()) {
+		memcpy (&(*_buf)[pre], payload.data (), payload.size ());
+	}
+}
+
 bool
 ClientContext::has_state (const NodeState& node_state)
 {
@@ -58,6 +69,23 @@ ClientContext::update_state (const NodeState& node_state)
 	_state.insert (node_state);
 }
 
+bool
+ClientContext::subscribed (uint32_t strip_id) const
+{
+	return _strips.empty () || _strips.find (strip_id) != _strips.end ();
+}
+
+bool
+ClientContext::subscribed (const NodeState& node_state) const
+{
+	/* subscriptions only apply to strip nodes, addressed by strip id */
+	if (_strips.empty () || node_state.n_addr () < 1 || node_state.node ().compare (0, 6, "strip_") != 0) {
+		return true;
+	}
+
+	return subscribed (node_state.nth_addr (0));
+}
+
 std::string
 ClientContext::debug_str ()
 {
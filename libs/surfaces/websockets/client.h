@@ -21,6 +21,9 @@
 
 #include <set>
 #include <list>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
 
 #include "message.h"
 #include "state.h"
@@ -29,13 +32,43 @@ typedef struct lws* Client;
 
 namespace ArdourSurface {
 
-typedef std::list<NodeStateMessage> ClientOutputBuffer;
+/* A serialized message. The buffer is shared by all clients that the
+ * message is queued for, and reserves room in front of the payload for
+ * the protocol header, see LWS_PRE. */
+class ClientOutputMessage
+{
+public:
+	ClientOutputMessage (const std::string& payload, size_t pre, bool binary);
+
+	unsigned char* payload () const
+	{
+		return &(*_buf)[0] + _pre;
+	}
+
+	size_t size () const
+	{
+		return _buf->size () - _pre;
+	}
+
+	bool binary () const
+	{
+		return _binary;
+	}
+
+private:
+	boost::shared_ptr<std::vector<unsigned char> > _buf;
+	size_t                                         _pre;
+	bool                                           _binary;
+};
+
+typedef std::list<ClientOutputMessage> ClientOutputBuffer;
 
 class ClientContext
 {
 public:
 	ClientContext (Client wsi)
-	    : _wsi (wsi){};
+	    : _wsi (wsi)
+	    , _binary_meters (false){};
 	virtual ~ClientContext (){};
 
 	Client wsi () const
@@ -46,6 +79,29 @@ public:
 	bool has_state (const NodeState&);
 	void update_state (const NodeState&);
 
+	/* strips the client receives feedback for, empty for all strips */
+	typedef std::set<uint32_t> StripSet;
+
+	bool subscribed (uint32_t strip_id) const;
+	bool subscribed (const NodeState&) const;
+	bool subscribed_all () const
+	{
+		return _strips.empty ();
+	}
+	void subscribe (const StripSet& strips)
+	{
+		_strips = strips;
+	}
+
+	bool binary_meters () const
+	{
+		return _binary_meters;
+	}
+	void set_binary_meters (bool yn)
+	{
+		_binary_meters = yn;
+	}
+
 	ClientOutputBuffer& output_buf ()
 	{
 		return _output_buf;
@@ -60,6 +116,9 @@ private:
 	ClientState                 _state;
 
 	ClientOutputBuffer _output_buf;
+
+	StripSet _strips;
+	bool     _binary_meters;
 };
 
 } // namespace ArdourSurface
@@ -38,7 +38,9 @@ WebsocketsDispatcher::NodeMethodMap
 		NODE_METHOD_PAIR (strip_pan)
 		NODE_METHOD_PAIR (strip_mute)
 		NODE_METHOD_PAIR (strip_plugin_enable)
-		NODE_METHOD_PAIR (strip_plugin_param_value);
+		NODE_METHOD_PAIR (strip_plugin_param_value)
+		NODE_METHOD_PAIR (strip_subscribe)
+		NODE_METHOD_PAIR (strip_meter_binary);
 
 void
 WebsocketsDispatcher::dispatch (Client client, const NodeStateMessage& msg)
@@ -266,6 +268,71 @@ WebsocketsDispatcher::strip_plugin_param_value_handler (Client client, const Nod
 	}
 }
 
+void
+WebsocketsDispatcher::strip_subscribe_handler (Client client, const NodeStateMessage& msg)
+{
+	const NodeState& state = msg.state ();
+
+	/* values are the ids of the strips to receive feedback for,
+	 * an empty list subscribes to all strips */
+	ClientContext::StripSet strips;
+
+	for (int i = 0; i < state.n_val (); ++i) {
+		int strip_id = state.nth_val (i);
+		if (strip_id >= 0) {
+			strips.insert (strip_id);
+		}
+	}
+
+	server ().subscribe_client (client, strips);
+
+	/* feedback was not sent while not subscribed, refresh all strips */
+	for (ArdourMixer::StripMap::iterator it = mixer ().strips ().begin (); it != mixer ().strips ().end (); ++it) {
+		if (strips.empty () || strips.find (it->first) != strips.end ()) {
+			update_strip (client, it->first);
+		}
+	}
+}
+
+void
+WebsocketsDispatcher::strip_meter_binary_handler (Client client, const NodeStateMessage& msg)
+{
+	const NodeState& state = msg.state ();
+
+	if (msg.is_write () && (state.n_val () > 0)) {
+		server ().set_client_binary_meters (client, state.nth_val (0));
+	}
+}
+
+void
+WebsocketsDispatcher::update_strip (Client client, uint32_t strip_id)
+{
+	ArdourMixerStrip& strip = mixer ().strip (strip_id);
+
+	update (client, Node::strip_gain, strip_id, strip.gain ());
+	update (client, Node::strip_mute, strip_id, strip.mute ());
+
+	if (strip.has_pan ()) {
+		update (client, Node::strip_pan, strip_id, strip.pan ());
+	}
+
+	for (ArdourMixerStrip::PluginMap::iterator it = strip.plugins ().begin (); it != strip.plugins ().end (); ++it) {
+		uint32_t           plugin_id = it->first;
+		ArdourMixerPlugin& plugin    = *it->second;
+
+		update (client, Node::strip_plugin_enable, strip_id, plugin_id, plugin.enabled ());
+
+		for (uint32_t param_id = 0; param_id < plugin.param_count (); ++param_id) {
+			try {
+				update (client, Node::strip_plugin_param_value, strip_id, plugin_id, param_id,
+				        plugin.param_value (param_id));
+			} catch (ArdourMixerNotFoundException& err) {
+				continue;
+			}
+		}
+	}
+}
+
 void
 WebsocketsDispatcher::update (Client client, std::string node, TypedValue val1)
 {
@@ -51,6 +51,10 @@ private:
 	void strip_mute_handler (Client, const NodeStateMessage&);
 	void strip_plugin_enable_handler (Client, const NodeStateMessage&);
 	void strip_plugin_param_value_handler (Client, const NodeStateMessage&);
+	void strip_subscribe_handler (Client, const NodeStateMessage&);
+	void strip_meter_binary_handler (Client, const NodeStateMessage&);
+
+	void update_strip (Client, uint32_t);
 
 	void update (Client, std::string, TypedValue);
 	void update (Client, std::string, uint32_t, TypedValue);
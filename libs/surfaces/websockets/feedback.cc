@@ -29,6 +29,7 @@
 
 // TO DO: make this configurable
 #define POLL_INTERVAL_MS 100
+#define FLUSH_INTERVAL_MS 40
 
 using namespace ARDOUR;
 using namespace ArdourSurface;
@@ -128,13 +129,20 @@ ArdourFeedback::start ()
 	_periodic_connection                               = periodic_timeout->connect (sigc::mem_fun (*this,
                                                                          &ArdourFeedback::poll));
 
+	// changes are collected and sent to clients at most once per interval
+	Glib::RefPtr<Glib::TimeoutSource> flush_timeout = Glib::TimeoutSource::create (FLUSH_INTERVAL_MS);
+	_flush_connection                               = flush_timeout->connect (sigc::mem_fun (*this,
+                                                                      &ArdourFeedback::flush));
+
 	// server must be started before feedback otherwise
 	// read_blocks_event_loop() will always return false
 	if (server ().read_blocks_event_loop ()) {
 		_helper.run();
 		periodic_timeout->attach (_helper.main_loop()->get_context ());
+		flush_timeout->attach (_helper.main_loop()->get_context ());
 	} else {
 		periodic_timeout->attach (main_loop ()->get_context ());
+		flush_timeout->attach (main_loop ()->get_context ());
 	}
 
 	return 0;
@@ -148,7 +156,13 @@ ArdourFeedback::stop ()
 	}
 
 	_periodic_connection.disconnect ();
+	_flush_connection.disconnect ();
 	_transport_connections.drop_connections ();
+
+	_pending.clear ();
+	_pending_index.clear ();
+	_meters.clear ();
+	_meters_dirty = false;
 	
 	return 0;
 }
@@ -193,7 +207,35 @@ ArdourFeedback::update_all (std::string node, uint32_t strip_id, uint32_t plugin
 	ValueVector val = ValueVector ();
 	val.push_back (value);
 
-	server ().update_all_clients (NodeState (node, addr, val), false);
+	NodeState state (node, addr, val);
+
+	/* coalesce, only the last value set before the next flush is sent */
+	std::pair<PendingIndex::iterator, bool> rv = _pending_index.insert (std::make_pair (state.node_addr_hash (), _pending.size ()));
+
+	if (rv.second) {
+		_pending.push_back (state);
+	} else {
+		_pending[rv.first->second] = state;
+	}
+}
+
+bool
+ArdourFeedback::flush () const
+{
+	/* every update is serialized once and shared by all clients */
+	for (std::vector<NodeState>::const_iterator it = _pending.begin (); it != _pending.end (); ++it) {
+		server ().update_all_clients (*it, false);
+	}
+
+	_pending.clear ();
+	_pending_index.clear ();
+
+	if (_meters_dirty) {
+		server ().update_all_meters (_meters);
+		_meters_dirty = false;
+	}
+
+	return true;
 }
 
 PBD::EventLoop*
@@ -213,11 +255,16 @@ ArdourFeedback::poll () const
 
 	Glib::Threads::Mutex::Lock lock (mixer ().mutex ());
 
+	/* meters are sent as one batch by the next flush. Clients that use
+	 * JSON only receive values that changed, see update_all_meters () */
+	_meters.clear ();
+
 	for (ArdourMixer::StripMap::iterator it = mixer ().strips ().begin (); it != mixer ().strips ().end (); ++it) {
-		double db = it->second->meter_level_db ();
-		update_all (Node::strip_meter, it->first, db);
+		_meters.push_back (std::make_pair (it->first, static_cast<float> (it->second->meter_level_db ())));
 	}
 
+	_meters_dirty = true;
+
 	return true;
 }
 
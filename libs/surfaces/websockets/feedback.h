@@ -28,6 +28,7 @@
 #include "component.h"
 #include "typed_value.h"
 #include "mixer.h"
+#include "state.h"
 
 namespace ArdourSurface {
 
@@ -46,7 +47,8 @@ class ArdourFeedback : public SurfaceComponent
 {
 public:
 	ArdourFeedback (ArdourSurface::ArdourWebsockets& surface)
-	    : SurfaceComponent (surface){};
+	    : SurfaceComponent (surface)
+	    , _meters_dirty (false){};
 	virtual ~ArdourFeedback (){};
 
 	int start ();
@@ -61,6 +63,17 @@ private:
 	Glib::Threads::Mutex      _client_state_lock;
 	PBD::ScopedConnectionList _transport_connections;
 	sigc::connection          _periodic_connection;
+	sigc::connection          _flush_connection;
+
+	/* changes since the last flush, only the most recent state
+	 * of each node and address is kept */
+	typedef boost::unordered_map<std::size_t, std::size_t> PendingIndex;
+
+	mutable std::vector<NodeState> _pending;
+	mutable PendingIndex           _pending_index;
+
+	mutable StripMeterVector _meters;
+	mutable bool             _meters_dirty;
 
 	// Only needed for server event loop integration method #3
 	mutable FeedbackHelperUI  _helper;
@@ -68,6 +81,7 @@ private:
 	PBD::EventLoop* event_loop () const;
 
 	bool poll () const;
+	bool flush () const;
 
 	void observe_transport ();
 	void observe_mixer ();
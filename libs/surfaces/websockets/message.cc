@@ -109,12 +109,27 @@ NodeStateMessage::NodeStateMessage (void* buf, size_t len)
 size_t
 NodeStateMessage::serialize (void* buf, size_t len) const
 {
-	// boost json writes all values as strings, we do not want that
-
 	if (len == 0) {
 		return -1;
 	}
 
+	std::string s     = serialize ();
+	size_t      cs_sz = s.size ();
+
+	if (len < cs_sz) {
+		return -1;
+	}
+
+	memcpy (buf, s.c_str (), cs_sz);
+
+	return cs_sz;
+}
+
+std::string
+NodeStateMessage::serialize () const
+{
+	// boost json writes all values as strings, we do not want that
+
 	std::stringstream ss;
 
 	ss << "{\"node\":\"" << _state.node () << "\"";
@@ -181,15 +196,5 @@ NodeStateMessage::serialize (void* buf, size_t len) const
 
 	ss << '}';
 
-	std::string s     = ss.str ();
-	const char* cs    = s.c_str ();
-	size_t      cs_sz = strlen (cs);
-
-	if (len < cs_sz) {
-		return -1;
-	}
-
-	memcpy (buf, cs, cs_sz);
-
-	return cs_sz;
+	return ss.str ();
 }
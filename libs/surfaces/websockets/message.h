@@ -29,7 +29,8 @@ public:
 	NodeStateMessage (const NodeState& state);
 	NodeStateMessage (void*, size_t);
 
-	size_t serialize (void*, size_t) const;
+	size_t      serialize (void*, size_t) const;
+	std::string serialize () const;
 
 	bool is_valid () const
 	{
@@ -216,16 +216,171 @@ WebsocketsServer::update_client (Client wsi, const NodeState& state, bool force)
 	if (force || !it->second.has_state (state)) {
 		/* write to client only if state was updated */
 		it->second.update_state (state);
-		it->second.output_buf ().push_back (NodeStateMessage (state));
-		request_write (wsi);
+		queue_message (it->second, output_message (NodeStateMessage (state).serialize ()));
 	}
 }
 
 void
 WebsocketsServer::update_all_clients (const NodeState& state, bool force)
 {
+	/* serialize once, and share the buffer among all clients */
+	boost::shared_ptr<ClientOutputMessage> msg;
+
 	for (ClientContextMap::iterator it = _client_ctx.begin (); it != _client_ctx.end (); ++it) {
-		update_client (it->second.wsi (), state, force);
+		ClientContext& ctx = it->second;
+
+		if (!ctx.subscribed (state) || (!force && ctx.has_state (state))) {
+			continue;
+		}
+
+		ctx.update_state (state);
+
+		if (!msg) {
+			msg.reset (new ClientOutputMessage (output_message (NodeStateMessage (state).serialize ())));
+		}
+
+		queue_message (ctx, *msg);
+	}
+}
+
+/* Binary meter frame, all values are little-endian:
+ *
+ *   uint8   'M'
+ *   uint8   format version (1)
+ *   uint16  number of strips (N)
+ *   N times:
+ *     uint32  strip id
+ *     float32 meter level [dBFS]
+ */
+static void
+append_u32 (std::string& s, uint32_t v)
+{
+	s += static_cast<char> (v & 0xff);
+	s += static_cast<char> ((v >> 8) & 0xff);
+	s += static_cast<char> ((v >> 16) & 0xff);
+	s += static_cast<char> ((v >> 24) & 0xff);
+}
+
+static std::string
+meter_frame (const StripMeterVector& meters, const ClientContext& ctx)
+{
+	std::string frame;
+	frame.reserve (4 + 8 * meters.size ());
+	frame.resize (4);
+
+	uint32_t n = 0;
+	for (StripMeterVector::const_iterator it = meters.begin (); it != meters.end () && n < 0xffff; ++it) {
+		if (!ctx.subscribed (it->first)) {
+			continue;
+		}
+		uint32_t db;
+		memcpy (&db, &it->second, sizeof (db));
+		append_u32 (frame, it->first);
+		append_u32 (frame, db);
+		++n;
+	}
+
+	frame[0] = 'M';
+	frame[1] = 1;
+	frame[2] = static_cast<char> (n & 0xff);
+	frame[3] = static_cast<char> ((n >> 8) & 0xff);
+
+	return frame;
+}
+
+void
+WebsocketsServer::update_all_meters (const StripMeterVector& meters)
+{
+	/* clients with the same subscription share the serialized messages */
+	boost::shared_ptr<ClientOutputMessage>              frame;
+	std::vector<NodeState>                              states;
+	std::vector<boost::shared_ptr<ClientOutputMessage> > json;
+
+	for (ClientContextMap::iterator it = _client_ctx.begin (); it != _client_ctx.end (); ++it) {
+		ClientContext& ctx = it->second;
+
+		if (ctx.binary_meters ()) {
+			/* only the most recent meter frame is relevant */
+			ClientOutputBuffer& pending = ctx.output_buf ();
+			for (ClientOutputBuffer::iterator i = pending.begin (); i != pending.end ();) {
+				if (i->binary ()) {
+					i = pending.erase (i);
+				} else {
+					++i;
+				}
+			}
+
+			if (!ctx.subscribed_all ()) {
+				queue_message (ctx, output_message (meter_frame (meters, ctx), true));
+				continue;
+			}
+			if (!frame) {
+				frame.reset (new ClientOutputMessage (output_message (meter_frame (meters, ctx), true)));
+			}
+			queue_message (ctx, *frame);
+			continue;
+		}
+
+		if (states.empty ()) {
+			for (StripMeterVector::const_iterator i = meters.begin (); i != meters.end (); ++i) {
+				states.push_back (NodeState (Node::strip_meter, AddressVector (1, i->first),
+				                             ValueVector (1, TypedValue (static_cast<double> (i->second)))));
+			}
+			json.resize (meters.size ());
+		}
+
+		for (size_t i = 0; i < states.size (); ++i) {
+			if (!ctx.subscribed (meters[i].first) || ctx.has_state (states[i])) {
+				continue;
+			}
+
+			ctx.update_state (states[i]);
+
+			if (!json[i]) {
+				json[i].reset (new ClientOutputMessage (output_message (NodeStateMessage (states[i]).serialize ())));
+			}
+
+			queue_message (ctx, *json[i]);
+		}
+	}
+}
+
+void
+WebsocketsServer::subscribe_client (Client wsi, const ClientContext::StripSet& strips)
+{
+	ClientContextMap::iterator it = _client_ctx.find (wsi);
+	if (it != _client_ctx.end ()) {
+		it->second.subscribe (strips);
+	}
+}
+
+void
+WebsocketsServer::set_client_binary_meters (Client wsi, bool yn)
+{
+	ClientContextMap::iterator it = _client_ctx.find (wsi);
+	if (it != _client_ctx.end ()) {
+		it->second.set_binary_meters (yn);
+	}
+}
+
+ClientOutputMessage
+WebsocketsServer::output_message (const std::string& payload, bool binary) const
+{
+	return ClientOutputMessage (payload, LWS_PRE, binary);
+}
+
+void
+WebsocketsServer::queue_message (ClientContext& ctx, const ClientOutputMessage& msg)
+{
+	ClientOutputBuffer& pending = ctx.output_buf ();
+
+	/* a write was already requested, if there are pending messages */
+	bool idle = pending.empty ();
+
+	pending.push_back (msg);
+
+	if (idle) {
+		request_write (ctx.wsi ());
 	}
 }
 
@@ -289,21 +444,24 @@ WebsocketsServer::write_client (Client wsi)
 
 	/* one lws_write() call per LWS_CALLBACK_SERVER_WRITEABLE callback */
 
-	NodeStateMessage msg = pending.front ();
+	ClientOutputMessage msg = pending.front ();
 	pending.pop_front ();
 
-	unsigned char out_buf[1024];
-	int len = msg.serialize (out_buf + LWS_PRE, 1024 - LWS_PRE);
+	/* lws_write() writes the protocol header into the LWS_PRE bytes in
+	 * front of the payload, but leaves the payload itself untouched, so
+	 * the buffer can be shared by all clients */
+	int len = msg.size ();
 
-	if (len > 0) {
 #ifdef PRINT_TRAFFIC
-		std::cerr << "TX " << msg.state ().debug_str () << std::endl;
-#endif
-		if (lws_write (wsi, out_buf + LWS_PRE, len, LWS_WRITE_TEXT) != len) {
-			return 1;
-		}
+	if (msg.binary ()) {
+		std::cerr << "TX binary, " << len << " bytes" << std::endl;
 	} else {
-		PBD::error << "ArdourWebsockets: cannot serialize message" << endmsg;
+		std::cerr << "TX " << std::string (reinterpret_cast<char*> (msg.payload ()), len) << std::endl;
+	}
+#endif
+
+	if (lws_write (wsi, msg.payload (), len, msg.binary () ? LWS_WRITE_BINARY : LWS_WRITE_TEXT) != len) {
+		return 1;
 	}
 
 	if (!pending.empty ()) {
@@ -52,6 +52,10 @@ public:
 
 	void update_client (Client, const NodeState&, bool);
 	void update_all_clients (const NodeState&, bool);
+	void update_all_meters (const StripMeterVector&);
+
+	void subscribe_client (Client, const ClientContext::StripSet&);
+	void set_client_binary_meters (Client, bool);
 
 private:
 #if LWS_LIBRARY_VERSION_MAJOR < 3
@@ -68,6 +72,9 @@ private:
 
 	ServerResources _resources;
 
+	ClientOutputMessage output_message (const std::string&, bool binary = false) const;
+	void                queue_message (ClientContext&, const ClientOutputMessage&);
+
 	int add_client (Client);
 	int del_client (Client);
 	int recv_client (Client, void*, size_t);
@@ -23,6 +23,7 @@
 #include <cmath>
 #include <cstring>
 #include <stdint.h>
+#include <utility>
 #include <vector>
 
 #include "typed_value.h"
@@ -42,6 +43,8 @@ namespace Node
 	const std::string strip_plugin_enable            = "strip_plugin_enable";
 	const std::string strip_plugin_param_description = "strip_plugin_param_description";
 	const std::string strip_plugin_param_value       = "strip_plugin_param_value";
+	const std::string strip_subscribe                = "strip_subscribe";
+	const std::string strip_meter_binary             = "strip_meter_binary";
 	const std::string transport_tempo                = "transport_tempo";
 	const std::string transport_time                 = "transport_time";
 	const std::string transport_roll                 = "transport_roll";
@@ -51,6 +54,8 @@ namespace Node
 typedef std::vector<uint32_t>   AddressVector;
 typedef std::vector<TypedValue> ValueVector;
 
+typedef std::vector<std::pair<uint32_t, float> > StripMeterVector;
+
 class NodeState
 {
 public:
@@ -65,6 +65,7 @@ Convproc::Convproc (void)
 	, _maxpart (0)
 	, _nlevels (0)
 	, _latecnt (0)
+	, _sched (0)
 {
 	memset (_inpbuff, 0, MAXINP * sizeof (float*));
 	memset (_outbuff, 0, MAXOUT * sizeof (float*));
@@ -83,6 +84,12 @@ Convproc::set_options (uint32_t options)
 	_options = options;
 }
 
+void
+Convproc::set_scheduler (Convsched* sched)
+{
+	_sched = sched;
+}
+
 int
 Convproc::configure (uint32_t ninp,
                      uint32_t nout,
@@ -263,7 +270,7 @@ Convproc::start_process (int abspri, int policy)
 	reset ();
 
 	for (k = (_minpart == _quantum) ? 1 : 0; k < _nlevels; k++) {
-		_convlev[k]->start (abspri, policy);
+		_convlev[k]->start (abspri, policy, _sched);
 	}
 
 	while (!check_started ((_minpart == _quantum) ? 1 : 0)) {
@@ -435,6 +442,7 @@ Convlevel::Convlevel (void)
 #ifndef PTW32_VERSION
 	, _pthr (0)
 #endif
+	, _sched (0)
 	, _inp_list (0)
 	, _out_list (0)
 	, _plan_r2c (0)
@@ -601,12 +609,18 @@ Convlevel::reset (uint32_t inpsize,
 }
 
 void
-Convlevel::start (int abspri, int policy)
+Convlevel::start (int abspri, int policy, Convsched* sched)
 {
 	int                min, max;
 	pthread_attr_t     attr;
 	struct sched_param parm;
 
+	if (sched && sched->add_level (_parsize)) {
+		_sched = sched;
+		_stat  = ST_PROC;
+		return;
+	}
+
 #ifndef PTW32_VERSION
 	_pthr = 0;
 #endif
@@ -634,6 +648,17 @@ Convlevel::start (int abspri, int policy)
 void
 Convlevel::stop (void)
 {
+	if (_sched) {
+		/* wait for scheduled cycles to complete */
+		while (_wait) {
+			_done.wait ();
+			_wait--;
+		}
+		_sched->remove_level (_parsize);
+		_sched = 0;
+		_stat  = ST_IDLE;
+		return;
+	}
 	if (_stat != ST_IDLE) {
 		_stat = ST_TERM;
 		_trig.post ();
@@ -704,11 +729,17 @@ Convlevel::main (void)
 #endif
 			return;
 		}
-		process ();
-		_done.post ();
+		run ();
 	}
 }
 
+void
+Convlevel::run ()
+{
+	process ();
+	_done.post ();
+}
+
 void
 Convlevel::process ()
 {
@@ -828,7 +859,11 @@ Convlevel::readout ()
 			if (++_opind == 3) {
 				_opind = 0;
 			}
-			_trig.post ();
+			if (_sched) {
+				_sched->schedule (this, _parsize);
+			} else {
+				_trig.post ();
+			}
 			_wait++;
 		} else {
 			process ();
@@ -163,6 +163,8 @@ private:
 
 // ----------------------------------------------------------------------------
 
+class Convsched;
+
 class LIBZCONVOLVER_API Inpnode
 {
 private:
@@ -229,6 +231,7 @@ class LIBZCONVOLVER_API Convlevel
 {
 private:
 	friend class Convproc;
+	friend class Convsched;
 
 	enum {
 		OPT_FFTW_MEASURE = 1,
@@ -267,9 +270,10 @@ private:
 	            float**  inpbuff,
 	            float**  outbuff);
 
-	void start (int absprio, int policy);
+	void start (int absprio, int policy, Convsched* sched);
 
 	void process ();
+	void run ();
 
 	int readout ();
 	int readtail (uint32_t n_samples);
@@ -303,6 +307,7 @@ private:
 	int               _bits;      // bit identifiying this level
 	int               _wait;      // number of unfinished cycles
 	pthread_t         _pthr;      // posix thread executing this level
+	Convsched*        _sched;     // external scheduler executing this level
 	ZCsema            _trig;      // sema used to trigger a cycle
 	ZCsema            _done;      // sema used to wait for a cycle
 	Inpnode*          _inp_list;  // linked list of active inputs
@@ -318,6 +323,39 @@ private:
 
 // ----------------------------------------------------------------------------
 
+/* Optional replacement for the per-level threads. A scheduler can
+ * execute the partition levels of many Convproc instances using a
+ * shared pool of threads.
+ */
+class LIBZCONVOLVER_API Convsched
+{
+public:
+	virtual ~Convsched (void) {}
+
+	/* Called by Convproc::start_process() for every level that is
+	 * not processed in the caller's thread. Return false to use a
+	 * dedicated thread for the level instead.
+	 */
+	virtual bool add_level (uint32_t parsize) = 0;
+
+	/* Called when the level stops, after all its cycles completed */
+	virtual void remove_level (uint32_t parsize) = 0;
+
+	/* Called by Convproc::process(), must be realtime-safe.
+	 * The scheduler has to call run (level) from another thread,
+	 * the result is required after parsize samples.
+	 */
+	virtual void schedule (Convlevel* level, uint32_t parsize) = 0;
+
+protected:
+	static void run (Convlevel* level)
+	{
+		level->run ();
+	}
+};
+
+// ----------------------------------------------------------------------------
+
 class LIBZCONVOLVER_API Convproc
 {
 public:
@@ -388,6 +426,9 @@ public:
 
 	void set_options (uint32_t options);
 
+	/* Use the given scheduler for the next start_process() */
+	void set_scheduler (Convsched* sched);
+
 	int reset (void);
 
 	int start_process (int abspri, int policy);
@@ -419,6 +460,7 @@ private:
 	uint32_t   _nlevels;         // number of partition sizes
 	uint32_t   _inpsize;         // size of input buffers
 	uint32_t   _latecnt;         // count of cycles ending too late
+	Convsched* _sched;           // external scheduler, optional
 	Convlevel* _convlev[MAXLEV]; // array of processors
 	void*      _dummy[64];
 
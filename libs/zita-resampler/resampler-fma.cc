@@ -0,0 +1,79 @@
+// ----------------------------------------------------------------------------
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// ----------------------------------------------------------------------------
+
+// AVX/FMA polyphase inner loops, see Resampler_kernels.
+// This file is compiled with -mavx -mfma.
+
+#include <immintrin.h>
+
+namespace ArdourZita {
+
+static inline __m256 reverse8 (__m256 v)
+{
+	v = _mm256_permute_ps (v, _MM_SHUFFLE (0, 1, 2, 3));
+	return _mm256_permute2f128_ps (v, v, 0x01);
+}
+
+static inline float hsum8 (__m256 v)
+{
+	__m128 s = _mm_add_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+	s = _mm_add_ps (s, _mm_movehl_ps (s, s));
+	s = _mm_add_ss (s, _mm_shuffle_ps (s, s, 1));
+	return _mm_cvtss_f32 (s);
+}
+
+float
+fir_avx_fma (const float *p1, const float *p2, const float *c1, const float *c2, int hl)
+{
+	__m256        s1 = _mm256_setzero_ps ();
+	__m256        s2 = _mm256_setzero_ps ();
+	int           i  = 0;
+
+	for (; i + 8 <= hl; i += 8) {
+		s1 = _mm256_fmadd_ps (_mm256_loadu_ps (p1 + i), _mm256_loadu_ps (c1 + i), s1);
+		s2 = _mm256_fmadd_ps (reverse8 (_mm256_loadu_ps (p2 - i - 8)), _mm256_loadu_ps (c2 + i), s2);
+	}
+	float a = 1e-25f + hsum8 (_mm256_add_ps (s1, s2));
+	for (; i < hl; i++) {
+		a += p1 [i] * c1 [i] + p2 [-i - 1] * c2 [i];
+	}
+	return a - 1e-25f;
+}
+
+float
+fir_interp_avx_fma (const float *p1, const float *p2, const float *q1, const float *q2, float a, float b, int hl)
+{
+	const __m256  va = _mm256_set1_ps (a);
+	const __m256  vb = _mm256_set1_ps (b);
+	__m256        s1 = _mm256_setzero_ps ();
+	__m256        s2 = _mm256_setzero_ps ();
+	int           i  = 0;
+
+	for (; i + 8 <= hl; i += 8) {
+		const __m256 c1 = _mm256_fmadd_ps (va, _mm256_loadu_ps (q1 + i), _mm256_mul_ps (vb, _mm256_loadu_ps (q1 + i + hl)));
+		const __m256 c2 = _mm256_fmadd_ps (va, _mm256_loadu_ps (q2 + i), _mm256_mul_ps (vb, _mm256_loadu_ps (q2 + i - hl)));
+		s1 = _mm256_fmadd_ps (_mm256_loadu_ps (p1 + i), c1, s1);
+		s2 = _mm256_fmadd_ps (reverse8 (_mm256_loadu_ps (p2 - i - 8)), c2, s2);
+	}
+	float r = 1e-25f + hsum8 (_mm256_add_ps (s1, s2));
+	for (; i < hl; i++) {
+		r += p1 [i] * (a * q1 [i] + b * q1 [i + hl]) + p2 [-i - 1] * (a * q2 [i] + b * q2 [i - hl]);
+	}
+	return r - 1e-25f;
+}
+
+}
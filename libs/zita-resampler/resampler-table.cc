@@ -24,6 +24,14 @@
 
 #include "zita-resampler/resampler-table.h"
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define RESAMPLER_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RESAMPLER_NEON
+#endif
+
 using namespace ArdourZita;
 
 Resampler_table  *Resampler_table::_list = 0;
@@ -121,3 +129,158 @@ Resampler_table::destroy (Resampler_table *T)
 	}
 	_mutex.unlock ();
 }
+
+
+// The accumulator starts at a small offset, which is removed from the
+// result, to avoid denormals while summing.
+
+#if defined(RESAMPLER_SSE)
+
+static inline __m128 reverse4 (__m128 v)
+{
+	return _mm_shuffle_ps (v, v, _MM_SHUFFLE (0, 1, 2, 3));
+}
+
+static inline float hsum4 (__m128 v)
+{
+	v = _mm_add_ps (v, _mm_movehl_ps (v, v));
+	v = _mm_add_ss (v, _mm_shuffle_ps (v, v, 1));
+	return _mm_cvtss_f32 (v);
+}
+
+static float
+fir_sse (const float *p1, const float *p2, const float *c1, const float *c2, int hl)
+{
+	__m128        s = _mm_set_ss (1e-25f);
+	int           i = 0;
+
+	for (; i + 4 <= hl; i += 4) {
+		s = _mm_add_ps (s, _mm_mul_ps (_mm_loadu_ps (p1 + i), _mm_loadu_ps (c1 + i)));
+		s = _mm_add_ps (s, _mm_mul_ps (reverse4 (_mm_loadu_ps (p2 - i - 4)), _mm_loadu_ps (c2 + i)));
+	}
+	float a = hsum4 (s);
+	for (; i < hl; i++) {
+		a += p1 [i] * c1 [i] + p2 [-i - 1] * c2 [i];
+	}
+	return a - 1e-25f;
+}
+
+static float
+fir_interp_sse (const float *p1, const float *p2, const float *q1, const float *q2, float a, float b, int hl)
+{
+	const __m128  va = _mm_set1_ps (a);
+	const __m128  vb = _mm_set1_ps (b);
+	__m128        s  = _mm_set_ss (1e-25f);
+	int           i  = 0;
+
+	for (; i + 4 <= hl; i += 4) {
+		const __m128 c1 = _mm_add_ps (_mm_mul_ps (va, _mm_loadu_ps (q1 + i)), _mm_mul_ps (vb, _mm_loadu_ps (q1 + i + hl)));
+		const __m128 c2 = _mm_add_ps (_mm_mul_ps (va, _mm_loadu_ps (q2 + i)), _mm_mul_ps (vb, _mm_loadu_ps (q2 + i - hl)));
+		s = _mm_add_ps (s, _mm_mul_ps (_mm_loadu_ps (p1 + i), c1));
+		s = _mm_add_ps (s, _mm_mul_ps (reverse4 (_mm_loadu_ps (p2 - i - 4)), c2));
+	}
+	float r = hsum4 (s);
+	for (; i < hl; i++) {
+		r += p1 [i] * (a * q1 [i] + b * q1 [i + hl]) + p2 [-i - 1] * (a * q2 [i] + b * q2 [i - hl]);
+	}
+	return r - 1e-25f;
+}
+
+Resampler_kernels::fir_t        Resampler_kernels::fir        = &fir_sse;
+Resampler_kernels::fir_interp_t Resampler_kernels::fir_interp = &fir_interp_sse;
+
+#elif defined(RESAMPLER_NEON)
+
+static inline float32x4_t reverse4 (float32x4_t v)
+{
+	v = vrev64q_f32 (v);
+	return vcombine_f32 (vget_high_f32 (v), vget_low_f32 (v));
+}
+
+static inline float hsum4 (float32x4_t v)
+{
+	float32x2_t r = vadd_f32 (vget_high_f32 (v), vget_low_f32 (v));
+	return vget_lane_f32 (vpadd_f32 (r, r), 0);
+}
+
+static float
+fir_neon (const float *p1, const float *p2, const float *c1, const float *c2, int hl)
+{
+	float32x4_t   s = vsetq_lane_f32 (1e-25f, vdupq_n_f32 (0), 0);
+	int           i = 0;
+
+	for (; i + 4 <= hl; i += 4) {
+		s = vmlaq_f32 (s, vld1q_f32 (p1 + i), vld1q_f32 (c1 + i));
+		s = vmlaq_f32 (s, reverse4 (vld1q_f32 (p2 - i - 4)), vld1q_f32 (c2 + i));
+	}
+	float a = hsum4 (s);
+	for (; i < hl; i++) {
+		a += p1 [i] * c1 [i] + p2 [-i - 1] * c2 [i];
+	}
+	return a - 1e-25f;
+}
+
+static float
+fir_interp_neon (const float *p1, const float *p2, const float *q1, const float *q2, float a, float b, int hl)
+{
+	float32x4_t   s = vsetq_lane_f32 (1e-25f, vdupq_n_f32 (0), 0);
+	int           i = 0;
+
+	for (; i + 4 <= hl; i += 4) {
+		const float32x4_t c1 = vmlaq_n_f32 (vmulq_n_f32 (vld1q_f32 (q1 + i), a), vld1q_f32 (q1 + i + hl), b);
+		const float32x4_t c2 = vmlaq_n_f32 (vmulq_n_f32 (vld1q_f32 (q2 + i), a), vld1q_f32 (q2 + i - hl), b);
+		s = vmlaq_f32 (s, vld1q_f32 (p1 + i), c1);
+		s = vmlaq_f32 (s, reverse4 (vld1q_f32 (p2 - i - 4)), c2);
+	}
+	float r = hsum4 (s);
+	for (; i < hl; i++) {
+		r += p1 [i] * (a * q1 [i] + b * q1 [i + hl]) + p2 [-i - 1] * (a * q2 [i] + b * q2 [i - hl]);
+	}
+	return r - 1e-25f;
+}
+
+Resampler_kernels::fir_t        Resampler_kernels::fir        = &fir_neon;
+Resampler_kernels::fir_interp_t Resampler_kernels::fir_interp = &fir_interp_neon;
+
+#else
+
+static float
+fir_generic (const float *p1, const float *p2, const float *c1, const float *c2, int hl)
+{
+	float a = 1e-25f;
+	for (int i = 0; i < hl; i++) {
+		a += p1 [i] * c1 [i] + p2 [-i - 1] * c2 [i];
+	}
+	return a - 1e-25f;
+}
+
+static float
+fir_interp_generic (const float *p1, const float *p2, const float *q1, const float *q2, float a, float b, int hl)
+{
+	float r = 1e-25f;
+	for (int i = 0; i < hl; i++) {
+		r += p1 [i] * (a * q1 [i] + b * q1 [i + hl]) + p2 [-i - 1] * (a * q2 [i] + b * q2 [i - hl]);
+	}
+	return r - 1e-25f;
+}
+
+Resampler_kernels::fir_t        Resampler_kernels::fir        = &fir_generic;
+Resampler_kernels::fir_interp_t Resampler_kernels::fir_interp = &fir_interp_generic;
+
+#endif
+
+#ifdef FPU_AVX_FMA_SUPPORT
+namespace ArdourZita {
+extern float fir_avx_fma (const float *, const float *, const float *, const float *, int);
+extern float fir_interp_avx_fma (const float *, const float *, const float *, const float *, float, float, int);
+}
+#endif
+
+void
+Resampler_kernels::use_avx_fma (void)
+{
+#ifdef FPU_AVX_FMA_SUPPORT
+	fir        = &fir_avx_fma;
+	fir_interp = &fir_interp_avx_fma;
+#endif
+}
@@ -194,16 +194,20 @@ Resampler::process (void)
 				if (nz < 2 * hl) {
 					float *c1 = _table->_ctab + hl * ph;
 					float *c2 = _table->_ctab + hl * (np - ph);
-					for (c = 0; c < _nchan; c++) {
-						float *q1 = p1 + c;
-						float *q2 = p2 + c;
-						float s = 1e-20f;
-						for (i = 0; i < hl; i++) {
-							q2 -= _nchan;
-							s += *q1 * c1 [i] + *q2 * c2 [i];
-							q1 += _nchan;
+					if (_nchan == 1) {
+						*out_data++ = Resampler_kernels::fir (p1, p2, c1, c2, hl);
+					} else {
+						for (c = 0; c < _nchan; c++) {
+							float *q1 = p1 + c;
+							float *q2 = p2 + c;
+							float s = 1e-20f;
+							for (i = 0; i < hl; i++) {
+								q2 -= _nchan;
+								s += *q1 * c1 [i] + *q2 * c2 [i];
+								q1 += _nchan;
+							}
+							*out_data++ = s - 1e-20f;
 						}
-						*out_data++ = s - 1e-20f;
 					}
 				} else {
 					for (c = 0; c < _nchan; c++) *out_data++ = 0;
@@ -31,8 +31,6 @@ using namespace ArdourZita;
 VMResampler::VMResampler (void)
 	: _table (0)
   , _buff  (0)
-  , _c1 (0)
-  , _c2 (0)
 {
 	reset ();
 }
@@ -65,8 +63,6 @@ VMResampler::setup (unsigned int hlen, double frel)
 	if (T) {
 		_table = T;
 		_buff  = new float [2 * h - 1 + k];
-		_c1 = new float [2 * h];
-		_c2 = new float [2 * h];
 		_inmax = k;
 		_pstep = s;
 		_qstep = s;
@@ -81,11 +77,7 @@ VMResampler::clear (void)
 {
 	Resampler_table::destroy (_table);
 	delete[] _buff;
-	delete[] _c1;
-	delete[] _c2;
 	_buff  = 0;
-	_c1 = 0;
-	_c2 = 0;
 	_table = 0;
 	_inmax = 0;
 	_pstep = 0;
@@ -163,7 +155,7 @@ VMResampler::process (void)
 {
 	unsigned int   in, nr, n;
 	double         ph, dp;
-	float          a, *p1, *p2;
+	float          *p1, *p2;
 
 	if (!_table) return 1;
 
@@ -233,16 +225,7 @@ VMResampler::process (void)
 				const float aa = 1.0f - bb;
 				float const* cq1 = _table->_ctab + hl * k;
 				float const* cq2 = _table->_ctab + hl * (np - k);
-				for (int i = 0; i < hl; i++) {
-					_c1 [i] = aa * cq1 [i] + bb * cq1 [i + hl];
-					_c2 [i] = aa * cq2 [i] + bb * cq2 [i - hl];
-				}
-
-				a = 1e-25f;
-				for (int i = 0; i < hl; i++) {
-					a += p1[i] * _c1 [i] + p2[-i-1] * _c2 [i];
-				}
-				*out_data++ = a - 1e-25f;
+				*out_data++ = Resampler_kernels::fir_interp (p1, p2, cq1, cq2, aa, bb, hl);
 			}
 			out_count--;
 
@@ -203,20 +203,24 @@ VResampler::process (void)
 					a = 1.0f - b;
 					q1 = _table->_ctab + hl * k;
 					q2 = _table->_ctab + hl * (np - k);
-					for (i = 0; i < hl; i++) {
-						_c1 [i] = a * q1 [i] + b * q1 [i + hl];
-						_c2 [i] = a * q2 [i] + b * q2 [i - hl];
-					}
-					for (c = 0; c < _nchan; c++) {
-						q1 = p1 + c;
-						q2 = p2 + c;
-						a = 1e-25f;
+					if (_nchan == 1) {
+						*out_data++ = Resampler_kernels::fir_interp (p1, p2, q1, q2, a, b, hl);
+					} else {
 						for (i = 0; i < hl; i++) {
-							q2 -= _nchan;
-							a += *q1 * _c1 [i] + *q2 * _c2 [i];
-							q1 += _nchan;
+							_c1 [i] = a * q1 [i] + b * q1 [i + hl];
+							_c2 [i] = a * q2 [i] + b * q2 [i - hl];
+						}
+						for (c = 0; c < _nchan; c++) {
+							q1 = p1 + c;
+							q2 = p2 + c;
+							a = 1e-25f;
+							for (i = 0; i < hl; i++) {
+								q2 -= _nchan;
+								a += *q1 * _c1 [i] + *q2 * _c2 [i];
+								q1 += _nchan;
+							}
+							*out_data++ = a - 1e-25f;
 						}
-						*out_data++ = a - 1e-25f;
 					}
 				} else {
 					for (c = 0; c < _nchan; c++) *out_data++ = 0;
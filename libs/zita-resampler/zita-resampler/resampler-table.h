@@ -65,6 +65,36 @@ private:
 	static Resampler_mutex   _mutex;
 };
 
+
+class LIBZRESAMPLER_API Resampler_kernels
+{
+public:
+	// Use the AVX/FMA inner loops. The caller must check that the CPU
+	// supports both. This is a no-op if the library was built without
+	// AVX/FMA support.
+	static void use_avx_fma (void);
+
+private:
+	friend class Resampler;
+	friend class VResampler;
+	friend class VMResampler;
+
+	// Polyphase FIR of a single channel:
+	//   sum (p1 [i] * c1 [i] + p2 [-i-1] * c2 [i]), 0 <= i < hl
+	typedef float (*fir_t) (const float *p1, const float *p2,
+	                        const float *c1, const float *c2, int hl);
+
+	// Same, with the coefficients interpolated between two phases:
+	//   c1 [i] = a * q1 [i] + b * q1 [i + hl]
+	//   c2 [i] = a * q2 [i] + b * q2 [i - hl]
+	typedef float (*fir_interp_t) (const float *p1, const float *p2,
+	                               const float *q1, const float *q2,
+	                               float a, float b, int hl);
+
+	static fir_t         fir;
+	static fir_interp_t  fir_interp;
+};
+
 };
 
 #endif
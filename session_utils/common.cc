@@ -200,7 +200,7 @@ SessionUtils::load_session (string dir, string state, bool exit_at_failure)
 }
 
 Session *
-SessionUtils::create_session (string dir, string state, float sample_rate)
+SessionUtils::create_session (string dir, string state, float sample_rate, int master_bus_chn)
 {
 	AudioEngine* engine = AudioEngine::create ();
 
@@ -232,7 +232,15 @@ SessionUtils::create_session (string dir, string state, float sample_rate)
 		return 0;
 	}
 
-	Session* session = new Session (*engine, dir, state);
+	BusProfile  bus_profile;
+	BusProfile* bus_profile_ptr = NULL;
+
+	if (master_bus_chn > 0) {
+		bus_profile_ptr = &bus_profile;
+		bus_profile.master_out_channels = master_bus_chn;
+	}
+
+	Session* session = new Session (*engine, dir, state, bus_profile_ptr);
 	engine->set_session (session);
 	return session;
 }
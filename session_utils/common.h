@@ -40,9 +40,10 @@ namespace SessionUtils {
 
 	/** @param dir Session directory.
 	 *  @param state Session state file, without .ardour suffix.
+	 *  @param master_bus_chn Master-bus channel count, zero for no master-bus.
 	 *  @returns an ardour session object (free with \ref unload_session) or NULL on error
 	 */
-	ARDOUR::Session* create_session (std::string dir, std::string state, float sample_rate);
+	ARDOUR::Session* create_session (std::string dir, std::string state, float sample_rate, int master_bus_chn = 0);
 
 	/** close session and stop engine
 	 * @param s Session to close (may me NULL)
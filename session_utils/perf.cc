@@ -0,0 +1,685 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <iostream>
+#include <vector>
+
+#include <glibmm.h>
+
+#include "pbd/compose.h"
+#include "pbd/stateful_diff_command.h"
+#include "pbd/string_convert.h"
+#include "pbd/timing.h"
+#include "pbd/xml++.h"
+
+#include "ardour/audio_track.h"
+#include "ardour/audioengine.h"
+#include "ardour/audiofilesource.h"
+#include "ardour/audioregion.h"
+#include "ardour/automation_list.h"
+#include "ardour/export_channel_configuration.h"
+#include "ardour/export_filename.h"
+#include "ardour/export_format_specification.h"
+#include "ardour/export_handler.h"
+#include "ardour/export_status.h"
+#include "ardour/export_timespan.h"
+#include "ardour/gain_control.h"
+#include "ardour/lua_api.h"
+#include "ardour/midi_model.h"
+#include "ardour/midi_region.h"
+#include "ardour/midi_source.h"
+#include "ardour/midi_track.h"
+#include "ardour/playlist.h"
+#include "ardour/region_factory.h"
+#include "ardour/route.h"
+
+#include "common.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace SessionUtils;
+
+struct PerfSettings
+{
+	PerfSettings ()
+		: audio_tracks (16)
+		, midi_tracks (4)
+		, regions (8)
+		, region_len (4)
+		, plugins (1)
+		, plugin ("ACE High/Low Pass Filter")
+		, instrument ("Simple Synth")
+		, automation (100)
+		, notes (64)
+		, cycles (2000)
+		, sample_rate (48000)
+		, export_session (true)
+	{}
+
+	int    audio_tracks;
+	int    midi_tracks;
+	int    regions;      ///< per track
+	int    region_len;   ///< seconds
+	int    plugins;      ///< per track
+	string plugin;
+	string instrument;
+	int    automation;   ///< gain automation events per track
+	int    notes;        ///< per MIDI region
+	int    cycles;
+	int    sample_rate;
+	bool   export_session;
+};
+
+/* all metrics are printed as "<name> <value> <unit>", one per line,
+ * in a fixed order, so that the output of different builds can be
+ * compared directly.
+ */
+static void
+metric (char const* name, double val, char const* unit)
+{
+	printf ("%-28s %14.3f %s\n", name, val, unit);
+}
+
+static double
+msec_since (PBD::microseconds_t t0)
+{
+	return (PBD::get_microseconds () - t0) / 1000.0;
+}
+
+/* deterministic pseudo-random numbers, identical on all platforms */
+static uint32_t
+lcg_rand ()
+{
+	static uint32_t seed = 12345;
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 16) & 0x7fff;
+}
+
+static boost::shared_ptr<Region>
+create_audio_region (Session* s, PerfSettings const& cfg, int track, int n)
+{
+	const samplecnt_t len = (samplecnt_t)cfg.region_len * s->sample_rate ();
+	const string      name = string_compose ("perf-%1-%2", track, n);
+
+	boost::shared_ptr<AudioFileSource> afs = s->create_audio_source_for_session (1, name, 0);
+
+	Sample      buf[8192];
+	const float freq = 2.f * M_PI * (110.f * (1 + track % 8) + 5.f * n) / s->sample_rate ();
+
+	for (samplecnt_t pos = 0; pos < len;) {
+		const samplecnt_t cnt = std::min<samplecnt_t> (8192, len - pos);
+		for (samplecnt_t i = 0; i < cnt; ++i) {
+			buf[i] = .25f * sinf (freq * (pos + i));
+		}
+		if (afs->write (buf, cnt) != cnt) {
+			return boost::shared_ptr<Region> ();
+		}
+		pos += cnt;
+	}
+
+	time_t     xnow = time (NULL);
+	struct tm* now  = localtime (&xnow);
+
+	/* compare to LuaAPI::Rubberband::finalize */
+	afs->done_with_peakfile_writes ();
+	afs->update_header (0, *now, xnow);
+	afs->mark_immutable ();
+
+	SourceList sl;
+	sl.push_back (afs);
+
+	PropertyList plist;
+	plist.add (Properties::start, timepos_t (0));
+	plist.add (Properties::length, timecnt_t (len));
+	plist.add (Properties::name, name);
+	plist.add (Properties::whole_file, true);
+
+	boost::shared_ptr<Region> whole = RegionFactory::create (sl, plist);
+	return RegionFactory::create (whole, true);
+}
+
+static boost::shared_ptr<Region>
+create_midi_region (Session* s, PerfSettings const& cfg, int track, int n, Temporal::Beats const& len)
+{
+	const string name = string_compose ("perf-%1-%2", track, n);
+
+	boost::shared_ptr<MidiSource> src = s->create_midi_source_for_session (name);
+
+	PropertyList plist;
+	plist.add (Properties::start, timepos_t (Temporal::Beats ()));
+	plist.add (Properties::length, timecnt_t (len));
+	plist.add (Properties::name, name);
+	plist.add (Properties::whole_file, true);
+
+	boost::shared_ptr<MidiRegion> mr = boost::dynamic_pointer_cast<MidiRegion> (RegionFactory::create (src, plist));
+	if (!mr) {
+		return mr;
+	}
+
+	{
+		Source::Lock lm (src->mutex ());
+		if (!src->model ()) {
+			src->load_model (lm);
+		}
+	}
+
+	boost::shared_ptr<MidiModel> mm  = src->model ();
+	MidiModel::NoteDiffCommand*  cmd = mm->new_note_diff_command ("perf");
+
+	const int64_t ticks = len.to_ticks ();
+	const int64_t dur   = std::max<int64_t> (1, ticks / std::max (1, cfg.notes) / 2);
+
+	for (int i = 0; i < cfg.notes; ++i) {
+		Temporal::Beats start = Temporal::Beats::ticks (i * ticks / cfg.notes);
+		cmd->add (boost::shared_ptr<Evoral::Note<Temporal::Beats> > (
+		    new Evoral::Note<Temporal::Beats> (0, start, Temporal::Beats::ticks (dur), 36 + lcg_rand () % 48, 64 + lcg_rand () % 64)));
+	}
+	mm->apply_command (s, cmd);
+
+	return RegionFactory::create (mr, true);
+}
+
+static bool
+add_plugin (Session* s, boost::shared_ptr<Route> r, string const& name)
+{
+	boost::shared_ptr<Processor> p = LuaAPI::new_luaproc (s, name);
+	if (!p || r->add_processor_by_index (p, -1, 0, true)) {
+		cerr << "Cannot add plugin '" << name << "' to '" << r->name () << "'\n";
+		return false;
+	}
+	return true;
+}
+
+static void
+add_gain_automation (boost::shared_ptr<Route> r, PerfSettings const& cfg, samplecnt_t range)
+{
+	if (cfg.automation <= 0) {
+		return;
+	}
+	boost::shared_ptr<AutomationList> al = r->gain_control ()->alist ();
+	al->freeze ();
+	for (int i = 0; i < cfg.automation; ++i) {
+		const samplepos_t when = range * i / cfg.automation;
+		al->fast_simple_add (timepos_t (when), .5 + .4 * sin (2 * M_PI * i / 32.));
+	}
+	al->thaw ();
+	r->gain_control ()->set_automation_state (Play);
+}
+
+static int
+generate (Session* s, PerfSettings const& cfg)
+{
+	const samplecnt_t     rlen   = (samplecnt_t)cfg.region_len * s->sample_rate ();
+	const samplecnt_t     range  = rlen * cfg.regions;
+	/* assume the default tempo of 120 BPM */
+	const Temporal::Beats blen (std::max (1, 2 * cfg.region_len), 0);
+
+	if (cfg.audio_tracks > 0) {
+		list<boost::shared_ptr<AudioTrack> > tl = s->new_audio_track (1, 2, 0, cfg.audio_tracks, "Audio", PresentationInfo::max_order, Normal);
+		if ((int)tl.size () != cfg.audio_tracks) {
+			cerr << "Cannot create audio tracks\n";
+			return -1;
+		}
+		int t = 0;
+		for (list<boost::shared_ptr<AudioTrack> >::iterator i = tl.begin (); i != tl.end (); ++i, ++t) {
+			boost::shared_ptr<Playlist> pl = (*i)->playlist ();
+			for (int n = 0; n < cfg.regions; ++n) {
+				boost::shared_ptr<Region> r = create_audio_region (s, cfg, t, n);
+				if (!r) {
+					cerr << "Cannot create audio region\n";
+					return -1;
+				}
+				pl->add_region (r, timepos_t (n * rlen));
+			}
+			for (int p = 0; p < cfg.plugins; ++p) {
+				if (!add_plugin (s, *i, cfg.plugin)) {
+					return -1;
+				}
+			}
+			add_gain_automation (*i, cfg, range);
+		}
+	}
+
+	if (cfg.midi_tracks > 0) {
+		list<boost::shared_ptr<MidiTrack> > tl = s->new_midi_track (ChanCount (DataType::MIDI, 1), ChanCount (DataType::MIDI, 1),
+		                                                            false, boost::shared_ptr<PluginInfo> (), 0, 0,
+		                                                            cfg.midi_tracks, "MIDI", PresentationInfo::max_order, Normal, true);
+		if ((int)tl.size () != cfg.midi_tracks) {
+			cerr << "Cannot create MIDI tracks\n";
+			return -1;
+		}
+		int t = 0;
+		for (list<boost::shared_ptr<MidiTrack> >::iterator i = tl.begin (); i != tl.end (); ++i, ++t) {
+			boost::shared_ptr<Playlist> pl = (*i)->playlist ();
+			for (int n = 0; n < cfg.regions; ++n) {
+				boost::shared_ptr<Region> r = create_midi_region (s, cfg, t, n, blen);
+				if (!r) {
+					cerr << "Cannot create MIDI region\n";
+					return -1;
+				}
+				pl->add_region (r, timepos_t (Temporal::Beats (n * blen.get_beats (), 0)));
+			}
+			if (!cfg.instrument.empty () && !add_plugin (s, *i, cfg.instrument)) {
+				return -1;
+			}
+			for (int p = 0; p < cfg.plugins && !cfg.instrument.empty (); ++p) {
+				if (!add_plugin (s, *i, cfg.plugin)) {
+					return -1;
+				}
+			}
+			add_gain_automation (*i, cfg, range);
+		}
+	}
+
+	s->set_session_extents (timepos_t (0), timepos_t (range));
+
+	/* do not save the notes as undo-history */
+	s->history ().clear ();
+	return 0;
+}
+
+static void
+playback (Session* s, PerfSettings const& cfg)
+{
+	const pframes_t nframes = s->engine ().samples_per_cycle ();
+	const double    nominal = 1e6 * nframes / s->sample_rate ();
+
+	/* let the engine's process thread handle the locate and start the transport */
+	s->request_locate (0, MustRoll);
+	for (int i = 0; i < 5000 && !s->transport_rolling (); ++i) {
+		Glib::usleep (1000);
+	}
+	if (!s->transport_rolling ()) {
+		cerr << "Transport did not start\n";
+	}
+
+	vector<float> dt (cfg.cycles);
+
+	/* compare to libs/ardour/test/profiling/runpc.cc
+	 * while the process-lock is held, the backend does not run the session
+	 */
+	{
+		Glib::Threads::Mutex::Lock lm (AudioEngine::instance ()->process_lock ());
+		for (int i = 0; i < cfg.cycles; ++i) {
+			const PBD::microseconds_t t0 = PBD::get_microseconds ();
+			s->process (nframes);
+			dt[i] = PBD::get_microseconds () - t0;
+		}
+	}
+
+	s->request_stop ();
+
+	double sum  = 0;
+	int    over = 0;
+	for (int i = 0; i < cfg.cycles; ++i) {
+		sum += dt[i];
+		if (dt[i] > nominal) {
+			++over;
+		}
+	}
+	sort (dt.begin (), dt.end ());
+
+	const int n = cfg.cycles;
+#define PERCENTILE(P) dt[std::min (n - 1, (int)floor ((P) * 0.01 * n))]
+	metric ("process.nominal", nominal, "us");
+	metric ("process.cycles", n, "");
+	metric ("process.min", dt[0], "us");
+	metric ("process.avg", sum / n, "us");
+	metric ("process.p50", PERCENTILE (50), "us");
+	metric ("process.p90", PERCENTILE (90), "us");
+	metric ("process.p99", PERCENTILE (99), "us");
+	metric ("process.max", dt[n - 1], "us");
+	metric ("process.dsp_load", 100.0 * sum / n / nominal, "%");
+	metric ("process.overruns", over, "");
+#undef PERCENTILE
+}
+
+static void
+undo_redo (Session* s)
+{
+	boost::shared_ptr<RouteList> rl = s->get_tracks ();
+
+	PBD::microseconds_t t0 = PBD::get_microseconds ();
+
+	/* compare to libs/ardour/test/profiling/lots_of_regions.cc */
+	s->begin_reversible_command ("perf duplicate");
+	for (RouteList::const_iterator i = rl->begin (); i != rl->end (); ++i) {
+		boost::shared_ptr<Track> t = boost::dynamic_pointer_cast<Track> (*i);
+		if (!t || t->playlist ()->n_regions () == 0) {
+			continue;
+		}
+		boost::shared_ptr<Playlist> pl = t->playlist ();
+		boost::shared_ptr<Region>   r  = pl->region_list_property ().rlist ().front ();
+		timepos_t                   pos (pl->get_extent ().second);
+		pl->clear_changes ();
+		pl->duplicate (r, pos, 4);
+		s->add_command (new StatefulDiffCommand (pl));
+	}
+	s->commit_reversible_command ();
+	metric ("edit.duplicate", msec_since (t0), "ms");
+
+	t0 = PBD::get_microseconds ();
+	s->undo (1);
+	metric ("edit.undo", msec_since (t0), "ms");
+
+	t0 = PBD::get_microseconds ();
+	s->redo (1);
+	metric ("edit.redo", msec_since (t0), "ms");
+
+	s->undo (1);
+}
+
+static int
+export_range (Session* s)
+{
+	ExportTimespanPtr                             tsp = s->get_export_handler ()->add_timespan ();
+	boost::shared_ptr<ExportChannelConfiguration> ccp = s->get_export_handler ()->add_channel_config ();
+	boost::shared_ptr<ARDOUR::ExportFilename>     fnp = s->get_export_handler ()->add_filename ();
+
+	XMLTree tree;
+
+	/* compare to export.cc */
+	tree.read_buffer (string (
+"<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+"<ExportFormatSpecification name=\"UTIL-PERF-EXPORT\" id=\"6a2a63b3-a7d3-4b3c-9e5a-2bb0b6d2b0c1\">"
+"  <Encoding id=\"F_WAV\" type=\"T_Sndfile\" extension=\"wav\" name=\"WAV\" has-sample-format=\"true\" channel-limit=\"256\"/>"
+"  <SampleRate rate=\"" + PBD::to_string (s->nominal_sample_rate ()) + "\"/>"
+"  <SRCQuality quality=\"SRC_SincBest\"/>"
+"  <EncodingOptions>"
+"    <Option name=\"sample-format\" value=\"SF_Float\"/>"
+"    <Option name=\"dithering\" value=\"D_None\"/>"
+"    <Option name=\"tag-metadata\" value=\"false\"/>"
+"    <Option name=\"tag-support\" value=\"false\"/>"
+"    <Option name=\"broadcast-info\" value=\"false\"/>"
+"  </EncodingOptions>"
+"  <Processing>"
+"    <Normalize enabled=\"false\" target=\"0\"/>"
+"    <Silence>"
+"      <Start>"
+"        <Trim enabled=\"false\"/>"
+"        <Add enabled=\"false\">"
+"          <Duration format=\"Timecode\" hours=\"0\" minutes=\"0\" seconds=\"0\" frames=\"0\"/>"
+"        </Add>"
+"      </Start>"
+"      <End>"
+"        <Trim enabled=\"false\"/>"
+"        <Add enabled=\"false\">"
+"          <Duration format=\"Timecode\" hours=\"0\" minutes=\"0\" seconds=\"0\" frames=\"0\"/>"
+"        </Add>"
+"      </End>"
+"    </Silence>"
+"  </Processing>"
+"</ExportFormatSpecification>"
+	).c_str ());
+
+	boost::shared_ptr<ExportFormatSpecification> fmp = s->get_export_handler ()->add_format (*tree.root ());
+
+	const samplepos_t start = s->current_start_sample ();
+	const samplepos_t end   = s->current_end_sample ();
+	tsp->set_range (start, end);
+	tsp->set_range_id ("session");
+	tsp->set_name ("perf");
+
+	if (!s->master_out ()) {
+		cerr << "No master-bus to export\n";
+		return -1;
+	}
+
+	IO* master_out = s->master_out ()->output ().get ();
+	for (uint32_t n = 0; n < master_out->n_ports ().n_audio (); ++n) {
+		PortExportChannel* channel = new PortExportChannel ();
+		channel->add_port (master_out->audio (n));
+		ExportChannelPtr chan_ptr (channel);
+		ccp->register_channel (chan_ptr);
+	}
+
+	fnp->set_timespan (tsp);
+	fnp->include_label = false;
+	fmp->set_soundcloud_upload (false);
+
+	s->get_export_handler ()->add_export_config (tsp, ccp, fmp, fnp, boost::shared_ptr<BroadcastInfo> ());
+
+	PBD::microseconds_t t0 = PBD::get_microseconds ();
+
+	if (0 != s->get_export_handler ()->do_export ()) {
+		cerr << "Export failed\n";
+		return -1;
+	}
+
+	boost::shared_ptr<ARDOUR::ExportStatus> status = s->get_export_status ();
+	while (status->running ()) {
+		Glib::usleep (10000);
+	}
+
+	const double ms = msec_since (t0);
+	status->finish (TRS_UI);
+
+	metric ("export.duration", ms, "ms");
+	metric ("export.realtime", ms > 0 ? 1000.0 * (end - start) / s->nominal_sample_rate () / ms : 0, "x");
+	return 0;
+}
+
+static void
+usage ()
+{
+	// help2man compatible format (standard GNU help-text)
+	printf (UTILNAME " - generate a synthetic session and measure its performance.\n\n");
+	printf ("Usage: " UTILNAME " [ OPTIONS ] <session-dir>\n\n");
+	printf ("Options:\n\
+  -a, --audio-tracks <n>      Number of audio tracks (default 16)\n\
+  -A, --automation <n>        Gain automation events per track (default 100)\n\
+  -c, --cycles <n>            Number of process cycles to time (default 2000)\n\
+  -E, --no-export             Do not time an export of the session\n\
+  -h, --help                  Display this help and exit\n\
+  -i, --instrument <name>     Lua instrument for MIDI tracks (default \"Simple Synth\")\n\
+  -l, --region-length <sec>   Length of each region (default 4)\n\
+  -m, --midi-tracks <n>       Number of MIDI tracks (default 4)\n\
+  -n, --notes <n>             Notes per MIDI region (default 64)\n\
+  -p, --plugins <n>           Plugins per track (default 1)\n\
+  -P, --plugin <name>         Lua plugin to use (default \"ACE High/Low Pass Filter\")\n\
+  -r, --regions <n>           Regions per track (default 8)\n\
+  -s, --samplerate <rate>     Samplerate to use (default 48000)\n\
+  -V, --version               Print version information and exit\n\
+\n");
+
+	printf ("\n\
+This tool creates a new session in the given directory, which must not\n\
+exist, and populates it with tracks, regions, plugins, automation and\n\
+MIDI notes. It then measures the time to save, unload and re-load the\n\
+session, the cost of process cycles during playback, duplicating regions\n\
+on all tracks with undo and redo, and an export of the session-range.\n\
+\n\
+Results are printed as \"<metric> <value> <unit>\", one per line, in a fixed\n\
+order, so that the output of different builds can be compared directly.\n\
+Generation is deterministic for a given set of options.\n\
+\n\
+Process cycles are timed with the engine's process-lock held, using the\n\
+Dummy backend's period size. For per-cycle statistics of the backend\n\
+itself, see the ARDOUR_DUMMY_BENCHMARK environment variable.\n\
+\n");
+
+	printf ("\n\
+Examples:\n\
+" UTILNAME " -a 64 -m 16 -r 32 -p 2 /tmp/PerfSession\n\
+\n");
+
+	printf ("Report bugs to <http://tracker.ardour.org/>\n"
+	        "Website: <http://ardour.org/>\n");
+	::exit (EXIT_SUCCESS);
+}
+
+int
+main (int argc, char* argv[])
+{
+	PerfSettings cfg;
+
+	const char* optstring = "a:A:c:Ehi:l:m:n:p:P:r:s:V";
+
+	/* clang-format off */
+	const struct option longopts[] = {
+		{ "audio-tracks",  required_argument, 0, 'a' },
+		{ "automation",    required_argument, 0, 'A' },
+		{ "cycles",        required_argument, 0, 'c' },
+		{ "no-export",     no_argument,       0, 'E' },
+		{ "help",          no_argument,       0, 'h' },
+		{ "instrument",    required_argument, 0, 'i' },
+		{ "region-length", required_argument, 0, 'l' },
+		{ "midi-tracks",   required_argument, 0, 'm' },
+		{ "notes",         required_argument, 0, 'n' },
+		{ "plugins",       required_argument, 0, 'p' },
+		{ "plugin",        required_argument, 0, 'P' },
+		{ "regions",       required_argument, 0, 'r' },
+		{ "samplerate",    required_argument, 0, 's' },
+		{ "version",       no_argument,       0, 'V' },
+	};
+	/* clang-format on */
+
+	int c = 0;
+	while (EOF != (c = getopt_long (argc, argv,
+	                                optstring, longopts, (int*)0))) {
+		switch (c) {
+			case 'a':
+				cfg.audio_tracks = std::max (0, atoi (optarg));
+				break;
+			case 'A':
+				cfg.automation = std::max (0, atoi (optarg));
+				break;
+			case 'c':
+				cfg.cycles = std::max (1, atoi (optarg));
+				break;
+			case 'E':
+				cfg.export_session = false;
+				break;
+			case 'i':
+				cfg.instrument = optarg;
+				break;
+			case 'l':
+				cfg.region_len = std::max (1, atoi (optarg));
+				break;
+			case 'm':
+				cfg.midi_tracks = std::max (0, atoi (optarg));
+				break;
+			case 'n':
+				cfg.notes = std::max (0, atoi (optarg));
+				break;
+			case 'p':
+				cfg.plugins = std::max (0, atoi (optarg));
+				break;
+			case 'P':
+				cfg.plugin = optarg;
+				break;
+			case 'r':
+				cfg.regions = std::max (1, atoi (optarg));
+				break;
+			case 's': {
+				const int sr = atoi (optarg);
+				if (sr >= 8000 && sr <= 192000) {
+					cfg.sample_rate = sr;
+				} else {
+					cerr << "Invalid Samplerate\n";
+				}
+			} break;
+
+			case 'V':
+				printf ("ardour-utils version %s\n\n", VERSIONSTRING);
+				exit (EXIT_SUCCESS);
+				break;
+
+			case 'h':
+				usage ();
+				break;
+
+			default:
+				cerr << "Error: unrecognized option. See --help for usage information.\n";
+				::exit (EXIT_FAILURE);
+				break;
+		}
+	}
+
+	if (optind + 1 != argc) {
+		cerr << "Error: Missing parameter. See --help for usage information.\n";
+		::exit (EXIT_FAILURE);
+	}
+
+	const string dir  = argv[optind];
+	const string name = Glib::path_get_basename (dir);
+
+	if (Glib::file_test (dir, Glib::FILE_TEST_EXISTS)) {
+		cerr << "Error: Session folder already exists '" << dir << "'\n";
+		::exit (EXIT_FAILURE);
+	}
+
+	SessionUtils::init (false);
+
+	PBD::microseconds_t t0 = PBD::get_microseconds ();
+
+	Session* s = SessionUtils::create_session (dir, name, cfg.sample_rate, 2);
+	if (!s) {
+		::exit (EXIT_FAILURE);
+	}
+
+	printf ("# audio-tracks=%d midi-tracks=%d regions=%d region-length=%d plugins=%d automation=%d notes=%d cycles=%d samplerate=%d\n",
+	        cfg.audio_tracks, cfg.midi_tracks, cfg.regions, cfg.region_len, cfg.plugins,
+	        cfg.automation, cfg.notes, cfg.cycles, cfg.sample_rate);
+
+	metric ("session.create", msec_since (t0), "ms");
+
+	t0 = PBD::get_microseconds ();
+	if (generate (s, cfg)) {
+		SessionUtils::unload_session (s);
+		SessionUtils::cleanup ();
+		::exit (EXIT_FAILURE);
+	}
+	metric ("session.generate", msec_since (t0), "ms");
+
+	t0 = PBD::get_microseconds ();
+	s->save_state ("");
+	metric ("session.save", msec_since (t0), "ms");
+
+	/* unload_session also stops the engine, and load_session
+	 * re-starts it, which is included in the load time.
+	 */
+	t0 = PBD::get_microseconds ();
+	SessionUtils::unload_session (s);
+	metric ("session.unload", msec_since (t0), "ms");
+
+	t0 = PBD::get_microseconds ();
+	s = SessionUtils::load_session (dir, name);
+	metric ("session.load", msec_since (t0), "ms");
+
+	metric ("session.routes", s->get_routes ()->size (), "");
+
+	playback (s, cfg);
+	undo_redo (s);
+
+	if (cfg.export_session) {
+		export_range (s);
+	}
+
+	t0 = PBD::get_microseconds ();
+	s->save_state ("");
+	metric ("session.resave", msec_since (t0), "ms");
+
+	SessionUtils::unload_session (s);
+	SessionUtils::cleanup ();
+
+	return 0;
+}
@@ -17,7 +17,7 @@
  */
 
 import { Component } from './base/component.js';
-import { StateNode } from './base/protocol.js';
+import { Message, StateNode } from './base/protocol.js';
 import MessageChannel from './base/channel.js';
 import Mixer from './components/mixer.js';
 import Transport from './components/transport.js';
@@ -40,6 +40,8 @@ export default class ArdourClient extends Component {
 		}
 
 		this._autoReconnect = getOption(options, 'autoReconnect', true);
+		this._binaryMeters = getOption(options, 'binaryMeters', false);
+		this._subscribedStrips = [];
 		this._connected = false;
 
 		this.channel.onMessage = (msg, inbound) => this._handleMessage(msg, inbound);
@@ -87,6 +89,16 @@ export default class ArdourClient extends Component {
 		return await this.channel.sendAndReceive(msg);
 	}
 
+	// Only receive feedback for the given strip ids, an empty list means all strips
+
+	subscribeStrips (stripIds) {
+		this._subscribedStrips = stripIds || [];
+
+		if (this._connected) {
+			this.send(new Message(StateNode.STRIP_SUBSCRIBE, [], this._subscribedStrips));
+		}
+	}
+
 	// Surface metadata API goes over HTTP
 
 	async getAvailableSurfaces () {
@@ -125,6 +137,15 @@ export default class ArdourClient extends Component {
 
 	async _connect () {
 		await this.channel.open();
+
+		if (this._binaryMeters) {
+			this.send(new Message(StateNode.STRIP_METER_BINARY, [], [true]));
+		}
+
+		if (this._subscribedStrips.length > 0) {
+			this.send(new Message(StateNode.STRIP_SUBSCRIBE, [], this._subscribedStrips));
+		}
+
 		this._setConnected(true);
 	}
 
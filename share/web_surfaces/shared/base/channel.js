@@ -29,12 +29,20 @@ export default class MessageChannel {
 	async open () {
 		return new Promise((resolve, reject) => {
 			this._socket = new WebSocket(`ws://${this._host}`);
+			this._socket.binaryType = 'arraybuffer';
 
 			this._socket.onclose = () => this.onClose();
 
 			this._socket.onerror = (error) => this.onError(error);
 
 			this._socket.onmessage = (event) => {
+				if (event.data instanceof ArrayBuffer) {
+					for (const msg of Message.fromMeterFrame(event.data)) {
+						this.onMessage(msg, true);
+					}
+					return;
+				}
+
 				const msg = Message.fromJsonText(event.data);
 
 				if (this._pending && (this._pending.nodeAddrId == msg.nodeAddrId)) {
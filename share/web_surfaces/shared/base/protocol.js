@@ -28,6 +28,8 @@ export const StateNode = Object.freeze({
 	STRIP_PLUGIN_ENABLE            : 'strip_plugin_enable',
 	STRIP_PLUGIN_PARAM_DESCRIPTION : 'strip_plugin_param_description',
 	STRIP_PLUGIN_PARAM_VALUE       : 'strip_plugin_param_value',
+	STRIP_SUBSCRIBE                : 'strip_subscribe',
+	STRIP_METER_BINARY             : 'strip_meter_binary',
 	TRANSPORT_TEMPO                : 'transport_tempo',
 	TRANSPORT_TIME                 : 'transport_time',
 	TRANSPORT_ROLL                 : 'transport_roll',
@@ -61,6 +63,26 @@ export class Message {
 		return new Message(rawMsg.node, rawMsg.addr || [], rawMsg.val);
 	}
 
+	// see WebsocketsServer::update_all_meters()
+	static fromMeterFrame (buffer) {
+		const view = new DataView(buffer);
+		const messages = [];
+
+		if ((view.byteLength < 4) || (view.getUint8(0) != 0x4d /* M */) || (view.getUint8(1) != 1)) {
+			return messages;
+		}
+
+		const n = Math.min(view.getUint16(2, true), (view.byteLength - 4) / 8);
+
+		for (let i = 0; i < n; i++) {
+			const stripId = view.getUint32(4 + 8 * i, true);
+			const db = view.getFloat32(8 + 8 * i, true);
+			messages.push(new Message(StateNode.STRIP_METER, [stripId], [db]));
+		}
+
+		return messages;
+	}
+
 	toJsonText () {
 		let val = [];
 